@@ -0,0 +1,190 @@
+#include "AnalyticSky.h"
+#include "glew.h"
+#include "GLState.h"
+#include <math.h>
+
+static const float PI = 3.14159265f;
+
+// Dome resolution; the rings go a little below the horizon so no gap shows
+static const int SKY_SLICES = 48;
+static const int SKY_STACKS = 24;
+static const float SKY_LOWEST = -0.35f;    // Elevation of the bottom ring (radians)
+
+// Keeps the model in its valid range while the sun sets
+static const float MIN_SUN_ELEVATION = 0.03f;
+// Tone mapping: 1 - exp(-exposure * RGB), then gamma
+static const float SKY_EXPOSURE = 0.08f;
+// Recompute only after the sun moved about a tenth of a degree
+static const float SUN_EPSILON = 0.002f;
+
+AnalyticSky::AnalyticSky() : turbidity(3.0f), valid(false), sunZenith(0.0f), dayFactor(1.0f) {
+    buildDome();
+}
+
+void AnalyticSky::setTurbidity(float value) {
+    if (value < 1.7f) value = 1.7f;
+    if (value > 10.0f) value = 10.0f;
+    turbidity = value;
+    valid = false;
+}
+
+void AnalyticSky::buildDome() {
+    positions.clear();
+    for (int i = 0; i <= SKY_STACKS; i++) {
+        float elevation = PI / 2.0f - (PI / 2.0f - SKY_LOWEST) * i / SKY_STACKS;
+        for (int j = 0; j <= SKY_SLICES; j++) {
+            float azimuth = 2.0f * PI * j / SKY_SLICES;
+            positions.push_back(cosf(elevation) * sinf(azimuth));
+            positions.push_back(sinf(elevation));
+            positions.push_back(cosf(elevation) * cosf(azimuth));
+        }
+    }
+    colors.assign(positions.size() / 3 * 4, 255);
+
+    indices.clear();
+    for (int i = 0; i < SKY_STACKS; i++) {
+        for (int j = 0; j < SKY_SLICES; j++) {
+            unsigned short top = (unsigned short)(i * (SKY_SLICES + 1) + j);
+            unsigned short bottom = (unsigned short)(top + SKY_SLICES + 1);
+            indices.push_back(top);
+            indices.push_back(bottom);
+            indices.push_back((unsigned short)(top + 1));
+            indices.push_back((unsigned short)(top + 1));
+            indices.push_back(bottom);
+            indices.push_back((unsigned short)(bottom + 1));
+        }
+    }
+}
+
+float AnalyticSky::perez(const float c[5], float cosTheta, float gamma) {
+    float cosGamma = cosf(gamma);
+    return (1.0f + c[0] * expf(c[1] / cosTheta)) * (1.0f + c[2] * expf(c[3] * gamma) + c[4] * cosGamma * cosGamma);
+}
+
+void AnalyticSky::computeCoefficients() {
+    // Preetham, Shirley & Smits 1999, "A Practical Analytic Model for Daylight"
+    float T = turbidity;
+    float elevation = asinf(sun.y < -1.0f ? -1.0f : (sun.y > 1.0f ? 1.0f : sun.y));
+    if (elevation < MIN_SUN_ELEVATION) elevation = MIN_SUN_ELEVATION;
+    float ts = PI / 2.0f - elevation;
+    sunZenith = ts;
+
+    const float coeffY[5] = { 0.1787f * T - 1.4630f, -0.3554f * T + 0.4275f, -0.0227f * T + 5.3251f,
+                              0.1206f * T - 2.5771f, -0.0670f * T + 0.3703f };
+    const float coeffX[5] = { -0.0193f * T - 0.2592f, -0.0665f * T + 0.0008f, -0.0004f * T + 0.2125f,
+                              -0.0641f * T - 0.8989f, -0.0033f * T + 0.0452f };
+    const float coeffYc[5] = { -0.0167f * T - 0.2608f, -0.0950f * T + 0.0092f, -0.0079f * T + 0.2102f,
+                               -0.0441f * T - 1.6537f, -0.0109f * T + 0.0529f };
+    for (int i = 0; i < 5; i++) {
+        perezY[i] = coeffY[i];
+        perezX[i] = coeffX[i];
+        perezYc[i] = coeffYc[i];
+    }
+
+    float chi = (4.0f / 9.0f - T / 120.0f) * (PI - 2.0f * ts);
+    zenithY = (4.0453f * T - 4.9710f) * tanf(chi) - 0.2155f * T + 2.4192f;
+
+    float ts2 = ts * ts;
+    float ts3 = ts2 * ts;
+    zenithX = T * T * (0.00166f * ts3 - 0.00375f * ts2 + 0.00209f * ts) +
+              T * (-0.02903f * ts3 + 0.06377f * ts2 - 0.03202f * ts + 0.00394f) +
+              (0.11693f * ts3 - 0.21196f * ts2 + 0.06052f * ts + 0.25886f);
+    zenithYc = T * T * (0.00275f * ts3 - 0.00610f * ts2 + 0.00317f * ts) +
+               T * (-0.04214f * ts3 + 0.08970f * ts2 - 0.04153f * ts + 0.00516f) +
+               (0.15346f * ts3 - 0.26756f * ts2 + 0.06670f * ts + 0.26688f);
+
+    // Daylight fades out over the first few degrees below the horizon
+    float t = (sun.y + 0.12f) / 0.17f;
+    if (t < 0.0f) t = 0.0f;
+    if (t > 1.0f) t = 1.0f;
+    dayFactor = t * t * (3.0f - 2.0f * t);
+}
+
+void AnalyticSky::evaluate(const Vector3f& direction, float rgb[3]) const {
+    float length = sqrtf(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+    if (length <= 0.0f) {
+        rgb[0] = rgb[1] = rgb[2] = 0.0f;
+        return;
+    }
+    float dx = direction.x / length;
+    float dy = direction.y / length;
+    float dz = direction.z / length;
+
+    // Night gradient: deep blue overhead, a little lighter at the horizon
+    float up = dy > 0.0f ? dy : 0.0f;
+    float night[3] = { 0.04f - 0.03f * up, 0.05f - 0.035f * up, 0.11f - 0.06f * up };
+
+    float day[3] = { 0.0f, 0.0f, 0.0f };
+    if (dayFactor > 0.0f) {
+        // Below the horizon the horizon color continues, slightly darker
+        float cosTheta = dy < 0.01f ? 0.01f : dy;
+        float shade = dy < 0.0f ? 1.0f + dy : 1.0f;
+
+        // Sun direction clamped to the model's range, same azimuth
+        float horizontal = sqrtf(sun.x * sun.x + sun.z * sun.z);
+        float sunElevation = PI / 2.0f - sunZenith;
+        float sx = horizontal > 0.0f ? sun.x / horizontal * cosf(sunElevation) : 0.0f;
+        float sz = horizontal > 0.0f ? sun.z / horizontal * cosf(sunElevation) : cosf(sunElevation);
+        float sy = sinf(sunElevation);
+        float cosGamma = dx * sx + dy * sy + dz * sz;
+        if (cosGamma > 1.0f) cosGamma = 1.0f;
+        if (cosGamma < -1.0f) cosGamma = -1.0f;
+        float gamma = acosf(cosGamma);
+
+        float Y = zenithY * perez(perezY, cosTheta, gamma) / perez(perezY, 1.0f, sunZenith);
+        float x = zenithX * perez(perezX, cosTheta, gamma) / perez(perezX, 1.0f, sunZenith);
+        float y = zenithYc * perez(perezYc, cosTheta, gamma) / perez(perezYc, 1.0f, sunZenith);
+
+        // xyY -> XYZ -> linear sRGB
+        float X = y > 0.0f ? x / y * Y : 0.0f;
+        float Z = y > 0.0f ? (1.0f - x - y) / y * Y : 0.0f;
+        float linear[3] = {
+            3.2406f * X - 1.5372f * Y - 0.4986f * Z,
+            -0.9689f * X + 1.8758f * Y + 0.0415f * Z,
+            0.0557f * X - 0.2040f * Y + 1.0570f * Z
+        };
+        for (int c = 0; c < 3; c++) {
+            float v = linear[c] > 0.0f ? linear[c] : 0.0f;
+            day[c] = powf(1.0f - expf(-v * SKY_EXPOSURE), 1.0f / 2.2f) * shade;
+        }
+    }
+
+    for (int c = 0; c < 3; c++) {
+        rgb[c] = night[c] + (day[c] - night[c]) * dayFactor;
+    }
+}
+
+void AnalyticSky::update(const Vector3f& sunDirection) {
+    if (valid && fabsf(sunDirection.x - sun.x) < SUN_EPSILON && fabsf(sunDirection.y - sun.y) < SUN_EPSILON &&
+        fabsf(sunDirection.z - sun.z) < SUN_EPSILON) {
+        return;
+    }
+    sun = sunDirection;
+    computeCoefficients();
+
+    int count = getVertexCount();
+    for (int i = 0; i < count; i++) {
+        float rgb[3];
+        evaluate(Vector3f(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]), rgb);
+        for (int c = 0; c < 3; c++) {
+            float v = rgb[c] < 0.0f ? 0.0f : (rgb[c] > 1.0f ? 1.0f : rgb[c]);
+            colors[i * 4 + c] = (unsigned char)(v * 255.0f + 0.5f);
+        }
+    }
+    valid = true;
+}
+
+void AnalyticSky::draw() {
+    if (!valid) {
+        update(Vector3f(0.0f, 1.0f, 0.0f));
+    }
+
+    GLState::disable(GL_TEXTURE_2D);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, 0, &positions[0]);
+    glColorPointer(4, GL_UNSIGNED_BYTE, 0, &colors[0]);
+    glDrawElements(GL_TRIANGLES, (GLsizei)indices.size(), GL_UNSIGNED_SHORT, &indices[0]);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
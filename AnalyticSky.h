@@ -0,0 +1,51 @@
+#pragma once
+#include "Vector3f.h"
+#include <vector>
+
+// Analytic Sky - Preetham daylight model on a coarse dome
+// The textured sky keeps four full-resolution skyboxes around and can only
+// cross-fade between them, so the time of day jumps in four steps. This
+// evaluates the Preetham/Perez clear-sky model for the current sun
+// direction instead: luminance and chromaticity per dome vertex, tone
+// mapped, fading into a night gradient once the sun is below the horizon.
+// There are no shaders in this renderer, so the model is evaluated per
+// vertex on the CPU; the sky is smooth enough that a 48x24 dome holds it,
+// and the colors are only recomputed when the sun has actually moved.
+class AnalyticSky {
+public:
+    AnalyticSky();
+
+    // Atmospheric haziness: 2 = very clear, 10 = hazy
+    void setTurbidity(float value);
+    float getTurbidity() const { return turbidity; }
+
+    // Recompute the dome colors for this sun direction (world space, +Y up)
+    void update(const Vector3f& sunDirection);
+
+    // Unit dome in world orientation around the origin; untextured and unlit
+    void draw();
+
+    // Tone-mapped sky color in a world direction for the last update()
+    void evaluate(const Vector3f& direction, float rgb[3]) const;
+
+    int getVertexCount() const { return (int)positions.size() / 3; }
+
+private:
+    float turbidity;
+    Vector3f sun;
+    bool valid;
+
+    // Perez coefficients (A..E) and zenith values for Y, x, y at the current sun
+    float perezY[5], perezX[5], perezYc[5];
+    float zenithY, zenithX, zenithYc;
+    float sunZenith;
+    float dayFactor;    // 1 in daylight, 0 at full night
+
+    std::vector<float> positions;
+    std::vector<unsigned char> colors;
+    std::vector<unsigned short> indices;
+
+    void buildDome();
+    void computeCoefficients();
+    static float perez(const float coeffs[5], float cosTheta, float gamma);
+};
@@ -0,0 +1,147 @@
+#include "BillboardBatch.h"
+#include "glew.h"
+#include <math.h>
+#include <cstddef>
+#include <algorithm>
+
+BillboardBatch::BillboardBatch(float size) : chunkSize(size), vbo(0), vertexCount(0), built(false) {
+}
+
+BillboardBatch::~BillboardBatch() {
+    // Buffers are released explicitly (level cleanup) while the GL context is alive
+}
+
+BillboardBatch::Chunk& BillboardBatch::chunkAt(float x, float z) {
+    int cellX = (int)floorf(x / chunkSize);
+    int cellZ = (int)floorf(z / chunkSize);
+    for (Chunk& chunk : chunks) {
+        if (chunk.cellX == cellX && chunk.cellZ == cellZ) {
+            return chunk;
+        }
+    }
+    Chunk chunk;
+    chunk.cellX = cellX;
+    chunk.cellZ = cellZ;
+    chunk.minX = chunk.maxX = x;
+    chunk.minZ = chunk.maxZ = z;
+    chunk.first = 0;
+    chunk.count = 0;
+    chunks.push_back(chunk);
+    return chunks.back();
+}
+
+void BillboardBatch::addCross(const Vector3f& position, float width, float height, float rotation,
+                              const SpriteRect& sprite) {
+    Chunk& chunk = chunkAt(position.x, position.z);
+    float halfSize = width * 0.5f;
+
+    for (int q = 0; q < 2; q++) {
+        float angle = (rotation + q * 90.0f) * 3.14159f / 180.0f;
+        float ax = cosf(angle) * halfSize;
+        float az = -sinf(angle) * halfSize;
+
+        const Vertex corners[4] = {
+            { { position.x - ax, position.y, position.z - az }, { sprite.u0, sprite.v1 } },
+            { { position.x + ax, position.y, position.z + az }, { sprite.u1, sprite.v1 } },
+            { { position.x + ax, position.y + height, position.z + az }, { sprite.u1, sprite.v0 } },
+            { { position.x - ax, position.y + height, position.z - az }, { sprite.u0, sprite.v0 } }
+        };
+        for (const Vertex& v : corners) {
+            chunk.vertices.push_back(v);
+            chunk.minX = std::min(chunk.minX, v.position[0]);
+            chunk.maxX = std::max(chunk.maxX, v.position[0]);
+            chunk.minZ = std::min(chunk.minZ, v.position[2]);
+            chunk.maxZ = std::max(chunk.maxZ, v.position[2]);
+        }
+    }
+}
+
+void BillboardBatch::build() {
+    // Row by row, so neighbouring visible chunks merge into one draw
+    std::sort(chunks.begin(), chunks.end(), [](const Chunk& a, const Chunk& b) {
+        return a.cellZ != b.cellZ ? a.cellZ < b.cellZ : a.cellX < b.cellX;
+    });
+
+    packed.clear();
+    for (Chunk& chunk : chunks) {
+        chunk.first = (int)packed.size();
+        chunk.count = (int)chunk.vertices.size();
+        packed.insert(packed.end(), chunk.vertices.begin(), chunk.vertices.end());
+        std::vector<Vertex>().swap(chunk.vertices);
+    }
+    vertexCount = (int)packed.size();
+    built = true;
+
+    if (packed.empty()) {
+        return;
+    }
+    if ((GLEW_VERSION_1_5 || GLEW_ARB_vertex_buffer_object) && glGenBuffers != NULL) {
+        glGenBuffers(1, &vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, packed.size() * sizeof(Vertex), &packed[0], GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        std::vector<Vertex>().swap(packed);
+    }
+}
+
+int BillboardBatch::draw(const Vector3f& eye, float maxDistance) const {
+    if (!built || vertexCount == 0) {
+        return 0;
+    }
+
+    const char* base = NULL;
+    if (vbo != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    } else {
+        base = (const char*)&packed[0];
+    }
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, position));
+    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, texCoord));
+
+    // Squared distance from the eye to each chunk's bounds; runs of visible
+    // chunks are contiguous in the buffer and go out as one call
+    float maxDistanceSq = maxDistance * maxDistance;
+    int drawn = 0;
+    int runFirst = 0;
+    int runCount = 0;
+    for (const Chunk& chunk : chunks) {
+        float dx = std::max(0.0f, std::max(chunk.minX - eye.x, eye.x - chunk.maxX));
+        float dz = std::max(0.0f, std::max(chunk.minZ - eye.z, eye.z - chunk.maxZ));
+        if (chunk.count == 0 || dx * dx + dz * dz > maxDistanceSq) {
+            continue;
+        }
+        drawn++;
+        if (runCount > 0 && runFirst + runCount == chunk.first) {
+            runCount += chunk.count;
+            continue;
+        }
+        if (runCount > 0) {
+            glDrawArrays(GL_QUADS, runFirst, runCount);
+        }
+        runFirst = chunk.first;
+        runCount = chunk.count;
+    }
+    if (runCount > 0) {
+        glDrawArrays(GL_QUADS, runFirst, runCount);
+    }
+
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    if (vbo != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    return drawn;
+}
+
+void BillboardBatch::release() {
+    if (vbo != 0) {
+        glDeleteBuffers(1, &vbo);
+        vbo = 0;
+    }
+    chunks.clear();
+    packed.clear();
+    vertexCount = 0;
+    built = false;
+}
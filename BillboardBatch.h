@@ -0,0 +1,58 @@
+#pragma once
+#include "SpriteAtlas.h"
+#include "Vector3f.h"
+#include <vector>
+
+// Billboard Batch - crossed-quad billboards baked into one buffer by chunk
+// Level2's forest (400+ cardboard trees) was rebuilt through glBegin/glEnd
+// every frame, with a square root per tree for the distance cut. The trees
+// never move, so their quads are now generated once, sorted into square
+// chunks of the ground and uploaded as one vertex buffer with each chunk a
+// contiguous range. draw() tests each chunk's bounds against the view
+// distance and issues one glDrawArrays per run of visible chunks. All the
+// sprites come from one atlas, so the caller binds a single texture.
+class BillboardBatch {
+public:
+    explicit BillboardBatch(float chunkSize = 200.0f);
+    ~BillboardBatch();
+
+    BillboardBatch(const BillboardBatch&) = delete;
+    BillboardBatch& operator=(const BillboardBatch&) = delete;
+
+    // Two upright quads crossed at 90 degrees, base centered at position,
+    // the first one turned by rotation degrees around Y
+    void addCross(const Vector3f& position, float width, float height, float rotation, const SpriteRect& sprite);
+
+    // Sort the billboards into chunks and upload them (needs a GL context)
+    void build();
+    // Draw the chunks that reach within maxDistance of eye (on XZ); the
+    // caller sets texture, blending and alpha test. Returns the chunks drawn.
+    int draw(const Vector3f& eye, float maxDistance) const;
+    void release();
+
+    int getChunkCount() const { return (int)chunks.size(); }
+    int getQuadCount() const { return vertexCount / 4; }
+
+private:
+    struct Vertex {
+        float position[3];
+        float texCoord[2];
+    };
+
+    struct Chunk {
+        int cellX, cellZ;
+        float minX, minZ, maxX, maxZ;   // Bounds of its quads, not just the cell
+        std::vector<Vertex> vertices;   // Until build()
+        int first;
+        int count;
+    };
+
+    float chunkSize;
+    std::vector<Chunk> chunks;
+    std::vector<Vertex> packed;         // Client-side copy when there are no VBOs
+    unsigned int vbo;
+    int vertexCount;
+    bool built;
+
+    Chunk& chunkAt(float x, float z);
+};
@@ -1,10 +1,12 @@
 #include "FlightController.h"
+#include "GLState.h"
 #include <stdio.h>
 #include <iostream>
 #include <cstring>
 
 FlightController::FlightController() {
     modelLoaded = false;  // Model needs to be loaded for this instance
+    terrain = NULL;
     reset();
     // Closer camera as requested
     cameraDist = 15.0f;  // Was 30.0f
@@ -218,18 +220,30 @@ void FlightController::update(float deltaTime) {
     smokeSystem.update(deltaTime);
 }
 
+float FlightController::getGroundHeight() const {
+    return terrain ? terrain->getHeight(player.position.x, player.position.z) : 0.0f;
+}
+
 void FlightController::resolveCollisions(float deltaTime) {
     // Ground check
-    if (player.position.y <= 0.5f) {
-        player.position.y = 0.5f;
+    float groundY = getGroundHeight() + 0.5f;
+    if (player.position.y <= groundY) {
+        player.position.y = groundY;
         
         // Check landing/crash conditions
         if (!isGrounded) {
-            float verticalSpeed = player.velocity.y;
+            // Measured against the ground's normal (straight up on flat
+            // ground), so flying into a hillside is an impact too
+            Vector3f normal = terrain ? terrain->getNormal(player.position.x, player.position.z)
+                                      : Vector3f(0.0f, 1.0f, 0.0f);
+            float verticalSpeed = player.velocity.x * normal.x + player.velocity.y * normal.y +
+                                  player.velocity.z * normal.z;
+            float nosePitch = player.forward.x * normal.x + player.forward.y * normal.y +
+                              player.forward.z * normal.z;
             float speed = getSpeed();
             
             // Hard crash: Falling too fast or hitting ground nose first
-            if (verticalSpeed < -10.0f || (speed > 40.0f && player.forward.y < -0.2f)) {
+            if (verticalSpeed < -10.0f || (speed > 40.0f && nosePitch < -0.2f)) {
                 isCrashed = true;
                 player.throttle = 0;
                 std::cout << "CRASHED! Ground Impact." << std::endl;
@@ -389,12 +403,12 @@ void FlightController::drawPlane(bool showWingLights) {
 }
 
 void FlightController::renderWingLights() {
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    GLState::push(GL_CURRENT_BIT);
     
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);  // Additive blending for glow
+    GLState::disable(GL_TEXTURE_2D);
+    GLState::disable(GL_LIGHTING);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE);  // Additive blending for glow
     
     // Wing light positions (relative to plane center in model space)
     // Note: Model is rotated 90 degrees around X axis, so:
@@ -468,7 +482,7 @@ void FlightController::renderWingLights() {
     glutSolidSphere(0.15f, 8, 8);
     glPopMatrix();
     
-    glPopAttrib();
+    GLState::pop();
 }
 
 void FlightController::loadModel(const char* path) {
@@ -6,6 +6,7 @@
 #include <Vector3f.h>
 #include "Model_3DS.h"
 #include "SmokeSystem.h"
+#include "Terrain.h"
 #include <string>
 
 #define PI 3.14159265359
@@ -58,10 +59,15 @@ public:
     
     // Render smoke particles (call after scene rendering)
     void renderSmoke();
+    
+    // Ground to collide with; without one the ground is flat at zero
+    void setTerrain(const Terrain* ground) { terrain = ground; }
+    float getGroundHeight() const;
 
 private:
     float cameraDist;
     float cameraHeight;
+    const Terrain* terrain;
     
     // Tuned Physics Constants
     const float GRAVITY = 9.8f;
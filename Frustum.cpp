@@ -0,0 +1,95 @@
+#include "Frustum.h"
+#include <math.h>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__)
+#include <xmmintrin.h>
+#define FRUSTUM_SSE 1
+#endif
+
+Frustum::Frustum() : valid(false) {
+    for (int p = 0; p < 6; p++) {
+        planes[p][0] = planes[p][1] = planes[p][2] = planes[p][3] = 0.0f;
+    }
+    for (int i = 0; i < 16; i++) {
+        clip[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+    }
+}
+
+void Frustum::extract(const float* projection, const float* modelview) {
+    // clip = projection * modelview
+    for (int col = 0; col < 4; col++) {
+        for (int row = 0; row < 4; row++) {
+            clip[col * 4 + row] = projection[row] * modelview[col * 4] + projection[4 + row] * modelview[col * 4 + 1] +
+                                  projection[8 + row] * modelview[col * 4 + 2] +
+                                  projection[12 + row] * modelview[col * 4 + 3];
+        }
+    }
+
+    // Row i of the clip matrix is (clip[i], clip[4 + i], clip[8 + i], clip[12 + i]);
+    // the planes are row 3 plus/minus rows 0 (left/right), 1 (bottom/top), 2 (near/far)
+    for (int p = 0; p < 6; p++) {
+        int row = p / 2;
+        float sign = (p % 2 == 0) ? 1.0f : -1.0f;
+        for (int k = 0; k < 4; k++) {
+            planes[p][k] = clip[k * 4 + 3] + sign * clip[k * 4 + row];
+        }
+        float length = sqrtf(planes[p][0] * planes[p][0] + planes[p][1] * planes[p][1] + planes[p][2] * planes[p][2]);
+        if (length > 0.0f) {
+            for (int k = 0; k < 4; k++) {
+                planes[p][k] /= length;
+            }
+        }
+    }
+    valid = true;
+}
+
+bool Frustum::testSphere(float x, float y, float z, float radius) const {
+    if (!valid) {
+        return true;
+    }
+    for (int p = 0; p < 6; p++) {
+        if (planes[p][0] * x + planes[p][1] * y + planes[p][2] * z + planes[p][3] < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Frustum::testSpheres(const float* x, const float* y, const float* z, const float* radius, int count,
+                          unsigned char* visible) const {
+    int i = 0;
+    if (!valid) {
+        for (; i < count; i++) {
+            visible[i] = 1;
+        }
+        return;
+    }
+
+#ifdef FRUSTUM_SSE
+    __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        __m128 px = _mm_loadu_ps(x + i);
+        __m128 py = _mm_loadu_ps(y + i);
+        __m128 pz = _mm_loadu_ps(z + i);
+        __m128 pr = _mm_loadu_ps(radius + i);
+        __m128 inside = _mm_cmpeq_ps(zero, zero);
+        for (int p = 0; p < 6; p++) {
+            // a*x + b*y + c*z + d + r >= 0 for every plane
+            __m128 distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[p][0]), px),
+                                         _mm_mul_ps(_mm_set1_ps(planes[p][1]), py));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes[p][2]), pz));
+            distance = _mm_add_ps(distance, _mm_add_ps(_mm_set1_ps(planes[p][3]), pr));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, zero));
+        }
+        int mask = _mm_movemask_ps(inside);
+        visible[i] = (unsigned char)(mask & 1);
+        visible[i + 1] = (unsigned char)((mask >> 1) & 1);
+        visible[i + 2] = (unsigned char)((mask >> 2) & 1);
+        visible[i + 3] = (unsigned char)((mask >> 3) & 1);
+    }
+#endif
+
+    for (; i < count; i++) {
+        visible[i] = testSphere(x[i], y[i], z[i], radius[i]) ? 1 : 0;
+    }
+}
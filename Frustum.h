@@ -0,0 +1,28 @@
+#pragma once
+
+// Frustum - view volume planes and batched bounding-sphere tests
+// Planes are extracted from projection * modelview (Gribb & Hartmann), so
+// with the camera's modelview they are in world space. testSpheres takes
+// the spheres as separate x/y/z/radius arrays and tests four at a time
+// with SSE where the compiler targets it, plain loops otherwise.
+class Frustum {
+public:
+    Frustum();
+
+    // Column-major matrices as glGetFloatv returns them
+    void extract(const float* projection, const float* modelview);
+    void invalidate() { valid = false; }
+    bool isValid() const { return valid; }
+    // projection * modelview from the last extract(), column-major
+    const float* getClipMatrix() const { return clip; }
+
+    bool testSphere(float x, float y, float z, float radius) const;
+    // visible[i] = 1 if sphere i touches the frustum, else 0
+    void testSpheres(const float* x, const float* y, const float* z, const float* radius, int count,
+                     unsigned char* visible) const;
+
+private:
+    float planes[6][4];     // a, b, c, d with unit normals pointing inwards
+    float clip[16];
+    bool valid;
+};
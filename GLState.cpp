@@ -0,0 +1,358 @@
+#include "GLState.h"
+#include "glew.h"
+#include <cstdio>
+
+// Slot layout: the tracked enable bits, then single values, then 8 parameters per light
+static const GLenum TRACKED_CAPS[] = {
+    GL_TEXTURE_2D, GL_LIGHTING, GL_DEPTH_TEST, GL_BLEND, GL_ALPHA_TEST, GL_CULL_FACE, GL_FOG,
+    GL_COLOR_MATERIAL, GL_NORMALIZE, GL_POLYGON_OFFSET_FILL, GL_STENCIL_TEST, GL_SCISSOR_TEST,
+    GL_LIGHT0, GL_LIGHT1, GL_LIGHT2, GL_LIGHT3, GL_LIGHT4, GL_LIGHT5, GL_LIGHT6, GL_LIGHT7
+};
+static const int CAP_COUNT = sizeof(TRACKED_CAPS) / sizeof(TRACKED_CAPS[0]);
+
+enum {
+    SLOT_TEXTURE = CAP_COUNT,
+    SLOT_BLEND_FUNC,
+    SLOT_DEPTH_MASK,
+    SLOT_DEPTH_FUNC,
+    SLOT_ALPHA_FUNC,
+    SLOT_LINE_WIDTH,
+    SLOT_POINT_SIZE,
+    SLOT_POLYGON_OFFSET,
+    SLOT_LIGHTS
+};
+
+static const GLenum LIGHT_PARAMS[] = {
+    GL_AMBIENT, GL_DIFFUSE, GL_SPECULAR, GL_CONSTANT_ATTENUATION, GL_LINEAR_ATTENUATION,
+    GL_QUADRATIC_ATTENUATION, GL_SPOT_CUTOFF, GL_SPOT_EXPONENT
+};
+static const int LIGHT_PARAM_COUNT = sizeof(LIGHT_PARAMS) / sizeof(LIGHT_PARAMS[0]);
+static const int LIGHT_COUNT = 8;
+static const int SLOT_COUNT = SLOT_LIGHTS + LIGHT_COUNT * LIGHT_PARAM_COUNT;
+
+GLState::Slot GLState::slots[SLOT_COUNT];
+std::vector<GLState::Saved> GLState::journal;
+std::vector<GLState::Frame> GLState::frames;
+int GLState::issued = 0;
+int GLState::filtered = 0;
+
+int GLState::capSlot(unsigned int cap) {
+    for (int i = 0; i < CAP_COUNT; i++) {
+        if (TRACKED_CAPS[i] == cap) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int GLState::lightSlot(unsigned int light, unsigned int pname) {
+    if (light < GL_LIGHT0 || light >= GL_LIGHT0 + LIGHT_COUNT) {
+        return -1;
+    }
+    for (int i = 0; i < LIGHT_PARAM_COUNT; i++) {
+        if (LIGHT_PARAMS[i] == pname) {
+            return SLOT_LIGHTS + (light - GL_LIGHT0) * LIGHT_PARAM_COUNT + i;
+        }
+    }
+    return -1;
+}
+
+int GLState::slotSize(int slot) {
+    switch (slot) {
+    case SLOT_BLEND_FUNC:
+    case SLOT_ALPHA_FUNC:
+    case SLOT_POLYGON_OFFSET:
+        return 2;
+    default:
+        break;
+    }
+    if (slot >= SLOT_LIGHTS) {
+        // Ambient, diffuse and specular are colors, the rest scalars
+        return (slot - SLOT_LIGHTS) % LIGHT_PARAM_COUNT < 3 ? 4 : 1;
+    }
+    return 1;
+}
+
+void GLState::issue(int slot) {
+    const float* v = slots[slot].value;
+    issued++;
+    if (slot < CAP_COUNT) {
+        if (v[0] != 0.0f) {
+            glEnable(TRACKED_CAPS[slot]);
+        } else {
+            glDisable(TRACKED_CAPS[slot]);
+        }
+        return;
+    }
+    switch (slot) {
+    case SLOT_TEXTURE:          glBindTexture(GL_TEXTURE_2D, (GLuint)v[0]); return;
+    case SLOT_BLEND_FUNC:       glBlendFunc((GLenum)v[0], (GLenum)v[1]); return;
+    case SLOT_DEPTH_MASK:       glDepthMask(v[0] != 0.0f ? GL_TRUE : GL_FALSE); return;
+    case SLOT_DEPTH_FUNC:       glDepthFunc((GLenum)v[0]); return;
+    case SLOT_ALPHA_FUNC:       glAlphaFunc((GLenum)v[0], v[1]); return;
+    case SLOT_LINE_WIDTH:       glLineWidth(v[0]); return;
+    case SLOT_POINT_SIZE:       glPointSize(v[0]); return;
+    case SLOT_POLYGON_OFFSET:   glPolygonOffset(v[0], v[1]); return;
+    default:
+        break;
+    }
+    GLenum light = GL_LIGHT0 + (slot - SLOT_LIGHTS) / LIGHT_PARAM_COUNT;
+    GLenum pname = LIGHT_PARAMS[(slot - SLOT_LIGHTS) % LIGHT_PARAM_COUNT];
+    if (slotSize(slot) == 4) {
+        glLightfv(light, pname, v);
+    } else {
+        glLightf(light, pname, v[0]);
+    }
+}
+
+void GLState::query(int slot, float* value) {
+    GLint ints[2] = { 0, 0 };
+    GLboolean flag = GL_FALSE;
+    if (slot < CAP_COUNT) {
+        value[0] = glIsEnabled(TRACKED_CAPS[slot]) ? 1.0f : 0.0f;
+        return;
+    }
+    switch (slot) {
+    case SLOT_TEXTURE:
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, ints);
+        value[0] = (float)ints[0];
+        return;
+    case SLOT_BLEND_FUNC:
+        glGetIntegerv(GL_BLEND_SRC, &ints[0]);
+        glGetIntegerv(GL_BLEND_DST, &ints[1]);
+        value[0] = (float)ints[0];
+        value[1] = (float)ints[1];
+        return;
+    case SLOT_DEPTH_MASK:
+        glGetBooleanv(GL_DEPTH_WRITEMASK, &flag);
+        value[0] = flag ? 1.0f : 0.0f;
+        return;
+    case SLOT_DEPTH_FUNC:
+        glGetIntegerv(GL_DEPTH_FUNC, ints);
+        value[0] = (float)ints[0];
+        return;
+    case SLOT_ALPHA_FUNC:
+        glGetIntegerv(GL_ALPHA_TEST_FUNC, ints);
+        value[0] = (float)ints[0];
+        glGetFloatv(GL_ALPHA_TEST_REF, &value[1]);
+        return;
+    case SLOT_LINE_WIDTH:
+        glGetFloatv(GL_LINE_WIDTH, value);
+        return;
+    case SLOT_POINT_SIZE:
+        glGetFloatv(GL_POINT_SIZE, value);
+        return;
+    case SLOT_POLYGON_OFFSET:
+        glGetFloatv(GL_POLYGON_OFFSET_FACTOR, &value[0]);
+        glGetFloatv(GL_POLYGON_OFFSET_UNITS, &value[1]);
+        return;
+    default:
+        break;
+    }
+    GLenum light = GL_LIGHT0 + (slot - SLOT_LIGHTS) / LIGHT_PARAM_COUNT;
+    glGetLightfv(light, LIGHT_PARAMS[(slot - SLOT_LIGHTS) % LIGHT_PARAM_COUNT], value);
+}
+
+void GLState::set(int slot, const float* value) {
+    Slot& current = slots[slot];
+    int size = slotSize(slot);
+    int depth = (int)frames.size();
+
+    // Inside a push() the old value is needed for pop(), so fetch it now
+    if (!current.known && depth > 0) {
+        query(slot, current.value);
+        current.known = true;
+    }
+    if (current.known) {
+        bool same = true;
+        for (int i = 0; i < size; i++) {
+            if (current.value[i] != value[i]) {
+                same = false;
+                break;
+            }
+        }
+        if (same) {
+            filtered++;
+            return;
+        }
+    }
+
+    if (depth > 0 && current.savedBy != depth) {
+        Saved saved;
+        saved.slot = slot;
+        for (int i = 0; i < 4; i++) {
+            saved.value[i] = current.value[i];
+        }
+        saved.previousSavedBy = current.savedBy;
+        journal.push_back(saved);
+        current.savedBy = depth;
+    }
+    for (int i = 0; i < size; i++) {
+        current.value[i] = value[i];
+    }
+    current.known = true;
+    issue(slot);
+}
+
+void GLState::enable(unsigned int cap) {
+    setEnabled(cap, true);
+}
+
+void GLState::disable(unsigned int cap) {
+    setEnabled(cap, false);
+}
+
+void GLState::setEnabled(unsigned int cap, bool enabled) {
+    int slot = capSlot(cap);
+    if (slot < 0) {
+        if (enabled) {
+            glEnable(cap);
+        } else {
+            glDisable(cap);
+        }
+        issued++;
+        return;
+    }
+    float value = enabled ? 1.0f : 0.0f;
+    set(slot, &value);
+}
+
+bool GLState::isEnabled(unsigned int cap) {
+    int slot = capSlot(cap);
+    if (slot < 0) {
+        return glIsEnabled(cap) == GL_TRUE;
+    }
+    if (!slots[slot].known) {
+        query(slot, slots[slot].value);
+        slots[slot].known = true;
+    }
+    return slots[slot].value[0] != 0.0f;
+}
+
+void GLState::bindTexture(unsigned int texture) {
+    float value = (float)texture;
+    set(SLOT_TEXTURE, &value);
+}
+
+void GLState::deleteTextures(int count, const unsigned int* textures) {
+    glDeleteTextures(count, textures);
+    // GL falls back to texture 0 when the bound texture is deleted, and a
+    // saved binding must not bring a deleted name back on pop()
+    for (int i = 0; i < count; i++) {
+        float name = (float)textures[i];
+        if (slots[SLOT_TEXTURE].value[0] == name) {
+            slots[SLOT_TEXTURE].value[0] = 0.0f;
+        }
+        for (Saved& saved : journal) {
+            if (saved.slot == SLOT_TEXTURE && saved.value[0] == name) {
+                saved.value[0] = 0.0f;
+            }
+        }
+    }
+}
+
+void GLState::blendFunc(unsigned int source, unsigned int destination) {
+    float value[2] = { (float)source, (float)destination };
+    set(SLOT_BLEND_FUNC, value);
+}
+
+void GLState::depthMask(bool write) {
+    float value = write ? 1.0f : 0.0f;
+    set(SLOT_DEPTH_MASK, &value);
+}
+
+void GLState::depthFunc(unsigned int func) {
+    float value = (float)func;
+    set(SLOT_DEPTH_FUNC, &value);
+}
+
+void GLState::alphaFunc(unsigned int func, float reference) {
+    float value[2] = { (float)func, reference };
+    set(SLOT_ALPHA_FUNC, value);
+}
+
+void GLState::lineWidth(float width) {
+    set(SLOT_LINE_WIDTH, &width);
+}
+
+void GLState::pointSize(float size) {
+    set(SLOT_POINT_SIZE, &size);
+}
+
+void GLState::polygonOffset(float factor, float units) {
+    float value[2] = { factor, units };
+    set(SLOT_POLYGON_OFFSET, value);
+}
+
+void GLState::lightfv(unsigned int light, unsigned int pname, const float* values) {
+    int slot = lightSlot(light, pname);
+    if (slot < 0) {
+        glLightfv(light, pname, values);
+        issued++;
+        return;
+    }
+    set(slot, values);
+}
+
+void GLState::lightf(unsigned int light, unsigned int pname, float value) {
+    int slot = lightSlot(light, pname);
+    if (slot < 0 || slotSize(slot) != 1) {
+        glLightf(light, pname, value);
+        issued++;
+        return;
+    }
+    set(slot, &value);
+}
+
+void GLState::push(unsigned int attribBits) {
+    Frame frame;
+    frame.attribBits = attribBits;
+    frame.journalSize = journal.size();
+    frames.push_back(frame);
+    if (attribBits != 0) {
+        glPushAttrib(attribBits);
+    }
+}
+
+void GLState::pop() {
+    if (frames.empty()) {
+        printf("GLState: pop() without push()\n");
+        return;
+    }
+    Frame frame = frames.back();
+
+    // Newest first, so a slot saved twice ends up at its oldest value
+    while (journal.size() > frame.journalSize) {
+        const Saved& saved = journal.back();
+        Slot& current = slots[saved.slot];
+        int size = slotSize(saved.slot);
+        bool same = current.known;
+        for (int i = 0; i < size && same; i++) {
+            same = current.value[i] == saved.value[i];
+        }
+        if (!same) {
+            for (int i = 0; i < size; i++) {
+                current.value[i] = saved.value[i];
+            }
+            current.known = true;
+            issue(saved.slot);
+        }
+        current.savedBy = saved.previousSavedBy;
+        journal.pop_back();
+    }
+
+    if (frame.attribBits != 0) {
+        glPopAttrib();
+    }
+    frames.pop_back();
+}
+
+void GLState::invalidate() {
+    for (int i = 0; i < SLOT_COUNT; i++) {
+        slots[i].known = false;
+    }
+}
+
+void GLState::printStats(const char* label) {
+    printf("GL state %s: %d calls issued, %d redundant calls dropped\n", label, issued, filtered);
+}
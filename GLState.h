@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// GL State - shadow copy of the fixed-function state the game changes
+// Every frame re-issued dozens of glEnable/glLight calls with the values
+// already set, and about twenty draw functions saved and restored the whole
+// attribute stack (glPushAttrib(GL_ALL_ATTRIB_BITS)) to undo a blend mode
+// and a few enables. State now goes through these wrappers, which remember
+// the last value of each enable bit, the texture bound on unit 0, blend,
+// depth and alpha test functions, line width, point size, polygon offset
+// and the light colors/attenuation, and drop calls that change nothing.
+// push()/pop() replace the attribute stack: pop() puts back only the
+// tracked values that were changed since the matching push(), plus any
+// untracked attribute groups the caller names (usually GL_CURRENT_BIT).
+//
+// The shadow copy is only right if nothing changes tracked state behind its
+// back: use these instead of the raw calls, and call invalidate() after code
+// that can't (glPopAttrib, other texture units, foreign libraries).
+class GLState {
+public:
+    static void enable(unsigned int cap);
+    static void disable(unsigned int cap);
+    static void setEnabled(unsigned int cap, bool enabled);
+    static bool isEnabled(unsigned int cap);
+
+    // GL_TEXTURE_2D on the active unit, which must be unit 0
+    static void bindTexture(unsigned int texture);
+    // glDeleteTextures, forgetting the binding if it was one of them
+    static void deleteTextures(int count, const unsigned int* textures);
+
+    static void blendFunc(unsigned int source, unsigned int destination);
+    static void depthMask(bool write);
+    static void depthFunc(unsigned int func);
+    static void alphaFunc(unsigned int func, float reference);
+    static void lineWidth(float width);
+    static void pointSize(float size);
+    static void polygonOffset(float factor, float units);
+
+    // Colors and attenuation are filtered; GL_POSITION and GL_SPOT_DIRECTION
+    // depend on the modelview at the time of the call and always go through
+    static void lightfv(unsigned int light, unsigned int pname, const float* values);
+    static void lightf(unsigned int light, unsigned int pname, float value);
+
+    // Save point: pop() restores what was changed through GLState since, and
+    // glPushAttrib/glPopAttrib the given groups (none of the tracked ones)
+    static void push(unsigned int attribBits = 0);
+    static void pop();
+
+    // Forget everything; the next call of each kind goes to GL
+    static void invalidate();
+
+    // Calls sent to GL and calls dropped as no-ops, since resetCounts()
+    static int getIssuedCount() { return issued; }
+    static int getFilteredCount() { return filtered; }
+    static void resetCounts() { issued = filtered = 0; }
+    static void printStats(const char* label);
+
+private:
+    struct Slot {
+        bool known;
+        float value[4];
+        int savedBy;        // Depth of the innermost push() that saved this slot, 0 if none
+    };
+    struct Saved {
+        int slot;
+        float value[4];
+        int previousSavedBy;
+    };
+    struct Frame {
+        unsigned int attribBits;
+        size_t journalSize;
+    };
+
+    static Slot slots[];
+    static std::vector<Saved> journal;
+    static std::vector<Frame> frames;
+    static int issued;
+    static int filtered;
+
+    static int capSlot(unsigned int cap);
+    static int lightSlot(unsigned int light, unsigned int pname);
+    static int slotSize(int slot);
+    // Store the value and send it, unless it is already current
+    static void set(int slot, const float* value);
+    static void issue(int slot);
+    static void query(int slot, float* value);
+};
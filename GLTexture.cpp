@@ -35,10 +35,13 @@
 //////////////////////////////////////////////////////////////////////
 
 #include "GLTexture.h"
+#include "TextureManager.h"
+#include "GLState.h"
 
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <vector>
 
 
 //////////////////////////////////////////////////////////////////////
@@ -72,6 +75,8 @@ void GLTexture::Load(char *name)
 		LoadBMP(texturename);
 	if(strstr(texturename, ".tga"))	
 		LoadTGA(texturename);
+	if(strstr(texturename, ".png"))
+		LoadPNG(texturename);
 }
 
 void GLTexture::LoadFromResource(char *name)
@@ -88,371 +93,96 @@ void GLTexture::LoadFromResource(char *name)
 
 void GLTexture::Use()
 {
-	glEnable(GL_TEXTURE_2D);								// Enable texture mapping
-	glBindTexture(GL_TEXTURE_2D, texture[0]);				// Bind the texture as the current one
+	GLState::enable(GL_TEXTURE_2D);								// Enable texture mapping
+	GLState::bindTexture(texture[0]);				// Bind the texture as the current one
 }
 
 void GLTexture::LoadBMP(char *name)
 {
-    FILE *file;
-    unsigned char header[54];
-    unsigned int dataPos;
-    unsigned int imageSize;
-    unsigned char *data;
-
-    // Open the file
-    file = fopen(name, "rb");
-    if (!file) return;
-
-    // Read the header, i.e. the 54 first bytes
-    if (fread(header, 1, 54, file) != 54) {
-        fclose(file);
-        return;
-    }
-
-    // A BMP file begins with "BM"
-    if (header[0] != 'B' || header[1] != 'M') {
-        fclose(file);
-        return;
-    }
-
-    // Read ints from the byte array
-    dataPos    = *(int*)&(header[0x0A]);
-    imageSize  = *(int*)&(header[0x22]);
-    width      = *(int*)&(header[0x12]);
-    height     = *(int*)&(header[0x16]);
-    
-    // Handle potential negative height (top-down BMP)
-    if (height < 0) height = -height;
-
-    // Some BMP files are misformatted, guess missing information
-    // Calculate proper size including padding for 24-bit BMP (rows aligned to 4 bytes)
-    int rowSize = (width * 3 + 3) & (~3);
-    int calculatedSize = rowSize * height;
-    
-    if (imageSize == 0) imageSize = calculatedSize;
-    
-    // Safety check
-    if (imageSize == 0) {
-        fclose(file);
-        return;
-    }
-
-    // Create a buffer
-    data = new unsigned char[imageSize];
-    if (!data) {
-        fclose(file);
-        return;
-    }
-
-    // Read the actual data from the file into the buffer
-    fseek(file, dataPos, SEEK_SET);
-    size_t bytesRead = fread(data, 1, imageSize, file);
-
-    // Everything is in memory now, the file can be closed
-    fclose(file);
-    
-    // Check if we read enough data
-    if (bytesRead < (size_t)(width * height * 3)) {
-        delete[] data;
-        return;
-    }
-    
-    // BGR -> RGB
-    // BMP stores data as BGR, OpenGL expects RGB
-    // Use the actual width*height*3 for the loop to avoid going out of bounds
-    unsigned int actualSize = width * height * 3;
-    for (unsigned int i = 0; i + 2 < actualSize && i + 2 < imageSize; i += 3) {
-        unsigned char temp = data[i];
-        data[i] = data[i+2];
-        data[i+2] = temp;
-    }
-
-    // Generate the OpenGL texture id
-    glGenTextures(1, &texture[0]);
-
-    // Bind this texture to its id
-    glBindTexture(GL_TEXTURE_2D, texture[0]);
-
-    // Use mipmapping filter
-    glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR_MIPMAP_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
-
-    // Generate the mipmaps
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);  // Use 1-byte alignment for safety
-    gluBuild2DMipmaps(GL_TEXTURE_2D, 3, width, height, GL_RGB, GL_UNSIGNED_BYTE, data);
+    // Decoding and uploading is done by the TextureManager, so every model
+    // that uses the same bitmap shares one GL texture. The 3DS texture
+    // coordinates expect the BMP's bottom-up row order.
+    TextureManager& textures = TextureManager::getInstance();
+    texture[0] = textures.acquire(name, TEX_FLIP_VERTICAL | TEX_NEAREST_MIPMAP);
+    if (texture[0] != 0)
+        textures.getSize(texture[0], width, height);
+}
 
-    // Cleanup
-    delete[] data;
+void GLTexture::LoadPNG(char *name)
+{
+    // The TextureManager decodes PNGs too; same row order as LoadBMP
+    LoadBMP(name);
 }
 
 void GLTexture::LoadTGA(char *name)
 {
-	GLubyte		TGAheader[12]	= {0,0,2,0,0,0,0,0,0,0,0,0};// Uncompressed TGA header
-	GLubyte		TGAcompare[12];								// Used to compare TGA header
-	GLubyte		header[6];									// First 6 useful bytes of the header
-	GLuint		bytesPerPixel;								// Holds the number of bytes per pixel used
-	GLuint		imageSize;									// Used to store the image size
-	GLuint		temp;										// Temporary variable
-	GLuint		type			= GL_RGBA;					// Set the default type to RBGA (32 BPP)
-	GLubyte		*imageData;									// Image data (up to 32 Bits)
-	GLuint		bpp;										// Image color depth in bits per pixel.
-
-	FILE *file = fopen(name, "rb");							// Open the TGA file
-
-	// Load the file and perform checks
-	if(file == NULL ||														// Does file exist?
-	   fread(TGAcompare,1,sizeof(TGAcompare),file) != sizeof(TGAcompare) ||	// Are there 12 bytes to read?
-	   memcmp(TGAheader,TGAcompare,sizeof(TGAheader)) != 0				 ||	// Is it the right format?
-	   fread(header,1,sizeof(header),file) != sizeof(header))				// If so then read the next 6 header bytes
-	{
-		if (file == NULL)									// If the file didn't exist then return
-			return;
-		else
-		{
-			fclose(file);									// If something broke then close the file and return
-			return;
-		}
-	}
-
-	// Determine the TGA width and height (highbyte*256+lowbyte)
-	width  = header[1] * 256 + header[0];
-	height = header[3] * 256 + header[2];
-    
-	// Check to make sure the targa is valid and is 24 bit or 32 bit
-	if(width	<=0	||										// Is the width less than or equal to zero
-	   height	<=0	||										// Is the height less than or equal to zero
-	   (header[4] != 24 && header[4] != 32))				// Is it 24 or 32 bit?
-	{
-		fclose(file);										// If anything didn't check out then close the file and return
-		return;
-	}
-
-	bpp				= header[4];							// Grab the bits per pixel
-	bytesPerPixel	= bpp / 8;								// Divide by 8 to get the bytes per pixel
-	imageSize		= width * height * bytesPerPixel;		// Calculate the memory required for the data
-
-	// Allocate the memory for the image data
-	imageData		= new GLubyte[imageSize];
-
-	// Make sure the data is allocated write and load it
-	if(imageData == NULL ||									// Does the memory storage exist?
-	   fread(imageData, 1, imageSize, file) != imageSize)	// Does the image size match the memory reserved?
-	{
-		if(imageData != NULL)								// Was the image data loaded
-			free(imageData);								// If so, then release the image data
-
-		fclose(file);										// Close the file
-		return;
-	}
-
-	// Loop through the image data and swap the 1st and 3rd bytes (red and blue)
-	for(GLuint i = 0; i < int(imageSize); i += bytesPerPixel)
-	{
-		temp = imageData[i];
-		imageData[i] = imageData[i + 2];
-		imageData[i + 2] = temp;
-	}
-
-	// We are done with the file so close it
-	fclose(file);
-
-	// Set the type
-	if (bpp == 24)
-		type = GL_RGB;
-	
-	// Generate the OpenGL texture id
-	glGenTextures(1, &texture[0]);
-
-	// Bind this texture to its id
-	glBindTexture(GL_TEXTURE_2D, texture[0]);
-
-	// Use mipmapping filter
-	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR_MIPMAP_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
-
-	// Generate the mipmaps
-	gluBuild2DMipmaps(GL_TEXTURE_2D, type, width, height, type, GL_UNSIGNED_BYTE, imageData);
-
-	// Cleanup
-	free(imageData);
+    // The TextureManager decodes uncompressed TGAs too; same row order as LoadBMP
+    LoadBMP(name);
 }
 
 
 void GLTexture::LoadBMPResource(char *name)
 {
-	// Find the bitmap in the bitmap resources
-	HRSRC hrsrc = FindResource(0, name, RT_BITMAP);
-
-	// If you can't find it then return
-	if (hrsrc==0)
-		return;
-
-	// Load the bitmap
-	HGLOBAL resource = LoadResource(0, hrsrc);
-	
-	// If you can't load it then return
-	if (resource==0)
-		return;
-
-	// Load it into the buffer
-	void *buffer = LockResource(resource);
-
-	// Cast it into a bitmap
-	BITMAP *bmp = (BITMAP*)buffer;
-
-	// Get the height and width for future use
-	width = bmp->bmWidth;
-	height = bmp->bmHeight;
-
-	// Reverse the blue colot bit and the red color bit
-	unsigned char *ptr = (unsigned char *)buffer+sizeof(BITMAPINFO)+2;
-	unsigned char temp;
-
-	for (int i = 0; i < width*height; i++)
-	{
-		temp = ptr[i*3];
-		ptr[i*3] = ptr[i*3+2];
-		ptr[i*3+2] = temp;
-	}
-
-	// Generate the OpenGL texture id
-	glGenTextures(1, &texture[0]);
-
-	// Bind this texture to its id
-	glBindTexture(GL_TEXTURE_2D, texture[0]);
-
-	// Use mipmapping filter
-	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR_MIPMAP_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
-
-	// Generate the mipmaps
-	gluBuild2DMipmaps(GL_TEXTURE_2D, 3, width, height, GL_RGB, GL_UNSIGNED_BYTE, (unsigned char *)buffer+sizeof(BITMAPINFO)+2);
-	//gluBuild2DMipmaps(GL_TEXTURE_2D, 3, width, height, GL_RGB, GL_UNSIGNED_BYTE, bmp->bmBits);
+    // Find the bitmap in the bitmap resources
+    HRSRC hrsrc = FindResource(0, name, RT_BITMAP);
+    if (hrsrc == 0)
+        return;
+    HGLOBAL resource = LoadResource(0, hrsrc);
+    if (resource == 0)
+        return;
 
-	// Cleanup
-	free(buffer);
-	free(bmp);
+    // A bitmap resource is a BMP file without its 14-byte file header; put
+    // one back so the TextureManager's decoder (and mip builder) can take it
+    const unsigned char* dib = (const unsigned char*)LockResource(resource);
+    DWORD dibSize = SizeofResource(0, hrsrc);
+    if (dib == NULL || dibSize < sizeof(BITMAPINFOHEADER))
+        return;
+    const BITMAPINFOHEADER* info = (const BITMAPINFOHEADER*)dib;
+    DWORD paletteSize = 0;
+    if (info->biBitCount <= 8)
+        paletteSize = (info->biClrUsed != 0 ? info->biClrUsed : (1u << info->biBitCount)) * 4;
+
+    std::vector<unsigned char> file(14 + dibSize);
+    unsigned int fileSize = (unsigned int)file.size();
+    unsigned int dataOffset = 14 + info->biSize + paletteSize;
+    file[0] = 'B';
+    file[1] = 'M';
+    memcpy(&file[2], &fileSize, 4);
+    memcpy(&file[10], &dataOffset, 4);
+    memcpy(&file[14], dib, dibSize);
+
+    ImageData image;
+    if (!TextureManager::decodeBMP(&file[0], file.size(), TEX_FLIP_VERTICAL, image))
+        return;
+    texture[0] = TextureManager::getInstance().acquireImage(name, image, TEX_FLIP_VERTICAL | TEX_NEAREST_MIPMAP);
+    width = image.width;
+    height = image.height;
 }
 
 void GLTexture::LoadTGAResource(char *name)
 {
-	// struct to cast the resource into
-	struct TGAstruct {
-		GLubyte	TGAcompare[12];								// Used to compare TGA header
-		GLubyte	header[6];									// First 6 useful bytes of the header
-	};
-
-	GLubyte		TGAheader[12]	= {0,0,2,0,0,0,0,0,0,0,0,0};// Uncompressed TGA header
-	GLuint		bytesPerPixel;								// Holds the number of bytes per pixel used
-	GLuint		imageSize;									// Used to store the image size
-	GLuint		temp;										// Temporary variable
-	GLuint		type			= GL_RGBA;					// Set the default type to RBGA (32 BPP)
-	GLubyte		*imageData;									// Image data (up to 32 Bits)
-	GLuint		bpp;										// Image color depth in bits per pixel.
-
-	// Find the targa in the "TGA" resources
-	HRSRC hrsrc = FindResource(0, name, "TGA");
-
-	// If you can't find it then return
-	if (hrsrc==0)
-		return;
-
-	// Load the targa
-	HGLOBAL resource = LoadResource(0, hrsrc);
-
-	// If you can't load it then return
-	if (resource==0)
-		return;
-
-	// Load it into the buffer
-	void *buffer = LockResource(resource);
-
-	// Cast it into the targa struct
-	TGAstruct *top = (TGAstruct*)buffer;
-
-	// Make sure it checks out against our comparison header
-	if (memcmp(TGAheader,top,sizeof(TGAheader)) != 0)
-		return;
-
-	// Determine the TGA width and height (highbyte*256+lowbyte)
-	width  = top->header[1] * 256 + top->header[0];
-	height = top->header[3] * 256 + top->header[2];
-    
-	// Check to make sure the targa is valid and is 24 bit or 32 bit
-	if(width	<=0	||										// Is the width less than or equal to zero
-	   height	<=0	||										// Is the height less than or equal to zero
-	   (top->header[4] != 24 && top->header[4] != 32))		// Is it 24 or 32 bit?
-	{
-		// If anything didn't check out then close the file and return
-		return;
-	}
-
-	bpp				= top->header[4];							// Grab the bits per pixel
-	bytesPerPixel	= bpp / 8;								// Divide by 8 to get the bytes per pixel
-	imageSize		= width * height * bytesPerPixel;		// Calculate the memory required for the data
-
-	// Allocate the memory for the image data
-	imageData		= new GLubyte[imageSize];
-
-	// Load the data in
-	memcpy(imageData, (GLubyte*)buffer+18, imageSize);
-
-	// Loop through the image data and swap the 1st and 3rd bytes (red and blue)
-	for(GLuint i = 0; i < int(imageSize); i += bytesPerPixel)
-	{
-		temp = imageData[i];
-		imageData[i] = imageData[i + 2];
-		imageData[i + 2] = temp;
-	}
-
-	// Set the type
-	if (bpp == 24)
-		type = GL_RGB;
-	
-	// Generate the OpenGL texture id
-	glGenTextures(1, &texture[0]);
-
-	// Bind this texture to its id
-	glBindTexture(GL_TEXTURE_2D, texture[0]);
-
-	// Use mipmapping filter
-	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR_MIPMAP_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
-
-	// Generate the mipmaps
-	gluBuild2DMipmaps(GL_TEXTURE_2D, type, width, height, type, GL_UNSIGNED_BYTE, imageData);
+    // Find the targa in the "TGA" resources
+    HRSRC hrsrc = FindResource(0, name, "TGA");
+    if (hrsrc == 0)
+        return;
+    HGLOBAL resource = LoadResource(0, hrsrc);
+    if (resource == 0)
+        return;
 
-	// Cleanup
-	free(imageData);
-	free(buffer);
-	free(top);
+    const unsigned char* bytes = (const unsigned char*)LockResource(resource);
+    ImageData image;
+    if (bytes == NULL || !TextureManager::decodeTGA(bytes, SizeofResource(0, hrsrc), TEX_FLIP_VERTICAL, image))
+        return;
+    texture[0] = TextureManager::getInstance().acquireImage(name, image, TEX_FLIP_VERTICAL | TEX_NEAREST_MIPMAP);
+    width = image.width;
+    height = image.height;
 }
 
 void GLTexture::BuildColorTexture(unsigned char r, unsigned char g, unsigned char b)
 {
-	unsigned char data[12];	// a 2x2 texture at 24 bits
-
-	// Store the data
-	for(int i = 0; i < 12; i += 3)
-	{
-		data[i] = r;
-		data[i+1] = g;
-		data[i+2] = b;
-	}
-
-	// Generate the OpenGL texture id
-	glGenTextures(1, &texture[0]);
-
-	// Bind this texture to its id
-	glBindTexture(GL_TEXTURE_2D, texture[0]);
-
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-	// Use mipmapping filter
-	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_LINEAR_MIPMAP_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_LINEAR);
-
-	// Generate the texture
-	gluBuild2DMipmaps(GL_TEXTURE_2D, 3, 2, 2, GL_RGB, GL_UNSIGNED_BYTE, data);
+    // Untextured 3DS materials share one 1x1 texture per color
+    TextureManager& textures = TextureManager::getInstance();
+    texture[0] = textures.acquireColor(r, g, b);
+    if (texture[0] != 0)
+        textures.getSize(texture[0], width, height);
 }
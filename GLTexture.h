@@ -58,6 +58,7 @@ public:
 	void LoadFromResource(char *name);				// Load the texture from a resource
 	void LoadTGA(char *name);						// Loads a targa file
 	void LoadBMP(char *name);						// Loads a bitmap file
+	void LoadPNG(char *name);						// Loads a PNG file
 	void Load(char *name);							// Load the texture
 	GLTexture();									// Constructor
 	virtual ~GLTexture();							// Destructor
@@ -1,4 +1,5 @@
 #include "GameManager.h"
+#include "TextureManager.h"
 #include <iostream>
 #include <glut.h>
 
@@ -30,6 +31,18 @@ void GameManager::registerLevel(const std::string& name, Level* level) {
     std::cout << "Level '" << name << "' registered successfully." << std::endl;
 }
 
+void GameManager::initLevel(const std::string& name) {
+    auto it = levels.find(name);
+    if (it == levels.end()) {
+        std::cerr << "Error: Level '" << name << "' not found!" << std::endl;
+        return;
+    }
+
+    // Textures acquired during init belong to this level for residency
+    TextureManager::getInstance().setScope(name);
+    it->second->init();
+}
+
 void GameManager::switchToLevel(const std::string& name) {
     // Check if level exists
     auto it = levels.find(name);
@@ -51,6 +64,9 @@ void GameManager::switchToLevel(const std::string& name) {
     
     std::cout << "Switching to level: " << name << std::endl;
     
+    // Bring the level's evicted textures back, evict other levels' if over budget
+    TextureManager::getInstance().setScope(name);
+    
     // Initialize if not already initialized
     currentLevel->onEnter();
     printf("New level activated: %d\n", currentLevel->isActive());
@@ -14,6 +14,7 @@ public:
     
     // Level management
     void registerLevel(const std::string& name, Level* level);
+    void initLevel(const std::string& name);  // init() with its textures scoped to the level
     void switchToLevel(const std::string& name);
     void unloadLevel(const std::string& name);
     void unloadAllLevels();
@@ -0,0 +1,260 @@
+#include "GrassField.h"
+#include "glew.h"
+#include <math.h>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+// Cell coordinate to ring index, also for negative cells
+static int wrap(int value, int size) {
+    int r = value % size;
+    return r < 0 ? r + size : r;
+}
+
+// Next value of the LCG the old per-frame grass used, scaled to 0..1
+static float nextRandom(unsigned int& seed) {
+    seed = seed * 1103515245 + 12345;
+    return ((seed >> 16) & 0x7FFF) / 32767.0f;
+}
+
+GrassField::GrassField(float size, int radiusCells, int blades)
+    : cellSize(size), radius(radiusCells), ringSize(2 * radiusCells + 1), bladesPerCell(blades),
+      slotVertices(blades * 8), terrain(NULL), vbo(0), allocated(false), multiDraw(false), residentCount(0) {
+    for (int dz = -radius; dz <= radius; dz++) {
+        for (int dx = -radius; dx <= radius; dx++) {
+            if (dx * dx + dz * dz <= radius * radius) {
+                Offset offset = { dx, dz };
+                offsets.push_back(offset);
+            }
+        }
+    }
+    std::sort(offsets.begin(), offsets.end(), [](const Offset& a, const Offset& b) {
+        return a.dx * a.dx + a.dz * a.dz < b.dx * b.dx + b.dz * b.dz;
+    });
+}
+
+GrassField::~GrassField() {
+    // The buffer is released explicitly (level cleanup) while the GL context is alive
+}
+
+void GrassField::addExclusion(float x, float z, float clearRadius) {
+    Exclusion exclusion = { x, z, clearRadius * clearRadius };
+    exclusions.push_back(exclusion);
+}
+
+void GrassField::allocate() {
+    if (allocated) {
+        return;
+    }
+    Slot empty = { 0, 0, 0, 0.0f, 0.0f, false };
+    slots.assign(ringSize * ringSize, empty);
+    size_t totalVertices = slots.size() * slotVertices;
+
+    if ((GLEW_VERSION_1_5 || GLEW_ARB_vertex_buffer_object) && glGenBuffers != NULL) {
+        glGenBuffers(1, &vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, totalVertices * sizeof(Vertex), NULL, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    } else {
+        printf("GrassField: no buffer objects, drawing from client arrays\n");
+        clientVertices.resize(totalVertices);
+    }
+    multiDraw = GLEW_VERSION_1_4 && glMultiDrawArrays != NULL;
+    allocated = true;
+
+    printf("GrassField: %d slots of %d blades, %.0f units out\n", (int)slots.size(), bladesPerCell,
+           radius * cellSize);
+}
+
+GrassField::Slot& GrassField::slotFor(int cellX, int cellZ) {
+    return slots[wrap(cellZ, ringSize) * ringSize + wrap(cellX, ringSize)];
+}
+
+void GrassField::generate(int cellX, int cellZ, Slot& slot) {
+    // Seeded by the cell, so a cell that comes back looks the same
+    unsigned int seed = ((unsigned int)cellX * 73856093u) ^ ((unsigned int)cellZ * 19349663u);
+
+    scratch.clear();
+    slot.minY = 1e9f;
+    slot.maxY = -1e9f;
+    for (int i = 0; i < bladesPerCell; i++) {
+        float x = (cellX + nextRandom(seed)) * cellSize;
+        float z = (cellZ + nextRandom(seed)) * cellSize;
+        float height = 1.5f + nextRandom(seed) * 1.0f;     // Height 1.5-2.5
+        float width = 0.8f + nextRandom(seed) * 0.6f;      // Width 0.8-1.4
+        float angle = nextRandom(seed) * 1.5708f;           // The cross already covers the other quarter
+        float colorVar = 0.8f + ((seed >> 8) & 0xFF) / 255.0f * 0.4f;
+
+        bool excluded = false;
+        for (const Exclusion& exclusion : exclusions) {
+            float dx = x - exclusion.x;
+            float dz = z - exclusion.z;
+            if (dx * dx + dz * dz < exclusion.radiusSq) {
+                excluded = true;
+                break;
+            }
+        }
+        if (excluded) continue;
+        float ground = terrain ? terrain->getHeight(x, z) : 0.0f;
+        slot.minY = std::min(slot.minY, ground);
+        slot.maxY = std::max(slot.maxY, ground);
+
+        unsigned char color[4] = {
+            (unsigned char)(0.3f * colorVar * 255.0f), (unsigned char)(0.6f * colorVar * 255.0f),
+            (unsigned char)(0.2f * colorVar * 255.0f), 255
+        };
+
+        // Two upright quads crossed at 90 degrees
+        float halfWidth = width * 0.5f;
+        for (int q = 0; q < 2; q++) {
+            float ax = cosf(angle + q * 1.5708f) * halfWidth;
+            float az = sinf(angle + q * 1.5708f) * halfWidth;
+            const float corners[4][5] = {
+                { x - ax, ground, z - az, 0.0f, 0.0f },
+                { x + ax, ground, z + az, 1.0f, 0.0f },
+                { x + ax, ground + height, z + az, 1.0f, 1.0f },
+                { x - ax, ground + height, z - az, 0.0f, 1.0f }
+            };
+            for (int c = 0; c < 4; c++) {
+                Vertex vertex;
+                vertex.position[0] = corners[c][0];
+                vertex.position[1] = corners[c][1];
+                vertex.position[2] = corners[c][2];
+                vertex.texCoord[0] = corners[c][3];
+                vertex.texCoord[1] = corners[c][4];
+                memcpy(vertex.color, color, 4);
+                scratch.push_back(vertex);
+            }
+        }
+    }
+
+    size_t slotIndex = &slot - &slots[0];
+    if (!scratch.empty()) {
+        size_t first = slotIndex * slotVertices;
+        if (vbo != 0) {
+            glBindBuffer(GL_ARRAY_BUFFER, vbo);
+            glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(Vertex), scratch.size() * sizeof(Vertex), &scratch[0]);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        } else {
+            std::copy(scratch.begin(), scratch.end(), clientVertices.begin() + first);
+        }
+    }
+
+    if (!slot.resident) {
+        residentCount++;
+    }
+    slot.cellX = cellX;
+    slot.cellZ = cellZ;
+    slot.bladeCount = (int)scratch.size() / 8;
+    slot.resident = true;
+}
+
+void GrassField::update(float x, float z, int maxNewCells) {
+    allocate();
+    int camCellX = (int)floorf(x / cellSize);
+    int camCellZ = (int)floorf(z / cellSize);
+
+    // Without even the player's own cell (first frame, respawn) the ring is
+    // filled all at once, so the field doesn't grow in around the player
+    const Slot& own = slotFor(camCellX, camCellZ);
+    bool jumped = !own.resident || own.cellX != camCellX || own.cellZ != camCellZ;
+    int budget = jumped ? (int)offsets.size() : maxNewCells;
+    for (const Offset& offset : offsets) {
+        if (budget <= 0) break;
+        int cellX = camCellX + offset.dx;
+        int cellZ = camCellZ + offset.dz;
+        Slot& slot = slotFor(cellX, cellZ);
+        if (slot.resident && slot.cellX == cellX && slot.cellZ == cellZ) {
+            continue;
+        }
+        // Whatever held the slot is out of range now; its vertices are overwritten
+        generate(cellX, cellZ, slot);
+        budget--;
+    }
+}
+
+int GrassField::draw(const Frustum& frustum, float x, float z, float maxDistance) {
+    if (!allocated || residentCount == 0 || maxDistance <= 0.0f) {
+        return 0;
+    }
+    int camCellX = (int)floorf(x / cellSize);
+    int camCellZ = (int)floorf(z / cellSize);
+    float fadeStart = maxDistance * 0.6f;
+    float cellRadius = cellSize * 0.75f + 1.5f;
+
+    // Nearest cells first, so the far ones fail the depth test
+    drawFirst.clear();
+    drawCount.clear();
+    int blades = 0;
+    for (const Offset& offset : offsets) {
+        int cellX = camCellX + offset.dx;
+        int cellZ = camCellZ + offset.dz;
+        const Slot& slot = slotFor(cellX, cellZ);
+        if (!slot.resident || slot.cellX != cellX || slot.cellZ != cellZ || slot.bladeCount == 0) {
+            continue;
+        }
+
+        float centerX = (cellX + 0.5f) * cellSize;
+        float centerZ = (cellZ + 0.5f) * cellSize;
+        float dx = centerX - x;
+        float dz = centerZ - z;
+        float dist = sqrtf(dx * dx + dz * dz);
+        if (dist >= maxDistance) continue;
+        if (!frustum.testSphere(centerX, (slot.minY + slot.maxY) * 0.5f + 1.25f, centerZ,
+                                cellRadius + (slot.maxY - slot.minY) * 0.5f)) continue;
+
+        int count = slot.bladeCount;
+        if (dist > fadeStart) {
+            count = (int)(count * (maxDistance - dist) / (maxDistance - fadeStart) + 0.5f);
+            if (count == 0) continue;
+        }
+        drawFirst.push_back((int)(&slot - &slots[0]) * slotVertices);
+        drawCount.push_back(count * 8);
+        blades += count;
+    }
+    if (drawFirst.empty()) {
+        return 0;
+    }
+
+    const char* base = NULL;
+    if (vbo != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    } else {
+        base = (const char*)&clientVertices[0];
+    }
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, position));
+    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, texCoord));
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), base + offsetof(Vertex, color));
+
+    if (multiDraw) {
+        glMultiDrawArrays(GL_QUADS, &drawFirst[0], &drawCount[0], (GLsizei)drawFirst.size());
+    } else {
+        for (size_t i = 0; i < drawFirst.size(); i++) {
+            glDrawArrays(GL_QUADS, drawFirst[i], drawCount[i]);
+        }
+    }
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    if (vbo != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    return blades;
+}
+
+void GrassField::release() {
+    if (vbo != 0) {
+        glDeleteBuffers(1, &vbo);
+        vbo = 0;
+    }
+    slots.clear();
+    clientVertices.clear();
+    scratch.clear();
+    allocated = false;
+    residentCount = 0;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "Frustum.h"
+#include "Terrain.h"
+#include <vector>
+
+// Grass Field - ground grass generated once per cell and kept in a ring
+// Level2 placed its grass with an LCG over a 12x12 cell grid every frame,
+// through glBegin/glEnd and capped at 80 blades. Cells are now generated
+// the first time they come within range, nearest first and a few per
+// frame, and stay resident until they leave it. Residency is a toroidal
+// ring: cell (x, z) always lands in slot (x mod N, z mod N) with N wide
+// enough for the whole range, so a cell entering on one side takes over
+// the slot of the one that just left the other side. Every slot owns a
+// fixed range of one vertex buffer, updated in place when its cell
+// changes. The blades of a cell are stored in random order; toward the
+// edge of the range only a leading part of each cell is drawn, so the
+// field thins out instead of ending at a line.
+class GrassField {
+public:
+    // Cells of cellSize units, generated out to radiusCells cells from the
+    // camera's cell, bladesPerCell crossed-quad blades each
+    GrassField(float cellSize = 20.0f, int radiusCells = 8, int bladesPerCell = 64);
+    ~GrassField();
+
+    GrassField(const GrassField&) = delete;
+    GrassField& operator=(const GrassField&) = delete;
+
+    // Leave out blades within radius of (x, z); applies to cells generated after the call
+    void addExclusion(float x, float z, float clearRadius);
+    // Stand blades on this ground instead of at zero; like addExclusion, for cells generated after
+    void setTerrain(const Terrain* ground) { terrain = ground; }
+
+    // Generate missing cells around (x, z), at most maxNewCells of them
+    // unless the cell under (x, z) is missing too (needs a GL context)
+    void update(float x, float z, int maxNewCells = 6);
+    // Draw the resident cells within maxDistance of (x, z) that touch the
+    // frustum; the caller sets texture, blending and alpha test. Returns
+    // the blades drawn.
+    int draw(const Frustum& frustum, float x, float z, float maxDistance);
+    // Drop the buffer and every cell (exclusions are kept)
+    void release();
+
+    float getRange() const { return radius * cellSize; }
+
+private:
+    struct Vertex {
+        float position[3];
+        float texCoord[2];
+        unsigned char color[4];
+    };
+
+    struct Slot {
+        int cellX, cellZ;
+        int bladeCount;
+        float minY, maxY;   // Lowest and highest blade base
+        bool resident;
+    };
+
+    struct Exclusion {
+        float x, z;
+        float radiusSq;
+    };
+
+    struct Offset {
+        int dx, dz;
+    };
+
+    float cellSize;
+    int radius;
+    int ringSize;                   // N = 2 * radius + 1
+    int bladesPerCell;
+    int slotVertices;               // Vertices reserved per slot (8 per blade)
+    std::vector<Slot> slots;
+    std::vector<Offset> offsets;    // Cells in range around the camera's cell, nearest first
+    std::vector<Exclusion> exclusions;
+    const Terrain* terrain;
+    std::vector<Vertex> clientVertices;     // Whole ring when there are no VBOs
+    std::vector<Vertex> scratch;            // One cell, before upload
+    std::vector<int> drawFirst;
+    std::vector<int> drawCount;
+    unsigned int vbo;
+    bool allocated;
+    bool multiDraw;
+    int residentCount;                      // Slots holding a cell; nothing to draw at 0
+
+    void allocate();
+    Slot& slotFor(int cellX, int cellZ);
+    void generate(int cellX, int cellZ, Slot& slot);
+};
@@ -1,10 +1,18 @@
 #include "HUDRenderer.h"
+#include "GLState.h"
+#include "TextRenderer.h"
 #include <cmath>
+#include <cstdio>
 
-void HUDRenderer::drawText(float x, float y, const std::string& text, void* font) {
-    glRasterPos2f(x, y);
-    for (char c : text) {
-        glutBitmapCharacter(font, c);
+void HUDRenderer::drawText(float x, float y, const char* text, void* font) {
+    TextRenderer::getInstance().add(x, y, text, font);
+}
+
+void HUDRenderer::formatCounter(char* buffer, size_t size, const HUDCounter& counter) {
+    if (counter.showTotal) {
+        snprintf(buffer, size, "%s: %d / %d", counter.label.c_str(), counter.value, counter.total);
+    } else {
+        snprintf(buffer, size, "%s: %d", counter.label.c_str(), counter.value);
     }
 }
 
@@ -21,19 +29,17 @@ void HUDRenderer::drawCounterBlock(float x0, float y0, float x1, float y1, const
     glEnd();
 
     // Text
-    glColor3f(1.0f, 1.0f, 1.0f);
-    std::string line;
-    if (counter.showTotal) {
-        line = counter.label + ": " + std::to_string(counter.value) + " / " + std::to_string(counter.total);
-    } else {
-        line = counter.label + ": " + std::to_string(counter.value);
-    }
+    char line[96];
+    formatCounter(line, sizeof(line), counter);
+    TextRenderer::getInstance().setColor(1.0f, 1.0f, 1.0f);
     drawText(x0 + 12.0f, y1 - 20.0f, line);
 }
 
 void HUDRenderer::render(const HUDParams& params) {
+    TextRenderer& textRenderer = TextRenderer::getInstance();
+
     // Save states
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    GLState::push(GL_CURRENT_BIT);
 
     // Ortho setup
     glMatrixMode(GL_PROJECTION);
@@ -45,15 +51,15 @@ void HUDRenderer::render(const HUDParams& params) {
     glPushMatrix();
     glLoadIdentity();
 
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_TEXTURE_2D);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::disable(GL_TEXTURE_2D);
 
     // Blending for translucent panels
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    char buffer[64];
+    char buffer[96];
 
     // Top-left block: primary + optional secondary stacked
     float leftX0 = 10.0f;
@@ -75,25 +81,15 @@ void HUDRenderer::render(const HUDParams& params) {
 
         float textY = leftY1 - 24.0f;
         if (params.primary.enabled) {
-            std::string line;
-            if (params.primary.showTotal) {
-                line = params.primary.label + ": " + std::to_string(params.primary.value) + " / " + std::to_string(params.primary.total);
-            } else {
-                line = params.primary.label + ": " + std::to_string(params.primary.value);
-            }
-            glColor3f(1.0f, 1.0f, 1.0f);
-            drawText(leftX0 + 12.0f, textY, line);
+            formatCounter(buffer, sizeof(buffer), params.primary);
+            textRenderer.setColor(1.0f, 1.0f, 1.0f);
+            drawText(leftX0 + 12.0f, textY, buffer);
             textY -= lineHeight;
         }
         if (params.secondary.enabled) {
-            std::string line;
-            if (params.secondary.showTotal) {
-                line = params.secondary.label + ": " + std::to_string(params.secondary.value) + " / " + std::to_string(params.secondary.total);
-            } else {
-                line = params.secondary.label + ": " + std::to_string(params.secondary.value);
-            }
-            glColor3f(1.0f, 0.9f, 0.3f);
-            drawText(leftX0 + 12.0f, textY, line);
+            formatCounter(buffer, sizeof(buffer), params.secondary);
+            textRenderer.setColor(1.0f, 0.9f, 0.3f);
+            drawText(leftX0 + 12.0f, textY, buffer);
         }
     }
 
@@ -111,11 +107,11 @@ void HUDRenderer::render(const HUDParams& params) {
 
     // Timer text with color shift
     if (params.gameTimer > 30.0f) {
-        glColor3f(1.0f, 1.0f, 1.0f);
+        textRenderer.setColor(1.0f, 1.0f, 1.0f);
     } else if (params.gameTimer > 10.0f) {
-        glColor3f(1.0f, 1.0f, 0.0f);
+        textRenderer.setColor(1.0f, 1.0f, 0.0f);
     } else {
-        glColor3f(1.0f, 0.3f, 0.3f);
+        textRenderer.setColor(1.0f, 0.3f, 0.3f);
     }
     int minutes = (int)(params.gameTimer) / 60;
     int seconds = (int)(params.gameTimer) % 60;
@@ -135,22 +131,23 @@ void HUDRenderer::render(const HUDParams& params) {
     glVertex2f(scoreX0, scoreY0);
     glEnd();
 
-    glColor3f(1.0f, 0.9f, 0.2f);
+    textRenderer.setColor(1.0f, 0.9f, 0.2f);
     snprintf(buffer, sizeof(buffer), "Score: %d", params.score);
     drawText(scoreX0 + 12.0f, scoreY1 - 32.0f, buffer);
 
     // Altitude warning (optional)
     if (params.showWarning && !params.warningText.empty()) {
         float pulse = 0.7f + 0.3f * sinf(params.warningPhase);
-        glColor4f(1.0f, 0.0f, 0.0f, pulse);
+        textRenderer.setColor(1.0f, 0.0f, 0.0f, pulse);
         float warnX = (params.screenWidth - 220.0f) * 0.5f;
-        drawText(warnX, params.screenHeight - 80.0f, params.warningText);
+        drawText(warnX, params.screenHeight - 80.0f, params.warningText.c_str());
     }
+    textRenderer.flush(TextRenderer::SCREEN_GAUGES);
 
     // Restore matrices/state
     glMatrixMode(GL_PROJECTION);
     glPopMatrix();
     glMatrixMode(GL_MODELVIEW);
     glPopMatrix();
-    glPopAttrib();
+    GLState::pop();
 }
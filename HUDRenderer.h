@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <glut.h>
 
@@ -30,6 +31,9 @@ public:
     static void render(const HUDParams& params);
 
 private:
-    static void drawText(float x, float y, const std::string& text, void* font = GLUT_BITMAP_HELVETICA_18);
+    // Queued on TextRenderer; render() flushes it before restoring state
+    static void drawText(float x, float y, const char* text, void* font = GLUT_BITMAP_HELVETICA_18);
+    // "label: value" or "label: value / total" without building strings
+    static void formatCounter(char* buffer, size_t size, const HUDCounter& counter);
     static void drawCounterBlock(float x0, float y0, float x1, float y1, const HUDCounter& counter);
 };
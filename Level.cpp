@@ -1,4 +1,5 @@
 #include "Level.h"
+#include "glew.h"
 
 Level::Level() : active(false) {
 }
@@ -13,3 +14,20 @@ void Level::onEnter() {
 void Level::onExit() {
     active = false;
 }
+
+void Level::updateViewFrustum() {
+    float projection[16];
+    float modelview[16];
+    glGetFloatv(GL_PROJECTION_MATRIX, projection);
+    glGetFloatv(GL_MODELVIEW_MATRIX, modelview);
+    viewFrustum.extract(projection, modelview);
+}
+
+void Level::drawScene() {
+    renderQueue.setFrustum(viewFrustum);
+    recordScene();
+    GLRenderBackend backend;
+    renderQueue.submit(backend);
+    renderStats = backend.getStats();
+    renderQueue.clear();
+}
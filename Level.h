@@ -1,4 +1,5 @@
 #pragma once
+#include "RenderQueue.h"
 
 class Level {
 public:
@@ -22,9 +23,24 @@ public:
     virtual void onEnter();
     virtual void onExit();
     
+    // Record this frame's draw items into the render queue. Must not touch
+    // GL, so a frame can be built and counted headless (NullRenderBackend).
+    virtual void recordScene() {}
+    RenderQueue& getRenderQueue() { return renderQueue; }
+    // Groups, draws and state changes of the last drawScene()
+    const RenderStats& getRenderStats() const { return renderStats; }
+    
     bool isActive() const { return active; }
     void setActive(bool value) { active = value; }
     
 protected:
     bool active;
+    RenderQueue renderQueue;    // Meshes/materials registered at load, items per frame
+    RenderStats renderStats;
+    Frustum viewFrustum;        // World-space view volume of the current frame
+    
+    // Read the view frustum from the GL projection/modelview (call right after the camera is set)
+    void updateViewFrustum();
+    // recordScene() and submit the items to GL, culled against viewFrustum
+    void drawScene();
 };
@@ -6,208 +6,19 @@
 #include <stdio.h>
 #include <cstdlib>
 #include <cstring>
+#include <algorithm>
 #include "HUDRenderer.h"
+#include "TextureManager.h"
+#include "GLState.h"
+#include "TextRenderer.h"
 
 extern void loadBMP(unsigned int* textureID, char* strFileName, int wrap);
 
-// Custom BMP loader that handles both 8-bit paletted and 24-bit BMPs
+// BMP textures go through the shared TextureManager so the same file is
+// decoded and uploaded once no matter how many levels or systems use it
 static bool loadGroundTexture(GLuint* texID, const char* filename, bool useAlpha = false) {
-    FILE* file = NULL;
-    fopen_s(&file, filename, "rb");
-    if (!file) {
-        return false;
-    }
-
-    // Read BMP header (54 bytes minimum, but BITMAPV4/V5 can be larger)
-    unsigned char header[138];  // Large enough for BITMAPV4HEADER
-    memset(header, 0, sizeof(header));
-    if (fread(header, 1, 54, file) != 54 || header[0] != 'B' || header[1] != 'M') {
-        fclose(file);
-        return false;
-    }
-
-    // Extract info
-    int dataOffset = *(int*)&header[10];
-    int headerSize = *(int*)&header[14];  // DIB header size
-    int width = *(int*)&header[18];
-    int height = *(int*)&header[22];
-    int bitsPerPixel = *(short*)&header[28];
-    int compression = *(int*)&header[30];
-
-    if (width <= 0 || height <= 0) {
-        fclose(file);
-        return false;
-    }
-
-    // Handle negative height (top-down bitmap)
-    bool topDown = height < 0;
-    if (topDown) height = -height;
-
-    unsigned char* rgbData = new unsigned char[width * height * 3];
-
-    if (bitsPerPixel == 8) {
-        // 8-bit paletted BMP
-        // Read the color palette (located right after the DIB header)
-        fseek(file, 14 + headerSize, SEEK_SET);  // 14 = BMP file header size
-
-        unsigned char palette[1024];  // 256 colors * 4 bytes (BGRA)
-        if (fread(palette, 1, 1024, file) != 1024) {
-            delete[] rgbData;
-            fclose(file);
-            return false;
-        }
-
-        // Seek to pixel data
-        fseek(file, dataOffset, SEEK_SET);
-
-        // Calculate row size with padding (rows are 4-byte aligned)
-        int rowSize = ((width + 3) / 4) * 4;
-        unsigned char* indexData = new unsigned char[rowSize * height];
-
-        if (fread(indexData, 1, rowSize * height, file) != (size_t)(rowSize * height)) {
-            delete[] indexData;
-            delete[] rgbData;
-            fclose(file);
-            return false;
-        }
-
-        // Convert indexed to RGB using palette
-        for (int y = 0; y < height; y++) {
-            int srcY = topDown ? y : (height - 1 - y);
-            for (int x = 0; x < width; x++) {
-                unsigned char index = indexData[srcY * rowSize + x];
-                int destIdx = (y * width + x) * 3;
-                rgbData[destIdx + 0] = palette[index * 4 + 2];  // R (palette is BGRA)
-                rgbData[destIdx + 1] = palette[index * 4 + 1];  // G
-                rgbData[destIdx + 2] = palette[index * 4 + 0];  // B
-            }
-        }
-        delete[] indexData;
-    }
-    else if (bitsPerPixel == 16) {
-        // 16-bit 565/555 BMP
-        fseek(file, dataOffset, SEEK_SET);
-        int rowSize = ((width * 2 + 3) / 4) * 4;
-        unsigned char* bmpData = new unsigned char[rowSize * height];
-        if (fread(bmpData, 1, rowSize * height, file) != (size_t)(rowSize * height)) {
-            delete[] bmpData;
-            delete[] rgbData;
-            fclose(file);
-            return false;
-        }
-        for (int y = 0; y < height; y++) {
-            int srcY = topDown ? y : (height - 1 - y);
-            for (int x = 0; x < width; x++) {
-                int srcIdx = srcY * rowSize + x * 2;
-                unsigned short pix = bmpData[srcIdx] | (bmpData[srcIdx + 1] << 8);
-                // Assume 565; fallback to 555 by masking
-                unsigned char r = (unsigned char)((pix >> 11) & 0x1F);
-                unsigned char g = (unsigned char)((pix >> 5)  & 0x3F);
-                unsigned char b = (unsigned char)(pix & 0x1F);
-                // Expand to 8-bit per channel
-                r = (r << 3) | (r >> 2);
-                g = (g << 2) | (g >> 4);
-                b = (b << 3) | (b >> 2);
-                int destIdx = (y * width + x) * 3;
-                rgbData[destIdx + 0] = r;
-                rgbData[destIdx + 1] = g;
-                rgbData[destIdx + 2] = b;
-            }
-        }
-        delete[] bmpData;
-    }
-    else if (bitsPerPixel == 24) {
-        // 24-bit RGB BMP
-        fseek(file, dataOffset, SEEK_SET);
-
-        int rowSize = ((width * 3 + 3) / 4) * 4;
-        unsigned char* bmpData = new unsigned char[rowSize * height];
-
-        if (fread(bmpData, 1, rowSize * height, file) != (size_t)(rowSize * height)) {
-            delete[] bmpData;
-            delete[] rgbData;
-            fclose(file);
-            return false;
-        }
-
-        // Convert BGR to RGB
-        for (int y = 0; y < height; y++) {
-            int srcY = topDown ? y : (height - 1 - y);
-            for (int x = 0; x < width; x++) {
-                int srcIdx = srcY * rowSize + x * 3;
-                int destIdx = (y * width + x) * 3;
-                rgbData[destIdx + 0] = bmpData[srcIdx + 2];  // R
-                rgbData[destIdx + 1] = bmpData[srcIdx + 1];  // G
-                rgbData[destIdx + 2] = bmpData[srcIdx + 0];  // B
-            }
-        }
-        delete[] bmpData;
-    }
-    else if (bitsPerPixel == 32) {
-        // 32-bit ARGB/BGRA BMP
-        delete[] rgbData;  // We need RGBA instead
-        unsigned char* rgbaData = new unsigned char[width * height * 4];
-
-        fseek(file, dataOffset, SEEK_SET);
-        int rowSize = width * 4;
-        unsigned char* bmpData = new unsigned char[rowSize * height];
-
-        if (fread(bmpData, 1, rowSize * height, file) != (size_t)(rowSize * height)) {
-            delete[] bmpData;
-            delete[] rgbaData;
-            fclose(file);
-            return false;
-        }
-
-        // Convert BGRA to RGBA
-        for (int y = 0; y < height; y++) {
-            int srcY = topDown ? y : (height - 1 - y);
-            for (int x = 0; x < width; x++) {
-                int srcIdx = srcY * rowSize + x * 4;
-                int destIdx = (y * width + x) * 4;
-                rgbaData[destIdx + 0] = bmpData[srcIdx + 2];  // R
-                rgbaData[destIdx + 1] = bmpData[srcIdx + 1];  // G
-                rgbaData[destIdx + 2] = bmpData[srcIdx + 0];  // B
-                // If useAlpha is false, force alpha to 255 (opaque)
-                rgbaData[destIdx + 3] = useAlpha ? bmpData[srcIdx + 3] : 255;
-            }
-        }
-        delete[] bmpData;
-
-        fclose(file);
-
-        // Create OpenGL texture with alpha
-        glGenTextures(1, texID);
-        glBindTexture(GL_TEXTURE_2D, *texID);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGBA, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgbaData);
-
-        delete[] rgbaData;
-        return true;
-    }
-    else {
-        // Unsupported format
-        delete[] rgbData;
-        fclose(file);
-        return false;
-    }
-
-    fclose(file);
-
-    // Create OpenGL texture
-    glGenTextures(1, texID);
-    glBindTexture(GL_TEXTURE_2D, *texID);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGB, width, height, GL_RGB, GL_UNSIGNED_BYTE, rgbData);
-
-    delete[] rgbData;
-    return true;
+    *texID = TextureManager::getInstance().acquire(filename, useAlpha ? TEX_ALPHA : TEX_DEFAULT);
+    return *texID != 0;
 }
 
 Level1::Level1() : Level(), flightSim(nullptr), screenWidth(1280), screenHeight(720),
@@ -219,13 +30,14 @@ Level1::Level1() : Level(), flightSim(nullptr), screenWidth(1280), screenHeight(
     tex_helipad_metal(0), tex_tent(0),
     tex_tank_rubber(0), tex_tank1(0), tex_tank2(0), tex_tank3(0), tex_tank4(0),
     rocketSpawnTimer(0.0f), rocketSpawnInterval(5.0f),
-    waterLevel(-2.0f), portHeight(3.0f),
+    waterLevel(-2.0f), portHeight(3.0f), ocean(waterLevel), waterMode(GL_TRIANGLES), waterColored(false),
     spawnProtectionTimer(3.0f), hasSpawnProtection(true) {
     
     // Aircraft carrier positioned in water at surface level
     carrierPosition = Vector3f(0.0f, waterLevel + 50.0f, -100.0f);  // At water surface
     carrierRotation = 0.0f;
     carrierScale = 0.001f;  // Appropriate scale
+    carrierFreeboard = carrierPosition.y - waterLevel;
 }
 
 Level1::~Level1() {
@@ -263,6 +75,8 @@ void Level1::init() {
     initToolkits();
     initRockets();
     initBoats();
+    registerRenderMeshes();  // Render queue meshes/materials (needs the toolkits)
+    buildPortBatches();      // Static port geometry (needs the textures)
     
     gameTimer = maxGameTime;
     score = 0;
@@ -309,23 +123,13 @@ void Level1::loadAssets() {
     // Load rocket texture
     if (!loadGroundTexture(&tex_rocket, "Models/rocket/Military Rocket Textures/Military Rocket_mat_BaseColor.bmp")) {
         printf("Failed to load rocket texture, using fallback\n");
-        glGenTextures(1, &tex_rocket);
-        glBindTexture(GL_TEXTURE_2D, tex_rocket);
-        unsigned char gray[3] = { 160, 160, 160 };
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, gray);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        tex_rocket = TextureManager::getInstance().acquireColor(160, 160, 160);
     }
     
     // Load boat texture
     if (!loadGroundTexture(&tex_boat, "Models/boat/MEtal Boat.bmp")) {
         printf("Failed to load boat texture, using fallback\n");
-        glGenTextures(1, &tex_boat);
-        glBindTexture(GL_TEXTURE_2D, tex_boat);
-        unsigned char grayBoat[3] = { 120, 120, 130 };
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, grayBoat);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        tex_boat = TextureManager::getInstance().acquireColor(120, 120, 130);
     }
 
     // Force boat materials to use boat texture
@@ -339,12 +143,7 @@ void Level1::loadAssets() {
     // Load humvee texture
     if (!loadGroundTexture(&tex_humvee, "Models/humvees/texture.bmp")) {
         printf("Failed to load humvee texture, using fallback\n");
-        glGenTextures(1, &tex_humvee);
-        glBindTexture(GL_TEXTURE_2D, tex_humvee);
-        unsigned char olive[3] = { 85, 90, 70 };
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, olive);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        tex_humvee = TextureManager::getInstance().acquireColor(85, 90, 70);
     }
 
     // Force humvee materials to use humvee texture
@@ -380,48 +179,38 @@ void Level1::loadAssets() {
     // Use loadGroundTexture which is more robust than loadBMP
     if (!loadGroundTexture(&tex_lighthouse_wall, "textures/concert.bmp")) {
          printf("Failed to load lighthouse wall, using fallback\n");
-         glGenTextures(1, &tex_lighthouse_wall);
-         glBindTexture(GL_TEXTURE_2D, tex_lighthouse_wall);
-         unsigned char white[3] = { 255, 255, 255 };
-         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, white);
-         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+         tex_lighthouse_wall = TextureManager::getInstance().acquireColor(255, 255, 255);
     }
     
     if (!loadGroundTexture(&tex_lighthouse_top, "models/containor/red-corrugated-surface.bmp")) {
          printf("Failed to load lighthouse top, using fallback\n");
-         glGenTextures(1, &tex_lighthouse_top);
-         glBindTexture(GL_TEXTURE_2D, tex_lighthouse_top);
-         unsigned char red[3] = { 200, 50, 50 };
-         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, red);
-         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    }
-
-    // Load tank textures
-    auto loadTankTex = [&](GLuint* dst, const char* p1, const char* p2) {
-        if (!loadGroundTexture(dst, p1)) {
-            if (!loadGroundTexture(dst, p2)) {
-                printf("Failed to load %s and %s\n", p1, p2);
-            }
-        }
+         tex_lighthouse_top = TextureManager::getInstance().acquireColor(200, 50, 50);
+    }
+
+    // Load tank textures: the BaseColor PNGs shipped with the model, decoded
+    // together on the worker pool. Normal and ORM maps need shaders, so only
+    // the base colors are used. 3DS texture coordinates expect bottom-up rows.
+    const char* tankPaths[5] = {
+        "models/tank/Textures/Tank_01_MainMetal_Armor_BaseColor.png",
+        "models/tank/Textures/Tank_01_MainMetal_Guns_BaseColor.png",
+        "models/tank/Textures/Tank_01_Metal_Wheels_BaseColor.png",
+        "models/tank/Textures/Tank_01_DMainMetal_Shield_BaseColor.png",
+        "models/tank/Textures/Tank_01_Rubber_Wheels_BaseColor.png"
     };
+    unsigned int tankTextures[5];
+    TextureManager::getInstance().acquireBatch(tankPaths, 5, TEX_FLIP_VERTICAL, tankTextures);
+    tex_tank1 = tankTextures[0];        // Hull armor
+    tex_tank2 = tankTextures[1];        // Guns
+    tex_tank3 = tankTextures[2];        // Road wheels
+    tex_tank4 = tankTextures[3];        // Turret shield
+    tex_tank_rubber = tankTextures[4];  // Tracks and tyres
 
-    loadTankTex(&tex_tank4, "Models/tank/tank4.bmp", "../Models/tank/tank4.bmp");
-    if (tex_tank4 == 0) {
-        printf("tank4 texture missing; creating fallback color texture\n");
-        unsigned char green[3] = { 90, 120, 80 };
-        glGenTextures(1, &tex_tank4);
-        glBindTexture(GL_TEXTURE_2D, tex_tank4);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, green);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    }
-    // Force all tank textures to use the single camo texture (tank4.bmp or fallback)
-    tex_tank1 = tex_tank4;
-    tex_tank2 = tex_tank4;
-    tex_tank3 = tex_tank4;
-    tex_tank_rubber = tex_tank4;
+    if (tex_tank1 == 0) {
+        printf("Tank PNGs missing; trying tank4.bmp\n");
+        if (!loadGroundTexture(&tex_tank1, "Models/tank/tank4.bmp")) {
+            tex_tank1 = TextureManager::getInstance().acquireColor(90, 120, 80);
+        }
+    }
     
     // Load carrier texture using custom loader (handles more BMP formats)
     printf("Loading carrier texture...\n");
@@ -430,12 +219,7 @@ void Level1::loadAssets() {
     } else {
         printf("Failed to load carrier texture, using fallback\n");
         // Fallback to gray texture if loading fails
-        glGenTextures(1, &tex_carrier);
-        glBindTexture(GL_TEXTURE_2D, tex_carrier);
-        unsigned char gray[3] = { 80, 80, 85 };
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, gray);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        tex_carrier = TextureManager::getInstance().acquireColor(80, 80, 85);
     }
 
     // Force carrier model materials to use the loaded carrier texture
@@ -473,22 +257,32 @@ void Level1::loadAssets() {
     // Force tank model materials to use the loaded tank textures (fallback to gray if load failed)
     if (tex_tank1 == 0) {
         // Create a simple gray texture so materials are not white/untextured
-        unsigned char gray[3] = { 160, 160, 160 };
-        glGenTextures(1, &tex_tank1);
-        glBindTexture(GL_TEXTURE_2D, tex_tank1);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, gray);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        tex_tank1 = TextureManager::getInstance().acquireColor(160, 160, 160);
     }
     if (tex_tank2 == 0) tex_tank2 = tex_tank1;
     if (tex_tank3 == 0) tex_tank3 = tex_tank1;
     if (tex_tank4 == 0) tex_tank4 = tex_tank1;
     if (tex_tank_rubber == 0) tex_tank_rubber = tex_tank1;
 
-    // Apply single camo texture (tank4.bmp) to every tank material
+    // Pick each tank material's texture from its name; anything unrecognised is hull armor
     for (int m = 0; m < model_tank.numMaterials; ++m) {
-        model_tank.Materials[m].tex.texture[0] = tex_tank4;
-        model_tank.Materials[m].tex.texturename = (char*)"tank4"; // non-null name
+        char name[80];
+        strncpy_s(name, sizeof(name), model_tank.Materials[m].name, _TRUNCATE);
+        _strlwr_s(name, sizeof(name));
+
+        GLuint tex = tex_tank1;
+        if (strstr(name, "rubber") || strstr(name, "track") || strstr(name, "tyre") || strstr(name, "tire")) {
+            tex = tex_tank_rubber;
+        } else if (strstr(name, "wheel") || strstr(name, "gear")) {
+            tex = tex_tank3;
+        } else if (strstr(name, "gun") || strstr(name, "barrel") || strstr(name, "cannon")) {
+            tex = tex_tank2;
+        } else if (strstr(name, "shield") || strstr(name, "turret")) {
+            tex = tex_tank4;
+        }
+
+        model_tank.Materials[m].tex.texture[0] = tex;
+        model_tank.Materials[m].tex.texturename = (char*)"tank"; // non-null name
         model_tank.Materials[m].textured = true;
         model_tank.Materials[m].tex.Use();
     }
@@ -501,12 +295,7 @@ void Level1::loadAssets() {
     // Load rings and rockets texture
     if (!loadGroundTexture(&tex_rings, "textures/Tiles_G_200cm.bmp")) {
         // Fallback to cyan texture if loading fails
-        glGenTextures(1, &tex_rings);
-        glBindTexture(GL_TEXTURE_2D, tex_rings);
-        unsigned char cyan[3] = { 0, 200, 255 };
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, cyan);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        tex_rings = TextureManager::getInstance().acquireColor(0, 200, 255);
     }
     
     // Load textures
@@ -520,21 +309,11 @@ void Level1::loadAssets() {
     
     // Fallback textures if loading fails
     if (tex_water == 0) {
-        glGenTextures(1, &tex_water);
-        glBindTexture(GL_TEXTURE_2D, tex_water);
-        unsigned char blue[3] = { 30, 80, 150 };
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, blue);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        tex_water = TextureManager::getInstance().acquireColor(30, 80, 150);
     }
     
     if (tex_concrete == 0) {
-        glGenTextures(1, &tex_concrete);
-        glBindTexture(GL_TEXTURE_2D, tex_concrete);
-        unsigned char gray[3] = { 128, 128, 128 };
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, gray);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        tex_concrete = TextureManager::getInstance().acquireColor(128, 128, 128);
     }
 
     // Initialize sky system (loads lens flare textures, cloud data, etc.)
@@ -600,14 +379,14 @@ void Level1::initBoats() {
     boats.clear();
 
     auto addBoat = [&](const Vector3f& start, const Vector3f& end, float speed,
-               bool moving, float yawDeg, float phase, float bobSpeed, float bobAmount) {
+               bool moving, float yawDeg, float phase) {
     BoatInstance boat;
     boat.startPosition = start;
     boat.endPosition = moving ? end : start;
     boat.position = start;
     boat.phase = phase;
-    boat.bobSpeed = bobSpeed;
-    boat.bobAmount = bobAmount;
+    boat.pitch = 0.0f;
+    boat.roll = 0.0f;
     boat.isMoving = moving;
     boat.movingForward = true;
     boat.moveSpeed = moving ? speed : 0.0f;
@@ -629,11 +408,11 @@ void Level1::initBoats() {
     // Stationary boats near port (away from carrier)
     addBoat(Vector3f(360.0f, baseY, -300.0f),
         Vector3f(360.0f, baseY, -300.0f),
-        0.0f, false, 90.0f, 1.2f, 1.2f, 0.6f);
+        0.0f, false, 90.0f, 1.2f);
 
     addBoat(Vector3f(320.0f, baseY, 240.0f),
         Vector3f(320.0f, baseY, 240.0f),
-        0.0f, false, 45.0f, 2.1f, 1.6f, 0.65f);
+        0.0f, false, 45.0f, 2.1f);
 
     // Moving boats heading toward rings (rings start at z=200 and go to z~3000)
     // Carrier is at x=0, z=-100, so keep boats away from that area
@@ -642,27 +421,27 @@ void Level1::initBoats() {
     // Boat 1: Left lane, heading toward rings
     addBoat(Vector3f(-180.0f, baseY, -400.0f),
         Vector3f(-180.0f, baseY, 2800.0f),
-        20.0f, true, 0.0f, 0.0f, 1.0f, 0.5f);
+        20.0f, true, 0.0f, 0.0f);
 
     // Boat 2: Far left lane, heading toward rings
     addBoat(Vector3f(-320.0f, baseY, -600.0f),
         Vector3f(-320.0f, baseY, 2600.0f),
-        18.0f, true, 0.0f, 1.5f, 1.1f, 0.55f);
+        18.0f, true, 0.0f, 1.5f);
 
     // Boat 3: Right side, heading toward rings
     addBoat(Vector3f(180.0f, baseY, -500.0f),
         Vector3f(180.0f, baseY, 2700.0f),
-        22.0f, true, 0.0f, 0.8f, 0.9f, 0.5f);
+        22.0f, true, 0.0f, 0.8f);
 
     // Boat 4: Far right, heading toward rings
     addBoat(Vector3f(280.0f, baseY, -300.0f),
         Vector3f(280.0f, baseY, 2500.0f),
-        16.0f, true, 0.0f, 2.0f, 1.2f, 0.6f);
+        16.0f, true, 0.0f, 2.0f);
 
     // Boat 5: Center-left diagonal path
     addBoat(Vector3f(-100.0f, baseY, -700.0f),
         Vector3f(-50.0f, baseY, 2400.0f),
-        19.0f, true, 0.0f, 0.5f, 1.0f, 0.55f);
+        19.0f, true, 0.0f, 0.5f);
 }
 
 void Level1::update(float deltaTime) {
@@ -724,6 +503,8 @@ void Level1::update(float deltaTime) {
         
         bool wasCrashedBefore = flightSim->isCrashed;
         
+        updateSea();
+        
         // Store old position for carrier deck collision
         Vector3f oldPos = flightSim->player.position;
         
@@ -874,14 +655,25 @@ void Level1::updateRockets(float deltaTime) {
     }
 }
 
-void Level1::updateBoats(float deltaTime) {
-    float time = ringTimer;
+void Level1::updateSea() {
+    ocean.update(ringTimer);
+
+    // The hull spans several wavelengths, so heave on the average under it;
+    // a plane parked on the deck goes up and down with it
+    float sea = (ocean.getHeight(carrierPosition.x, carrierPosition.z) +
+                 ocean.getHeight(carrierPosition.x, carrierPosition.z - 100.0f) +
+                 ocean.getHeight(carrierPosition.x, carrierPosition.z + 100.0f) +
+                 ocean.getHeight(carrierPosition.x - 20.0f, carrierPosition.z) +
+                 ocean.getHeight(carrierPosition.x + 20.0f, carrierPosition.z)) * 0.2f;
+    float heave = sea + carrierFreeboard - carrierPosition.y;
+    if (flightSim->isGrounded && isOnCarrierDeck(flightSim->player.position)) {
+        flightSim->player.position.y += heave;
+    }
+    carrierPosition.y += heave;
+}
 
+void Level1::updateBoats(float deltaTime) {
     for (auto& boat : boats) {
-        float baseY = boat.startPosition.y;
-        float bob = sin(time * boat.bobSpeed + boat.phase) * boat.bobAmount;
-        boat.position.y = baseY + bob;
-
         if (boat.isMoving && boat.pathLength > 0.001f) {
             Vector3f dir = boat.forwardDir * (boat.movingForward ? 1.0f : -1.0f);
             boat.position = boat.position + dir * (boat.moveSpeed * deltaTime);
@@ -898,6 +690,18 @@ void Level1::updateBoats(float deltaTime) {
                 boat.movingForward = true;
             }
         }
+
+        // Ride the waves: heave on the average of bow, stern and both sides,
+        // pitch and roll from the differences between them
+        Vector3f dir = boat.forwardDir * (boat.movingForward ? 1.0f : -1.0f);
+        Vector3f side(-dir.z, 0.0f, dir.x);
+        float bow = ocean.getHeight(boat.position.x + dir.x * 10.0f, boat.position.z + dir.z * 10.0f);
+        float stern = ocean.getHeight(boat.position.x - dir.x * 10.0f, boat.position.z - dir.z * 10.0f);
+        float left = ocean.getHeight(boat.position.x - side.x * 4.0f, boat.position.z - side.z * 4.0f);
+        float right = ocean.getHeight(boat.position.x + side.x * 4.0f, boat.position.z + side.z * 4.0f);
+        boat.position.y = boat.startPosition.y + (bow + stern + left + right) * 0.25f - waterLevel;
+        boat.pitch = atan2(bow - stern, 20.0f) * 180.0f / 3.14159f;
+        boat.roll = atan2(right - left, 8.0f) * 180.0f / 3.14159f;
     }
 }
 
@@ -1080,41 +884,20 @@ void Level1::renderPortLights() {
     // Only render lights at night
     if (!skySystem.isNightTime()) return;
     
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);  // Additive blending for glow
-    
-    float portX = 450.0f;  // Updated to match new port position
-    float lightY = portHeight + 5.0f;
+    GLState::disable(GL_TEXTURE_2D);
+    GLState::disable(GL_LIGHTING);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE);  // Additive blending for glow
     
     // Pulsing effect
     float pulse = 0.7f + 0.3f * sin(ringTimer * 2.0f);
     
-    // Place lights along the expanded port edge
-    for (float z = -1400.0f; z <= 1400.0f; z += 120.0f) {
-        // Light post (simple cylinder approximation)
-        glColor3f(0.3f, 0.3f, 0.35f);
-        glPushMatrix();
-        glTranslatef(portX + 10.0f, portHeight, z);
-        glScalef(1.0f, 5.0f, 1.0f);
-        glutSolidCube(2.0f);
-        glPopMatrix();
-        
-        // Light glow (yellow/orange)
-        glColor4f(1.0f, 0.9f, 0.5f, 0.8f * pulse);
-        glPushMatrix();
-        glTranslatef(portX + 10.0f, lightY, z);
-        glutSolidSphere(2.0f, 8, 8);
-        glPopMatrix();
-        
-        // Light halo
-        glColor4f(1.0f, 0.8f, 0.4f, 0.3f * pulse);
-        glPushMatrix();
-        glTranslatef(portX + 10.0f, lightY, z);
-        glutSolidSphere(5.0f, 8, 8);
-        glPopMatrix();
-    }
+    // Posts, glows and halos along the expanded port edge (see buildPortBatches)
+    portLightPosts.draw();
+    glColor4f(1.0f, 0.9f, 0.5f, 0.8f * pulse);  // Light glow (yellow/orange)
+    portLightGlows.draw(false);
+    glColor4f(1.0f, 0.8f, 0.4f, 0.3f * pulse);  // Light halo
+    portLightHalos.draw(false);
     
     // Also add some lights on the carrier
     glColor4f(0.8f, 0.2f, 0.2f, 0.9f * pulse);  // Red warning lights
@@ -1125,8 +908,8 @@ void Level1::renderPortLights() {
         glPopMatrix();
     }
     
-    glDisable(GL_BLEND);
-    glEnable(GL_LIGHTING);
+    GLState::disable(GL_BLEND);
+    GLState::enable(GL_LIGHTING);
 }
 
 bool Level1::isOnCarrierDeck(const Vector3f& pos) {
@@ -1154,15 +937,15 @@ void Level1::render() {
     
     glClearColor(0.35f, 0.45f, 0.65f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glEnable(GL_DEPTH_TEST);
-    glDepthMask(GL_TRUE);
-    glDepthFunc(GL_LEQUAL);
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::depthMask(true);
+    GLState::depthFunc(GL_LEQUAL);
     glClearDepth(1.0f);
     
     // ===== ENHANCED GRAPHICS SETTINGS =====
     glShadeModel(GL_SMOOTH);  // Smooth Gouraud shading
-    glEnable(GL_NORMALIZE);   // Normalize normals for proper lighting after scaling
-    glEnable(GL_COLOR_MATERIAL);  // Use glColor with lighting
+    GLState::enable(GL_NORMALIZE);   // Normalize normals for proper lighting after scaling
+    GLState::enable(GL_COLOR_MATERIAL);  // Use glColor with lighting
     glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
     glLightModeli(GL_LIGHT_MODEL_LOCAL_VIEWER, GL_TRUE);  // Better specular
     glLightModeli(GL_LIGHT_MODEL_TWO_SIDE, GL_FALSE);  // One-sided lighting
@@ -1172,14 +955,15 @@ void Level1::render() {
     glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
     glHint(GL_POLYGON_SMOOTH_HINT, GL_NICEST);
     
-    glEnable(GL_TEXTURE_2D);
-    glEnable(GL_LIGHTING);
+    GLState::enable(GL_TEXTURE_2D);
+    GLState::enable(GL_LIGHTING);
     
     if (flightSim) {
         glMatrixMode(GL_PROJECTION);
         glLoadIdentity();
         float aspect = (float)screenWidth / (float)(screenHeight > 0 ? screenHeight : 1);
         gluPerspective(flightSim->getFOV(), aspect, 0.1, 2000.0);
+        TextureManager::getInstance().setViewport(screenHeight, flightSim->getFOV());
     }
     
     glMatrixMode(GL_MODELVIEW);
@@ -1188,6 +972,7 @@ void Level1::render() {
     if (flightSim) {
         flightSim->setupCamera();
     }
+    updateViewFrustum();  // Culls the queued models
     
     // Render sky
     if (flightSim) {
@@ -1220,11 +1005,11 @@ void Level1::render() {
         sunDiffuse[2] = 0.3f + t * 0.4f;
     }
     
-    glEnable(GL_LIGHT0);
-    glLightfv(GL_LIGHT0, GL_POSITION, sunDirection);
-    glLightfv(GL_LIGHT0, GL_AMBIENT, sunAmbient);
-    glLightfv(GL_LIGHT0, GL_DIFFUSE, sunDiffuse);
-    glLightfv(GL_LIGHT0, GL_SPECULAR, sunSpecular);
+    GLState::enable(GL_LIGHT0);
+    GLState::lightfv(GL_LIGHT0, GL_POSITION, sunDirection);
+    GLState::lightfv(GL_LIGHT0, GL_AMBIENT, sunAmbient);
+    GLState::lightfv(GL_LIGHT0, GL_DIFFUSE, sunDiffuse);
+    GLState::lightfv(GL_LIGHT0, GL_SPECULAR, sunSpecular);
     
     // GL_LIGHT1: Port Area ROTATING Searchlight (Lighthouse effect) - MEETS LIGHT ANIMATION CRITERIA
     // Port is at x=450, extends from z=-1500 to z=1500
@@ -1243,23 +1028,23 @@ void Level1::render() {
         GLfloat portDiffuse[] = { 1.0f, 0.9f, 0.7f, 1.0f };  // Stronger beam
         GLfloat portSpecular[] = { 1.0f, 1.0f, 0.9f, 1.0f };
         
-        glEnable(GL_LIGHT1);
-        glLightfv(GL_LIGHT1, GL_POSITION, portLightPos);
-        glLightfv(GL_LIGHT1, GL_SPOT_DIRECTION, spotDir);
-        glLightfv(GL_LIGHT1, GL_AMBIENT, portAmbient);
-        glLightfv(GL_LIGHT1, GL_DIFFUSE, portDiffuse);
-        glLightfv(GL_LIGHT1, GL_SPECULAR, portSpecular);
+        GLState::enable(GL_LIGHT1);
+        GLState::lightfv(GL_LIGHT1, GL_POSITION, portLightPos);
+        GLState::lightfv(GL_LIGHT1, GL_SPOT_DIRECTION, spotDir);
+        GLState::lightfv(GL_LIGHT1, GL_AMBIENT, portAmbient);
+        GLState::lightfv(GL_LIGHT1, GL_DIFFUSE, portDiffuse);
+        GLState::lightfv(GL_LIGHT1, GL_SPECULAR, portSpecular);
         
         // Make it a spotlight
-        glLightf(GL_LIGHT1, GL_SPOT_CUTOFF, 30.0f);
-        glLightf(GL_LIGHT1, GL_SPOT_EXPONENT, 20.0f);
+        GLState::lightf(GL_LIGHT1, GL_SPOT_CUTOFF, 30.0f);
+        GLState::lightf(GL_LIGHT1, GL_SPOT_EXPONENT, 20.0f);
         
         // Attenuation for realistic falloff
-        glLightf(GL_LIGHT1, GL_CONSTANT_ATTENUATION, 1.0f);
-        glLightf(GL_LIGHT1, GL_LINEAR_ATTENUATION, 0.01f);
-        glLightf(GL_LIGHT1, GL_QUADRATIC_ATTENUATION, 0.001f);
+        GLState::lightf(GL_LIGHT1, GL_CONSTANT_ATTENUATION, 1.0f);
+        GLState::lightf(GL_LIGHT1, GL_LINEAR_ATTENUATION, 0.01f);
+        GLState::lightf(GL_LIGHT1, GL_QUADRATIC_ATTENUATION, 0.001f);
     } else {
-        glDisable(GL_LIGHT1);
+        GLState::disable(GL_LIGHT1);
     }
     
     // GL_LIGHT2: Carrier Deck Lights
@@ -1268,16 +1053,16 @@ void Level1::render() {
     GLfloat carrierSpecular[] = { 1.0f, 1.0f, 1.0f, 1.0f };
     
     if (isNight) {
-        glEnable(GL_LIGHT2);
-        glLightfv(GL_LIGHT2, GL_POSITION, carrierLightPos);
-        glLightfv(GL_LIGHT2, GL_AMBIENT, portAmbient);
-        glLightfv(GL_LIGHT2, GL_DIFFUSE, carrierDiffuse);
-        glLightfv(GL_LIGHT2, GL_SPECULAR, carrierSpecular);
-        glLightf(GL_LIGHT2, GL_CONSTANT_ATTENUATION, 1.0f);
-        glLightf(GL_LIGHT2, GL_LINEAR_ATTENUATION, 0.015f);
-        glLightf(GL_LIGHT2, GL_QUADRATIC_ATTENUATION, 0.003f);
+        GLState::enable(GL_LIGHT2);
+        GLState::lightfv(GL_LIGHT2, GL_POSITION, carrierLightPos);
+        GLState::lightfv(GL_LIGHT2, GL_AMBIENT, portAmbient);
+        GLState::lightfv(GL_LIGHT2, GL_DIFFUSE, carrierDiffuse);
+        GLState::lightfv(GL_LIGHT2, GL_SPECULAR, carrierSpecular);
+        GLState::lightf(GL_LIGHT2, GL_CONSTANT_ATTENUATION, 1.0f);
+        GLState::lightf(GL_LIGHT2, GL_LINEAR_ATTENUATION, 0.015f);
+        GLState::lightf(GL_LIGHT2, GL_QUADRATIC_ATTENUATION, 0.003f);
     } else {
-        glDisable(GL_LIGHT2);
+        GLState::disable(GL_LIGHT2);
     }
     
     // GL_LIGHT3: Dynamic Plane Landing Lights (forward spotlight)
@@ -1287,52 +1072,52 @@ void Level1::render() {
         GLfloat planeLightDir[] = { flightSim->player.forward.x, flightSim->player.forward.y, flightSim->player.forward.z };
         GLfloat planeDiffuse[] = { 1.0f, 1.0f, 0.95f, 1.0f };
         
-        glEnable(GL_LIGHT3);
-        glLightfv(GL_LIGHT3, GL_POSITION, planeLightPos);
-        glLightfv(GL_LIGHT3, GL_SPOT_DIRECTION, planeLightDir);
-        glLightfv(GL_LIGHT3, GL_DIFFUSE, planeDiffuse);
-        glLightfv(GL_LIGHT3, GL_SPECULAR, planeDiffuse);
-        glLightf(GL_LIGHT3, GL_SPOT_CUTOFF, 25.0f);  // 25 degree cone
-        glLightf(GL_LIGHT3, GL_SPOT_EXPONENT, 15.0f);  // Focused beam
-        glLightf(GL_LIGHT3, GL_CONSTANT_ATTENUATION, 1.0f);
-        glLightf(GL_LIGHT3, GL_LINEAR_ATTENUATION, 0.05f);
-        glLightf(GL_LIGHT3, GL_QUADRATIC_ATTENUATION, 0.01f);
+        GLState::enable(GL_LIGHT3);
+        GLState::lightfv(GL_LIGHT3, GL_POSITION, planeLightPos);
+        GLState::lightfv(GL_LIGHT3, GL_SPOT_DIRECTION, planeLightDir);
+        GLState::lightfv(GL_LIGHT3, GL_DIFFUSE, planeDiffuse);
+        GLState::lightfv(GL_LIGHT3, GL_SPECULAR, planeDiffuse);
+        GLState::lightf(GL_LIGHT3, GL_SPOT_CUTOFF, 25.0f);  // 25 degree cone
+        GLState::lightf(GL_LIGHT3, GL_SPOT_EXPONENT, 15.0f);  // Focused beam
+        GLState::lightf(GL_LIGHT3, GL_CONSTANT_ATTENUATION, 1.0f);
+        GLState::lightf(GL_LIGHT3, GL_LINEAR_ATTENUATION, 0.05f);
+        GLState::lightf(GL_LIGHT3, GL_QUADRATIC_ATTENUATION, 0.01f);
     } else {
-        glDisable(GL_LIGHT3);
+        GLState::disable(GL_LIGHT3);
     }
     
     // GL_LIGHT4: Secondary Fill Light (opposite side of sun for softer shadows)
     GLfloat fillLightPos[] = { -0.5f, 0.3f, 0.5f, 0.0f };  // Directional fill
     GLfloat fillDiffuse[] = { 0.25f, 0.28f, 0.35f, 1.0f };  // Cool blue fill
     GLfloat fillSpecular[] = { 0.1f, 0.1f, 0.15f, 1.0f };
-    glEnable(GL_LIGHT4);
-    glLightfv(GL_LIGHT4, GL_POSITION, fillLightPos);
-    glLightfv(GL_LIGHT4, GL_DIFFUSE, fillDiffuse);
-    glLightfv(GL_LIGHT4, GL_SPECULAR, fillSpecular);
+    GLState::enable(GL_LIGHT4);
+    GLState::lightfv(GL_LIGHT4, GL_POSITION, fillLightPos);
+    GLState::lightfv(GL_LIGHT4, GL_DIFFUSE, fillDiffuse);
+    GLState::lightfv(GL_LIGHT4, GL_SPECULAR, fillSpecular);
     GLfloat noAmbient[] = { 0.0f, 0.0f, 0.0f, 1.0f };
-    glLightfv(GL_LIGHT4, GL_AMBIENT, noAmbient);
+    GLState::lightfv(GL_LIGHT4, GL_AMBIENT, noAmbient);
     
     // GL_LIGHT5: Rim/Back Light for better object definition
     GLfloat rimLightPos[] = { 0.0f, 0.8f, -1.0f, 0.0f };  // From behind/above
     GLfloat rimDiffuse[] = { 0.3f, 0.32f, 0.4f, 1.0f };   // Subtle rim light
     GLfloat rimSpecular[] = { 0.5f, 0.5f, 0.6f, 1.0f };   // Stronger specular for rim
-    glEnable(GL_LIGHT5);
-    glLightfv(GL_LIGHT5, GL_POSITION, rimLightPos);
-    glLightfv(GL_LIGHT5, GL_DIFFUSE, rimDiffuse);
-    glLightfv(GL_LIGHT5, GL_SPECULAR, rimSpecular);
-    glLightfv(GL_LIGHT5, GL_AMBIENT, noAmbient);
+    GLState::enable(GL_LIGHT5);
+    GLState::lightfv(GL_LIGHT5, GL_POSITION, rimLightPos);
+    GLState::lightfv(GL_LIGHT5, GL_DIFFUSE, rimDiffuse);
+    GLState::lightfv(GL_LIGHT5, GL_SPECULAR, rimSpecular);
+    GLState::lightfv(GL_LIGHT5, GL_AMBIENT, noAmbient);
     
     // GL_LIGHT6: Water Reflection Light (bounced light from ocean)
     if (!isNight) {
         GLfloat waterReflectPos[] = { 0.0f, -1.0f, 0.0f, 0.0f };  // From below (water reflection)
         GLfloat waterReflectDiffuse[] = { 0.15f, 0.2f, 0.25f, 1.0f };  // Blue-ish water bounce
-        glEnable(GL_LIGHT6);
-        glLightfv(GL_LIGHT6, GL_POSITION, waterReflectPos);
-        glLightfv(GL_LIGHT6, GL_DIFFUSE, waterReflectDiffuse);
-        glLightfv(GL_LIGHT6, GL_SPECULAR, noAmbient);  // No specular from water
-        glLightfv(GL_LIGHT6, GL_AMBIENT, noAmbient);
+        GLState::enable(GL_LIGHT6);
+        GLState::lightfv(GL_LIGHT6, GL_POSITION, waterReflectPos);
+        GLState::lightfv(GL_LIGHT6, GL_DIFFUSE, waterReflectDiffuse);
+        GLState::lightfv(GL_LIGHT6, GL_SPECULAR, noAmbient);  // No specular from water
+        GLState::lightfv(GL_LIGHT6, GL_AMBIENT, noAmbient);
     } else {
-        glDisable(GL_LIGHT6);
+        GLState::disable(GL_LIGHT6);
     }
     
     // Set global ambient light
@@ -1343,10 +1128,10 @@ void Level1::render() {
     glLightModelfv(GL_LIGHT_MODEL_AMBIENT, globalAmbient);
     
     // DISABLE FOG for Level 1 to match user request and fix "flat blue" water
-    glDisable(GL_FOG);
+    GLState::disable(GL_FOG);
     
     /* ===== ATMOSPHERIC FOG FOR DEPTH =====
-    glEnable(GL_FOG);
+    GLState::enable(GL_FOG);
     glFogi(GL_FOG_MODE, GL_EXP2);  // Exponential fog for realistic atmosphere
     
     // Dynamic fog color based on time of day
@@ -1402,7 +1187,7 @@ void Level1::render() {
     
     // Render game elements
     renderRings();
-    renderToolkits();
+    drawScene();  // Queued models (port props, boat hulls, toolkits)
     renderRockets();
     
     // Render bullets and explosions from shooting system
@@ -1441,154 +1226,93 @@ void Level1::render() {
 
 void Level1::renderWater() {
     // Reset material state to prevent metallic appearance
-    glDisable(GL_LIGHTING);
-    glDisable(GL_FOG); // Ensure fog is disabled for water
-    glDisable(GL_COLOR_MATERIAL);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_FOG); // Ensure fog is disabled for water
+    GLState::disable(GL_COLOR_MATERIAL);
     // Reset material to white
     GLfloat white[] = {1.0f, 1.0f, 1.0f, 1.0f};
     glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, white);
     glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, white);
     glMaterialf(GL_FRONT_AND_BACK, GL_SHININESS, 0.0f);
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, tex_water);
+    GLState::enable(GL_TEXTURE_2D);
+    GLState::bindTexture(tex_water);
     glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE); // CHANGED TO MODULATE for Navy Blue tint
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
-    float size = 6000.0f;
-    float texScale = 0.003f;
-    
-    // Animated texture offset - slides the water texture
+    // Same scroll as the old main layer, so the texture keeps drifting
     float timeOffset = ringTimer * 0.05f;  // Slow sliding motion
     float waveOffset = sin(ringTimer * 0.3f) * 0.02f;  // Gentle wave motion
+    float scroll = timeOffset + waveOffset;
     
-    // Multiple water layers for depth effect
-    // Layer 1: Deep water (darker, slower) - ADJUSTED LIGHTER
-    glColor4f(0.05f, 0.1f, 0.35f, 1.0f); // Medium deep blue
-    glBegin(GL_QUADS);
-    float offset1 = timeOffset * 0.3f;
-    glTexCoord2f(offset1, offset1 + waveOffset);
-    glVertex3f(-size, waterLevel - 1.0f, -size);
-    glTexCoord2f(size * texScale * 2 + offset1, offset1 + waveOffset);
-    glVertex3f(size, waterLevel - 1.0f, -size);
-    glTexCoord2f(size * texScale * 2 + offset1, size * texScale * 2 + offset1 - waveOffset);
-    glVertex3f(size, waterLevel - 1.0f, size);
-    glTexCoord2f(offset1, size * texScale * 2 + offset1 - waveOffset);
-    glVertex3f(-size, waterLevel - 1.0f, size);
-    glEnd();
-    
-    // Layer 2: Main water surface (medium blue, main animation) - ADJUSTED LIGHTER
-    glColor4f(0.1f, 0.25f, 0.55f, 0.9f); // Lighter blue
-    glBegin(GL_QUADS);
-    float offset2 = timeOffset + waveOffset;
-    glTexCoord2f(offset2, -offset2 * 0.5f);
-    glVertex3f(-size, waterLevel - 0.2f, -size);
-    glTexCoord2f(size * texScale * 2 + offset2, -offset2 * 0.5f);
-    glVertex3f(size, waterLevel - 0.2f, -size);
-    glTexCoord2f(size * texScale * 2 + offset2, size * texScale * 2 - offset2 * 0.5f);
-    glVertex3f(size, waterLevel - 0.2f, size);
-    glTexCoord2f(offset2, size * texScale * 2 - offset2 * 0.5f);
-    glVertex3f(-size, waterLevel - 0.2f, size);
-    glEnd();
-    
-    // Layer 3: Surface highlights (lighter, faster, more transparent) - UPDATED SUBTLER
-    glColor4f(0.1f, 0.2f, 0.4f, 0.25f);
-    glBegin(GL_QUADS);
-    float offset3 = timeOffset * 1.5f - waveOffset * 2.0f;
-    float texScale2 = texScale * 1.5f;  // Different scale for variety
-    glTexCoord2f(-offset3, offset3 * 0.7f);
-    glVertex3f(-size, waterLevel + 0.05f, -size);
-    glTexCoord2f(size * texScale2 * 2 - offset3, offset3 * 0.7f);
-    glVertex3f(size, waterLevel + 0.05f, -size);
-    glTexCoord2f(size * texScale2 * 2 - offset3, size * texScale2 * 2 + offset3 * 0.7f);
-    glVertex3f(size, waterLevel + 0.05f, size);
-    glTexCoord2f(-offset3, size * texScale2 * 2 + offset3 * 0.7f);
-    glVertex3f(-size, waterLevel + 0.05f, size);
-    glEnd();
-    
-    // Foam/whitecap layer near carrier (extra detail)
-    if (flightSim) {
-        float px = flightSim->player.position.x;
-        float pz = flightSim->player.position.z;
-        float foamSize = 300.0f;
-        float foamPulse = 0.3f + 0.1f * sin(ringTimer * 2.0f);
-        
-        glColor4f(0.7f, 0.8f, 0.9f, foamPulse);
-        glBegin(GL_QUADS);
-        float foamOffset = timeOffset * 2.0f;
-        glTexCoord2f(foamOffset, foamOffset);
-        glVertex3f(px - foamSize, waterLevel + 0.2f, pz - foamSize);
-        glTexCoord2f(foamOffset + 2.0f, foamOffset);
-        glVertex3f(px + foamSize, waterLevel + 0.2f, pz - foamSize);
-        glTexCoord2f(foamOffset + 2.0f, foamOffset + 2.0f);
-        glVertex3f(px + foamSize, waterLevel + 0.2f, pz + foamSize);
-        glTexCoord2f(foamOffset, foamOffset + 2.0f);
-        glVertex3f(px - foamSize, waterLevel + 0.2f, pz + foamSize);
-        glEnd();
+    // Waves, slope shading and crest foam are all in the ocean's vertex colors
+    if (viewFrustum.isValid()) {
+        ocean.draw(viewFrustum.getClipMatrix(), 0.003f, scroll, -scroll * 0.5f);
     }
     
     // Sea foam where water meets port edge and carrier (MORE PROMINENT)
-    glDisable(GL_TEXTURE_2D);
+    GLState::disable(GL_TEXTURE_2D);
     
     float portX = 450.0f;
     float foamWidth = 15.0f;  // Wider foam strip
     float foamSize = 1500.0f;
     
     // Foam along port edge - brighter and more visible
+    // Short steps, so the strips follow the swell instead of cutting through it
     glColor4f(1.0f, 1.0f, 1.0f, 0.85f + 0.15f * sin(ringTimer * 2.0f));
-    glBegin(GL_QUAD_STRIP);
-    for (float z = -foamSize; z <= foamSize; z += 40.0f) {
+    beginWater(GL_QUAD_STRIP);
+    for (float z = -foamSize; z <= foamSize; z += 10.0f) {
         float wave = sin(z * 0.01f + ringTimer) * 2.5f;
-        glVertex3f(portX + wave, waterLevel + 0.4f, z);
-        glVertex3f(portX + foamWidth + wave, waterLevel + 0.4f, z);
+        waterVertex(portX + wave, z, 0.4f);
+        waterVertex(portX + foamWidth + wave, z, 0.4f);
     }
-    glEnd();
+    endWater();
     
     // Additional inner foam layer for more visibility
     glColor4f(0.95f, 0.98f, 1.0f, 0.6f + 0.3f * sin(ringTimer * 3.0f));
-    glBegin(GL_QUAD_STRIP);
-    for (float z = -foamSize; z <= foamSize; z += 40.0f) {
+    beginWater(GL_QUAD_STRIP);
+    for (float z = -foamSize; z <= foamSize; z += 10.0f) {
         float wave = sin(z * 0.015f + ringTimer * 1.5f) * 2.0f;
-        glVertex3f(portX + foamWidth + wave, waterLevel + 0.45f, z);
-        glVertex3f(portX + foamWidth * 2.0f + wave, waterLevel + 0.45f, z);
+        waterVertex(portX + foamWidth + wave, z, 0.45f);
+        waterVertex(portX + foamWidth * 2.0f + wave, z, 0.45f);
     }
-    glEnd();
+    endWater();
     
     // Foam around carrier (circular pattern) - more prominent
     Vector3f carrierCenter = carrierPosition;
     float carrierRadius = 30.0f;
     
     // Outer foam ring
-    glBegin(GL_TRIANGLE_FAN);
-    glColor4f(1.0f, 1.0f, 1.0f, 0.9f);
-    glVertex3f(carrierCenter.x, waterLevel + 0.4f, carrierCenter.z);
+    beginWater(GL_TRIANGLE_FAN);
+    waterColor(1.0f, 1.0f, 1.0f, 0.9f);
+    waterVertex(carrierCenter.x, carrierCenter.z, 0.4f);
     for (int i = 0; i <= 32; i++) {
         float angle = (float)i / 32.0f * 6.28318f;
         float wave = sin(angle * 3.0f + ringTimer * 2.0f) * 3.0f;
         float x = carrierCenter.x + cos(angle) * (carrierRadius + wave);
         float z = carrierCenter.z + sin(angle) * (carrierRadius + wave);
-        glColor4f(1.0f, 1.0f, 1.0f, 0.75f + 0.15f * sin(angle * 2.0f + ringTimer));
-        glVertex3f(x, waterLevel + 0.4f, z);
+        waterColor(1.0f, 1.0f, 1.0f, 0.75f + 0.15f * sin(angle * 2.0f + ringTimer));
+        waterVertex(x, z, 0.4f);
     }
-    glEnd();
+    endWater();
     
     // Inner foam ring for carrier
-    glBegin(GL_TRIANGLE_FAN);
-    glColor4f(0.95f, 0.98f, 1.0f, 0.8f);
-    glVertex3f(carrierCenter.x, waterLevel + 0.45f, carrierCenter.z);
+    beginWater(GL_TRIANGLE_FAN);
+    waterColor(0.95f, 0.98f, 1.0f, 0.8f);
+    waterVertex(carrierCenter.x, carrierCenter.z, 0.45f);
     for (int i = 0; i <= 32; i++) {
         float angle = (float)i / 32.0f * 6.28318f;
         float wave = sin(angle * 4.0f + ringTimer * 2.5f) * 2.0f;
         float x = carrierCenter.x + cos(angle) * (carrierRadius + 10.0f + wave);
         float z = carrierCenter.z + sin(angle) * (carrierRadius + 10.0f + wave);
-        glColor4f(0.95f, 0.98f, 1.0f, 0.6f + 0.2f * sin(angle * 3.0f + ringTimer * 1.5f));
-        glVertex3f(x, waterLevel + 0.45f, z);
+        waterColor(0.95f, 0.98f, 1.0f, 0.6f + 0.2f * sin(angle * 3.0f + ringTimer * 1.5f));
+        waterVertex(x, z, 0.45f);
     }
-    glEnd();
+    endWater();
     
-    glDisable(GL_BLEND);
-    glEnable(GL_LIGHTING);
-    glEnable(GL_COLOR_MATERIAL);
+    GLState::disable(GL_BLEND);
+    GLState::enable(GL_LIGHTING);
+    GLState::enable(GL_COLOR_MATERIAL);
     glColor3f(1.0f, 1.0f, 1.0f);
     
     // CRITICAL FIX: Restore texture environment to default (MODULATE)
@@ -1596,59 +1320,89 @@ void Level1::renderWater() {
     glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
 }
 
-void Level1::renderBoats() {
-    if (boats.empty()) return;
-
-    // Set material properties for boats (metal hull)
-    GLfloat boatAmbient[] = { 0.25f, 0.25f, 0.3f, 1.0f };
-    GLfloat boatDiffuse[] = { 0.6f, 0.6f, 0.65f, 1.0f };
-    GLfloat boatSpecular[] = { 0.7f, 0.7f, 0.75f, 1.0f };
-    GLfloat boatShininess = 40.0f;  // Shiny metal hull
-    glMaterialfv(GL_FRONT, GL_AMBIENT, boatAmbient);
-    glMaterialfv(GL_FRONT, GL_DIFFUSE, boatDiffuse);
-    glMaterialfv(GL_FRONT, GL_SPECULAR, boatSpecular);
-    glMaterialf(GL_FRONT, GL_SHININESS, boatShininess);
+void Level1::beginWater(GLenum mode) {
+    waterMode = mode;
+    waterColored = false;
+    waterX.clear();
+    waterZ.clear();
+    waterLift.clear();
+    waterColors.clear();
+}
 
-    for (const auto& boat : boats) {
-        glPushMatrix();
-        glTranslatef(boat.position.x, boat.position.y, boat.position.z);
+void Level1::waterColor(float r, float g, float b, float a) {
+    waterColored = true;
+    waterCurrentColor[0] = r;
+    waterCurrentColor[1] = g;
+    waterCurrentColor[2] = b;
+    waterCurrentColor[3] = a;
+}
 
-        Vector3f dir = boat.forwardDir * (boat.movingForward ? 1.0f : -1.0f);
-        float yaw = atan2(dir.x, dir.z) * 180.0f / 3.14159f;
-        glRotatef(yaw + 180.0f, 0, 1, 0);
+void Level1::waterVertex(float x, float z, float lift) {
+    waterX.push_back(x);
+    waterZ.push_back(z);
+    waterLift.push_back(lift);
+    if (waterColored) {
+        waterColors.insert(waterColors.end(), waterCurrentColor, waterCurrentColor + 4);
+    }
+}
 
-        float roll = sin(ringTimer * boat.bobSpeed * 0.8f + boat.phase) * 2.0f;
-        glRotatef(roll, 0, 0, 1);
+void Level1::endWater() {
+    int count = (int)waterX.size();
+    if (count == 0) return;
+
+    // Skip the lookup for decals out of view
+    float minX = waterX[0], maxX = waterX[0], minZ = waterZ[0], maxZ = waterZ[0];
+    for (int i = 1; i < count; i++) {
+        minX = std::min(minX, waterX[i]);
+        maxX = std::max(maxX, waterX[i]);
+        minZ = std::min(minZ, waterZ[i]);
+        maxZ = std::max(maxZ, waterZ[i]);
+    }
+    float halfX = (maxX - minX) * 0.5f;
+    float halfZ = (maxZ - minZ) * 0.5f;
+    float radius = sqrt(halfX * halfX + halfZ * halfZ) + ocean.getAmplitude() + 1.0f;
+    if (!viewFrustum.testSphere(minX + halfX, waterLevel, minZ + halfZ, radius)) return;
+
+    waterHeights.resize(count);
+    ocean.getHeights(&waterX[0], &waterZ[0], &waterHeights[0], count);
+
+    glBegin(waterMode);
+    for (int i = 0; i < count; i++) {
+        if (waterColored) {
+            glColor4fv(&waterColors[i * 4]);
+        }
+        glVertex3f(waterX[i], waterHeights[i] + waterLift[i], waterZ[i]);
+    }
+    glEnd();
+}
 
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, tex_boat);
-        glColor3f(1.0f, 1.0f, 1.0f);
-        glScalef(10.5f, 10.5f, 10.5f);
-        model_boat.Draw();
-        glPopMatrix();
+void Level1::renderBoats() {
+    if (boats.empty()) return;
 
+    // Hulls are queued (recordBoats); this draws the foam and wakes
+    for (const auto& boat : boats) {
         // Wake and foam around hull
-        glDisable(GL_TEXTURE_2D);
-        glDisable(GL_LIGHTING);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        GLState::disable(GL_TEXTURE_2D);
+        GLState::disable(GL_LIGHTING);
+        GLState::enable(GL_BLEND);
+        GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
         // Foam ring around hull
         float foamAlpha = boat.isMoving ? 0.5f : 0.55f;
         float foamRadius = boat.isMoving ? 18.0f : 20.0f;
         glColor4f(0.95f, 0.98f, 1.0f, foamAlpha);
-        glBegin(GL_TRIANGLE_FAN);
-        glVertex3f(boat.position.x, waterLevel + 0.5f, boat.position.z);
+        beginWater(GL_TRIANGLE_FAN);
+        waterVertex(boat.position.x, boat.position.z, 0.5f);
         for (int i = 0; i <= 24; i++) {
             float angle = (float)i / 24.0f * 6.28318f;
             float wave = sin(angle * 3.0f + ringTimer * 2.0f + boat.phase) * 1.8f;
-            glVertex3f(
+            waterVertex(
                 boat.position.x + cos(angle) * (foamRadius + wave),
-                waterLevel + 0.5f,
-                boat.position.z + sin(angle) * (foamRadius + wave)
+                boat.position.z + sin(angle) * (foamRadius + wave),
+                0.5f
             );
         }
-        glEnd();
+        endWater();
 
         // Wake effects for moving boats
         if (boat.isMoving && boat.pathLength > 0.001f) {
@@ -1661,27 +1415,27 @@ void Level1::renderBoats() {
 
                 // Bow wave (white foam at front)
                 Vector3f bowPos = boat.position + dirNorm * 12.0f;
-                glColor4f(1.0f, 1.0f, 1.0f, 0.7f);
-                glBegin(GL_TRIANGLE_FAN);
-                glVertex3f(bowPos.x, waterLevel + 0.6f, bowPos.z);
+                beginWater(GL_TRIANGLE_FAN);
+                waterColor(1.0f, 1.0f, 1.0f, 0.7f);
+                waterVertex(bowPos.x, bowPos.z, 0.6f);
                 for (int i = 0; i <= 12; i++) {
                     float angle = (float)i / 12.0f * 3.14159f - 1.5708f;
                     float r = 6.0f + sin(ringTimer * 4.0f + (float)i) * 1.0f;
-                    glColor4f(1.0f, 1.0f, 1.0f, 0.5f - (float)i * 0.03f);
-                    glVertex3f(
+                    waterColor(1.0f, 1.0f, 1.0f, 0.5f - (float)i * 0.03f);
+                    waterVertex(
                         bowPos.x + cos(angle) * r * dirNorm.x + sin(angle) * r * right.x,
-                        waterLevel + 0.55f,
-                        bowPos.z + cos(angle) * r * dirNorm.z + sin(angle) * r * right.z
+                        bowPos.z + cos(angle) * r * dirNorm.z + sin(angle) * r * right.z,
+                        0.55f
                     );
                 }
-                glEnd();
+                endWater();
 
                 // V-shaped wake trail (left arm)
                 float wakeLen = 60.0f + boat.moveSpeed * 1.5f;
                 float spreadAngle = 0.35f;
                 Vector3f sternPos = boat.position - dirNorm * 10.0f;
 
-                glBegin(GL_QUAD_STRIP);
+                beginWater(GL_QUAD_STRIP);
                 for (int s = 0; s <= 10; s++) {
                     float t = (float)s / 10.0f;
                     float dist = t * wakeLen;
@@ -1694,14 +1448,14 @@ void Level1::renderBoats() {
                     leftDir = leftDir * (1.0f / leftLen);
 
                     Vector3f pos = sternPos + leftDir * dist;
-                    glColor4f(1.0f, 1.0f, 1.0f, alpha);
-                    glVertex3f(pos.x - right.x * width + waveOff, waterLevel + 0.4f, pos.z - right.z * width);
-                    glVertex3f(pos.x + right.x * width + waveOff, waterLevel + 0.4f, pos.z + right.z * width);
+                    waterColor(1.0f, 1.0f, 1.0f, alpha);
+                    waterVertex(pos.x - right.x * width + waveOff, pos.z - right.z * width, 0.4f);
+                    waterVertex(pos.x + right.x * width + waveOff, pos.z + right.z * width, 0.4f);
                 }
-                glEnd();
+                endWater();
 
                 // V-shaped wake trail (right arm)
-                glBegin(GL_QUAD_STRIP);
+                beginWater(GL_QUAD_STRIP);
                 for (int s = 0; s <= 10; s++) {
                     float t = (float)s / 10.0f;
                     float dist = t * wakeLen;
@@ -1714,14 +1468,14 @@ void Level1::renderBoats() {
                     rightDir = rightDir * (1.0f / rightDirLen);
 
                     Vector3f pos = sternPos + rightDir * dist;
-                    glColor4f(1.0f, 1.0f, 1.0f, alpha);
-                    glVertex3f(pos.x - right.x * width + waveOff, waterLevel + 0.4f, pos.z - right.z * width);
-                    glVertex3f(pos.x + right.x * width + waveOff, waterLevel + 0.4f, pos.z + right.z * width);
+                    waterColor(1.0f, 1.0f, 1.0f, alpha);
+                    waterVertex(pos.x - right.x * width + waveOff, pos.z - right.z * width, 0.4f);
+                    waterVertex(pos.x + right.x * width + waveOff, pos.z + right.z * width, 0.4f);
                 }
-                glEnd();
+                endWater();
 
                 // Center turbulence strip
-                glBegin(GL_QUAD_STRIP);
+                beginWater(GL_QUAD_STRIP);
                 for (int s = 0; s <= 12; s++) {
                     float t = (float)s / 12.0f;
                     float dist = t * wakeLen * 0.7f;
@@ -1730,99 +1484,125 @@ void Level1::renderBoats() {
                     float waveOff = sin(ringTimer * 5.0f + t * 10.0f) * 1.2f;
 
                     Vector3f pos = sternPos - dirNorm * dist;
-                    glColor4f(0.9f, 0.95f, 1.0f, alpha);
-                    glVertex3f(pos.x - right.x * width, waterLevel + 0.45f + waveOff * 0.1f, pos.z - right.z * width);
-                    glVertex3f(pos.x + right.x * width, waterLevel + 0.45f + waveOff * 0.1f, pos.z + right.z * width);
+                    waterColor(0.9f, 0.95f, 1.0f, alpha);
+                    waterVertex(pos.x - right.x * width, pos.z - right.z * width, 0.45f + waveOff * 0.1f);
+                    waterVertex(pos.x + right.x * width, pos.z + right.z * width, 0.45f + waveOff * 0.1f);
                 }
-                glEnd();
+                endWater();
             }
         }
 
-        glDisable(GL_BLEND);
-        glEnable(GL_LIGHTING);
-        glEnable(GL_TEXTURE_2D);
+        GLState::disable(GL_BLEND);
+        GLState::enable(GL_LIGHTING);
+        GLState::enable(GL_TEXTURE_2D);
     }
 }
 
-void Level1::renderPort() {
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, tex_concrete);
-    glDisable(GL_LIGHTING);
+void Level1::buildPortBatches() {
+    portBatch.release();
+    portLightPosts.release();
+    portLightGlows.release();
+    portLightHalos.release();
     
     // Make port much larger and more extensive
     float size = 1500.0f;  // Doubled from 800 to 1500
     float portX = 450.0f;  // Moved slightly further right
     float portDepth = 600.0f;  // How far the port extends
-    
-    // Main port concrete area - larger perimeter
-    glColor3f(0.6f, 0.6f, 0.65f);
-    glBegin(GL_QUADS);
     float texScale = 0.01f;
     
-    glTexCoord2f(0, 0);
-    glVertex3f(portX, portHeight, -size);
-    glTexCoord2f(portDepth * texScale, 0);
-    glVertex3f(portX + portDepth, portHeight, -size);
-    glTexCoord2f(portDepth * texScale, size * texScale * 2);
-    glVertex3f(portX + portDepth, portHeight, size);
-    glTexCoord2f(0, size * texScale * 2);
-    glVertex3f(portX, portHeight, size);
-    glEnd();
+    // Main port concrete area - larger perimeter
+    portBatch.setMaterial(tex_concrete, false);
+    portBatch.color(0.6f, 0.6f, 0.65f);
+    portBatch.begin(StaticBatch::QUADS);
+    portBatch.texCoord(0, 0);
+    portBatch.vertex(portX, portHeight, -size);
+    portBatch.texCoord(portDepth * texScale, 0);
+    portBatch.vertex(portX + portDepth, portHeight, -size);
+    portBatch.texCoord(portDepth * texScale, size * texScale * 2);
+    portBatch.vertex(portX + portDepth, portHeight, size);
+    portBatch.texCoord(0, size * texScale * 2);
+    portBatch.vertex(portX, portHeight, size);
+    portBatch.end();
     
     // Port edge wall (between water and port) - taller and more defined
-    glColor3f(0.35f, 0.35f, 0.4f);
-    glBegin(GL_QUADS);
-    glVertex3f(portX, waterLevel, -size);
-    glVertex3f(portX, portHeight + 2.0f, -size);
-    glVertex3f(portX, portHeight + 2.0f, size);
-    glVertex3f(portX, waterLevel, size);
-    glEnd();
+    // (keeps the slab's last texture coordinate, as it always has)
+    portBatch.color(0.35f, 0.35f, 0.4f);
+    portBatch.begin(StaticBatch::QUADS);
+    portBatch.vertex(portX, waterLevel, -size);
+    portBatch.vertex(portX, portHeight + 2.0f, -size);
+    portBatch.vertex(portX, portHeight + 2.0f, size);
+    portBatch.vertex(portX, waterLevel, size);
+    portBatch.end();
     
     // Add concrete pylons/pillars along the edge
-    glDisable(GL_TEXTURE_2D);
-    glColor3f(0.4f, 0.4f, 0.45f);
+    portBatch.setMaterial(0, false);
+    portBatch.color(0.4f, 0.4f, 0.45f);
     for (float z = -size + 50.0f; z < size; z += 100.0f) {
-        glPushMatrix();
-        glTranslatef(portX, waterLevel + (portHeight - waterLevel) / 2, z);
-        glScalef(8.0f, portHeight - waterLevel + 2.0f, 8.0f);
-        glutSolidCube(1.0f);
-        glPopMatrix();
-    }
-    
-    glEnable(GL_LIGHTING);
-    
-    // Render port cranes at strategic positions
-    glPushMatrix();
-    glColor3f(0.8f, 0.7f, 0.1f);  // Yellow crane color
-    
-    // Crane 1 - Near front of port
-    glPushMatrix();
-    glTranslatef(portX + 19.0f, portHeight, -400.0f);
-    //glRotatef(45.0f, 0, 1, 0);
-    glScalef(0.0015f, 0.0015f, 0.0015f);
-    model_crane.Draw();
-    glPopMatrix();
-    
-    // Crane 2 - Middle section
-    glPushMatrix();
-    glTranslatef(portX + 19.0f, portHeight, 0.0f);
-    //glRotatef(-30.0f, 0, 1, 0);
-    glScalef(0.0015f, 0.0015f, 0.0015f);
-    model_crane.Draw();
-    glPopMatrix();
-    
-    // Crane 3 - Back section
-    glPushMatrix();
-    glTranslatef(portX + 19.0f, portHeight, 450.0f);
-    glRotatef(90.0f, 0, 1, 0);
-    glScalef(0.0015f, 0.0015f, 0.0015f);
-    model_crane.Draw();
-    glPopMatrix();
-    
-    glPopMatrix();
-    
-    // Render shipping containers in organized stacks
-    glPushMatrix();
+        RenderMatrix pylon;
+        pylon.translate(portX, waterLevel + (portHeight - waterLevel) / 2, z);
+        pylon.scale(8.0f, portHeight - waterLevel + 2.0f, 8.0f);
+        portBatch.setTransform(pylon);
+        portBatch.addCube(1.0f);
+    }
+    portBatch.resetTransform();
+    
+    // Shipping containers in organized stacks, textured boxes (20ft container proportions)
+    float containerLength = 2*9.0f;
+    float containerWidth = 2*3.6f;
+    float containerHeight = 2*3.9f;
+    auto addContainer = [&](float x, float y, float z, float rotation, GLuint texture) {
+        RenderMatrix placement;
+        placement.translate(x, y, z);
+        placement.rotate(rotation, 0, 1, 0);
+        portBatch.setMaterial(texture, true);
+        portBatch.setTransform(placement);
+        portBatch.color(1.0f, 1.0f, 1.0f);
+        portBatch.begin(StaticBatch::QUADS);
+        
+        // Front face
+        portBatch.normal(0.0f, 0.0f, 1.0f);
+        portBatch.texCoord(0.0f, 0.0f); portBatch.vertex(-containerLength/2, 0.0f, containerWidth/2);
+        portBatch.texCoord(1.0f, 0.0f); portBatch.vertex(containerLength/2, 0.0f, containerWidth/2);
+        portBatch.texCoord(1.0f, 1.0f); portBatch.vertex(containerLength/2, containerHeight, containerWidth/2);
+        portBatch.texCoord(0.0f, 1.0f); portBatch.vertex(-containerLength/2, containerHeight, containerWidth/2);
+        
+        // Back face
+        portBatch.normal(0.0f, 0.0f, -1.0f);
+        portBatch.texCoord(1.0f, 0.0f); portBatch.vertex(-containerLength/2, 0.0f, -containerWidth/2);
+        portBatch.texCoord(1.0f, 1.0f); portBatch.vertex(-containerLength/2, containerHeight, -containerWidth/2);
+        portBatch.texCoord(0.0f, 1.0f); portBatch.vertex(containerLength/2, containerHeight, -containerWidth/2);
+        portBatch.texCoord(0.0f, 0.0f); portBatch.vertex(containerLength/2, 0.0f, -containerWidth/2);
+        
+        // Left face
+        portBatch.normal(-1.0f, 0.0f, 0.0f);
+        portBatch.texCoord(0.0f, 0.0f); portBatch.vertex(-containerLength/2, 0.0f, -containerWidth/2);
+        portBatch.texCoord(1.0f, 0.0f); portBatch.vertex(-containerLength/2, 0.0f, containerWidth/2);
+        portBatch.texCoord(1.0f, 1.0f); portBatch.vertex(-containerLength/2, containerHeight, containerWidth/2);
+        portBatch.texCoord(0.0f, 1.0f); portBatch.vertex(-containerLength/2, containerHeight, -containerWidth/2);
+        
+        // Right face
+        portBatch.normal(1.0f, 0.0f, 0.0f);
+        portBatch.texCoord(0.0f, 0.0f); portBatch.vertex(containerLength/2, 0.0f, containerWidth/2);
+        portBatch.texCoord(1.0f, 0.0f); portBatch.vertex(containerLength/2, 0.0f, -containerWidth/2);
+        portBatch.texCoord(1.0f, 1.0f); portBatch.vertex(containerLength/2, containerHeight, -containerWidth/2);
+        portBatch.texCoord(0.0f, 1.0f); portBatch.vertex(containerLength/2, containerHeight, containerWidth/2);
+        
+        // Top face
+        portBatch.normal(0.0f, 1.0f, 0.0f);
+        portBatch.texCoord(0.0f, 0.0f); portBatch.vertex(-containerLength/2, containerHeight, containerWidth/2);
+        portBatch.texCoord(1.0f, 0.0f); portBatch.vertex(containerLength/2, containerHeight, containerWidth/2);
+        portBatch.texCoord(1.0f, 1.0f); portBatch.vertex(containerLength/2, containerHeight, -containerWidth/2);
+        portBatch.texCoord(0.0f, 1.0f); portBatch.vertex(-containerLength/2, containerHeight, -containerWidth/2);
+        
+        // Bottom face
+        portBatch.normal(0.0f, -1.0f, 0.0f);
+        portBatch.texCoord(0.0f, 1.0f); portBatch.vertex(-containerLength/2, 0.0f, containerWidth/2);
+        portBatch.texCoord(0.0f, 0.0f); portBatch.vertex(-containerLength/2, 0.0f, -containerWidth/2);
+        portBatch.texCoord(1.0f, 0.0f); portBatch.vertex(containerLength/2, 0.0f, -containerWidth/2);
+        portBatch.texCoord(1.0f, 1.0f); portBatch.vertex(containerLength/2, 0.0f, containerWidth/2);
+        
+        portBatch.end();
+    };
     
     // Container yard 1 - organized rows
     float containerBaseX = portX + 300.0f;
@@ -1835,84 +1615,16 @@ void Level1::renderPort() {
         {3, 1, 2, 3, 2, 1},
         {2, 2, 1, 2, 3, 2}
     };
+    GLuint yard1Textures[3] = { tex_container_red, tex_container_blue, tex_container_yellow };
     
     for (int row = 0; row < 4; row++) {
         for (int col = 0; col < 6; col++) {
-            int stackHeight = stackHeights1[row][col];
-            
-            for (int height = 0; height < stackHeight; height++) {
-                glPushMatrix();
-                glTranslatef(
-                    containerBaseX + row * 35.0f,
-                    portHeight + 0.5f + height * 7.5f,  // Lower to ground level
-                    containerBaseZ + col * 40.0f
-                );
-                glRotatef(90.0f * (row % 2), 0, 1, 0);  // Alternate rotation
-                
-                // Draw textured box instead of 3DS model to ensure textures work
-                glEnable(GL_TEXTURE_2D);
-                
-                // Select texture based on color variation
-                if ((row + col + height) % 3 == 0)
-                    glBindTexture(GL_TEXTURE_2D, tex_container_red);
-                else if ((row + col + height) % 3 == 1)
-                    glBindTexture(GL_TEXTURE_2D, tex_container_blue);
-                else
-                    glBindTexture(GL_TEXTURE_2D, tex_container_yellow);
-                
-                // Draw shipping container as textured box (20ft container proportions)
-                float containerLength = 2*9.0f;
-                float containerWidth = 2*3.6f;
-                float containerHeight = 2*3.9f;
-                
-                glBegin(GL_QUADS);
-                glColor3f(1.0f, 1.0f, 1.0f);
-                
-                // Front face
-                glNormal3f(0.0f, 0.0f, 1.0f);
-                glTexCoord2f(0.0f, 0.0f); glVertex3f(-containerLength/2, 0.0f, containerWidth/2);
-                glTexCoord2f(1.0f, 0.0f); glVertex3f(containerLength/2, 0.0f, containerWidth/2);
-                glTexCoord2f(1.0f, 1.0f); glVertex3f(containerLength/2, containerHeight, containerWidth/2);
-                glTexCoord2f(0.0f, 1.0f); glVertex3f(-containerLength/2, containerHeight, containerWidth/2);
-                
-                // Back face
-                glNormal3f(0.0f, 0.0f, -1.0f);
-                glTexCoord2f(1.0f, 0.0f); glVertex3f(-containerLength/2, 0.0f, -containerWidth/2);
-                glTexCoord2f(1.0f, 1.0f); glVertex3f(-containerLength/2, containerHeight, -containerWidth/2);
-                glTexCoord2f(0.0f, 1.0f); glVertex3f(containerLength/2, containerHeight, -containerWidth/2);
-                glTexCoord2f(0.0f, 0.0f); glVertex3f(containerLength/2, 0.0f, -containerWidth/2);
-                
-                // Left face
-                glNormal3f(-1.0f, 0.0f, 0.0f);
-                glTexCoord2f(0.0f, 0.0f); glVertex3f(-containerLength/2, 0.0f, -containerWidth/2);
-                glTexCoord2f(1.0f, 0.0f); glVertex3f(-containerLength/2, 0.0f, containerWidth/2);
-                glTexCoord2f(1.0f, 1.0f); glVertex3f(-containerLength/2, containerHeight, containerWidth/2);
-                glTexCoord2f(0.0f, 1.0f); glVertex3f(-containerLength/2, containerHeight, -containerWidth/2);
-                
-                // Right face
-                glNormal3f(1.0f, 0.0f, 0.0f);
-                glTexCoord2f(0.0f, 0.0f); glVertex3f(containerLength/2, 0.0f, containerWidth/2);
-                glTexCoord2f(1.0f, 0.0f); glVertex3f(containerLength/2, 0.0f, -containerWidth/2);
-                glTexCoord2f(1.0f, 1.0f); glVertex3f(containerLength/2, containerHeight, -containerWidth/2);
-                glTexCoord2f(0.0f, 1.0f); glVertex3f(containerLength/2, containerHeight, containerWidth/2);
-                
-                // Top face
-                glNormal3f(0.0f, 1.0f, 0.0f);
-                glTexCoord2f(0.0f, 0.0f); glVertex3f(-containerLength/2, containerHeight, containerWidth/2);
-                glTexCoord2f(1.0f, 0.0f); glVertex3f(containerLength/2, containerHeight, containerWidth/2);
-                glTexCoord2f(1.0f, 1.0f); glVertex3f(containerLength/2, containerHeight, -containerWidth/2);
-                glTexCoord2f(0.0f, 1.0f); glVertex3f(-containerLength/2, containerHeight, -containerWidth/2);
-                
-                // Bottom face
-                glNormal3f(0.0f, -1.0f, 0.0f);
-                glTexCoord2f(0.0f, 1.0f); glVertex3f(-containerLength/2, 0.0f, containerWidth/2);
-                glTexCoord2f(0.0f, 0.0f); glVertex3f(-containerLength/2, 0.0f, -containerWidth/2);
-                glTexCoord2f(1.0f, 0.0f); glVertex3f(containerLength/2, 0.0f, -containerWidth/2);
-                glTexCoord2f(1.0f, 1.0f); glVertex3f(containerLength/2, 0.0f, containerWidth/2);
-                
-                glEnd();
-                glDisable(GL_TEXTURE_2D);
-                glPopMatrix();
+            for (int height = 0; height < stackHeights1[row][col]; height++) {
+                addContainer(containerBaseX + row * 35.0f,
+                             portHeight + 0.5f + height * 7.5f,  // Lower to ground level
+                             containerBaseZ + col * 40.0f,
+                             90.0f * (row % 2),  // Alternate rotation
+                             yard1Textures[(row + col + height) % 3]);  // Color variation
             }
         }
     }
@@ -1924,206 +1636,107 @@ void Level1::renderPort() {
         {1, 2, 1, 2, 1},
         {2, 1, 2, 2, 1}
     };
+    GLuint yard2Textures[3] = { tex_container_yellow, tex_container_red, tex_container_blue };
     
     for (int row = 0; row < 3; row++) {
         for (int col = 0; col < 5; col++) {
-            int stackHeight = stackHeights2[row][col];
-            
-            for (int height = 0; height < stackHeight; height++) {
-                glPushMatrix();
-                glTranslatef(
-                    containerBaseX + row * 35.0f,
-                    portHeight + 0.5f + height * 7.5f,  // Lower to ground level
-                    containerBaseZ + col * 40.0f
-                );
-                glRotatef(90.0f * ((row + 1) % 2), 0, 1, 0);
-                
-                // Draw textured box instead of 3DS model to ensure textures work
-                glEnable(GL_TEXTURE_2D);
-                
-                // Select texture based on color variation
-                if ((row + col + height) % 3 == 0)
-                    glBindTexture(GL_TEXTURE_2D, tex_container_yellow);
-                else if ((row + col + height) % 3 == 1)
-                    glBindTexture(GL_TEXTURE_2D, tex_container_red);
-                else
-                    glBindTexture(GL_TEXTURE_2D, tex_container_blue);
-                
-                // Draw shipping container as textured box (20ft container proportions)
-                float containerLength = 2*9.0f;
-                float containerWidth = 2*3.6f;
-                float containerHeight = 2*3.9f;
-                
-                glBegin(GL_QUADS);
-                glColor3f(1.0f, 1.0f, 1.0f);
-                
-                // Front face
-                glNormal3f(0.0f, 0.0f, 1.0f);
-                glTexCoord2f(0.0f, 0.0f); glVertex3f(-containerLength/2, 0.0f, containerWidth/2);
-                glTexCoord2f(1.0f, 0.0f); glVertex3f(containerLength/2, 0.0f, containerWidth/2);
-                glTexCoord2f(1.0f, 1.0f); glVertex3f(containerLength/2, containerHeight, containerWidth/2);
-                glTexCoord2f(0.0f, 1.0f); glVertex3f(-containerLength/2, containerHeight, containerWidth/2);
-                
-                // Back face
-                glNormal3f(0.0f, 0.0f, -1.0f);
-                glTexCoord2f(1.0f, 0.0f); glVertex3f(-containerLength/2, 0.0f, -containerWidth/2);
-                glTexCoord2f(1.0f, 1.0f); glVertex3f(-containerLength/2, containerHeight, -containerWidth/2);
-                glTexCoord2f(0.0f, 1.0f); glVertex3f(containerLength/2, containerHeight, -containerWidth/2);
-                glTexCoord2f(0.0f, 0.0f); glVertex3f(containerLength/2, 0.0f, -containerWidth/2);
-                
-                // Left face
-                glNormal3f(-1.0f, 0.0f, 0.0f);
-                glTexCoord2f(0.0f, 0.0f); glVertex3f(-containerLength/2, 0.0f, -containerWidth/2);
-                glTexCoord2f(1.0f, 0.0f); glVertex3f(-containerLength/2, 0.0f, containerWidth/2);
-                glTexCoord2f(1.0f, 1.0f); glVertex3f(-containerLength/2, containerHeight, containerWidth/2);
-                glTexCoord2f(0.0f, 1.0f); glVertex3f(-containerLength/2, containerHeight, -containerWidth/2);
-                
-                // Right face
-                glNormal3f(1.0f, 0.0f, 0.0f);
-                glTexCoord2f(0.0f, 0.0f); glVertex3f(containerLength/2, 0.0f, containerWidth/2);
-                glTexCoord2f(1.0f, 0.0f); glVertex3f(containerLength/2, 0.0f, -containerWidth/2);
-                glTexCoord2f(1.0f, 1.0f); glVertex3f(containerLength/2, containerHeight, -containerWidth/2);
-                glTexCoord2f(0.0f, 1.0f); glVertex3f(containerLength/2, containerHeight, containerWidth/2);
-                
-                // Top face
-                glNormal3f(0.0f, 1.0f, 0.0f);
-                glTexCoord2f(0.0f, 0.0f); glVertex3f(-containerLength/2, containerHeight, containerWidth/2);
-                glTexCoord2f(1.0f, 0.0f); glVertex3f(containerLength/2, containerHeight, containerWidth/2);
-                glTexCoord2f(1.0f, 1.0f); glVertex3f(containerLength/2, containerHeight, -containerWidth/2);
-                glTexCoord2f(0.0f, 1.0f); glVertex3f(-containerLength/2, containerHeight, -containerWidth/2);
-                
-                // Bottom face
-                glNormal3f(0.0f, -1.0f, 0.0f);
-                glTexCoord2f(0.0f, 1.0f); glVertex3f(-containerLength/2, 0.0f, containerWidth/2);
-                glTexCoord2f(0.0f, 0.0f); glVertex3f(-containerLength/2, 0.0f, -containerWidth/2);
-                glTexCoord2f(1.0f, 0.0f); glVertex3f(containerLength/2, 0.0f, -containerWidth/2);
-                glTexCoord2f(1.0f, 1.0f); glVertex3f(containerLength/2, 0.0f, containerWidth/2);
-                
-                glEnd();
-                glDisable(GL_TEXTURE_2D);
-                glPopMatrix();
+            for (int height = 0; height < stackHeights2[row][col]; height++) {
+                addContainer(containerBaseX + row * 35.0f,
+                             portHeight + 0.5f + height * 7.5f,
+                             containerBaseZ + col * 40.0f,
+                             90.0f * ((row + 1) % 2),
+                             yard2Textures[(row + col + height) % 3]);
             }
         }
     }
     
-    glPopMatrix();
-    
-    // Render helipad on the port
-    glPushMatrix();
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glTranslatef(portX + 150.0f, portHeight + 0.1f, -700.0f);
-    glRotatef(-90.0f, 0, 1, 0);
-    glScalef(0.8f, 0.8f, 0.8f);  // Increased from 0.5f
-    model_helipad.Draw();
-    glPopMatrix();
-    
-    // Render tents near the port edge
-    // Tent 1
-    glPushMatrix();
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glTranslatef(portX + 100.0f, portHeight + 0.1f, -200.0f);
-    glRotatef(180.0f, 0, 1, 0);
-    glScalef(3.0f, 3.0f, 3.0f);  // Increased from 2.0f
-    model_tents.Draw();
-    glPopMatrix();
-    
-    // Tent 2
-    glPushMatrix();
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glTranslatef(portX + 100.0f, portHeight + 0.1f, 100.0f);
-    glRotatef(180.0f, 0, 1, 0);
-    glScalef(3.0f, 3.0f, 3.0f);  // Increased from 2.0f
-    model_tents.Draw();
-    glPopMatrix();
+    // Lighthouse tower (the beam is drawn per frame by drawLighthouseBeam)
+    RenderMatrix lighthouse;
+    lighthouse.translate(500.0f, portHeight, 0.0f);
+    lighthouse.rotate(-90.0f, 1, 0, 0); // Upright cylinder
+    portBatch.setTransform(lighthouse);
+    portBatch.color(1.0f, 1.0f, 1.0f);
     
-    // Tent 3
-    glPushMatrix();
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glTranslatef(portX + 100.0f, portHeight + 0.1f, 400.0f);
-    glRotatef(180.0f, 0, 1, 0);
-    glScalef(3.0f, 3.0f, 3.0f);  // Increased from 2.0f
-    model_tents.Draw();
-    glPopMatrix();
+    // Base/Wall
+    portBatch.setMaterial(tex_lighthouse_wall, true);
+    portBatch.addCylinder(6.0f, 4.0f, 55.0f, 32); // Tapered cylinder
     
-    // Render trucks on the port
-    // Truck 1
-    glPushMatrix();
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glTranslatef(portX + 200.0f, portHeight + 0.1f, -300.0f);
-    glRotatef(0.0f, 0, 1, 0);
-    glScalef(0.1f, 0.1f, 0.1f);
-    model_truck.Draw();
-    glPopMatrix();
+    // Top Platform (Red)
+    lighthouse.translate(0.0f, 0.0f, 55.0f);
+    portBatch.setTransform(lighthouse);
+    portBatch.setMaterial(tex_lighthouse_top, true);
+    portBatch.addDisk(0.0f, 7.0f, 32);  // Platform base
+    portBatch.addCylinder(4.0f, 4.0f, 8.0f, 32);  // Lantern room
+    
+    // Light bulb (self-illuminated sphere in the center of the lantern room)
+    RenderMatrix bulb = lighthouse;
+    bulb.translate(0.0f, 0.0f, 4.0f);
+    portBatch.setTransform(bulb);
+    portBatch.setMaterial(0, false);
+    portBatch.color(1.0f, 1.0f, 0.8f); // Bright yellow-white
+    portBatch.addSphere(2.0f, 16, 16);
     
-    // Truck 2
-    glPushMatrix();
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glTranslatef(portX + 200.0f, portHeight + 0.1f, 200.0f);
-    glRotatef(180.0f, 0, 1, 0);
-    glScalef(0.1f, 0.1f, 0.1f);
-    model_truck.Draw();
-    glPopMatrix();
-
-    // Render humvees on the port
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, tex_humvee);
-    glColor3f(1.0f, 1.0f, 1.0f);
-
-    // Humvee 1 - near helipad
-    glPushMatrix();
-    glTranslatef(portX + 120.0f, portHeight + 0.1f, -650.0f);
-    glRotatef(45.0f, 0, 1, 0);
-    glScalef(0.08f, 0.08f, 0.08f);
-    model_humvee.Draw();
-    glPopMatrix();
-
-    // Humvee 2 - near helipad
-    glPushMatrix();
-    glTranslatef(portX + 140.0f, portHeight + 0.1f, -620.0f);
-    glRotatef(30.0f, 0, 1, 0);
-    glScalef(0.08f, 0.08f, 0.08f);
-    model_humvee.Draw();
-    glPopMatrix();
-
-    // Humvee 3 - near tents
-    glPushMatrix();
-    glTranslatef(portX + 80.0f, portHeight + 0.1f, -150.0f);
-    glRotatef(-60.0f, 0, 1, 0);
-    glScalef(0.08f, 0.08f, 0.08f);
-    model_humvee.Draw();
-    glPopMatrix();
-
-    // Humvee 4 - near container yard
-    glPushMatrix();
-    glTranslatef(portX + 250.0f, portHeight + 0.1f, -500.0f);
-    glRotatef(90.0f, 0, 1, 0);
-    glScalef(0.08f, 0.08f, 0.08f);
-    model_humvee.Draw();
-    glPopMatrix();
-
-    // Humvee 5 - patrol near edge
-    glPushMatrix();
-    glTranslatef(portX + 50.0f, portHeight + 0.1f, 50.0f);
-    glRotatef(0.0f, 0, 1, 0);
-    glScalef(0.08f, 0.08f, 0.08f);
-    model_humvee.Draw();
-    glPopMatrix();
-
-    // Humvee 6 - near second tent area
-    glPushMatrix();
-    glTranslatef(portX + 85.0f, portHeight + 0.1f, 350.0f);
-    glRotatef(120.0f, 0, 1, 0);
-    glScalef(0.08f, 0.08f, 0.08f);
-    model_humvee.Draw();
-    glPopMatrix();
+    // Roof
+    lighthouse.translate(0.0f, 0.0f, 8.0f);
+    portBatch.setTransform(lighthouse);
+    portBatch.setMaterial(tex_lighthouse_top, true); // Reuse red texture
+    portBatch.color(1.0f, 1.0f, 1.0f);
+    portBatch.addCylinder(5.0f, 0.0f, 5.0f, 32); // Cone
+    portBatch.resetTransform();
+    portBatch.build();
+    
+    // Night lights along the expanded port edge
+    float lightY = portHeight + 5.0f;
+    portLightPosts.setMaterial(0, false);
+    portLightPosts.color(0.3f, 0.3f, 0.35f);
+    portLightGlows.setMaterial(0, false);
+    portLightHalos.setMaterial(0, false);
+    for (float z = -1400.0f; z <= 1400.0f; z += 120.0f) {
+        // Light post (simple cylinder approximation)
+        RenderMatrix post;
+        post.translate(portX + 10.0f, portHeight, z);
+        post.scale(1.0f, 5.0f, 1.0f);
+        portLightPosts.setTransform(post);
+        portLightPosts.addCube(2.0f);
+        
+        RenderMatrix light;
+        light.translate(portX + 10.0f, lightY, z);
+        portLightGlows.setTransform(light);
+        portLightGlows.addSphere(2.0f, 8, 8);
+        portLightHalos.setTransform(light);
+        portLightHalos.addSphere(5.0f, 8, 8);
+    }
+    portLightPosts.build();
+    portLightGlows.build();
+    portLightHalos.build();
+    
+    printf("Port batches: %d groups, %d vertices\n", portBatch.getGroupCount(),
+           portBatch.getVertexCount() + portLightPosts.getVertexCount() +
+           portLightGlows.getVertexCount() + portLightHalos.getVertexCount());
+}
 
+void Level1::renderPort() {
+    // Slab, edge wall, pylons, container stacks and the lighthouse tower
+    portBatch.draw();
+    
+    // Cranes, helipad, tents, trucks and humvees are queued (recordPortProps)
     // Leave texture/lighting state enabled for subsequent textured objects
+    GLState::enable(GL_LIGHTING);
+    GLState::enable(GL_TEXTURE_2D);
+    glColor3f(1.0f, 1.0f, 1.0f);
     
-    // Draw Lighthouse (Light Animation Source)
-    drawLighthouse();
+    // Lighthouse beam (Light Animation Source)
+    drawLighthouseBeam();
 }
 
 void Level1::renderCarrier() {
+    // One test for hull, deck and markings (the deck is 50 x 240 around the center)
+    RenderMatrix placement;
+    placement.translate(carrierPosition.x, carrierPosition.y, carrierPosition.z);
+    placement.rotate(carrierRotation, 0, 1, 0);
+    placement.scale(carrierScale);
+    if (!renderQueue.isVisible(mesh_carrier, placement, 125.0f)) return;
+    
     // 1. Draw the Model (Scaled) with material properties
     glPushMatrix();
     glTranslatef(carrierPosition.x, carrierPosition.y, carrierPosition.z);
@@ -2149,13 +1762,13 @@ void Level1::renderCarrier() {
     glTranslatef(carrierPosition.x, carrierPosition.y + 3.0f, carrierPosition.z); // +3.0f height
     glRotatef(carrierRotation, 0, 1, 0);
     
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, tex_carrier);
+    GLState::enable(GL_TEXTURE_2D);
+    GLState::bindTexture(tex_carrier);
     glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
     
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_LIGHTING);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::disable(GL_LIGHTING);
     
     // Draw textured deck surface (Runway style)
     float deckWidth = 25.0f;
@@ -2170,8 +1783,8 @@ void Level1::renderCarrier() {
     glEnd();
     
     // Markings (White lines)
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_LIGHTING);
+    GLState::disable(GL_TEXTURE_2D);
+    GLState::disable(GL_LIGHTING);
     glColor3f(1.0f, 1.0f, 1.0f);
     
     // Centerline dashes
@@ -2208,8 +1821,8 @@ void Level1::renderCarrier() {
     glVertex3f(edgeOffset, 0.1f, deckLength);
     glEnd();
     
-    glEnable(GL_LIGHTING);
-    glDisable(GL_BLEND);
+    GLState::enable(GL_LIGHTING);
+    GLState::disable(GL_BLEND);
     glPopMatrix();
 }
     // glTranslatef... glRotatef...
@@ -2236,11 +1849,11 @@ void Level1::renderRing(const Ring& ring) {
     glTranslatef(ring.position.x, ring.position.y, ring.position.z);
     glRotatef(ring.rotationAngle, 0, 0, 1);  // Rotate around forward axis
     
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, tex_rings);
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::enable(GL_TEXTURE_2D);
+    GLState::bindTexture(tex_rings);
+    GLState::disable(GL_LIGHTING);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
     // Find the next ring that needs to be passed (first unpassed ring in order)
     int nextRingIndex = -1;
@@ -2314,45 +1927,139 @@ void Level1::renderRing(const Ring& ring) {
         
     }
     
-    glDisable(GL_BLEND);
-    glEnable(GL_LIGHTING);
+    GLState::disable(GL_BLEND);
+    GLState::enable(GL_LIGHTING);
     glPopMatrix();
 }
 
-void Level1::renderToolkits() {
-    for (const auto& tk : toolkits) {
+void Level1::recordToolkits() {
+    for (size_t i = 0; i < toolkits.size() && i < mat_toolkits.size(); i++) {
+        const Toolkit& tk = toolkits[i];
         if (tk.collected) continue;
         
-        glPushMatrix();
-        
         // Bob up and down like fuel containers
         float bob = sin(collectableTimer * 2.0f + tk.bobOffset) * 3.0f;
-        glTranslatef(tk.position.x, tk.position.y + bob, tk.position.z);
-        
         // Rotate around Y axis (spinning)
         float spin = tk.rotationAngle + collectableTimer * 60.0f;  // Continuous spin
-        glRotatef(spin, 0, 1, 0);
         
-        // Larger scale for better visibility
-        glScalef(2.5f, 2.5f, 2.5f);
+        RenderMatrix transform;
+        transform.translate(tk.position.x, tk.position.y + bob, tk.position.z);
+        transform.rotate(spin, 0, 1, 0);
+        transform.scale(2.5f);  // Larger scale for better visibility
         
         // Add glow effect for visibility
         float glowPulse = 0.5f + 0.5f * sin(collectableTimer * 3.0f + tk.bobOffset);
-        float glowColor[] = { 1.0f * glowPulse, 0.8f * glowPulse, 0.2f * glowPulse, 1.0f };
-        glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, glowColor);
+        RenderMaterial& material = renderQueue.getMaterial(mat_toolkits[i]);
+        material.emission[0] = 1.0f * glowPulse;
+        material.emission[1] = 0.8f * glowPulse;
+        material.emission[2] = 0.2f * glowPulse;
         
-        model_wrench.Draw();
-        
-        // Reset emission
-        float noEmission[] = { 0.0f, 0.0f, 0.0f, 1.0f };
-        glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, noEmission);
+        renderQueue.record(mesh_wrench, mat_toolkits[i], transform);
+    }
+}
+
+void Level1::recordPortProps() {
+    float portX = 450.0f;
+    
+    // Placement: x offset from the port edge, height above the slab, z, yaw, scale
+    struct Placement { int mesh; int material; float x, lift, z, yaw, scale; };
+    const Placement props[] = {
+        // Cranes - front, middle and back of the port
+        { mesh_crane,   mat_crane,     19.0f, 0.0f, -400.0f,   0.0f, 0.0015f },
+        { mesh_crane,   mat_crane,     19.0f, 0.0f,    0.0f,   0.0f, 0.0015f },
+        { mesh_crane,   mat_crane,     19.0f, 0.0f,  450.0f,  90.0f, 0.0015f },
+        { mesh_helipad, mat_portProps, 150.0f, 0.1f, -700.0f, -90.0f, 0.8f },
+        // Tents near the port edge
+        { mesh_tents,   mat_portProps, 100.0f, 0.1f, -200.0f, 180.0f, 3.0f },
+        { mesh_tents,   mat_portProps, 100.0f, 0.1f,  100.0f, 180.0f, 3.0f },
+        { mesh_tents,   mat_portProps, 100.0f, 0.1f,  400.0f, 180.0f, 3.0f },
+        { mesh_truck,   mat_portProps, 200.0f, 0.1f, -300.0f,   0.0f, 0.1f },
+        { mesh_truck,   mat_portProps, 200.0f, 0.1f,  200.0f, 180.0f, 0.1f },
+        // Humvees - by the helipad, the tents, the container yard and the edge
+        { mesh_humvee,  mat_portProps, 120.0f, 0.1f, -650.0f,  45.0f, 0.08f },
+        { mesh_humvee,  mat_portProps, 140.0f, 0.1f, -620.0f,  30.0f, 0.08f },
+        { mesh_humvee,  mat_portProps,  80.0f, 0.1f, -150.0f, -60.0f, 0.08f },
+        { mesh_humvee,  mat_portProps, 250.0f, 0.1f, -500.0f,  90.0f, 0.08f },
+        { mesh_humvee,  mat_portProps,  50.0f, 0.1f,   50.0f,   0.0f, 0.08f },
+        { mesh_humvee,  mat_portProps,  85.0f, 0.1f,  350.0f, 120.0f, 0.08f }
+    };
+    
+    for (const Placement& prop : props) {
+        RenderMatrix transform;
+        transform.translate(portX + prop.x, portHeight + prop.lift, prop.z);
+        transform.rotate(prop.yaw, 0, 1, 0);
+        transform.scale(prop.scale);
+        renderQueue.record(prop.mesh, prop.material, transform);
+    }
+}
+
+void Level1::recordBoats() {
+    for (const auto& boat : boats) {
+        Vector3f dir = boat.forwardDir * (boat.movingForward ? 1.0f : -1.0f);
+        float yaw = atan2(dir.x, dir.z) * 180.0f / 3.14159f;
         
-        glPopMatrix();
+        RenderMatrix transform;
+        transform.translate(boat.position.x, boat.position.y, boat.position.z);
+        transform.rotate(yaw + 180.0f, 0, 1, 0);
+        transform.rotate(boat.pitch, 1, 0, 0);
+        transform.rotate(boat.roll, 0, 0, 1);
+        transform.scale(10.5f);
+        renderQueue.record(mesh_boat, mat_boat, transform);
     }
 }
 
+void Level1::registerRenderMeshes() {
+    renderQueue.clearAll();
+    
+    mesh_wrench = renderQueue.addMesh("wrench", &model_wrench);
+    mesh_crane = renderQueue.addMesh("crane", &model_crane);
+    mesh_helipad = renderQueue.addMesh("helipad", &model_helipad);
+    mesh_tents = renderQueue.addMesh("tents", &model_tents);
+    mesh_truck = renderQueue.addMesh("truck", &model_truck);
+    mesh_humvee = renderQueue.addMesh("humvee", &model_humvee);
+    mesh_boat = renderQueue.addMesh("boat", &model_boat);
+    mesh_carrier = renderQueue.addMesh("carrier", &model_carrier);  // Drawn by renderCarrier, only culled here
+    
+    // Port props: white, the cranes painted yellow
+    RenderMaterial portProps;
+    portProps.flags = RMAT_COLOR;
+    mat_portProps = renderQueue.addMaterial(portProps);
+    RenderMaterial crane;
+    crane.flags = RMAT_COLOR;
+    const float craneColor[] = { 0.8f, 0.7f, 0.1f, 1.0f };
+    memcpy(crane.color, craneColor, sizeof(craneColor));
+    mat_crane = renderQueue.addMaterial(crane);
+    
+    // Boats: shiny metal hull
+    RenderMaterial boat;
+    boat.flags = RMAT_SURFACE | RMAT_COLOR;
+    const float boatAmbient[] = { 0.25f, 0.25f, 0.3f, 1.0f };
+    const float boatDiffuse[] = { 0.6f, 0.6f, 0.65f, 1.0f };
+    const float boatSpecular[] = { 0.7f, 0.7f, 0.75f, 1.0f };
+    memcpy(boat.ambient, boatAmbient, sizeof(boatAmbient));
+    memcpy(boat.diffuse, boatDiffuse, sizeof(boatDiffuse));
+    memcpy(boat.specular, boatSpecular, sizeof(boatSpecular));
+    boat.shininess = 40.0f;
+    mat_boat = renderQueue.addMaterial(boat);
+    
+    RenderMaterial toolkit;
+    toolkit.flags = RMAT_EMISSION;
+    mat_toolkits.clear();
+    for (size_t i = 0; i < toolkits.size(); i++) {
+        mat_toolkits.push_back(renderQueue.addMaterial(toolkit));
+    }
+}
+
+void Level1::recordScene() {
+    if (renderQueue.getMeshCount() == 0) return;
+    
+    recordPortProps();
+    recordBoats();
+    recordToolkits();
+}
+
 void Level1::renderRockets() {
-    glEnable(GL_LIGHTING);
+    GLState::enable(GL_LIGHTING);
     
     for (const auto& rocket : rockets) {
         if (!rocket.active) continue;
@@ -2375,18 +2082,18 @@ void Level1::renderRockets() {
         glColor3f(1.0f, 1.0f, 1.0f);
         glScalef(0.15f, 0.15f, 0.15f); // Reduced from 0.25f
         if (tex_rocket != 0) {
-            glEnable(GL_TEXTURE_2D);
-            glBindTexture(GL_TEXTURE_2D, tex_rocket);
+            GLState::enable(GL_TEXTURE_2D);
+            GLState::bindTexture(tex_rocket);
         }
         model_rocket.Draw();
         
         glPopMatrix();
         
         // Render smoke trail behind rocket
-        glDisable(GL_LIGHTING);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glDisable(GL_TEXTURE_2D);
+        GLState::disable(GL_LIGHTING);
+        GLState::enable(GL_BLEND);
+        GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        GLState::disable(GL_TEXTURE_2D);
         
         // Create smoke particles trailing behind the rocket
         Vector3f smokeOffset = dir * -4.5f;  // Offset behind rocket (further back)
@@ -2417,8 +2124,8 @@ void Level1::renderRockets() {
             glPopMatrix();
         }
         
-        glDisable(GL_BLEND);
-        glEnable(GL_LIGHTING);
+        GLState::disable(GL_BLEND);
+        GLState::enable(GL_LIGHTING);
     }
 }
 
@@ -2477,11 +2184,15 @@ void Level1::renderShadows() {
     shadowSystem.renderBaseAO(Vector3f(portX + 19.0f, portHeight, -400.0f), 15.0f, 0.35f);
     shadowSystem.renderBaseAO(Vector3f(portX + 19.0f, portHeight, 0.0f), 15.0f, 0.35f);
     shadowSystem.renderBaseAO(Vector3f(portX + 19.0f, portHeight, 450.0f), 15.0f, 0.35f);
+    
+    // Everything above was only queued; draw it as one batch
+    shadowSystem.flush();
 }
 
 void Level1::renderHUD() {
+    TextRenderer& textRenderer = TextRenderer::getInstance();
     // Save current matrices and states
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    GLState::push(GL_CURRENT_BIT);
     
     // Switch to orthographic projection for 2D HUD
     glMatrixMode(GL_PROJECTION);
@@ -2494,15 +2205,15 @@ void Level1::renderHUD() {
     glLoadIdentity();
     
     // Disable lighting and depth test for HUD
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_TEXTURE_2D);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::disable(GL_TEXTURE_2D);
     
     char buffer[64];
     
     // Draw semi-transparent background for Rings counter (top left)
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glColor4f(0.0f, 0.0f, 0.0f, 0.5f);
     glBegin(GL_QUADS);
     glVertex2f(10, screenHeight - 10);
@@ -2521,20 +2232,14 @@ void Level1::renderHUD() {
     glEnd();
     
     // Draw text for ring count
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glRasterPos2f(50, screenHeight - 35);
+    textRenderer.setColor(1.0f, 1.0f, 1.0f);
     sprintf_s(buffer, sizeof(buffer), "Rings: %d / %d", ringsPassedCount, totalRings);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(50, screenHeight - 35, buffer, GLUT_BITMAP_HELVETICA_18);
     
     // Draw toolkit count
-    glColor3f(1.0f, 0.8f, 0.2f);  // Gold color
-    glRasterPos2f(50, screenHeight - 55);
+    textRenderer.setColor(1.0f, 0.8f, 0.2f);  // Gold color
     sprintf_s(buffer, sizeof(buffer), "Toolkits: %d", collectedCount);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(50, screenHeight - 55, buffer, GLUT_BITMAP_HELVETICA_18);
     
     // Draw Timer (top center)
     glColor4f(0.0f, 0.0f, 0.0f, 0.5f);
@@ -2548,20 +2253,17 @@ void Level1::renderHUD() {
     
     // Timer color changes as time runs low
     if (gameTimer > 30.0f) {
-        glColor3f(1.0f, 1.0f, 1.0f);  // White
+        textRenderer.setColor(1.0f, 1.0f, 1.0f);  // White
     } else if (gameTimer > 10.0f) {
-        glColor3f(1.0f, 1.0f, 0.0f);  // Yellow
+        textRenderer.setColor(1.0f, 1.0f, 0.0f);  // Yellow
     } else {
-        glColor3f(1.0f, 0.3f, 0.3f);  // Red
+        textRenderer.setColor(1.0f, 0.3f, 0.3f);  // Red
     }
     
     int minutes = (int)gameTimer / 60;
     int seconds = (int)gameTimer % 60;
     sprintf_s(buffer, sizeof(buffer), "Time: %d:%02d", minutes, seconds);
-    glRasterPos2f(timerBoxX + 25, screenHeight - 35);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(timerBoxX + 25, screenHeight - 35, buffer, GLUT_BITMAP_HELVETICA_18);
     
     // Draw Score (top right)
     glColor4f(0.0f, 0.0f, 0.0f, 0.5f);
@@ -2572,12 +2274,9 @@ void Level1::renderHUD() {
     glVertex2f(screenWidth - 180, screenHeight - 50);
     glEnd();
     
-    glColor3f(1.0f, 0.9f, 0.2f);  // Gold color
+    textRenderer.setColor(1.0f, 0.9f, 0.2f);  // Gold color
     sprintf_s(buffer, sizeof(buffer), "Score: %d", score);
-    glRasterPos2f(screenWidth - 170, screenHeight - 35);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(screenWidth - 170, screenHeight - 35, buffer, GLUT_BITMAP_HELVETICA_18);
     
     // Draw Speed indicator (bottom left)
     if (flightSim) {
@@ -2594,20 +2293,17 @@ void Level1::renderHUD() {
         
         // Speed color changes based on value
         if (speed < 30.0f) {
-            glColor3f(1.0f, 0.3f, 0.3f);  // Red (slow/stalling)
+            textRenderer.setColor(1.0f, 0.3f, 0.3f);  // Red (slow/stalling)
         } else if (speed < 50.0f) {
-            glColor3f(1.0f, 1.0f, 0.0f);  // Yellow (takeoff speed)
+            textRenderer.setColor(1.0f, 1.0f, 0.0f);  // Yellow (takeoff speed)
         } else if (speed < 80.0f) {
-            glColor3f(0.0f, 1.0f, 0.0f);  // Green (good speed)
+            textRenderer.setColor(0.0f, 1.0f, 0.0f);  // Green (good speed)
         } else {
-            glColor3f(0.0f, 0.8f, 1.0f);  // Cyan (high speed)
+            textRenderer.setColor(0.0f, 0.8f, 1.0f);  // Cyan (high speed)
         }
         
         sprintf_s(buffer, sizeof(buffer), "Speed: %.0f", speed);
-        glRasterPos2f(20, 35);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-        }
+        textRenderer.add(20, 35, buffer, GLUT_BITMAP_HELVETICA_18);
         
         // Draw speed bar
         float speedBarWidth = 150.0f;
@@ -2709,12 +2405,12 @@ void Level1::renderHUD() {
         
         // Horizon line
         glColor3f(1.0f, 1.0f, 1.0f);
-        glLineWidth(2.0f);
+        GLState::lineWidth(2.0f);
         glBegin(GL_LINES);
         glVertex2f(-radius, pitch * 1.5f);
         glVertex2f(radius, pitch * 1.5f);
         glEnd();
-        glLineWidth(1.0f);
+        GLState::lineWidth(1.0f);
         
         // Pitch ladder marks (every 10 degrees)
         glColor3f(1.0f, 1.0f, 1.0f);
@@ -2733,7 +2429,7 @@ void Level1::renderHUD() {
         
         // Center reference mark (fixed airplane symbol)
         glColor3f(1.0f, 1.0f, 0.0f);
-        glLineWidth(3.0f);
+        GLState::lineWidth(3.0f);
         glBegin(GL_LINES);
         // Left wing
         glVertex2f(centerX - 40, centerY);
@@ -2745,7 +2441,7 @@ void Level1::renderHUD() {
         glVertex2f(centerX - 2, centerY);
         glVertex2f(centerX + 2, centerY);
         glEnd();
-        glLineWidth(1.0f);
+        GLState::lineWidth(1.0f);
         
         // Outer circle border
         glColor3f(1.0f, 1.0f, 1.0f);
@@ -2769,64 +2465,53 @@ void Level1::renderHUD() {
         glPopMatrix();
         
         // Display numerical values
-        glColor3f(1.0f, 1.0f, 1.0f);
+        textRenderer.setColor(1.0f, 1.0f, 1.0f);
         
         // Pitch value
         sprintf_s(buffer, sizeof(buffer), "Pitch: %.0f", pitch);
-        glRasterPos2f(screenWidth - 220, 200);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-        }
+        textRenderer.add(screenWidth - 220, 200, buffer, GLUT_BITMAP_HELVETICA_12);
         
         // Roll value
         sprintf_s(buffer, sizeof(buffer), "Roll: %.0f", roll);
-        glRasterPos2f(screenWidth - 220, 185);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-        }
+        textRenderer.add(screenWidth - 220, 185, buffer, GLUT_BITMAP_HELVETICA_12);
         
         // Yaw (heading) value
         sprintf_s(buffer, sizeof(buffer), "Heading: %.0f", yaw);
-        glRasterPos2f(screenWidth - 220, 30);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-        }
+        textRenderer.add(screenWidth - 220, 30, buffer, GLUT_BITMAP_HELVETICA_12);
     }
     
     // Draw altitude warning if flying too high
     if (flightSim && flightSim->player.position.y > 150.0f) {
-        glColor4f(1.0f, 0.0f, 0.0f, 0.7f + 0.3f * sin(ringTimer * 5.0f));
+        textRenderer.setColor(1.0f, 0.0f, 0.0f, 0.7f + 0.3f * sin(ringTimer * 5.0f));
         sprintf_s(buffer, sizeof(buffer), "WARNING: Fly Lower!");
         float warnX = (screenWidth - 180) / 2.0f;
-        glRasterPos2f(warnX, screenHeight - 80);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-        }
+        textRenderer.add(warnX, screenHeight - 80, buffer, GLUT_BITMAP_HELVETICA_18);
     }
     
     // Draw spawn protection indicator
     if (hasSpawnProtection) {
         // Flashing cyan "PROTECTED" text
         float alpha = 0.5f + 0.5f * sin(ringTimer * 8.0f);
-        glColor4f(0.0f, 1.0f, 1.0f, alpha);
+        textRenderer.setColor(0.0f, 1.0f, 1.0f, alpha);
         sprintf_s(buffer, sizeof(buffer), "SPAWN PROTECTION: %.1fs", spawnProtectionTimer);
         float protX = (screenWidth - 200) / 2.0f;
-        glRasterPos2f(protX, screenHeight - 100);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-        }
+        textRenderer.add(protX, screenHeight - 100, buffer, GLUT_BITMAP_HELVETICA_18);
     }
     
+    // All of the text above goes out in one draw
+    textRenderer.flush(TextRenderer::SCREEN_HUD);
+    
     // Restore matrices and states
     glMatrixMode(GL_PROJECTION);
     glPopMatrix();
     glMatrixMode(GL_MODELVIEW);
     glPopMatrix();
     
-    glPopAttrib();
+    GLState::pop();
 }
 
 void Level1::renderGameOverScreen() {
+    TextRenderer& textRenderer = TextRenderer::getInstance();
     glMatrixMode(GL_PROJECTION);
     glPushMatrix();
     glLoadIdentity();
@@ -2836,10 +2521,10 @@ void Level1::renderGameOverScreen() {
     glPushMatrix();
     glLoadIdentity();
     
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::disable(GL_LIGHTING);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
     // Dark overlay
     glColor4f(0, 0, 0, 0.7f);
@@ -2851,40 +2536,30 @@ void Level1::renderGameOverScreen() {
     glEnd();
     
     // Game Over text
-    glColor3f(1.0f, 0.2f, 0.2f);
+    textRenderer.setColor(1.0f, 0.2f, 0.2f);
     const char* gameOverText = "GAME OVER";
-    glRasterPos2f(screenWidth / 2 - 60, screenHeight / 2 + 30);
-    for (const char* c = gameOverText; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, *c);
-    }
+    textRenderer.add(screenWidth / 2 - 60, screenHeight / 2 + 30, gameOverText, GLUT_BITMAP_TIMES_ROMAN_24);
     
     // Reason
-    glColor3f(0.8f, 0.8f, 0.8f);
+    textRenderer.setColor(0.8f, 0.8f, 0.8f);
     const char* reason = flightSim->isCrashed ? "Hit by rocket!" : "Time ran out!";
-    glRasterPos2f(screenWidth / 2 - 50, screenHeight / 2);
-    for (const char* c = reason; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(screenWidth / 2 - 50, screenHeight / 2, reason, GLUT_BITMAP_HELVETICA_18);
     
     // Score
     char scoreText[64];
     sprintf_s(scoreText, "Final Score: %d", score);
-    glRasterPos2f(screenWidth / 2 - 60, screenHeight / 2 - 30);
-    for (char* c = scoreText; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(screenWidth / 2 - 60, screenHeight / 2 - 30, scoreText, GLUT_BITMAP_HELVETICA_18);
     
     // Restart prompt
-    glColor3f(0.6f, 0.8f, 1.0f);
+    textRenderer.setColor(0.6f, 0.8f, 1.0f);
     const char* restartText = "Press R to restart";
-    glRasterPos2f(screenWidth / 2 - 70, screenHeight / 2 - 70);
-    for (const char* c = restartText; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(screenWidth / 2 - 70, screenHeight / 2 - 70, restartText, GLUT_BITMAP_HELVETICA_18);
+    
+    textRenderer.flush(TextRenderer::SCREEN_GAME_OVER);
     
-    glDisable(GL_BLEND);
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    GLState::disable(GL_BLEND);
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_LIGHTING);
     
     glMatrixMode(GL_PROJECTION);
     glPopMatrix();
@@ -2893,6 +2568,7 @@ void Level1::renderGameOverScreen() {
 }
 
 void Level1::renderLevelCompleteScreen() {
+    TextRenderer& textRenderer = TextRenderer::getInstance();
     glMatrixMode(GL_PROJECTION);
     glPushMatrix();
     glLoadIdentity();
@@ -2902,10 +2578,10 @@ void Level1::renderLevelCompleteScreen() {
     glPushMatrix();
     glLoadIdentity();
     
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::disable(GL_LIGHTING);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
     // Semi-transparent overlay
     glColor4f(0, 0.1f, 0.2f, 0.7f);
@@ -2917,33 +2593,26 @@ void Level1::renderLevelCompleteScreen() {
     glEnd();
     
     // Level Complete text
-    glColor3f(0.2f, 1.0f, 0.4f);
+    textRenderer.setColor(0.2f, 1.0f, 0.4f);
     const char* completeText = "LEVEL COMPLETE!";
-    glRasterPos2f(screenWidth / 2 - 80, screenHeight / 2 + 40);
-    for (const char* c = completeText; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, *c);
-    }
+    textRenderer.add(screenWidth / 2 - 80, screenHeight / 2 + 40, completeText, GLUT_BITMAP_TIMES_ROMAN_24);
     
     // Score
-    glColor3f(1.0f, 0.9f, 0.3f);
+    textRenderer.setColor(1.0f, 0.9f, 0.3f);
     char scoreText[64];
     sprintf_s(scoreText, "Score: %d", score);
-    glRasterPos2f(screenWidth / 2 - 50, screenHeight / 2);
-    for (char* c = scoreText; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(screenWidth / 2 - 50, screenHeight / 2, scoreText, GLUT_BITMAP_HELVETICA_18);
     
     // Next level prompt
-    glColor3f(0.8f, 0.8f, 1.0f);
+    textRenderer.setColor(0.8f, 0.8f, 1.0f);
     const char* nextText = "Proceeding to Level 2...";
-    glRasterPos2f(screenWidth / 2 - 80, screenHeight / 2 - 40);
-    for (const char* c = nextText; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(screenWidth / 2 - 80, screenHeight / 2 - 40, nextText, GLUT_BITMAP_HELVETICA_18);
+    
+    textRenderer.flush(TextRenderer::SCREEN_LEVEL_COMPLETE);
     
-    glDisable(GL_BLEND);
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    GLState::disable(GL_BLEND);
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_LIGHTING);
     
     glMatrixMode(GL_PROJECTION);
     glPopMatrix();
@@ -3020,9 +2689,9 @@ void Level1::handleMouse(int x, int y) {
 void Level1::onEnter() {
     active = true;
     // IMPORTANT: Ensure depth test is enabled when entering level
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LEQUAL);
-    glDepthMask(GL_TRUE);
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::depthFunc(GL_LEQUAL);
+    GLState::depthMask(true);
 
     // Reload the selected plane model and texture to support "Change Plane" from menus
     if (flightSim) {
@@ -3073,14 +2742,20 @@ void Level1::cleanup() {
     }
     
     if (tex_water) {
-        glDeleteTextures(1, &tex_water);
+        TextureManager::getInstance().release(tex_water);
         tex_water = 0;
     }
     if (tex_concrete) {
-        glDeleteTextures(1, &tex_concrete);
+        TextureManager::getInstance().release(tex_concrete);
         tex_concrete = 0;
     }
     
+    portBatch.release();
+    portLightPosts.release();
+    portLightGlows.release();
+    portLightHalos.release();
+    ocean.release();
+    
     // Systems are cleaned up by their destructors
 }
 
@@ -3088,82 +2763,38 @@ void Level1::renderGround() {
     // Ground rendering is handled by renderWater and renderPort
 }
 
-void Level1::drawLighthouse() {
-    float x = 500.0f;
-    float z = 0.0f;
-    float baseY = portHeight;
+void Level1::drawLighthouseBeam() {
+    // Only draw at night
+    if (!skySystem.isNightTime()) return;
     
     glPushMatrix();
-    glTranslatef(x, baseY, z);
-    glRotatef(-90.0f, 1, 0, 0); // Upright cylinder
+    glTranslatef(500.0f, portHeight, 0.0f);
+    glRotatef(-90.0f, 1, 0, 0); // Upright, as the tower in portBatch
+    glTranslatef(0.0f, 0.0f, 55.0f + 4.0f); // Center of lantern room
     
-    glEnable(GL_TEXTURE_2D);
+    // Rotate beam to match GL_LIGHT1 rotation
+    float time = ringTimer * 2.0f;
+    float angle = -time * 180.0f / 3.14159f; // Convert rad to deg (negative for direction match)
+    glRotatef(angle, 0, 0, 1); // Rotate around local Z (which is Up for the cylinder)
     
-    // Base/Wall
-    glBindTexture(GL_TEXTURE_2D, tex_lighthouse_wall);
-    glColor3f(1.0f, 1.0f, 1.0f);
-    GLUquadric* quad = gluNewQuadric();
-    gluQuadricTexture(quad, GL_TRUE);
-    gluCylinder(quad, 6.0f, 4.0f, 55.0f, 32, 1); // Tapered cylinder
+    // Draw beam
+    GLState::disable(GL_TEXTURE_2D);
+    GLState::disable(GL_LIGHTING);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE); // Additive blending
     
-    // Top Platform (Red)
-    glTranslatef(0.0f, 0.0f, 55.0f);
-    glBindTexture(GL_TEXTURE_2D, tex_lighthouse_top);
-    // Platform base
-    gluDisk(quad, 0.0f, 7.0f, 32, 1);
-    
-    // Lantern room
-    gluCylinder(quad, 4.0f, 4.0f, 8.0f, 32, 1);
-    
-    // === LIGHT BULB (Emissive Sphere) ===
-    glPushMatrix();
-    glTranslatef(0.0f, 0.0f, 4.0f); // Center of lantern room
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_LIGHTING); // Make it self-illuminated
-    glColor3f(1.0f, 1.0f, 0.8f); // Bright yellow-white
-    glutSolidSphere(2.0f, 16, 16);
-    glEnable(GL_LIGHTING);
-    glEnable(GL_TEXTURE_2D);
-    glPopMatrix();
-    
-    // === LIGHT BEAM (Visual cone) ===
-    // Only draw at night
-    if (skySystem.isNightTime()) {
-        glPushMatrix();
-        glTranslatef(0.0f, 0.0f, 4.0f); // Center of lantern room
-        
-        // Rotate beam to match GL_LIGHT1 rotation
-        float time = ringTimer * 2.0f;
-        float angle = -time * 180.0f / 3.14159f; // Convert rad to deg (negative for direction match)
-        glRotatef(angle, 0, 0, 1); // Rotate around local Z (which is Up for the cylinder)
-        
-        // Draw beam
-        glDisable(GL_TEXTURE_2D);
-        glDisable(GL_LIGHTING);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE); // Additive blending
-        
-        glColor4f(1.0f, 0.9f, 0.7f, 0.3f); // Semi-transparent yellow beam
-        
-        // Beam cone
-        glPushMatrix();
-        glRotatef(90.0f, 0, 1, 0); // Point outwards
-        gluCylinder(quad, 0.5f, 15.0f, 100.0f, 16, 1); // Expand from 0.5 to 15 width, length 100
-        glPopMatrix();
-        
-        // Restore state
-        glDisable(GL_BLEND);
-        glEnable(GL_LIGHTING);
-        glEnable(GL_TEXTURE_2D);
-        glPopMatrix();
-    }
-    
-    // Roof
-    glTranslatef(0.0f, 0.0f, 8.0f);
-    glBindTexture(GL_TEXTURE_2D, tex_lighthouse_top); // Reuse red texture
-    gluCylinder(quad, 5.0f, 0.0f, 5.0f, 32, 1); // Cone
+    glColor4f(1.0f, 0.9f, 0.7f, 0.3f); // Semi-transparent yellow beam
     
+    // Beam cone
+    GLUquadric* quad = gluNewQuadric();
+    glRotatef(90.0f, 0, 1, 0); // Point outwards
+    gluCylinder(quad, 0.5f, 15.0f, 100.0f, 16, 1); // Expand from 0.5 to 15 width, length 100
     gluDeleteQuadric(quad);
+    
+    // Restore state
+    GLState::disable(GL_BLEND);
+    GLState::enable(GL_LIGHTING);
+    GLState::enable(GL_TEXTURE_2D);
     glPopMatrix();
 }
 
@@ -9,6 +9,8 @@
 #include "SoundSystem.h"
 #include "ShadowSystem.h"
 #include "ShootingSystem.h"
+#include "StaticBatch.h"
+#include "Ocean.h"
 #include <vector>
 
 // Forward declaration
@@ -55,6 +57,7 @@ public:
     
     void onEnter() override;
     void onExit() override;
+    void recordScene() override;
     
 private:
     FlightController* flightSim;
@@ -99,8 +102,8 @@ private:
         Vector3f forwardDir;     // Facing direction in world space
         float moveSpeed;
         float phase;
-        float bobSpeed;
-        float bobAmount;
+        float pitch;             // Degrees, nose up, from the waves under the hull
+        float roll;              // Degrees, from the waves under the hull
         float pathLength;
         bool isMoving;
         bool movingForward;
@@ -121,16 +124,38 @@ private:
     Vector3f carrierPosition;
     float carrierRotation;
     float carrierScale;
+    float carrierFreeboard;         // Carrier origin above the sea surface under the hull
     void renderCarrier();
     
     // Port/Ground System
     float waterLevel;
     float portHeight;               // Port is higher than water
+    Ocean ocean;                    // Waves at waterLevel; boats and the carrier ride it
     void renderGround();
     void renderWater();
+    void updateSea();               // Advance the waves and float the carrier
+    // Foam and wakes: glBegin/glColor4f/glVertex3f/glEnd lookalikes that
+    // queue vertices by their XZ and height above the water, then set the
+    // whole primitive on the waves with one batched height lookup. Call
+    // waterColor before the first vertex or not at all (the current color).
+    std::vector<float> waterX, waterZ, waterLift, waterHeights, waterColors;
+    GLenum waterMode;
+    bool waterColored;              // Per-vertex colors, waterColor was called
+    float waterCurrentColor[4];
+    void beginWater(GLenum mode);
+    void waterColor(float r, float g, float b, float a);
+    void waterVertex(float x, float z, float lift);
+    void endWater();
 
     void renderPort();
-    void drawLighthouse();
+    void drawLighthouseBeam();      // Animated part; the tower is in portBatch
+    
+    // Static port geometry, built once in buildPortBatches
+    StaticBatch portBatch;          // Slab, edge wall, pylons, container stacks, lighthouse
+    StaticBatch portLightPosts;     // Night light posts
+    StaticBatch portLightGlows;     // Glow spheres, colored by the pulse at draw time
+    StaticBatch portLightHalos;
+    void buildPortBatches();
     
 private:
     GLuint tex_lighthouse_wall;
@@ -152,7 +177,9 @@ private:
     float collectableTimer;
     void initToolkits();
     void updateToolkits(float deltaTime);
-    void renderToolkits();
+    void recordToolkits();
+    void recordPortProps();     // Cranes, helipad, tents, trucks, humvees
+    void recordBoats();         // Hulls; renderBoats draws the foam and wakes
     void checkToolkitCollision();
     
     // Rocket/Missile System
@@ -210,4 +237,12 @@ private:
     bool isOnCarrierDeck(const Vector3f& pos);
     
     void loadAssets();
+    
+    // Render queue handles (registered once in registerRenderMeshes)
+    int mesh_wrench;
+    int mesh_crane, mesh_helipad, mesh_tents, mesh_truck, mesh_humvee, mesh_boat;
+    int mesh_carrier;
+    int mat_portProps, mat_crane, mat_boat;
+    std::vector<int> mat_toolkits;  // One per toolkit, the glow pulses independently
+    void registerRenderMeshes();
 };
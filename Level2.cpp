@@ -5,209 +5,30 @@
 #include <cmath>
 #include <stdio.h>
 #include <cstring>
+#include <algorithm>
+#include <functional>
 #include "HUDRenderer.h"
+#include "TextureManager.h"
+#include "ProceduralTextures.h"
+#include "GLState.h"
+#include "TextRenderer.h"
 
 extern void loadBMP(unsigned int* textureID, char* strFileName, int wrap);
 
-// Custom BMP loader that handles 8/16/24/32-bit BMPs (with V4/V5 headers)
-static bool loadGroundTexture(GLuint* texID, const char* filename, bool useAlpha = false) {
-    FILE* file = NULL;
-    fopen_s(&file, filename, "rb");
-    if (!file) {
-        return false;
-    }
-    
-    // Read BMP header (54 bytes minimum, but BITMAPV4/V5 can be larger)
-    unsigned char header[138];  // Large enough for BITMAPV4HEADER
-    memset(header, 0, sizeof(header));
-    if (fread(header, 1, 54, file) != 54 || header[0] != 'B' || header[1] != 'M') {
-        fclose(file);
-        return false;
-    }
-    
-    // Extract info
-    int dataOffset = *(int*)&header[10];
-    int headerSize = *(int*)&header[14];  // DIB header size
-    int width = *(int*)&header[18];
-    int height = *(int*)&header[22];
-    int bitsPerPixel = *(short*)&header[28];
-    int compression = *(int*)&header[30];
-    
-    if (width <= 0 || height <= 0) {
-        fclose(file);
-        return false;
-    }
-    
-    // Handle negative height (top-down bitmap)
-    bool topDown = height < 0;
-    if (topDown) height = -height;
-    
-    unsigned char* rgbData = new unsigned char[width * height * 3];
-    
-    if (bitsPerPixel == 8) {
-        // 8-bit paletted BMP
-        // Read the color palette (located right after the DIB header)
-        fseek(file, 14 + headerSize, SEEK_SET);  // 14 = BMP file header size
-        
-        unsigned char palette[1024];  // 256 colors * 4 bytes (BGRA)
-        if (fread(palette, 1, 1024, file) != 1024) {
-            delete[] rgbData;
-            fclose(file);
-            return false;
-        }
-        
-        // Seek to pixel data
-        fseek(file, dataOffset, SEEK_SET);
-        
-        // Calculate row size with padding (rows are 4-byte aligned)
-        int rowSize = ((width + 3) / 4) * 4;
-        unsigned char* indexData = new unsigned char[rowSize * height];
-        
-        if (fread(indexData, 1, rowSize * height, file) != (size_t)(rowSize * height)) {
-            delete[] indexData;
-            delete[] rgbData;
-            fclose(file);
-            return false;
-        }
-        
-        // Convert indexed to RGB using palette
-        for (int y = 0; y < height; y++) {
-            int srcY = topDown ? y : (height - 1 - y);
-            for (int x = 0; x < width; x++) {
-                unsigned char index = indexData[srcY * rowSize + x];
-                int destIdx = (y * width + x) * 3;
-                rgbData[destIdx + 0] = palette[index * 4 + 2];  // R (palette is BGRA)
-                rgbData[destIdx + 1] = palette[index * 4 + 1];  // G
-                rgbData[destIdx + 2] = palette[index * 4 + 0];  // B
-            }
-        }
-        delete[] indexData;
-    }
-    else if (bitsPerPixel == 16) {
-        // 16-bit 565/555 BMP
-        fseek(file, dataOffset, SEEK_SET);
-        int rowSize = ((width * 2 + 3) / 4) * 4;
-        unsigned char* bmpData = new unsigned char[rowSize * height];
-        if (fread(bmpData, 1, rowSize * height, file) != (size_t)(rowSize * height)) {
-            delete[] bmpData;
-            delete[] rgbData;
-            fclose(file);
-            return false;
-        }
-        for (int y = 0; y < height; y++) {
-            int srcY = topDown ? y : (height - 1 - y);
-            for (int x = 0; x < width; x++) {
-                int srcIdx = srcY * rowSize + x * 2;
-                unsigned short pix = bmpData[srcIdx] | (bmpData[srcIdx + 1] << 8);
-                // Assume 565; fallback to 555 by masking
-                unsigned char r = (unsigned char)((pix >> 11) & 0x1F);
-                unsigned char g = (unsigned char)((pix >> 5)  & 0x3F);
-                unsigned char b = (unsigned char)(pix & 0x1F);
-                // Expand to 8-bit per channel
-                r = (r << 3) | (r >> 2);
-                g = (g << 2) | (g >> 4);
-                b = (b << 3) | (b >> 2);
-                int destIdx = (y * width + x) * 3;
-                rgbData[destIdx + 0] = r;
-                rgbData[destIdx + 1] = g;
-                rgbData[destIdx + 2] = b;
-            }
-        }
-        delete[] bmpData;
-    }
-    else if (bitsPerPixel == 24) {
-        // 24-bit RGB BMP
-        fseek(file, dataOffset, SEEK_SET);
-        
-        int rowSize = ((width * 3 + 3) / 4) * 4;
-        unsigned char* bmpData = new unsigned char[rowSize * height];
-        
-        if (fread(bmpData, 1, rowSize * height, file) != (size_t)(rowSize * height)) {
-            delete[] bmpData;
-            delete[] rgbData;
-            fclose(file);
-            return false;
-        }
-        
-        // Convert BGR to RGB
-        for (int y = 0; y < height; y++) {
-            int srcY = topDown ? y : (height - 1 - y);
-            for (int x = 0; x < width; x++) {
-                int srcIdx = srcY * rowSize + x * 3;
-                int destIdx = (y * width + x) * 3;
-                rgbData[destIdx + 0] = bmpData[srcIdx + 2];  // R
-                rgbData[destIdx + 1] = bmpData[srcIdx + 1];  // G
-                rgbData[destIdx + 2] = bmpData[srcIdx + 0];  // B
-            }
-        }
-        delete[] bmpData;
-    }
-    else if (bitsPerPixel == 32) {
-        // 32-bit ARGB/BGRA BMP
-        delete[] rgbData;  // We need RGBA instead
-        unsigned char* rgbaData = new unsigned char[width * height * 4];
-        
-        fseek(file, dataOffset, SEEK_SET);
-        int rowSize = width * 4;
-        unsigned char* bmpData = new unsigned char[rowSize * height];
-        
-        if (fread(bmpData, 1, rowSize * height, file) != (size_t)(rowSize * height)) {
-            delete[] bmpData;
-            delete[] rgbaData;
-            fclose(file);
-            return false;
-        }
-        
-        // Convert BGRA to RGBA
-        for (int y = 0; y < height; y++) {
-            int srcY = topDown ? y : (height - 1 - y);
-            for (int x = 0; x < width; x++) {
-                int srcIdx = srcY * rowSize + x * 4;
-                int destIdx = (y * width + x) * 4;
-                rgbaData[destIdx + 0] = bmpData[srcIdx + 2];  // R
-                rgbaData[destIdx + 1] = bmpData[srcIdx + 1];  // G
-                rgbaData[destIdx + 2] = bmpData[srcIdx + 0];  // B
-                // If useAlpha is false, force alpha to 255 (opaque)
-                // This fixes issues with 32-bit textures that have 0 alpha (XRGB)
-                rgbaData[destIdx + 3] = useAlpha ? bmpData[srcIdx + 3] : 255;
-            }
-        }
-        delete[] bmpData;
-        
-        fclose(file);
-        
-        // Create OpenGL texture with alpha
-        glGenTextures(1, texID);
-        glBindTexture(GL_TEXTURE_2D, *texID);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGBA, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgbaData);
-        
-        delete[] rgbaData;
-        return true;
-    }
-    else {
-        // Unsupported format
-        delete[] rgbData;
-        fclose(file);
-        return false;
-    }
-    
-    fclose(file);
-    
-    // Create OpenGL texture
-    glGenTextures(1, texID);
-    glBindTexture(GL_TEXTURE_2D, *texID);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGB, width, height, GL_RGB, GL_UNSIGNED_BYTE, rgbData);
-    
-    delete[] rgbData;
-    return true;
+bool Level2::occlusionCulling = true;
+
+// Occluders rasterized per frame, and the smallest worth drawing (radius / distance)
+static const int MAX_OCCLUDERS = 16;
+static const float MIN_OCCLUDER_SIZE = 0.05f;
+// Hull size relative to the model's box, so it stays inside the visible walls
+static const float OCCLUDER_SHRINK = 0.8f;
+
+// BMP textures go through the shared TextureManager so the same file is
+// decoded and uploaded once no matter how many levels or systems use it
+static bool loadGroundTexture(GLuint* texID, const char* filename, bool useAlpha = false,
+                              unsigned int extraFlags = TEX_DEFAULT) {
+    *texID = TextureManager::getInstance().acquire(filename, (useAlpha ? TEX_ALPHA : TEX_DEFAULT) | extraFlags);
+    return *texID != 0;
 }
 
 Level2::Level2() : Level(), flightSim(nullptr), screenWidth(1280), screenHeight(720), 
@@ -217,8 +38,12 @@ Level2::Level2() : Level(), flightSim(nullptr), screenWidth(1280), screenHeight(
     gameOver(false), showGameOver(false), runwayLightTimer(0.0f),
     tex_runway(0), tex_airportTerminal(0), runwayLength(700.0f), runwayWidth(50.0f),
     hasTouchedDown(false), touchdownLocalZ(0.0f), tex_grass(0),
-    grassRenderDistance(80.0f), grassCellSize(20.0f) {
+    grassRenderDistance(160.0f) {
     runwayPosition = Vector3f(-800.0f, 0.05f, -800.0f);
+    grassField.addExclusion(runwayPosition.x, runwayPosition.z, 120.0f);  // No grass on the runway
+    // Level ground under the city, the outskirts and the airport; hills beyond
+    terrain.addFlatZone(0.0f, 0.0f, 1450.0f, 700.0f);
+    grassField.setTerrain(&terrain);
     runwayRotation = 30.0f;
     terminalPosition = Vector3f(-1260.0f, 0.0f, -440.0f);  // Near runway
     terminalRotation = 30.0f;  // Match runway heading
@@ -231,6 +56,7 @@ Level2::~Level2() {
 
 void Level2::init() {
     flightSim = new FlightController();
+    flightSim->setTerrain(&terrain);
     
     // Plane loading moved to onEnter to support switching planes dynamically
     // flightSim->loadModelWithTexture is called in onEnter()
@@ -245,6 +71,8 @@ void Level2::init() {
     initBuildings();          // Initialize building obstacles
     initAirport();            // Initialize airport landing target
     initTrees();              // Initialize cardboard tree forest
+    buildForest();            // Bake the trees into chunked billboard buffers
+    registerRenderMeshes();   // Render queue meshes/materials (needs the fuel containers)
 
     // Initialize game timer and score
     gameTimer = maxGameTime;  // 300 seconds countdown (5 minutes for full day/night cycle)
@@ -266,33 +94,15 @@ void Level2::init() {
 }
 
 void Level2::loadAssets() {
-    // Try multiple relative roots so textures load regardless of working directory
-    auto tryLoad = [&](GLuint* texID, const char* relativePath, bool useAlpha = false) -> bool {
-        const char* prefixes[] = { "", "../", "../../" };
-        char fullPath[260];
-        for (int i = 0; i < 3; ++i) {
-            sprintf_s(fullPath, sizeof(fullPath), "%s%s", prefixes[i], relativePath);
-            if (loadGroundTexture(texID, fullPath, useAlpha)) {
-                return true;
-            }
-        }
-        return false;
-    };
-
     model_house.Load("Models/house/house.3DS");
     model_tree.Load("Models/tree/Tree1.3ds");
     model_fuelContainer.Load("Models/fuel container/Container Gas  N250815.3DS");
     
     // Load fuel container texture using custom loader (handles more BMP formats)
     // Pass false for useAlpha to ensure opaque rendering even if 32-bit
-    if (!tryLoad(&tex_fuelContainer, "models/fuel container/MetalBase0084_M.bmp", false)) {
+    if (!loadGroundTexture(&tex_fuelContainer, "models/fuel container/MetalBase0084_M.bmp", false)) {
         // Fallback to metallic gray texture if loading fails
-        glGenTextures(1, &tex_fuelContainer);
-        glBindTexture(GL_TEXTURE_2D, tex_fuelContainer);
-        unsigned char metal[3] = { 120, 120, 130 };
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, metal);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        tex_fuelContainer = TextureManager::getInstance().acquireColor(120, 120, 130);
     }
 
     // Force the 3DS material to use the loaded fuel texture (some 3DS files omit map names)
@@ -303,28 +113,20 @@ void Level2::loadAssets() {
         }
     }
     
-    // Create simple green grass texture (procedural)
-    glGenTextures(1, &tex_grass);
-    glBindTexture(GL_TEXTURE_2D, tex_grass);
-    unsigned char grassTex[16 * 16 * 4];
-    for (int y = 0; y < 16; y++) {
-        for (int x = 0; x < 16; x++) {
-            int idx = (y * 16 + x) * 4;
-            // Grass blade shape - transparent on sides, green in middle
-            float centerDist = fabs(x - 7.5f) / 7.5f;
-            float heightFade = (float)y / 15.0f;  // Fade at top
-            bool isGrass = (centerDist < 0.3f + heightFade * 0.4f) && (rand() % 100 > 20);
-            grassTex[idx + 0] = 40 + rand() % 40;   // R
-            grassTex[idx + 1] = 120 + rand() % 60;  // G
-            grassTex[idx + 2] = 30 + rand() % 30;   // B
-            grassTex[idx + 3] = isGrass ? 255 : 0;  // A
-        }
-    }
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 16, 16, 0, GL_RGBA, GL_UNSIGNED_BYTE, grassTex);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+    // Create simple green grass texture (procedural, fixed seed so it's the same every run)
+    const unsigned int grassSeed = 0x6A55u;
+    auto grassPixel = [&](int x, int y, unsigned char* rgba) {
+        // Grass blade shape - transparent on sides, green in middle
+        float centerDist = fabs(x - 7.5f) / 7.5f;
+        float heightFade = (float)y / 15.0f;  // Fade at top
+        bool isGrass = (centerDist < 0.3f + heightFade * 0.4f) &&
+                       (ProceduralTextures::random(grassSeed, x, y, 0) % 100 > 20);
+        rgba[0] = 40 + ProceduralTextures::random(grassSeed, x, y, 1) % 40;   // R
+        rgba[1] = 120 + ProceduralTextures::random(grassSeed, x, y, 2) % 60;  // G
+        rgba[2] = 30 + ProceduralTextures::random(grassSeed, x, y, 3) % 30;   // B
+        rgba[3] = isGrass ? 255 : 0;  // A
+    };
+    tex_grass = ProceduralTextures::acquire("grass", 1, 16, 16, grassSeed, grassPixel);
     
     // Load building models
     model_buildings[0].Load("Models/buildings/Residential Buildings 001.3ds");
@@ -348,14 +150,9 @@ void Level2::loadAssets() {
     model_warehouse.Load("models/buildings/wallmart.3ds");  // Wallmart for outskirts/farms
 
     // Load warehouse texture (Steel_C.bmp) and force it on the model
-    if (!tryLoad(&tex_warehouse, "models/buildings/Steel_C.bmp", false)) {
+    if (!loadGroundTexture(&tex_warehouse, "models/buildings/Steel_C.bmp", false)) {
         printf("Failed to load warehouse texture, using fallback\n");
-        glGenTextures(1, &tex_warehouse);
-        glBindTexture(GL_TEXTURE_2D, tex_warehouse);
-        unsigned char gray[3] = { 120, 120, 130 };
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, gray);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        tex_warehouse = TextureManager::getInstance().acquireColor(120, 120, 130);
     }
     // Force warehouse materials to use Steel_C texture
     if (tex_warehouse != 0) {
@@ -367,54 +164,134 @@ void Level2::loadAssets() {
 
     // Load runway texture
     // Pass false for useAlpha to ensure opaque rendering
-    if (!tryLoad(&tex_runway, "textures/runway.bmp", false)) {
+    // Big surfaces stream their mips from what the camera actually sees (see requestDetail calls)
+    if (!loadGroundTexture(&tex_runway, "textures/runway.bmp", false, TEX_STREAM_MIPS)) {
         // Create a dark gray fallback texture for runway
-        glGenTextures(1, &tex_runway);
-        glBindTexture(GL_TEXTURE_2D, tex_runway);
-        unsigned char gray[3] = { 60, 60, 65 };
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, gray);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        tex_runway = TextureManager::getInstance().acquireColor(60, 60, 65);
     }
     
     // Load airport terminal model and texture
     model_airportTerminal.Load("Models/airport terminal/3d-model.3ds");
-    if (!tryLoad(&tex_airportTerminal, "models/airport terminal/AussenWand_C.bmp", false)) {
-        tryLoad(&tex_airportTerminal, "Models/airport terminal/AussenWand_C.bmp", false);
+    if (!loadGroundTexture(&tex_airportTerminal, "models/airport terminal/AussenWand_C.bmp", false, TEX_STREAM_MIPS)) {
+        loadGroundTexture(&tex_airportTerminal, "Models/airport terminal/AussenWand_C.bmp", false, TEX_STREAM_MIPS);
     }
     
-    // Load tree textures (32-bit ARGB with transparency)
+    // Load tree textures (32-bit ARGB with transparency) into one atlas
+    // so renderTrees can draw the whole forest without rebinding
     for (int i = 0; i < 3; i++) {
         char filename[64];
         sprintf_s(filename, sizeof(filename), "textures/Tree%s.bmp", i == 0 ? "" : (i == 1 ? "2" : "3"));
         
-        // Pass true for useAlpha because trees need transparency
-        if (!tryLoad(&tex_tree[i], filename, true)) {
-            // Fallback: create a simple green texture
-            glGenTextures(1, &tex_tree[i]);
-            glBindTexture(GL_TEXTURE_2D, tex_tree[i]);
-            unsigned char green[4] = { 40, 120, 30, 255 };
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, green);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // TEX_ALPHA because trees need transparency
+        sprite_tree[i] = treeAtlas.addFile(filename, TEX_ALPHA);
+        if (sprite_tree[i] < 0) {
+            // Fallback: a simple green sprite
+            ImageData green;
+            green.width = 4;
+            green.height = 4;
+            green.channels = 4;
+            green.pixels.resize(4 * 4 * 4);
+            for (int p = 0; p < 16; p++) {
+                green.pixels[p * 4 + 0] = 40;
+                green.pixels[p * 4 + 1] = 120;
+                green.pixels[p * 4 + 2] = 30;
+                green.pixels[p * 4 + 3] = 255;
+            }
+            sprite_tree[i] = treeAtlas.addImage(green);
         }
     }
+    treeAtlas.build("tree_sprites");
     
     // Load ground texture using custom loader
     // Pass false for useAlpha to ensure opaque rendering
-    if (!tryLoad(&tex_ground, "textures/grassGround.bmp", false)) {
+    if (!loadGroundTexture(&tex_ground, "textures/grassGround.bmp", false, TEX_STREAM_MIPS)) {
         // Fallback to green if texture failed to load
-        glGenTextures(1, &tex_ground);
-        glBindTexture(GL_TEXTURE_2D, tex_ground);
-        unsigned char green[3] = { 50, 150, 50 };
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, green);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        tex_ground = TextureManager::getInstance().acquireColor(50, 150, 50);
     }
     
     skySystem.init();  // Initialize sky and lens flare system
 }
 
+void Level2::registerRenderMeshes() {
+    renderQueue.clearAll();
+    
+    mesh_house = renderQueue.addMesh("house", &model_house);
+    mesh_tree = renderQueue.addMesh("tree", &model_tree);
+    mesh_fuelContainer = renderQueue.addMesh("fuel container", &model_fuelContainer);
+    mesh_airportTerminal = renderQueue.addMesh("airport terminal", &model_airportTerminal);
+    for (int i = 0; i < 10; i++) {
+        mesh_buildings[i] = renderQueue.addMesh("residential building", &model_buildings[i]);
+    }
+    mesh_landmarks[0] = renderQueue.addMesh("old hotel", &model_oldHotel);
+    mesh_landmarks[1] = renderQueue.addMesh("la paz tower", &model_laPazTower);
+    mesh_landmarks[2] = renderQueue.addMesh("tower", &model_tower);
+    mesh_landmarks[3] = renderQueue.addMesh("skyscraper 02", &model_skyscraper02);
+    mesh_landmarks[4] = renderQueue.addMesh("empire trust", &model_empireTrust);
+    mesh_landmarks[5] = renderQueue.addMesh("stadium", &model_stadium);
+    mesh_landmarks[6] = renderQueue.addMesh("warehouse", &model_warehouse);  // Warehouse for outskirts
+    
+    // Leaves GL state alone (the props draw with whatever the models bind)
+    RenderMaterial plain;
+    mat_default = renderQueue.addMaterial(plain);
+    
+    // Landmark buildings - glass & steel (high specular)
+    RenderMaterial landmark;
+    landmark.flags = RMAT_SURFACE;
+    const float landmarkAmbient[] = { 0.3f, 0.3f, 0.35f, 1.0f };
+    const float landmarkDiffuse[] = { 0.7f, 0.7f, 0.75f, 1.0f };
+    const float landmarkSpecular[] = { 0.9f, 0.9f, 0.95f, 1.0f };
+    memcpy(landmark.ambient, landmarkAmbient, sizeof(landmarkAmbient));
+    memcpy(landmark.diffuse, landmarkDiffuse, sizeof(landmarkDiffuse));
+    memcpy(landmark.specular, landmarkSpecular, sizeof(landmarkSpecular));
+    landmark.shininess = 60.0f;  // Very shiny glass/steel
+    mat_landmark = renderQueue.addMaterial(landmark);
+    
+    // Regular residential buildings - concrete/brick (low specular)
+    RenderMaterial building;
+    building.flags = RMAT_SURFACE;
+    const float buildingAmbient[] = { 0.3f, 0.28f, 0.25f, 1.0f };
+    const float buildingDiffuse[] = { 0.65f, 0.6f, 0.55f, 1.0f };
+    const float buildingSpecular[] = { 0.2f, 0.2f, 0.2f, 1.0f };
+    memcpy(building.ambient, buildingAmbient, sizeof(buildingAmbient));
+    memcpy(building.diffuse, buildingDiffuse, sizeof(buildingDiffuse));
+    memcpy(building.specular, buildingSpecular, sizeof(buildingSpecular));
+    building.shininess = 10.0f;  // Matte concrete/brick
+    mat_building = renderQueue.addMaterial(building);
+    
+    // Terminal texture if loaded
+    RenderMaterial terminal;
+    terminal.flags = tex_airportTerminal != 0 ? RMAT_TEXTURE : RMAT_UNTEXTURED;
+    terminal.texId = tex_airportTerminal;
+    mat_airportTerminal = renderQueue.addMaterial(terminal);
+    
+    // Fuel containers: their texture plus a green glow; the glow is set per frame
+    RenderMaterial fuel;
+    fuel.flags = RMAT_TEXTURE | RMAT_EMISSION;
+    fuel.texId = tex_fuelContainer;
+    fuel.pass = RPASS_GLOW;     // Drawn together last, so the glow is reset once
+    mat_fuelContainers.clear();
+    for (size_t i = 0; i < fuelContainers.size(); i++) {
+        mat_fuelContainers.push_back(renderQueue.addMaterial(fuel));
+    }
+}
+
+void Level2::recordScene() {
+    if (renderQueue.getMeshCount() == 0) return;
+    
+    prepareOcclusion();
+    recordFuelContainers();
+    recordBuildings();
+    recordAirportTerminal();
+    
+    RenderMatrix treeTransform;
+    treeTransform.translate(10.0f, 0.0f, 0.0f).scale(0.7f);
+    renderQueue.record(mesh_tree, mat_default, treeTransform);
+    
+    RenderMatrix houseTransform;
+    houseTransform.rotate(90.0f, 1.0f, 0.0f, 0.0f);
+    renderQueue.record(mesh_house, mat_default, houseTransform);
+}
+
 void Level2::update(float deltaTime) {
     if (!active || !flightSim) return;
     if (deltaTime > 0.1f) deltaTime = 0.1f;
@@ -472,7 +349,7 @@ void Level2::update(float deltaTime) {
         // If so, trigger our unified crash system
         if (flightSim->isCrashed && !wasCrashedBefore) {
             Vector3f crashPos = flightSim->player.position;
-            crashPos.y = 1.0f;  // Slightly above ground for visibility
+            crashPos.y = flightSim->getGroundHeight() + 1.0f;  // Slightly above ground for visibility
             crashSystem.triggerCrash(crashPos);
             soundSystem.playCrashSound();  // Stop engine sounds, play crash
             return;
@@ -498,16 +375,16 @@ void Level2::render() {
     glClearColor(0.35f, 0.45f, 0.65f, 1.0f);
     
     // Ensure depth test is enabled (essential when coming from menus)
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LEQUAL);
-    glDepthMask(GL_TRUE);
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::depthFunc(GL_LEQUAL);
+    GLState::depthMask(true);
     
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     
     // ===== ENHANCED GRAPHICS SETTINGS =====
     glShadeModel(GL_SMOOTH);  // Smooth Gouraud shading
-    glEnable(GL_NORMALIZE);   // Normalize normals for proper lighting after scaling
-    glEnable(GL_COLOR_MATERIAL);  // Use glColor with lighting
+    GLState::enable(GL_NORMALIZE);   // Normalize normals for proper lighting after scaling
+    GLState::enable(GL_COLOR_MATERIAL);  // Use glColor with lighting
     glColorMaterial(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE);
     glLightModeli(GL_LIGHT_MODEL_LOCAL_VIEWER, GL_TRUE);  // Better specular
     glLightModeli(GL_LIGHT_MODEL_TWO_SIDE, GL_FALSE);  // One-sided lighting
@@ -517,14 +394,15 @@ void Level2::render() {
     glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
     glHint(GL_POLYGON_SMOOTH_HINT, GL_NICEST);
     
-    glEnable(GL_TEXTURE_2D);
-    glEnable(GL_LIGHTING);
+    GLState::enable(GL_TEXTURE_2D);
+    GLState::enable(GL_LIGHTING);
     
     if (flightSim) {
         glMatrixMode(GL_PROJECTION);
         glLoadIdentity();
         float aspect = (float)screenWidth / (float)(screenHeight > 0 ? screenHeight : 1);
         gluPerspective(flightSim->getFOV(), aspect, 0.1, 2000.0);
+        TextureManager::getInstance().setViewport(screenHeight, flightSim->getFOV());
     }
 
     glMatrixMode(GL_MODELVIEW);
@@ -533,6 +411,7 @@ void Level2::render() {
     if (flightSim) {
         flightSim->setupCamera();
     }
+    updateViewFrustum();  // Culls the queued models
     
     // Render sky using shared SkySystem
     if (flightSim) {
@@ -566,11 +445,11 @@ void Level2::render() {
         sunDiffuse[2] = 0.3f + t * 0.4f;
     }
     
-    glEnable(GL_LIGHT0);
-    glLightfv(GL_LIGHT0, GL_POSITION, sunDirection);
-    glLightfv(GL_LIGHT0, GL_AMBIENT, sunAmbient);
-    glLightfv(GL_LIGHT0, GL_DIFFUSE, sunDiffuse);
-    glLightfv(GL_LIGHT0, GL_SPECULAR, sunSpecular);
+    GLState::enable(GL_LIGHT0);
+    GLState::lightfv(GL_LIGHT0, GL_POSITION, sunDirection);
+    GLState::lightfv(GL_LIGHT0, GL_AMBIENT, sunAmbient);
+    GLState::lightfv(GL_LIGHT0, GL_DIFFUSE, sunDiffuse);
+    GLState::lightfv(GL_LIGHT0, GL_SPECULAR, sunSpecular);
     
     // GL_LIGHT1: Airport Terminal Lights + Rotating Beacon (Animation)
     // We add a rotating offset to animate the light position or direction
@@ -593,16 +472,16 @@ void Level2::render() {
     GLfloat terminalSpecular[] = { 1.0f, 1.0f, 1.0f, 1.0f };
     
     if (isNight) {
-        glEnable(GL_LIGHT1);
-        glLightfv(GL_LIGHT1, GL_POSITION, terminalLightPos);
-        glLightfv(GL_LIGHT1, GL_AMBIENT, terminalAmbient);
-        glLightfv(GL_LIGHT1, GL_DIFFUSE, terminalDiffuse);
-        glLightfv(GL_LIGHT1, GL_SPECULAR, terminalSpecular);
-        glLightf(GL_LIGHT1, GL_CONSTANT_ATTENUATION, 1.0f);
-        glLightf(GL_LIGHT1, GL_LINEAR_ATTENUATION, 0.01f);
-        glLightf(GL_LIGHT1, GL_QUADRATIC_ATTENUATION, 0.002f);
+        GLState::enable(GL_LIGHT1);
+        GLState::lightfv(GL_LIGHT1, GL_POSITION, terminalLightPos);
+        GLState::lightfv(GL_LIGHT1, GL_AMBIENT, terminalAmbient);
+        GLState::lightfv(GL_LIGHT1, GL_DIFFUSE, terminalDiffuse);
+        GLState::lightfv(GL_LIGHT1, GL_SPECULAR, terminalSpecular);
+        GLState::lightf(GL_LIGHT1, GL_CONSTANT_ATTENUATION, 1.0f);
+        GLState::lightf(GL_LIGHT1, GL_LINEAR_ATTENUATION, 0.01f);
+        GLState::lightf(GL_LIGHT1, GL_QUADRATIC_ATTENUATION, 0.002f);
     } else {
-        glDisable(GL_LIGHT1);
+        GLState::disable(GL_LIGHT1);
     }
     
     // GL_LIGHT2: Runway Approach Lights
@@ -611,16 +490,16 @@ void Level2::render() {
     GLfloat runwaySpecular[] = { 1.0f, 1.0f, 1.0f, 1.0f };
     
     if (isNight) {
-        glEnable(GL_LIGHT2);
-        glLightfv(GL_LIGHT2, GL_POSITION, runwayLightPos);
-        glLightfv(GL_LIGHT2, GL_AMBIENT, terminalAmbient);
-        glLightfv(GL_LIGHT2, GL_DIFFUSE, runwayDiffuse);
-        glLightfv(GL_LIGHT2, GL_SPECULAR, runwaySpecular);
-        glLightf(GL_LIGHT2, GL_CONSTANT_ATTENUATION, 1.0f);
-        glLightf(GL_LIGHT2, GL_LINEAR_ATTENUATION, 0.02f);
-        glLightf(GL_LIGHT2, GL_QUADRATIC_ATTENUATION, 0.005f);
+        GLState::enable(GL_LIGHT2);
+        GLState::lightfv(GL_LIGHT2, GL_POSITION, runwayLightPos);
+        GLState::lightfv(GL_LIGHT2, GL_AMBIENT, terminalAmbient);
+        GLState::lightfv(GL_LIGHT2, GL_DIFFUSE, runwayDiffuse);
+        GLState::lightfv(GL_LIGHT2, GL_SPECULAR, runwaySpecular);
+        GLState::lightf(GL_LIGHT2, GL_CONSTANT_ATTENUATION, 1.0f);
+        GLState::lightf(GL_LIGHT2, GL_LINEAR_ATTENUATION, 0.02f);
+        GLState::lightf(GL_LIGHT2, GL_QUADRATIC_ATTENUATION, 0.005f);
     } else {
-        glDisable(GL_LIGHT2);
+        GLState::disable(GL_LIGHT2);
     }
     
     // GL_LIGHT3: Dynamic Plane Landing Lights (forward spotlight)
@@ -630,52 +509,52 @@ void Level2::render() {
         GLfloat planeLightDir[] = { flightSim->player.forward.x, flightSim->player.forward.y, flightSim->player.forward.z };
         GLfloat planeDiffuse[] = { 1.0f, 1.0f, 0.95f, 1.0f };
 
-        glEnable(GL_LIGHT3);
-        glLightfv(GL_LIGHT3, GL_POSITION, planeLightPos);
-        glLightfv(GL_LIGHT3, GL_SPOT_DIRECTION, planeLightDir);
-        glLightfv(GL_LIGHT3, GL_DIFFUSE, planeDiffuse);
-        glLightfv(GL_LIGHT3, GL_SPECULAR, planeDiffuse);
-        glLightf(GL_LIGHT3, GL_SPOT_CUTOFF, 25.0f);  // 25 degree cone
-        glLightf(GL_LIGHT3, GL_SPOT_EXPONENT, 15.0f);  // Focused beam
-        glLightf(GL_LIGHT3, GL_CONSTANT_ATTENUATION, 1.0f);
-        glLightf(GL_LIGHT3, GL_LINEAR_ATTENUATION, 0.05f);
-        glLightf(GL_LIGHT3, GL_QUADRATIC_ATTENUATION, 0.01f);
+        GLState::enable(GL_LIGHT3);
+        GLState::lightfv(GL_LIGHT3, GL_POSITION, planeLightPos);
+        GLState::lightfv(GL_LIGHT3, GL_SPOT_DIRECTION, planeLightDir);
+        GLState::lightfv(GL_LIGHT3, GL_DIFFUSE, planeDiffuse);
+        GLState::lightfv(GL_LIGHT3, GL_SPECULAR, planeDiffuse);
+        GLState::lightf(GL_LIGHT3, GL_SPOT_CUTOFF, 25.0f);  // 25 degree cone
+        GLState::lightf(GL_LIGHT3, GL_SPOT_EXPONENT, 15.0f);  // Focused beam
+        GLState::lightf(GL_LIGHT3, GL_CONSTANT_ATTENUATION, 1.0f);
+        GLState::lightf(GL_LIGHT3, GL_LINEAR_ATTENUATION, 0.05f);
+        GLState::lightf(GL_LIGHT3, GL_QUADRATIC_ATTENUATION, 0.01f);
     } else {
-        glDisable(GL_LIGHT3);
+        GLState::disable(GL_LIGHT3);
     }
 
     // GL_LIGHT4: Secondary Fill Light (opposite side of sun for softer shadows)
     GLfloat fillLightPos[] = { -0.5f, 0.3f, 0.5f, 0.0f };  // Directional fill
     GLfloat fillDiffuse[] = { 0.25f, 0.28f, 0.35f, 1.0f };  // Cool blue fill
     GLfloat fillSpecular[] = { 0.1f, 0.1f, 0.15f, 1.0f };
-    glEnable(GL_LIGHT4);
-    glLightfv(GL_LIGHT4, GL_POSITION, fillLightPos);
-    glLightfv(GL_LIGHT4, GL_DIFFUSE, fillDiffuse);
-    glLightfv(GL_LIGHT4, GL_SPECULAR, fillSpecular);
+    GLState::enable(GL_LIGHT4);
+    GLState::lightfv(GL_LIGHT4, GL_POSITION, fillLightPos);
+    GLState::lightfv(GL_LIGHT4, GL_DIFFUSE, fillDiffuse);
+    GLState::lightfv(GL_LIGHT4, GL_SPECULAR, fillSpecular);
     GLfloat noAmbient[] = { 0.0f, 0.0f, 0.0f, 1.0f };
-    glLightfv(GL_LIGHT4, GL_AMBIENT, noAmbient);
+    GLState::lightfv(GL_LIGHT4, GL_AMBIENT, noAmbient);
 
     // GL_LIGHT5: Rim/Back Light for better object definition
     GLfloat rimLightPos[] = { 0.0f, 0.8f, -1.0f, 0.0f };  // From behind/above
     GLfloat rimDiffuse[] = { 0.3f, 0.32f, 0.4f, 1.0f };   // Subtle rim light
     GLfloat rimSpecular[] = { 0.5f, 0.5f, 0.6f, 1.0f };   // Stronger specular for rim
-    glEnable(GL_LIGHT5);
-    glLightfv(GL_LIGHT5, GL_POSITION, rimLightPos);
-    glLightfv(GL_LIGHT5, GL_DIFFUSE, rimDiffuse);
-    glLightfv(GL_LIGHT5, GL_SPECULAR, rimSpecular);
-    glLightfv(GL_LIGHT5, GL_AMBIENT, noAmbient);
+    GLState::enable(GL_LIGHT5);
+    GLState::lightfv(GL_LIGHT5, GL_POSITION, rimLightPos);
+    GLState::lightfv(GL_LIGHT5, GL_DIFFUSE, rimDiffuse);
+    GLState::lightfv(GL_LIGHT5, GL_SPECULAR, rimSpecular);
+    GLState::lightfv(GL_LIGHT5, GL_AMBIENT, noAmbient);
 
     // GL_LIGHT6: Ground Bounce Light (simulates light bouncing off terrain)
     if (!isNight) {
         GLfloat groundBouncePos[] = { 0.0f, -1.0f, 0.0f, 0.0f };  // From below
         GLfloat groundBounceDiffuse[] = { 0.12f, 0.15f, 0.1f, 1.0f };  // Greenish ground bounce
-        glEnable(GL_LIGHT6);
-        glLightfv(GL_LIGHT6, GL_POSITION, groundBouncePos);
-        glLightfv(GL_LIGHT6, GL_DIFFUSE, groundBounceDiffuse);
-        glLightfv(GL_LIGHT6, GL_SPECULAR, noAmbient);
-        glLightfv(GL_LIGHT6, GL_AMBIENT, noAmbient);
+        GLState::enable(GL_LIGHT6);
+        GLState::lightfv(GL_LIGHT6, GL_POSITION, groundBouncePos);
+        GLState::lightfv(GL_LIGHT6, GL_DIFFUSE, groundBounceDiffuse);
+        GLState::lightfv(GL_LIGHT6, GL_SPECULAR, noAmbient);
+        GLState::lightfv(GL_LIGHT6, GL_AMBIENT, noAmbient);
     } else {
-        glDisable(GL_LIGHT6);
+        GLState::disable(GL_LIGHT6);
     }
 
     // Set global ambient light
@@ -686,7 +565,7 @@ void Level2::render() {
     glLightModelfv(GL_LIGHT_MODEL_AMBIENT, globalAmbient);
     
     // ===== ATMOSPHERIC FOG FOR DEPTH =====
-    glEnable(GL_FOG);
+    GLState::enable(GL_FOG);
     glFogi(GL_FOG_MODE, GL_EXP2);  // Exponential fog for realistic atmosphere
     
     // Dynamic fog color based on time of day
@@ -737,18 +616,12 @@ void Level2::render() {
         particleEffects.renderWind(flightSim->player.forward, flightSim->getSpeed());
     }
     
-    // Render Fuel Containers
-    renderFuelContainers();
+    // Models (fuel containers, buildings, terminal, props) go through the render queue
+    drawScene();
     
     // Render Cardboard Trees
     renderTrees();
     
-    // Render Buildings
-    renderBuildings();
-    
-    // Render Airport Terminal
-    renderAirportTerminal();
-    
     // Render Runway (textured primitive with markings)
     renderAirport();
     renderRunwayMarkings();
@@ -756,17 +629,6 @@ void Level2::render() {
     renderRunwayLights(skySystem.isNightTime());
     renderTargetArrow();
     
-    glPushMatrix();
-    glTranslatef(10, 0, 0);
-    glScalef(0.7f, 0.7f, 0.7f);
-    model_tree.Draw();
-    glPopMatrix();
-    
-    glPushMatrix();
-    glRotatef(90.f, 1, 0, 0);
-    model_house.Draw();
-    glPopMatrix();
-    
     // Render Crash Effects (explosion + smoke) using unified CrashSystem
     if (flightSim) {
         crashSystem.render(flightSim->player.position);
@@ -801,190 +663,95 @@ void Level2::render() {
 void Level2::renderGround() {
     // CRITICAL FIX: Completely disable lighting AND fog for ground
     // Blue tint was caused by blue fog color blending with ground at distance/angles
-    GLboolean lightingWasEnabled = glIsEnabled(GL_LIGHTING);
-    GLboolean fogWasEnabled = glIsEnabled(GL_FOG);
-    glDisable(GL_LIGHTING);
-    glDisable(GL_FOG);  // Disable fog to prevent blue tint from fog color
+    GLboolean lightingWasEnabled = GLState::isEnabled(GL_LIGHTING);
+    GLboolean fogWasEnabled = GLState::isEnabled(GL_FOG);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_FOG);  // Disable fog to prevent blue tint from fog color
 
     // Track previous cull state so we can restore it
-    GLboolean wasCullEnabled = glIsEnabled(GL_CULL_FACE);
-    glDisable(GL_CULL_FACE);  // Draw both sides to avoid upside-down black view
+    GLboolean wasCullEnabled = GLState::isEnabled(GL_CULL_FACE);
+    GLState::disable(GL_CULL_FACE);  // Draw both sides to avoid upside-down black view
 
-    float px = 0, pz = 0;
+    Vector3f eye(0.0f, 1.0f, 0.0f);
+    float altitude = 1.0f;
     if (flightSim) {
-        px = flightSim->player.position.x;
-        pz = flightSim->player.position.z;
+        eye = flightSim->player.position;
+        altitude = eye.y - flightSim->getGroundHeight();
     }
+    terrain.update(eye.x, eye.z);
 
-    float size = 2000.0f;
     float texScale = 0.02f;  // Controls texture density (smaller = more repetitions)
 
-    glPushMatrix();
-    glTranslatef(px, 0, pz);  // Ground follows player
-
     // Ensure proper texture state
-    glEnable(GL_TEXTURE_2D);
-    glDisable(GL_BLEND);
+    GLState::enable(GL_TEXTURE_2D);
+    GLState::disable(GL_BLEND);
 
     // Check if texture loaded - use fallback color if not
-    if (tex_ground != 0) {
-        glBindTexture(GL_TEXTURE_2D, tex_ground);
+    bool textured = tex_ground != 0;
+    if (textured) {
+        // One repeat every 1/texScale units; the closest ground is straight below
+        TextureManager::getInstance().requestDetail(tex_ground, 1.0f / texScale, altitude);
+        GLState::bindTexture(tex_ground);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        // Use REPLACE to show ONLY the texture - no lighting influence at all
-        glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+        // MODULATE by the baked slope shading only; lighting stays off
+        glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
     } else {
-        glDisable(GL_TEXTURE_2D);
+        GLState::disable(GL_TEXTURE_2D);
         // Neutral earthy color without any blue
         glColor3f(0.55f, 0.5f, 0.4f);
     }
 
-    // Use world coordinates for texture mapping so texture stays fixed in world space
-    // This prevents the texture from sliding as the camera moves
-    float worldMinX = px - size;
-    float worldMaxX = px + size;
-    float worldMinZ = pz - size;
-    float worldMaxZ = pz + size;
-
-    glBegin(GL_QUADS);
-    glNormal3f(0, 1, 0);
-    glTexCoord2f(worldMinX * texScale, worldMinZ * texScale); glVertex3f(-size, 0, -size);
-    glTexCoord2f(worldMaxX * texScale, worldMinZ * texScale); glVertex3f(size, 0, -size);
-    glTexCoord2f(worldMaxX * texScale, worldMaxZ * texScale); glVertex3f(size, 0, size);
-    glTexCoord2f(worldMinX * texScale, worldMaxZ * texScale); glVertex3f(-size, 0, size);
-    glEnd();
-
-    glPopMatrix();
+    // Texture coordinates are baked in world space, so the texture stays put
+    terrain.draw(viewFrustum, eye, textured);
 
     // Reset texture environment back to normal for other objects
     glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-    glDisable(GL_TEXTURE_2D);   // Prevent texture bleed into plane rendering
+    GLState::disable(GL_TEXTURE_2D);   // Prevent texture bleed into plane rendering
 
     // Restore previous culling state
-    if (wasCullEnabled) glEnable(GL_CULL_FACE); else glDisable(GL_CULL_FACE);
+    if (wasCullEnabled) GLState::enable(GL_CULL_FACE); else GLState::disable(GL_CULL_FACE);
 
     // Restore lighting and fog for other objects
-    if (lightingWasEnabled) glEnable(GL_LIGHTING);
-    if (fogWasEnabled) glEnable(GL_FOG);
+    if (lightingWasEnabled) GLState::enable(GL_LIGHTING);
+    if (fogWasEnabled) GLState::enable(GL_FOG);
 
     glColor3f(1, 1, 1);
 }
 
-// Optimized grass rendering - uses simple billboard quads instead of 3D models
+// Grass cells are generated as they come into range and drawn from their buffer
 void Level2::renderGrass() {
     if (!flightSim) return;
     
     Vector3f camPos = flightSim->player.position;
     
     // Don't render grass if too high (optimization) - grass not visible from altitude
-    if (camPos.y > 40.0f) return;
+    float altitude = camPos.y - flightSim->getGroundHeight();
+    if (altitude > 40.0f) return;
     
     // Dynamic render distance based on altitude
     float dynamicRenderDist = grassRenderDistance;
-    if (camPos.y > 20.0f) {
+    if (altitude > 20.0f) {
         dynamicRenderDist *= 0.6f;
     }
     
-    // Calculate grid bounds around camera
-    int gridHalf = GRASS_GRID_SIZE / 2;
-    int camCellX = (int)floor(camPos.x / grassCellSize);
-    int camCellZ = (int)floor(camPos.z / grassCellSize);
+    grassField.update(camPos.x, camPos.z);
     
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    GLState::push(GL_CURRENT_BIT);
     
     // Setup for billboard grass rendering
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, tex_grass);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_ALPHA_TEST);
-    glAlphaFunc(GL_GREATER, 0.5f);
-    glDisable(GL_CULL_FACE);
-    glDisable(GL_LIGHTING);
-    
-    // Get camera right vector for billboarding
-    float modelview[16];
-    glGetFloatv(GL_MODELVIEW_MATRIX, modelview);
-    Vector3f camRight(modelview[0], modelview[4], modelview[8]);
-    
-    int grassRendered = 0;
-    const int MAX_GRASS = 80;  // Reduced limit for performance
-    
-    glBegin(GL_QUADS);  // Batch all grass in one draw call
-    
-    // Iterate through grid cells around camera
-    for (int gz = -gridHalf; gz <= gridHalf && grassRendered < MAX_GRASS; gz++) {
-        for (int gx = -gridHalf; gx <= gridHalf && grassRendered < MAX_GRASS; gx++) {
-            int cellX = camCellX + gx;
-            int cellZ = camCellZ + gz;
-            
-            // Cell world position (center)
-            float cellWorldX = cellX * grassCellSize + grassCellSize * 0.5f;
-            float cellWorldZ = cellZ * grassCellSize + grassCellSize * 0.5f;
-            
-            // Quick distance check for culling
-            float dx = cellWorldX - camPos.x;
-            float dz = cellWorldZ - camPos.z;
-            float distSq = dx * dx + dz * dz;
-            
-            if (distSq > dynamicRenderDist * dynamicRenderDist) continue;
-            
-            // Use cell coordinates as seed for deterministic random placement
-            unsigned int seed = (unsigned int)(cellX * 73856093) ^ (unsigned int)(cellZ * 19349663);
-            
-            // Render grass patches in this cell
-            for (int i = 0; i < GRASS_PER_CELL && grassRendered < MAX_GRASS; i++) {
-                // Deterministic pseudo-random position within cell
-                seed = seed * 1103515245 + 12345;
-                float offsetX = ((seed >> 16) & 0x7FFF) / 32767.0f * grassCellSize;
-                seed = seed * 1103515245 + 12345;
-                float offsetZ = ((seed >> 16) & 0x7FFF) / 32767.0f * grassCellSize;
-                seed = seed * 1103515245 + 12345;
-                float grassHeight = 1.5f + ((seed >> 16) & 0x7FFF) / 32767.0f * 1.0f;  // Height 1.5-2.5
-                seed = seed * 1103515245 + 12345;
-                float grassWidth = 0.8f + ((seed >> 16) & 0x7FFF) / 32767.0f * 0.6f;  // Width 0.8-1.4
-                
-                float grassX = cellX * grassCellSize + offsetX;
-                float grassZ = cellZ * grassCellSize + offsetZ;
-                
-                // Skip grass on runway area
-                float rdx = grassX - runwayPosition.x;
-                float rdz = grassZ - runwayPosition.z;
-                if (rdx * rdx + rdz * rdz < 14400.0f) continue;  // Skip within 120 units of runway
-                
-                // Distance-based alpha fade
-                float dist = sqrt(distSq);
-                float alpha = 1.0f;
-                if (dist > dynamicRenderDist * 0.6f) {
-                    alpha = 1.0f - (dist - dynamicRenderDist * 0.6f) / (dynamicRenderDist * 0.4f);
-                }
-                
-                // Slight color variation
-                float colorVar = 0.8f + ((seed >> 8) & 0xFF) / 255.0f * 0.4f;
-                glColor4f(0.3f * colorVar, 0.6f * colorVar, 0.2f * colorVar, alpha);
-                
-                // Billboard quad vertices (cross pattern for 3D look)
-                float hw = grassWidth * 0.5f;
-                
-                // First quad (aligned with X)
-                glTexCoord2f(0, 0); glVertex3f(grassX - hw, 0.0f, grassZ);
-                glTexCoord2f(1, 0); glVertex3f(grassX + hw, 0.0f, grassZ);
-                glTexCoord2f(1, 1); glVertex3f(grassX + hw, grassHeight, grassZ);
-                glTexCoord2f(0, 1); glVertex3f(grassX - hw, grassHeight, grassZ);
-                
-                // Second quad (aligned with Z) - creates X pattern
-                glTexCoord2f(0, 0); glVertex3f(grassX, 0.0f, grassZ - hw);
-                glTexCoord2f(1, 0); glVertex3f(grassX, 0.0f, grassZ + hw);
-                glTexCoord2f(1, 1); glVertex3f(grassX, grassHeight, grassZ + hw);
-                glTexCoord2f(0, 1); glVertex3f(grassX, grassHeight, grassZ - hw);
-                
-                grassRendered++;
-            }
-        }
-    }
-    
-    glEnd();  // End batched grass quads
-    glPopAttrib();
+    GLState::enable(GL_TEXTURE_2D);
+    GLState::bindTexture(tex_grass);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::enable(GL_ALPHA_TEST);
+    GLState::alphaFunc(GL_GREATER, 0.5f);
+    GLState::disable(GL_CULL_FACE);
+    GLState::disable(GL_LIGHTING);
+    
+    grassField.draw(viewFrustum, camPos.x, camPos.z, std::min(dynamicRenderDist, grassField.getRange()));
+    
+    GLState::pop();
 }
 
 void Level2::handleKeyboard(unsigned char key, bool pressed) {
@@ -1123,6 +890,9 @@ void Level2::cleanup() {
         delete flightSim;
         flightSim = nullptr;
     }
+    forest.release();
+    grassField.release();
+    terrain.release();
 }
 
 // ============ FUEL CONTAINER FUNCTIONS ============
@@ -1149,6 +919,18 @@ void Level2::initFuelContainers() {
         container.glowIntensity = 1.0f;
         fuelContainers.push_back(container);
     }
+    indexFuelContainers();
+}
+
+void Level2::indexFuelContainers() {
+    // Containers only bob in place: index the full bob range once
+    fuelGrid.clear();
+    const float extent = 6.0f;
+    for (size_t i = 0; i < fuelContainers.size(); i++) {
+        const Vector3f& p = fuelContainers[i].position;
+        fuelGrid.insert((int)i, p.x - extent, p.z - extent, p.x + extent, p.z + extent,
+                        p.y - extent, p.y + extent);
+    }
 }
 
 void Level2::updateFuelContainers(float deltaTime) {
@@ -1174,42 +956,28 @@ void Level2::updateFuelContainers(float deltaTime) {
     }
 }
 
-void Level2::renderFuelContainers() {
-    for (size_t i = 0; i < fuelContainers.size(); i++) {
-        if (fuelContainers[i].collected) continue;
+void Level2::recordFuelContainers() {
+    fuelGrid.queryFrustum(viewFrustum, gridHits);
+    for (int i : gridHits) {
+        if (i >= (int)mat_fuelContainers.size() || fuelContainers[i].collected) continue;
         
         FuelCollectable& fc = fuelContainers[i];
         
         // Calculate bobbing offset (up/down motion)
         float bobHeight = sin(fc.bobOffset) * 3.0f;  // 3 units up/down
         
-        glPushMatrix();
-        
-        // Position the container
-        glTranslatef(fc.position.x, fc.position.y + bobHeight, fc.position.z);
-        
-        // Rotate around Y axis
-        glRotatef(fc.rotationAngle, 0.0f, 1.0f, 0.0f);
-        
-        // Scale the model appropriately (smaller size)
-        glScalef(0.02f, 0.02f, 0.02f);
-        
-        // Enable texturing and bind fuel container texture
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, tex_fuelContainer);
+        RenderMatrix transform;
+        transform.translate(fc.position.x, fc.position.y + bobHeight, fc.position.z);  // Position the container
+        transform.rotate(fc.rotationAngle, 0.0f, 1.0f, 0.0f);  // Rotate around Y axis
+        transform.scale(0.02f);  // Scale the model appropriately (smaller size)
         
         // Glow effect using emission
-        float glowColor[] = { 0.2f * fc.glowIntensity, 0.8f * fc.glowIntensity, 0.2f * fc.glowIntensity, 1.0f };
-        glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, glowColor);
-        
-        // Draw the fuel container model
-        model_fuelContainer.Draw();
+        RenderMaterial& material = renderQueue.getMaterial(mat_fuelContainers[i]);
+        material.emission[0] = 0.2f * fc.glowIntensity;
+        material.emission[1] = 0.8f * fc.glowIntensity;
+        material.emission[2] = 0.2f * fc.glowIntensity;
         
-        // Reset emission
-        float noEmission[] = { 0.0f, 0.0f, 0.0f, 1.0f };
-        glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, noEmission);
-        
-        glPopMatrix();
+        renderQueue.record(mesh_fuelContainer, mat_fuelContainers[i], transform);
     }
 }
 
@@ -1219,7 +987,8 @@ void Level2::checkFuelCollision() {
     Vector3f playerPos = flightSim->player.position;
     float collisionRadius = 25.0f;  // Distance to collect (generous for gameplay)
     
-    for (size_t i = 0; i < fuelContainers.size(); i++) {
+    fuelGrid.queryRadius(playerPos.x, playerPos.z, collisionRadius, gridHits);
+    for (int i : gridHits) {
         if (fuelContainers[i].collected) continue;
         
         // Calculate bobbing offset for accurate collision
@@ -1252,8 +1021,9 @@ void Level2::checkFuelCollision() {
 }
 
 void Level2::renderHUD() {
+    TextRenderer& textRenderer = TextRenderer::getInstance();
     // Save current state
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    GLState::push(GL_CURRENT_BIT);
     
     // Switch to 2D orthographic projection
     glMatrixMode(GL_PROJECTION);
@@ -1265,11 +1035,11 @@ void Level2::renderHUD() {
     glPushMatrix();
     glLoadIdentity();
     
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_TEXTURE_2D);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::disable(GL_TEXTURE_2D);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
     char buffer[64];
     
@@ -1290,13 +1060,10 @@ void Level2::renderHUD() {
     glVertex2f(20, screenHeight - 40);
     glEnd();
     
-    glColor3f(1.0f, 1.0f, 1.0f);
+    textRenderer.setColor(1.0f, 1.0f, 1.0f);
     int total = (int)fuelContainers.size();
     sprintf_s(buffer, sizeof(buffer), "Fuel: %d / %d", collectedCount, total);
-    glRasterPos2f(50, screenHeight - 35);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(50, screenHeight - 35, buffer, GLUT_BITMAP_HELVETICA_18);
     
     // Draw Timer (top center)
     glColor4f(0.0f, 0.0f, 0.0f, 0.5f);
@@ -1309,20 +1076,17 @@ void Level2::renderHUD() {
     glEnd();
     
     if (gameTimer > 30.0f) {
-        glColor3f(1.0f, 1.0f, 1.0f);
+        textRenderer.setColor(1.0f, 1.0f, 1.0f);
     } else if (gameTimer > 10.0f) {
-        glColor3f(1.0f, 1.0f, 0.0f);
+        textRenderer.setColor(1.0f, 1.0f, 0.0f);
     } else {
-        glColor3f(1.0f, 0.3f, 0.3f);
+        textRenderer.setColor(1.0f, 0.3f, 0.3f);
     }
     
     int minutes = (int)gameTimer / 60;
     int seconds = (int)gameTimer % 60;
     sprintf_s(buffer, sizeof(buffer), "Time: %d:%02d", minutes, seconds);
-    glRasterPos2f(timerBoxX + 25, screenHeight - 35);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(timerBoxX + 25, screenHeight - 35, buffer, GLUT_BITMAP_HELVETICA_18);
     
     // Draw Score (top right)
     glColor4f(0.0f, 0.0f, 0.0f, 0.5f);
@@ -1333,12 +1097,9 @@ void Level2::renderHUD() {
     glVertex2f(screenWidth - 180, screenHeight - 50);
     glEnd();
     
-    glColor3f(1.0f, 0.9f, 0.2f);
+    textRenderer.setColor(1.0f, 0.9f, 0.2f);
     sprintf_s(buffer, sizeof(buffer), "Score: %d", score);
-    glRasterPos2f(screenWidth - 170, screenHeight - 35);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(screenWidth - 170, screenHeight - 35, buffer, GLUT_BITMAP_HELVETICA_18);
     
     // Draw Speed indicator (bottom left)
     if (flightSim) {
@@ -1353,20 +1114,17 @@ void Level2::renderHUD() {
         glEnd();
         
         if (speed < 30.0f) {
-            glColor3f(1.0f, 0.3f, 0.3f);
+            textRenderer.setColor(1.0f, 0.3f, 0.3f);
         } else if (speed < 50.0f) {
-            glColor3f(1.0f, 1.0f, 0.0f);
+            textRenderer.setColor(1.0f, 1.0f, 0.0f);
         } else if (speed < 80.0f) {
-            glColor3f(0.0f, 1.0f, 0.0f);
+            textRenderer.setColor(0.0f, 1.0f, 0.0f);
         } else {
-            glColor3f(0.0f, 0.8f, 1.0f);
+            textRenderer.setColor(0.0f, 0.8f, 1.0f);
         }
         
         sprintf_s(buffer, sizeof(buffer), "Speed: %.0f", speed);
-        glRasterPos2f(20, 35);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-        }
+        textRenderer.add(20, 35, buffer, GLUT_BITMAP_HELVETICA_18);
         
         float speedBarWidth = 150.0f;
         float speedBarFill = (speed / 120.0f) * speedBarWidth;
@@ -1444,12 +1202,12 @@ void Level2::renderHUD() {
         glEnd();
         
         glColor3f(1.0f, 1.0f, 1.0f);
-        glLineWidth(2.0f);
+        GLState::lineWidth(2.0f);
         glBegin(GL_LINES);
         glVertex2f(-radius, pitch * 1.5f);
         glVertex2f(radius, pitch * 1.5f);
         glEnd();
-        glLineWidth(1.0f);
+        GLState::lineWidth(1.0f);
         
         for (int p = -30; p <= 30; p += 10) {
             if (p == 0) continue;
@@ -1465,7 +1223,7 @@ void Level2::renderHUD() {
         glPopMatrix();
         
         glColor3f(1.0f, 1.0f, 0.0f);
-        glLineWidth(3.0f);
+        GLState::lineWidth(3.0f);
         glBegin(GL_LINES);
         glVertex2f(centerX - 40, centerY);
         glVertex2f(centerX - 10, centerY);
@@ -1474,85 +1232,72 @@ void Level2::renderHUD() {
         glVertex2f(centerX - 2, centerY);
         glVertex2f(centerX + 2, centerY);
         glEnd();
-        glLineWidth(1.0f);
+        GLState::lineWidth(1.0f);
         
         glColor3f(0.8f, 0.8f, 0.8f);
-        glLineWidth(2.0f);
+        GLState::lineWidth(2.0f);
         glBegin(GL_LINE_LOOP);
         for (int i = 0; i < 360; i += 10) {
             float angle = (float)i * 3.14159f / 180.0f;
             glVertex2f(centerX + cos(angle) * radius, centerY + sin(angle) * radius);
         }
         glEnd();
-        glLineWidth(1.0f);
+        GLState::lineWidth(1.0f);
         
         sprintf_s(buffer, sizeof(buffer), "Pitch: %.0f", pitch);
-        glColor3f(1.0f, 1.0f, 1.0f);
-        glRasterPos2f(screenWidth - 220, 45);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-        }
+        textRenderer.setColor(1.0f, 1.0f, 1.0f);
+        textRenderer.add(screenWidth - 220, 45, buffer, GLUT_BITMAP_HELVETICA_12);
         
         sprintf_s(buffer, sizeof(buffer), "Roll: %.0f", roll);
-        glRasterPos2f(screenWidth - 220, 32);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-        }
+        textRenderer.add(screenWidth - 220, 32, buffer, GLUT_BITMAP_HELVETICA_12);
         
         sprintf_s(buffer, sizeof(buffer), "Heading: %.0f", yaw);
-        glRasterPos2f(screenWidth - 105, 195);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-        }
+        textRenderer.add(screenWidth - 105, 195, buffer, GLUT_BITMAP_HELVETICA_12);
     }
     
-    // Altitude warning when flying too high
-    if (flightSim && flightSim->player.position.y > 100.0f) {
-        glColor4f(1.0f, 0.0f, 0.0f, 0.7f + 0.3f * sin(arrowBobOffset * 5.0f));
+    // Altitude warning when flying too high above the ground under the plane
+    if (flightSim && flightSim->player.position.y - flightSim->getGroundHeight() > 100.0f) {
+        textRenderer.setColor(1.0f, 0.0f, 0.0f, 0.7f + 0.3f * sin(arrowBobOffset * 5.0f));
         sprintf_s(buffer, sizeof(buffer), "WARNING: Fly Lower!");
         float warnX = (screenWidth - 180) / 2.0f;
-        glRasterPos2f(warnX, screenHeight - 80);
-        for (char* c = buffer; *c != '\0'; c++) {
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-        }
+        textRenderer.add(warnX, screenHeight - 80, buffer, GLUT_BITMAP_HELVETICA_18);
     }
     
+    textRenderer.flush(TextRenderer::SCREEN_HUD);
+    
     // Restore matrices
     glMatrixMode(GL_PROJECTION);
     glPopMatrix();
     glMatrixMode(GL_MODELVIEW);
     glPopMatrix();
-    glPopAttrib();
+    GLState::pop();
 }
 
 // ============ BUILDING OBSTACLE FUNCTIONS ============
 
 // --- AIRPORT TERMINAL SYSTEM ---
-void Level2::renderAirportTerminal() {
-    glPushMatrix();
-    
+void Level2::recordAirportTerminal() {
     // Position terminal next to runway (offset to the side)
     // Terminal is placed to the left of the runway looking from approach direction
     float rotRad = runwayRotation * 3.14159f / 180.0f;
     float offsetX = -sin(rotRad) * 150.0f;  // 150 units to the left of runway (further away)
     float offsetZ = cos(rotRad) * 150.0f;
     
-    glTranslatef(runwayPosition.x + offsetX, 0.0f, runwayPosition.z + offsetZ);
-    glRotatef(runwayRotation, 0.0f, 1.0f, 0.0f);
-    glScalef(terminalScale, terminalScale, terminalScale);
-    
-    // Bind terminal texture if loaded
-    if (tex_airportTerminal != 0) {
-        glEnable(GL_TEXTURE_2D);
-        glBindTexture(GL_TEXTURE_2D, tex_airportTerminal);
-    }
-    else {
-        glDisable(GL_TEXTURE_2D);
-    }
+    RenderMatrix transform;
+    transform.translate(runwayPosition.x + offsetX, 0.0f, runwayPosition.z + offsetZ);
+    transform.rotate(runwayRotation, 0.0f, 1.0f, 0.0f);
+    transform.scale(terminalScale);
     
-    model_airportTerminal.Draw();
+    renderQueue.record(mesh_airportTerminal, mat_airportTerminal, transform);
     
-    glPopMatrix();
+    // Only stream the facade in when the terminal survives culling
+    if (tex_airportTerminal != 0 && flightSim && renderQueue.wouldDraw(mesh_airportTerminal, transform)) {
+        // The wall texture repeats roughly every 20 units across the facade
+        Vector3f toTerminal = flightSim->player.position -
+            Vector3f(runwayPosition.x + offsetX, 0.0f, runwayPosition.z + offsetZ);
+        float distance = sqrt(toTerminal.x * toTerminal.x + toTerminal.y * toTerminal.y + toTerminal.z * toTerminal.z);
+        TextureManager::getInstance().requestDetail(tex_airportTerminal, 20.0f, distance);
+    }
 }
 
 void Level2::initBuildings() {
@@ -1729,61 +1474,152 @@ void Level2::initBuildings() {
 
         buildings.push_back(warehouse);
     }
+    indexBuildings();
+}
+
+Model_3DS* Level2::getBuildingModel(const BuildingObstacle& b) {
+    Model_3DS* landmarks[7] = { &model_oldHotel, &model_laPazTower, &model_tower, &model_skyscraper02,
+                                &model_empireTrust, &model_stadium, &model_warehouse };
+    if (b.isLandmark) {
+        return (b.landmarkType >= 0 && b.landmarkType < 7) ? landmarks[b.landmarkType] : nullptr;
+    }
+    return (b.modelIndex >= 0 && b.modelIndex < 10) ? &model_buildings[b.modelIndex] : nullptr;
 }
 
-void Level2::renderBuildings() {
+void Level2::indexBuildings() {
+    // Each building's box covers both its collision box and its placed model,
+    // so collision and view queries can share the grid
+    buildingGrid.clear();
+    occluders.clear();
     for (size_t i = 0; i < buildings.size(); i++) {
+        const BuildingObstacle& b = buildings[i];
+        float minX = b.position.x - b.width / 2.0f;
+        float maxX = b.position.x + b.width / 2.0f;
+        float minZ = b.position.z - b.depth / 2.0f;
+        float maxZ = b.position.z + b.depth / 2.0f;
+        float minY = 0.0f;
+        float maxY = b.height;
+
+        Model_3DS* model = getBuildingModel(b);
+        if (model) {
+            float local[4];
+            float world[4];
+            RenderQueue::computeBounds(*model, local);
+            RenderMatrix transform;
+            transform.translate(b.position.x, b.position.y, b.position.z);
+            transform.rotate(b.rotation, 0.0f, 1.0f, 0.0f);
+            transform.scale(b.scale);
+            RenderQueue::transformBounds(transform, local, world);
+            // The stadium is an open bowl and hides nothing behind it
+            if (!(b.isLandmark && b.landmarkType == 5)) {
+                addOccluder(*model, transform);
+            }
+            if (world[3] >= 0.0f) {
+                minX = std::min(minX, world[0] - world[3]);
+                maxX = std::max(maxX, world[0] + world[3]);
+                minZ = std::min(minZ, world[2] - world[3]);
+                maxZ = std::max(maxZ, world[2] + world[3]);
+                minY = std::min(minY, world[1] - world[3]);
+                maxY = std::max(maxY, world[1] + world[3]);
+            }
+        }
+        buildingGrid.insert((int)i, minX, minZ, maxX, maxZ, minY, maxY);
+    }
+}
+
+void Level2::addOccluder(const Model_3DS& model, const RenderMatrix& transform) {
+    float minimum[3];
+    float maximum[3];
+    if (!RenderQueue::computeBox(model, minimum, maximum)) {
+        return;
+    }
+    RenderMatrix placed = transform;
+    placed.multiply(RenderQueue::getPlacement(model));
+    const float* m = placed.m;
+
+    BuildingOccluder occluder;
+    float center[3];
+    float half[3];
+    for (int k = 0; k < 3; k++) {
+        center[k] = (minimum[k] + maximum[k]) * 0.5f;
+        half[k] = (maximum[k] - minimum[k]) * 0.5f * OCCLUDER_SHRINK;
+    }
+    for (int i = 0; i < 8; i++) {
+        float corner[3] = { center[0] + ((i & 1) ? half[0] : -half[0]), center[1] + ((i & 2) ? half[1] : -half[1]),
+                            center[2] + ((i & 4) ? half[2] : -half[2]) };
+        for (int row = 0; row < 3; row++) {
+            occluder.corners[i * 3 + row] =
+                m[row] * corner[0] + m[4 + row] * corner[1] + m[8 + row] * corner[2] + m[12 + row];
+        }
+    }
+
+    float bounds[4] = { center[0], center[1], center[2],
+                        sqrtf(half[0] * half[0] + half[1] * half[1] + half[2] * half[2]) };
+    float world[4];
+    RenderQueue::transformBounds(placed, bounds, world);
+    occluder.center[0] = world[0];
+    occluder.center[1] = world[1];
+    occluder.center[2] = world[2];
+    occluder.radius = world[3];
+    occluders.push_back(occluder);
+}
+
+void Level2::prepareOcclusion() {
+    renderQueue.setOcclusion(nullptr);
+    if (!occlusionCulling || !flightSim || !viewFrustum.isValid() || occluders.empty()) {
+        return;
+    }
+
+    // Rank the occluders in view by how large they appear from the plane
+    const Vector3f& eye = flightSim->player.position;
+    occluderRanking.clear();
+    for (size_t i = 0; i < occluders.size(); i++) {
+        const BuildingOccluder& o = occluders[i];
+        if (!viewFrustum.testSphere(o.center[0], o.center[1], o.center[2], o.radius)) continue;
+        float dx = o.center[0] - eye.x;
+        float dy = o.center[1] - eye.y;
+        float dz = o.center[2] - eye.z;
+        float size = o.radius / std::max(sqrtf(dx * dx + dy * dy + dz * dz), 1.0f);
+        if (size < MIN_OCCLUDER_SIZE) continue;
+        occluderRanking.push_back(std::make_pair(size, (int)i));
+    }
+    if (occluderRanking.empty()) {
+        return;
+    }
+    int count = std::min((int)occluderRanking.size(), MAX_OCCLUDERS);
+    std::partial_sort(occluderRanking.begin(), occluderRanking.begin() + count, occluderRanking.end(),
+                      std::greater<std::pair<float, int> >());
+
+    occlusionBuffer.begin(viewFrustum.getClipMatrix());
+    for (int i = 0; i < count; i++) {
+        occlusionBuffer.addBox(occluders[occluderRanking[i].second].corners);
+    }
+    occlusionBuffer.finish();
+    renderQueue.setOcclusion(&occlusionBuffer);
+}
+
+void Level2::recordBuildings() {
+    // Only the buildings whose cells are in view reach the queue
+    buildingGrid.queryFrustum(viewFrustum, gridHits);
+    for (int i : gridHits) {
         BuildingObstacle& b = buildings[i];
         
-        glPushMatrix();
-        
-        // Position the building
-        glTranslatef(b.position.x, b.position.y, b.position.z);
+        RenderMatrix transform;
+        transform.translate(b.position.x, b.position.y, b.position.z);  // Position the building
+        transform.rotate(b.rotation, 0.0f, 1.0f, 0.0f);  // Rotate around Y axis
+        transform.scale(b.scale);  // Scale the building
         
-        // Rotate around Y axis
-        glRotatef(b.rotation, 0.0f, 1.0f, 0.0f);
-        
-        // Scale the building
-        glScalef(b.scale, b.scale, b.scale);
-        
-        // Set material properties based on building type
+        // Landmarks are glass & steel, the rest concrete/brick (see registerRenderMeshes)
+        int mesh, material;
         if (b.isLandmark) {
-            // Landmark buildings - glass & steel (high specular)
-            GLfloat landmarkAmbient[] = { 0.3f, 0.3f, 0.35f, 1.0f };
-            GLfloat landmarkDiffuse[] = { 0.7f, 0.7f, 0.75f, 1.0f };
-            GLfloat landmarkSpecular[] = { 0.9f, 0.9f, 0.95f, 1.0f };
-            GLfloat landmarkShininess = 60.0f;  // Very shiny glass/steel
-            glMaterialfv(GL_FRONT, GL_AMBIENT, landmarkAmbient);
-            glMaterialfv(GL_FRONT, GL_DIFFUSE, landmarkDiffuse);
-            glMaterialfv(GL_FRONT, GL_SPECULAR, landmarkSpecular);
-            glMaterialf(GL_FRONT, GL_SHININESS, landmarkShininess);
-            
-            // Draw landmark building based on type
-            switch (b.landmarkType) {
-                case 0: model_oldHotel.Draw(); break;
-                case 1: model_laPazTower.Draw(); break;
-                case 2: model_tower.Draw(); break;
-                case 3: model_skyscraper02.Draw(); break;
-                case 4: model_empireTrust.Draw(); break;
-                case 5: model_stadium.Draw(); break;
-                case 6: model_warehouse.Draw(); break;  // Warehouse for outskirts
-            }
+            if (b.landmarkType < 0 || b.landmarkType >= 7) continue;
+            mesh = mesh_landmarks[b.landmarkType];
+            material = mat_landmark;
         } else {
-            // Regular residential buildings - concrete/brick (low specular)
-            GLfloat buildingAmbient[] = { 0.3f, 0.28f, 0.25f, 1.0f };
-            GLfloat buildingDiffuse[] = { 0.65f, 0.6f, 0.55f, 1.0f };
-            GLfloat buildingSpecular[] = { 0.2f, 0.2f, 0.2f, 1.0f };
-            GLfloat buildingShininess = 10.0f;  // Matte concrete/brick
-            glMaterialfv(GL_FRONT, GL_AMBIENT, buildingAmbient);
-            glMaterialfv(GL_FRONT, GL_DIFFUSE, buildingDiffuse);
-            glMaterialfv(GL_FRONT, GL_SPECULAR, buildingSpecular);
-            glMaterialf(GL_FRONT, GL_SHININESS, buildingShininess);
-            
-            // Draw regular residential building
-            model_buildings[b.modelIndex].Draw();
+            mesh = mesh_buildings[b.modelIndex];
+            material = mat_building;
         }
-        
-        glPopMatrix();
+        renderQueue.record(mesh, material, transform);
     }
 }
 
@@ -1793,8 +1629,9 @@ void Level2::checkBuildingCollision() {
     Vector3f playerPos = flightSim->player.position;
     float playerRadius = 5.0f;  // Approximate plane collision radius
     
-    // Check collision with buildings
-    for (size_t i = 0; i < buildings.size(); i++) {
+    // Check collision with the buildings near the plane
+    buildingGrid.queryRadius(playerPos.x, playerPos.z, playerRadius, gridHits);
+    for (int i : gridHits) {
         BuildingObstacle& b = buildings[i];
         
         // Simple AABB collision check
@@ -1822,7 +1659,8 @@ void Level2::checkBuildingCollision() {
     }
     
     // Check collision with trees (cylindrical collision)
-    for (size_t i = 0; i < trees.size(); i++) {
+    treeGrid.queryRadius(playerPos.x, playerPos.z, playerRadius, gridHits);
+    for (int i : gridHits) {
         CardboardTree& tree = trees[i];
         
         // Calculate horizontal distance from tree
@@ -1861,7 +1699,7 @@ void Level2::initAirport() {
 }
 
 void Level2::renderAirport() {
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    GLState::push(GL_CURRENT_BIT);
     glPushMatrix();
     
     // Transform to runway position and rotation
@@ -1869,26 +1707,34 @@ void Level2::renderAirport() {
     glRotatef(runwayRotation, 0.0f, 1.0f, 0.0f);
     
     // Enable texturing
-    glDisable(GL_CULL_FACE); // Draw both sides; avoid cull state issues
-    glEnable(GL_TEXTURE_2D);
-    glDisable(GL_LIGHTING);
-    glEnable(GL_POLYGON_OFFSET_FILL);
-    glPolygonOffset(-1.0f, -1.0f);  // Pull runway slightly toward camera to prevent z-fighting
+    GLState::disable(GL_CULL_FACE); // Draw both sides; avoid cull state issues
+    GLState::enable(GL_TEXTURE_2D);
+    GLState::disable(GL_LIGHTING);
+    GLState::enable(GL_POLYGON_OFFSET_FILL);
+    GLState::polygonOffset(-1.0f, -1.0f);  // Pull runway slightly toward camera to prevent z-fighting
 
     // Ensure we have a valid runway texture (fallback to gray if load failed)
     if (tex_runway == 0) {
         glGenTextures(1, &tex_runway);
-        glBindTexture(GL_TEXTURE_2D, tex_runway);
+        GLState::bindTexture(tex_runway);
         unsigned char gray[3] = { 80, 80, 80 };
         glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, gray);
     }
-    glBindTexture(GL_TEXTURE_2D, tex_runway);
+    GLState::bindTexture(tex_runway);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glColor3f(1.0f, 1.0f, 1.0f);
     
     float halfLength = runwayLength / 2.0f;
     float halfWidth = runwayWidth / 2.0f;
+
+    // One repeat per runway width; nearest point is about the distance to the strip's end
+    if (flightSim) {
+        Vector3f toRunway = flightSim->player.position - runwayPosition;
+        float distance = sqrt(toRunway.x * toRunway.x + toRunway.y * toRunway.y + toRunway.z * toRunway.z) - halfLength;
+        if (distance < flightSim->player.position.y) distance = flightSim->player.position.y;
+        TextureManager::getInstance().requestDetail(tex_runway, runwayWidth, distance);
+    }
     
     // Main runway surface (dark asphalt)
     glBegin(GL_QUADS);
@@ -1901,8 +1747,8 @@ void Level2::renderAirport() {
     glEnd();
     
     // Runway shoulders (slightly lighter concrete)
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_POLYGON_OFFSET_FILL);
+    GLState::disable(GL_TEXTURE_2D);
+    GLState::disable(GL_POLYGON_OFFSET_FILL);
     float shoulderWidth = 8.0f;
     glColor3f(0.35f, 0.35f, 0.33f);
     
@@ -1946,23 +1792,23 @@ void Level2::renderAirport() {
     glVertex3f(-halfWidth, 0.02f, -halfLength + thresholdLength);
     glEnd();
     
-    glEnable(GL_CULL_FACE);
+    GLState::enable(GL_CULL_FACE);
     glPopMatrix();
-    glPopAttrib();
+    GLState::pop();
 }
 
 void Level2::renderRunwayMarkings() {
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    GLState::push(GL_CURRENT_BIT);
     glPushMatrix();
     
     glTranslatef(runwayPosition.x, runwayPosition.y + 0.06f, runwayPosition.z); // lift markings to avoid z-fight
     glRotatef(runwayRotation, 0.0f, 1.0f, 0.0f);
     
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_LIGHTING);
-    glDisable(GL_CULL_FACE);          // Ensure markings are not culled
-    glEnable(GL_POLYGON_OFFSET_FILL);
-    glPolygonOffset(-1.0f, -1.0f);    // Pull markings toward camera
+    GLState::disable(GL_TEXTURE_2D);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_CULL_FACE);          // Ensure markings are not culled
+    GLState::enable(GL_POLYGON_OFFSET_FILL);
+    GLState::polygonOffset(-1.0f, -1.0f);    // Pull markings toward camera
     
     float halfLength = runwayLength / 2.0f;
     float halfWidth = runwayWidth / 2.0f;
@@ -2098,7 +1944,7 @@ void Level2::renderRunwayMarkings() {
     
     // Draw "3"
     float num3X = 6.0f;
-    glLineWidth(2.0f);
+    GLState::lineWidth(2.0f);
     glBegin(GL_LINE_STRIP);
     glVertex3f(num3X - 2*numScale, 0, numZ);
     glVertex3f(num3X + 2*numScale, 0, numZ);
@@ -2109,10 +1955,10 @@ void Level2::renderRunwayMarkings() {
     glVertex3f(num3X - 2*numScale, 0, numZ - 8*numScale);
     glEnd();
     
-    glDisable(GL_POLYGON_OFFSET_FILL);
-    glEnable(GL_CULL_FACE);
+    GLState::disable(GL_POLYGON_OFFSET_FILL);
+    GLState::enable(GL_CULL_FACE);
     glPopMatrix();
-    glPopAttrib();
+    GLState::pop();
 }
 
 void Level2::renderPAPI(bool isNight) {
@@ -2120,16 +1966,16 @@ void Level2::renderPAPI(bool isNight) {
     // 4 lights on each side of runway threshold
     // Shows glide slope: 2 red/2 white = on glide path
     
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    GLState::push(GL_CURRENT_BIT);
     glPushMatrix();
     
     glTranslatef(runwayPosition.x, runwayPosition.y, runwayPosition.z);
     glRotatef(runwayRotation, 0.0f, 1.0f, 0.0f);
     
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+    GLState::disable(GL_TEXTURE_2D);
+    GLState::disable(GL_LIGHTING);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE);
     
     float halfLength = runwayLength / 2.0f;
     float halfWidth = runwayWidth / 2.0f;
@@ -2178,7 +2024,7 @@ void Level2::renderPAPI(bool isNight) {
     }
     
     glPopMatrix();
-    glPopAttrib();
+    GLState::pop();
 }
 
 void Level2::renderRunwayLights(bool isNight) {
@@ -2187,16 +2033,16 @@ void Level2::renderRunwayLights(bool isNight) {
     if (!isNight) baseBrightness = 0.0f;  // Only show at night for now
     if (baseBrightness < 0.01f) return;
     
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    GLState::push(GL_CURRENT_BIT);
     glPushMatrix();
     
     glTranslatef(runwayPosition.x, runwayPosition.y, runwayPosition.z);
     glRotatef(runwayRotation, 0.0f, 1.0f, 0.0f);
     
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);  // Additive blending for emissive glow
+    GLState::disable(GL_TEXTURE_2D);
+    GLState::disable(GL_LIGHTING);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE);  // Additive blending for emissive glow
     
     float halfLength = runwayLength / 2.0f;
     float halfWidth = runwayWidth / 2.0f;
@@ -2374,7 +2220,7 @@ void Level2::renderRunwayLights(bool isNight) {
     }
     
     glPopMatrix();
-    glPopAttrib();
+    GLState::pop();
 }
 
 void Level2::renderTargetArrow() {
@@ -2389,8 +2235,8 @@ void Level2::renderTargetArrow() {
     // Rotate to always face somewhat visible
     glRotatef(arrowBobOffset * 30.0f, 0.0f, 1.0f, 0.0f);
     
-    glDisable(GL_LIGHTING);
-    glDisable(GL_TEXTURE_2D);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_TEXTURE_2D);
     
     // Draw a 3D arrow pointing down
     float arrowSize = 15.0f;
@@ -2448,7 +2294,7 @@ void Level2::renderTargetArrow() {
     glVertex3f(0.0f, -arrowSize - 12.0f, -3.0f);
     glEnd();
     
-    glEnable(GL_LIGHTING);
+    GLState::enable(GL_LIGHTING);
     glPopMatrix();
 }
 
@@ -2494,6 +2340,7 @@ void Level2::checkLandingCondition() {
 }
 
 void Level2::renderWinScreen() {
+    TextRenderer& textRenderer = TextRenderer::getInstance();
     // Setup 2D rendering
     glMatrixMode(GL_PROJECTION);
     glPushMatrix();
@@ -2504,10 +2351,10 @@ void Level2::renderWinScreen() {
     glPushMatrix();
     glLoadIdentity();
     
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::disable(GL_LIGHTING);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
     // Semi-transparent overlay
     float alpha = (winMessageTimer < 1.0f) ? winMessageTimer : 1.0f;
@@ -2536,7 +2383,7 @@ void Level2::renderWinScreen() {
     
     // Box border
     glColor4f(0.3f, 1.0f, 0.3f, alpha);
-    glLineWidth(3.0f);
+    GLState::lineWidth(3.0f);
     glBegin(GL_LINE_LOOP);
     glVertex2f(boxX, boxY);
     glVertex2f(boxX + boxWidth, boxY);
@@ -2545,37 +2392,25 @@ void Level2::renderWinScreen() {
     glEnd();
     
     // Draw "YOU WIN!" text
-    glColor4f(1.0f, 1.0f, 1.0f, alpha);
+    textRenderer.setColor(1.0f, 1.0f, 1.0f, alpha);
     char buffer[128];
     
     // Title
     sprintf_s(buffer, sizeof(buffer), "MISSION COMPLETE!");
     float textX = boxX + 100;
-    glRasterPos2f(textX, boxY + boxHeight - 30);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(textX, boxY + boxHeight - 30, buffer, GLUT_BITMAP_HELVETICA_18);
     
     // Score breakdown
-    glColor4f(0.9f, 0.9f, 0.5f, alpha);
+    textRenderer.setColor(0.9f, 0.9f, 0.5f, alpha);
     sprintf_s(buffer, sizeof(buffer), "Landing Bonus: +%d", landingBonus);
-    glRasterPos2f(textX - 30, boxY + boxHeight - 60);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(textX - 30, boxY + boxHeight - 60, buffer, GLUT_BITMAP_HELVETICA_18);
     
     sprintf_s(buffer, sizeof(buffer), "Fuel Collected: %d", collectedCount);
-    glRasterPos2f(textX - 30, boxY + boxHeight - 85);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(textX - 30, boxY + boxHeight - 85, buffer, GLUT_BITMAP_HELVETICA_18);
     
-    glColor4f(1.0f, 1.0f, 0.2f, alpha);
+    textRenderer.setColor(1.0f, 1.0f, 0.2f, alpha);
     sprintf_s(buffer, sizeof(buffer), "FINAL SCORE: %d", score);
-    glRasterPos2f(textX - 20, boxY + boxHeight - 120);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(textX - 20, boxY + boxHeight - 120, buffer, GLUT_BITMAP_HELVETICA_18);
     
     // Draw a star pattern as celebration
     float starX = boxX + 50;
@@ -2592,9 +2427,11 @@ void Level2::renderWinScreen() {
     }
     glEnd();
     
-    glDisable(GL_BLEND);
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    textRenderer.flush(TextRenderer::SCREEN_LEVEL_COMPLETE);
+    
+    GLState::disable(GL_BLEND);
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_LIGHTING);
     
     glMatrixMode(GL_PROJECTION);
     glPopMatrix();
@@ -2603,6 +2440,7 @@ void Level2::renderWinScreen() {
 }
 
 void Level2::renderGameOverScreen() {
+    TextRenderer& textRenderer = TextRenderer::getInstance();
     // Setup 2D rendering
     glMatrixMode(GL_PROJECTION);
     glPushMatrix();
@@ -2613,10 +2451,10 @@ void Level2::renderGameOverScreen() {
     glPushMatrix();
     glLoadIdentity();
     
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::disable(GL_LIGHTING);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
     // Red-tinted overlay
     glColor4f(0.3f, 0.0f, 0.0f, 0.6f);
@@ -2644,7 +2482,7 @@ void Level2::renderGameOverScreen() {
     
     // Box border
     glColor4f(1.0f, 0.3f, 0.3f, 1.0f);
-    glLineWidth(3.0f);
+    GLState::lineWidth(3.0f);
     glBegin(GL_LINE_LOOP);
     glVertex2f(boxX, boxY);
     glVertex2f(boxX + boxWidth, boxY);
@@ -2655,37 +2493,27 @@ void Level2::renderGameOverScreen() {
     // Game Over text
     char buffer[128];
     
-    glColor3f(1.0f, 0.3f, 0.3f);
+    textRenderer.setColor(1.0f, 0.3f, 0.3f);
     sprintf_s(buffer, sizeof(buffer), "TIME'S UP!");
     float textX = boxX + 120;
-    glRasterPos2f(textX, boxY + boxHeight - 35);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(textX, boxY + boxHeight - 35, buffer, GLUT_BITMAP_HELVETICA_18);
     
-    glColor3f(1.0f, 1.0f, 1.0f);
+    textRenderer.setColor(1.0f, 1.0f, 1.0f);
     sprintf_s(buffer, sizeof(buffer), "You ran out of time!");
-    glRasterPos2f(textX - 30, boxY + boxHeight - 65);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(textX - 30, boxY + boxHeight - 65, buffer, GLUT_BITMAP_HELVETICA_18);
     
     sprintf_s(buffer, sizeof(buffer), "Fuel Collected: %d", collectedCount);
-    glRasterPos2f(textX - 20, boxY + boxHeight - 95);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(textX - 20, boxY + boxHeight - 95, buffer, GLUT_BITMAP_HELVETICA_18);
     
-    glColor4f(0.8f, 0.8f, 0.3f, 1.0f);
+    textRenderer.setColor(0.8f, 0.8f, 0.3f, 1.0f);
     sprintf_s(buffer, sizeof(buffer), "Final Score: %d", score);
-    glRasterPos2f(textX - 10, boxY + boxHeight - 125);
-    for (char* c = buffer; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(textX - 10, boxY + boxHeight - 125, buffer, GLUT_BITMAP_HELVETICA_18);
     
-    glDisable(GL_BLEND);
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
+    textRenderer.flush(TextRenderer::SCREEN_GAME_OVER);
+    
+    GLState::disable(GL_BLEND);
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_LIGHTING);
     
     glMatrixMode(GL_PROJECTION);
     glPopMatrix();
@@ -2697,7 +2525,8 @@ void Level2::renderShadows() {
     if (!flightSim) return;
     
     // Render plane shadow (oval shaped, follows plane orientation)
-    float planeHeight = flightSim->player.position.y;
+    float groundHeight = flightSim->getGroundHeight();
+    float planeHeight = flightSim->player.position.y - groundHeight;
     if (planeHeight < 150.0f) {  // Only render shadow if plane is not too high
         shadowSystem.renderOvalShadow(
             flightSim->player.position,
@@ -2705,7 +2534,8 @@ void Level2::renderShadows() {
             8.0f,   // Length (plane is longer than wide)
             4.0f,   // Width
             planeHeight,
-            150.0f  // Max height for visible shadow
+            150.0f, // Max height for visible shadow
+            groundHeight
         );
     }
     
@@ -2732,6 +2562,9 @@ void Level2::renderShadows() {
     
     // Runway shadow/AO (subtle under the runway area)
     shadowSystem.renderBaseAO(runwayPosition, runwayWidth, 0.15f);
+    
+    // Everything above was only queued; draw it as one batch
+    shadowSystem.flush();
 }
 
 // ============ CARDBOARD TREE SYSTEM ============
@@ -2829,6 +2662,12 @@ void Level2::initTrees() {
     }
     
     // ===== ADDITIONAL FOREST COVERAGE in surrounding areas =====
+    // Road trees so far; the spacing check below only looks at nearby cells
+    treeGrid.clear();
+    for (size_t i = 0; i < trees.size(); i++) {
+        insertTree((int)i);
+    }
+
     const int numRandomTrees = 300;  // Additional trees for natural forest
     const float forestSize = 1500.0f;
     const float minDistFromAirport = 300.0f;
@@ -2847,8 +2686,8 @@ void Level2::initTrees() {
         float distance = minDistFromAirport + (rand() % (int)(forestSize - minDistFromAirport));
         
         tree.position.x = runwayPosition.x + cos(angle) * distance;
-        tree.position.y = 0.0f;
         tree.position.z = runwayPosition.z + sin(angle) * distance;
+        tree.position.y = terrain.getHeight(tree.position.x, tree.position.z);
         
         // Check if position is clear
         if (!isPositionClearForTree(tree.position)) {
@@ -2857,7 +2696,8 @@ void Level2::initTrees() {
         
         // Check spacing from other trees
         bool tooClose = false;
-        for (size_t i = 0; i < trees.size(); i++) {
+        treeGrid.queryRadius(tree.position.x, tree.position.z, minTreeSpacing, gridHits);
+        for (int i : gridHits) {
             float dx = trees[i].position.x - tree.position.x;
             float dz = trees[i].position.z - tree.position.z;
             float dist = sqrt(dx * dx + dz * dz);
@@ -2876,6 +2716,7 @@ void Level2::initTrees() {
         tree.height = tree.scale;
 
         trees.push_back(tree);
+        insertTree((int)trees.size() - 1);
     }
 
     // ===== FARM/FOREST PATTERN AROUND WAREHOUSES =====
@@ -2907,8 +2748,8 @@ void Level2::initTrees() {
                 float offset = (t - treesPerLine / 2) * treeLineSpacing;
 
                 farmTree.position.x = lineStart.x + cos(perpAngle) * offset;
-                farmTree.position.y = 0.0f;
                 farmTree.position.z = lineStart.z + sin(perpAngle) * offset;
+                farmTree.position.y = terrain.getHeight(farmTree.position.x, farmTree.position.z);
 
                 // Check if position is valid
                 if (!isPositionClearForTree(farmTree.position)) continue;
@@ -2941,8 +2782,8 @@ void Level2::initTrees() {
             float treeDist = (rand() % (int)clusterRadius);
 
             clusterTree.position.x = clusterCenter.x + cos(treeAngle) * treeDist;
-            clusterTree.position.y = 0.0f;
             clusterTree.position.z = clusterCenter.z + sin(treeAngle) * treeDist;
+            clusterTree.position.y = terrain.getHeight(clusterTree.position.x, clusterTree.position.z);
 
             if (!isPositionClearForTree(clusterTree.position)) continue;
 
@@ -2956,6 +2797,19 @@ void Level2::initTrees() {
             trees.push_back(clusterTree);
         }
     }
+
+    treeGrid.clear();
+    for (size_t i = 0; i < trees.size(); i++) {
+        insertTree((int)i);
+    }
+}
+
+void Level2::insertTree(int index) {
+    // Collision cylinder footprint, full height
+    const CardboardTree& tree = trees[index];
+    float extent = std::max(tree.radius, tree.scale * 0.5f);
+    treeGrid.insert(index, tree.position.x - extent, tree.position.z - extent, tree.position.x + extent,
+                    tree.position.z + extent, tree.position.y, tree.position.y + std::max(tree.height, tree.scale));
 }
 
 bool Level2::isPositionClearForTree(const Vector3f& pos) {
@@ -2976,7 +2830,8 @@ bool Level2::isPositionClearForTree(const Vector3f& pos) {
     }
     
     // Check distance from buildings
-    for (size_t i = 0; i < buildings.size(); i++) {
+    buildingGrid.queryRadius(pos.x, pos.z, 30.0f, gridHits);
+    for (int i : gridHits) {
         float bx = pos.x - buildings[i].position.x;
         float bz = pos.z - buildings[i].position.z;
         float distFromBuilding = sqrt(bx * bx + bz * bz);
@@ -2988,68 +2843,39 @@ bool Level2::isPositionClearForTree(const Vector3f& pos) {
     return true;
 }
 
+void Level2::buildForest() {
+    // Trees never move: two crossed quads each (like Minecraft grass/flowers), baked once
+    forest.release();
+    for (size_t i = 0; i < trees.size(); i++) {
+        const CardboardTree& tree = trees[i];
+        forest.addCross(tree.position, tree.scale, tree.scale, tree.rotation,
+                        treeAtlas.getRect(sprite_tree[tree.textureVariant]));
+    }
+    forest.build();
+    printf("Forest: %d trees in %d chunks\n", (int)trees.size(), forest.getChunkCount());
+}
+
 void Level2::renderTrees() {
     if (!flightSim) return;
     
     Vector3f cameraPos = flightSim->player.position;
-    float renderDistance = 800.0f;  // Only render trees within this distance
+    float renderDistance = 800.0f;  // Only render chunks within this distance
     
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_ALPHA_TEST);
-    glAlphaFunc(GL_GREATER, 0.1f);
-    glEnable(GL_TEXTURE_2D);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::enable(GL_ALPHA_TEST);
+    GLState::alphaFunc(GL_GREATER, 0.1f);
+    GLState::enable(GL_TEXTURE_2D);
     
-    glDisable(GL_CULL_FACE);  // Render both sides of the cross
-    glDepthMask(GL_TRUE);
+    GLState::disable(GL_CULL_FACE);  // Render both sides of the cross
+    GLState::depthMask(true);
     
-    for (size_t i = 0; i < trees.size(); i++) {
-        CardboardTree& tree = trees[i];
-        
-        // Distance culling
-        float dx = tree.position.x - cameraPos.x;
-        float dz = tree.position.z - cameraPos.z;
-        float dist = sqrt(dx * dx + dz * dz);
-        if (dist > renderDistance) continue;
-        
-        // Bind appropriate tree texture
-        glBindTexture(GL_TEXTURE_2D, tex_tree[tree.textureVariant]);
-        
-        glPushMatrix();
-        glTranslatef(tree.position.x, tree.position.y, tree.position.z);
-        
-        // Draw two crossed quads (like Minecraft grass/flowers)
-        float halfSize = tree.scale * 0.5f;
-        float height = tree.scale;
-        
-        glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
-        
-        // First quad (along X axis)
-        glPushMatrix();
-        glRotatef(tree.rotation, 0, 1, 0);
-        glBegin(GL_QUADS);
-        glTexCoord2f(0.0f, 1.0f); glVertex3f(-halfSize, 0.0f, 0.0f);
-        glTexCoord2f(1.0f, 1.0f); glVertex3f(halfSize, 0.0f, 0.0f);
-        glTexCoord2f(1.0f, 0.0f); glVertex3f(halfSize, height, 0.0f);
-        glTexCoord2f(0.0f, 0.0f); glVertex3f(-halfSize, height, 0.0f);
-        glEnd();
-        glPopMatrix();
-        
-        // Second quad (perpendicular, along Z axis)
-        glPushMatrix();
-        glRotatef(tree.rotation + 90.0f, 0, 1, 0);
-        glBegin(GL_QUADS);
-        glTexCoord2f(0.0f, 1.0f); glVertex3f(-halfSize, 0.0f, 0.0f);
-        glTexCoord2f(1.0f, 1.0f); glVertex3f(halfSize, 0.0f, 0.0f);
-        glTexCoord2f(1.0f, 0.0f); glVertex3f(halfSize, height, 0.0f);
-        glTexCoord2f(0.0f, 0.0f); glVertex3f(-halfSize, height, 0.0f);
-        glEnd();
-        glPopMatrix();
-        
-        glPopMatrix();
-    }
+    // All three tree variants are in one atlas: one bind, one draw per run of nearby chunks
+    GLState::bindTexture(treeAtlas.getTexture());
+    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+    forest.draw(cameraPos, renderDistance);
     
-    glEnable(GL_CULL_FACE);
-    glDisable(GL_ALPHA_TEST);
-    glDisable(GL_BLEND);
+    GLState::enable(GL_CULL_FACE);
+    GLState::disable(GL_ALPHA_TEST);
+    GLState::disable(GL_BLEND);
 }
\ No newline at end of file
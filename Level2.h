@@ -9,6 +9,12 @@
 #include "SoundSystem.h"
 #include "ShadowSystem.h"
 #include "ShootingSystem.h"
+#include "SpriteAtlas.h"
+#include "BillboardBatch.h"
+#include "GrassField.h"
+#include "Terrain.h"
+#include "SpatialGrid.h"
+#include "OcclusionBuffer.h"
 #include <vector>
 
 // Forward declaration
@@ -62,6 +68,10 @@ public:
     
     void onEnter() override;
     void onExit() override;
+    void recordScene() override;
+    
+    // Off: the city is culled against the view frustum only (for comparison)
+    static void setOcclusionCulling(bool enabled) { occlusionCulling = enabled; }
     
 private:
     FlightController* flightSim;
@@ -85,14 +95,13 @@ private:
     GLuint tex_runway;              // Runway texture
     GLuint tex_grass;               // Grass billboard texture
     GLuint tex_fuelContainer;       // Fuel container texture
-    GLuint tex_tree[3];             // Three tree texture variations
+    SpriteAtlas treeAtlas;          // Three tree texture variations, one texture
+    int sprite_tree[3];
     GLuint tex_warehouse;           // Warehouse texture (Steel_C.bmp)
     
-    // Optimized Billboard Grass System (no 3D models - much faster)
-    static const int GRASS_GRID_SIZE = 12;      // Grid cells around player (reduced)
-    static const int GRASS_PER_CELL = 2;        // Grass patches per cell
+    // Billboard grass, generated once per cell as the player comes near
+    GrassField grassField;
     float grassRenderDistance;                   // Max render distance
-    float grassCellSize;                         // Size of each grid cell
     void renderGrass();
     
     // Particle Effects System (shared between levels)
@@ -102,7 +111,7 @@ private:
     Vector3f terminalPosition;
     float terminalRotation;
     float terminalScale;
-    void renderAirportTerminal();
+    void recordAirportTerminal();
     
     // Sky and Lens Flare System (shared/reusable)
     SkySystem skySystem;
@@ -156,26 +165,60 @@ private:
     
     // Building Obstacle System
     std::vector<BuildingObstacle> buildings;
+    SpatialGrid buildingGrid;       // Collision box and model bounds per building
     void initBuildings();
-    void renderBuildings();
+    void indexBuildings();
+    Model_3DS* getBuildingModel(const BuildingObstacle& b);
+    void recordBuildings();
     void checkBuildingCollision();
     
+    // Occlusion culling: a shrunken box inside each building's model; the
+    // largest on screen are rasterized each frame before the queue is culled
+    struct BuildingOccluder {
+        float corners[24];
+        float center[3];
+        float radius;
+    };
+    std::vector<BuildingOccluder> occluders;
+    std::vector<std::pair<float, int> > occluderRanking;
+    OcclusionBuffer occlusionBuffer;
+    static bool occlusionCulling;
+    void addOccluder(const Model_3DS& model, const RenderMatrix& transform);
+    void prepareOcclusion();
+    
     // Fuel Collectable System
     std::vector<FuelCollectable> fuelContainers;
     int collectedCount;
     float collectableTimer;  // For animation timing
+    SpatialGrid fuelGrid;
     void initFuelContainers();
+    void indexFuelContainers();
     void updateFuelContainers(float deltaTime);
-    void renderFuelContainers();
+    void recordFuelContainers();
     void checkFuelCollision();
     void renderHUD();
     
     // Cardboard Tree System (forest cover)
     std::vector<CardboardTree> trees;
+    BillboardBatch forest;          // Tree cross-quads, chunked for distance culling
+    SpatialGrid treeGrid;           // Tree collision cylinders
     void initTrees();
+    void insertTree(int index);
+    void buildForest();
     void renderTrees();
     bool isPositionClearForTree(const Vector3f& pos);
     
+    std::vector<int> gridHits;      // Scratch results for the grid queries
+    
+    Terrain terrain;                // Hills past the flat play area, streamed in chunks
     void renderGround();
     void loadAssets();
+    
+    // Render queue handles (registered once in registerRenderMeshes)
+    int mesh_house, mesh_tree, mesh_fuelContainer, mesh_airportTerminal;
+    int mesh_buildings[10];
+    int mesh_landmarks[7];          // Indexed by BuildingObstacle::landmarkType
+    int mat_default, mat_landmark, mat_building, mat_airportTerminal;
+    std::vector<int> mat_fuelContainers;    // One per container, emission pulses independently
+    void registerRenderMeshes();
 };
\ No newline at end of file
@@ -0,0 +1,406 @@
+#include "MipBuilder.h"
+#include "WorkerPool.h"
+#include <emmintrin.h>
+#include <math.h>
+#include <cstring>
+
+// Linear float copy of an image, always 4 floats (RGBA) per pixel so every
+// pixel is one SSE register
+struct FloatImage {
+    int width = 0;
+    int height = 0;
+    std::vector<float> data;
+
+    float* row(int y) { return &data[(size_t)y * width * 4]; }
+    const float* row(int y) const { return &data[(size_t)y * width * 4]; }
+};
+
+static const int KAISER_TAPS = 8;
+
+// sRGB <-> linear lookup tables and the Kaiser kernel, built once on first use
+struct FilterTables {
+    float toLinear[256];
+    unsigned char toSrgb[4096];
+    unsigned char toByte[4096];
+    float kaiser[KAISER_TAPS];
+
+    FilterTables() {
+        for (int i = 0; i < 256; i++) {
+            float c = i / 255.0f;
+            toLinear[i] = c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+        }
+        for (int i = 0; i < 4096; i++) {
+            float l = i / 4095.0f;
+            float c = l <= 0.0031308f ? l * 12.92f : 1.055f * powf(l, 1.0f / 2.4f) - 0.055f;
+            toSrgb[i] = (unsigned char)(c * 255.0f + 0.5f);
+            toByte[i] = (unsigned char)((i * 255 + 2047) / 4095);
+        }
+
+        // Windowed sinc with its cutoff at the new Nyquist limit (half the
+        // source rate); taps sit at -3.5 .. 3.5 source pixels from the center
+        const float alpha = 4.0f;
+        const float radius = KAISER_TAPS / 2.0f;
+        float sum = 0.0f;
+        for (int k = 0; k < KAISER_TAPS; k++) {
+            float x = k - (KAISER_TAPS - 1) / 2.0f;
+            float t = x * 0.5f * 3.14159265f;
+            float sinc = sinf(t) / t;
+            float r = x / radius;
+            float window = besselI0(alpha * sqrtf(1.0f - r * r)) / besselI0(alpha);
+            kaiser[k] = sinc * window;
+            sum += kaiser[k];
+        }
+        for (int k = 0; k < KAISER_TAPS; k++) {
+            kaiser[k] /= sum;
+        }
+    }
+
+    static float besselI0(float x) {
+        float sum = 1.0f;
+        float term = 1.0f;
+        for (int k = 1; k < 20; k++) {
+            float f = x / (2.0f * k);
+            term *= f * f;
+            sum += term;
+        }
+        return sum;
+    }
+};
+
+static const FilterTables& getTables() {
+    static FilterTables tables;
+    return tables;
+}
+
+// Rows per WorkerPool chunk: about 32K pixels, so small levels run inline
+static int rowGrain(int width) {
+    int grain = 32768 / (width > 0 ? width : 1);
+    return grain > 0 ? grain : 1;
+}
+
+static int nearestPowerOfTwo(int n) {
+    int p = 1;
+    while (p * 2 <= n) p *= 2;
+    if (n - p > p * 2 - n) p *= 2;
+    return p;
+}
+
+//=======================================================================
+// 8-bit <-> float
+//=======================================================================
+
+static void toFloat(const ImageData& image, bool gammaCorrect, FloatImage& out) {
+    const FilterTables& tables = getTables();
+    out.width = image.width;
+    out.height = image.height;
+    out.data.resize((size_t)image.width * image.height * 4);
+
+    int c = image.channels;
+    WorkerPool::getInstance().parallelFor(image.height, rowGrain(image.width), [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            const unsigned char* src = &image.pixels[(size_t)y * image.width * c];
+            float* dest = out.row(y);
+            for (int x = 0; x < image.width; x++) {
+                for (int i = 0; i < 3; i++) {
+                    dest[i] = gammaCorrect ? tables.toLinear[src[i]] : src[i] / 255.0f;
+                }
+                dest[3] = c == 4 ? src[3] / 255.0f : 1.0f;
+                src += c;
+                dest += 4;
+            }
+        }
+    });
+}
+
+static void toBytes(const FloatImage& image, int channels, bool gammaCorrect, ImageData& out) {
+    const FilterTables& tables = getTables();
+    out.width = image.width;
+    out.height = image.height;
+    out.channels = channels;
+    out.pixels.resize((size_t)image.width * image.height * channels);
+
+    const unsigned char* colorTable = gammaCorrect ? tables.toSrgb : tables.toByte;
+    WorkerPool::getInstance().parallelFor(image.height, rowGrain(image.width), [&](int begin, int end) {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(4095.0f);
+        const __m128 half = _mm_set1_ps(0.5f);
+        int index[4];
+
+        for (int y = begin; y < end; y++) {
+            const float* src = image.row(y);
+            unsigned char* dest = &out.pixels[(size_t)y * image.width * channels];
+            for (int x = 0; x < image.width; x++) {
+                __m128 p = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src), zero), one);
+                _mm_storeu_si128((__m128i*)index, _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(p, scale), half)));
+                dest[0] = colorTable[index[0]];
+                dest[1] = colorTable[index[1]];
+                dest[2] = colorTable[index[2]];
+                if (channels == 4) {
+                    dest[3] = tables.toByte[index[3]];
+                }
+                src += 4;
+                dest += channels;
+            }
+        }
+    });
+}
+
+//=======================================================================
+// Filters
+//=======================================================================
+
+// Bilinear resample (level 0 power-of-two / max size fit)
+static void resizeFloat(const FloatImage& src, int width, int height, FloatImage& dest) {
+    dest.width = width;
+    dest.height = height;
+    dest.data.resize((size_t)width * height * 4);
+
+    float scaleX = (float)src.width / width;
+    float scaleY = (float)src.height / height;
+
+    WorkerPool::getInstance().parallelFor(height, rowGrain(width), [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            float fy = (y + 0.5f) * scaleY - 0.5f;
+            if (fy < 0.0f) fy = 0.0f;
+            int y0 = (int)fy;
+            int y1 = y0 + 1 < src.height ? y0 + 1 : y0;
+            __m128 ty = _mm_set1_ps(fy - y0);
+            const float* row0 = src.row(y0);
+            const float* row1 = src.row(y1);
+            float* out = dest.row(y);
+
+            for (int x = 0; x < width; x++) {
+                float fx = (x + 0.5f) * scaleX - 0.5f;
+                if (fx < 0.0f) fx = 0.0f;
+                int x0 = (int)fx;
+                int x1 = x0 + 1 < src.width ? x0 + 1 : x0;
+                __m128 tx = _mm_set1_ps(fx - x0);
+
+                __m128 p00 = _mm_loadu_ps(row0 + x0 * 4);
+                __m128 p10 = _mm_loadu_ps(row0 + x1 * 4);
+                __m128 p01 = _mm_loadu_ps(row1 + x0 * 4);
+                __m128 p11 = _mm_loadu_ps(row1 + x1 * 4);
+                __m128 top = _mm_add_ps(p00, _mm_mul_ps(_mm_sub_ps(p10, p00), tx));
+                __m128 bottom = _mm_add_ps(p01, _mm_mul_ps(_mm_sub_ps(p11, p01), tx));
+                _mm_storeu_ps(out + x * 4, _mm_add_ps(top, _mm_mul_ps(_mm_sub_ps(bottom, top), ty)));
+            }
+        }
+    });
+}
+
+// Taps along one axis for dest texel i. An odd size n = 2m + 1 is spread
+// over m texels of 2 + 1/m source texels each (3 taps, weights (m - i),
+// m and (i + 1) over n), so its last row or column still contributes.
+struct BoxTaps {
+    int count;
+    int index[3];
+    float weight[3];
+};
+
+static void boxTaps(int i, int srcSize, BoxTaps& taps) {
+    if (srcSize == 1) {
+        taps.count = 1;
+        taps.index[0] = 0;
+        taps.weight[0] = 1.0f;
+    } else if ((srcSize & 1) == 0) {
+        taps.count = 2;
+        taps.index[0] = i * 2;
+        taps.index[1] = i * 2 + 1;
+        taps.weight[0] = taps.weight[1] = 0.5f;
+    } else {
+        int half = srcSize / 2;
+        taps.count = 3;
+        for (int k = 0; k < 3; k++) {
+            taps.index[k] = i * 2 + k;
+        }
+        taps.weight[0] = (float)(half - i) / srcSize;
+        taps.weight[1] = (float)half / srcSize;
+        taps.weight[2] = (float)(i + 1) / srcSize;
+    }
+}
+
+static void boxDownsample(const FloatImage& src, FloatImage& dest) {
+    dest.width = src.width > 1 ? src.width / 2 : 1;
+    dest.height = src.height > 1 ? src.height / 2 : 1;
+    dest.data.resize((size_t)dest.width * dest.height * 4);
+
+    // Odd sizes (NPOT chains) need the weighted taps
+    if ((src.width > 1 && (src.width & 1)) || (src.height > 1 && (src.height & 1))) {
+        std::vector<BoxTaps> columns(dest.width);
+        for (int x = 0; x < dest.width; x++) {
+            boxTaps(x, src.width, columns[x]);
+        }
+        WorkerPool::getInstance().parallelFor(dest.height, rowGrain(dest.width), [&](int begin, int end) {
+            for (int y = begin; y < end; y++) {
+                BoxTaps rows;
+                boxTaps(y, src.height, rows);
+                float* out = dest.row(y);
+                for (int x = 0; x < dest.width; x++) {
+                    const BoxTaps& cols = columns[x];
+                    __m128 sum = _mm_setzero_ps();
+                    for (int j = 0; j < rows.count; j++) {
+                        const float* in = src.row(rows.index[j]);
+                        __m128 line = _mm_setzero_ps();
+                        for (int i = 0; i < cols.count; i++) {
+                            line = _mm_add_ps(line, _mm_mul_ps(_mm_loadu_ps(in + cols.index[i] * 4),
+                                                               _mm_set1_ps(cols.weight[i])));
+                        }
+                        sum = _mm_add_ps(sum, _mm_mul_ps(line, _mm_set1_ps(rows.weight[j])));
+                    }
+                    _mm_storeu_ps(out + x * 4, sum);
+                }
+            }
+        });
+        return;
+    }
+
+    int stepX = src.width > 1 ? 4 : 0;
+    int stepY = src.height > 1 ? 1 : 0;
+
+    WorkerPool::getInstance().parallelFor(dest.height, rowGrain(dest.width), [&](int begin, int end) {
+        const __m128 quarter = _mm_set1_ps(0.25f);
+        for (int y = begin; y < end; y++) {
+            const float* row0 = src.row(y * 2);
+            const float* row1 = src.row(y * 2 + stepY);
+            float* out = dest.row(y);
+            for (int x = 0; x < dest.width; x++) {
+                int sx = x * 8;
+                __m128 sum = _mm_add_ps(_mm_add_ps(_mm_loadu_ps(row0 + sx), _mm_loadu_ps(row0 + sx + stepX)),
+                                        _mm_add_ps(_mm_loadu_ps(row1 + sx), _mm_loadu_ps(row1 + sx + stepX)));
+                _mm_storeu_ps(out + x * 4, _mm_mul_ps(sum, quarter));
+            }
+        }
+    });
+}
+
+static int tapIndex(int i, int size, bool wrap) {
+    if (wrap) {
+        i %= size;
+        return i < 0 ? i + size : i;
+    }
+    return i < 0 ? 0 : (i >= size ? size - 1 : i);
+}
+
+// Separable 8-tap Kaiser: horizontal pass into a temp image, then vertical.
+// Negative lobes can overshoot, so the result is clamped to [0, 1].
+static void kaiserDownsample(const FloatImage& src, bool wrapS, bool wrapT, FloatImage& dest) {
+    const float* weights = getTables().kaiser;
+    WorkerPool& pool = WorkerPool::getInstance();
+
+    FloatImage temp;
+    temp.width = src.width > 1 ? src.width / 2 : 1;
+    temp.height = src.height;
+    temp.data.resize((size_t)temp.width * temp.height * 4);
+
+    pool.parallelFor(temp.height, rowGrain(temp.width), [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            const float* in = src.row(y);
+            float* out = temp.row(y);
+            if (src.width == 1) {
+                memcpy(out, in, 4 * sizeof(float));
+                continue;
+            }
+            for (int x = 0; x < temp.width; x++) {
+                __m128 sum = _mm_setzero_ps();
+                int first = x * 2 - (KAISER_TAPS / 2 - 1);
+                for (int k = 0; k < KAISER_TAPS; k++) {
+                    int sx = tapIndex(first + k, src.width, wrapS);
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(in + sx * 4), _mm_set1_ps(weights[k])));
+                }
+                _mm_storeu_ps(out + x * 4, sum);
+            }
+        }
+    });
+
+    dest.width = temp.width;
+    dest.height = src.height > 1 ? src.height / 2 : 1;
+    dest.data.resize((size_t)dest.width * dest.height * 4);
+
+    pool.parallelFor(dest.height, rowGrain(dest.width), [&](int begin, int end) {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const float* rows[KAISER_TAPS];
+        for (int y = begin; y < end; y++) {
+            float* out = dest.row(y);
+            if (temp.height == 1) {
+                memcpy(out, temp.row(0), (size_t)dest.width * 4 * sizeof(float));
+                continue;
+            }
+            int first = y * 2 - (KAISER_TAPS / 2 - 1);
+            for (int k = 0; k < KAISER_TAPS; k++) {
+                rows[k] = temp.row(tapIndex(first + k, temp.height, wrapT));
+            }
+            for (int x = 0; x < dest.width; x++) {
+                __m128 sum = _mm_setzero_ps();
+                for (int k = 0; k < KAISER_TAPS; k++) {
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(rows[k] + x * 4), _mm_set1_ps(weights[k])));
+                }
+                _mm_storeu_ps(out + x * 4, _mm_min_ps(_mm_max_ps(sum, zero), one));
+            }
+        }
+    });
+}
+
+//=======================================================================
+// Public
+//=======================================================================
+
+void MipBuilder::getBaseSize(int width, int height, const MipOptions& options, int& outWidth, int& outHeight) {
+    outWidth = options.powerOfTwo ? nearestPowerOfTwo(width) : width;
+    outHeight = options.powerOfTwo ? nearestPowerOfTwo(height) : height;
+    // Like GLU, each edge is halved independently until it fits
+    while (outWidth > options.maxSize) outWidth /= 2;
+    while (outHeight > options.maxSize) outHeight /= 2;
+    if (outWidth < 1) outWidth = 1;
+    if (outHeight < 1) outHeight = 1;
+}
+
+void MipBuilder::resize(const ImageData& image, int width, int height, bool gammaCorrect, ImageData& out) {
+    FloatImage source, resized;
+    toFloat(image, gammaCorrect, source);
+    resizeFloat(source, width, height, resized);
+    toBytes(resized, image.channels, gammaCorrect, out);
+}
+
+void MipBuilder::buildChain(const ImageData& image, const MipOptions& options, std::vector<ImageData>& levels) {
+    levels.clear();
+    if (image.width <= 0 || image.height <= 0 || image.pixels.empty()) {
+        return;
+    }
+
+    int baseWidth, baseHeight;
+    getBaseSize(image.width, image.height, options, baseWidth, baseHeight);
+
+    FloatImage current;
+    toFloat(image, options.gammaCorrect, current);
+    if (baseWidth != image.width || baseHeight != image.height) {
+        FloatImage resized;
+        resizeFloat(current, baseWidth, baseHeight, resized);
+        current.width = resized.width;
+        current.height = resized.height;
+        current.data.swap(resized.data);
+
+        levels.push_back(ImageData());
+        toBytes(current, image.channels, options.gammaCorrect, levels.back());
+    } else {
+        // Untouched level 0 keeps the exact source bytes
+        levels.push_back(image);
+    }
+
+    while (current.width > 1 || current.height > 1) {
+        FloatImage next;
+        if (options.filter == MIP_FILTER_KAISER) {
+            kaiserDownsample(current, options.wrapS, options.wrapT, next);
+        } else {
+            boxDownsample(current, next);
+        }
+
+        levels.push_back(ImageData());
+        toBytes(next, image.channels, options.gammaCorrect, levels.back());
+
+        current.width = next.width;
+        current.height = next.height;
+        current.data.swap(next.data);
+    }
+}
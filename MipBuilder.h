@@ -0,0 +1,34 @@
+#pragma once
+#include "TextureManager.h"
+#include <vector>
+
+enum MipFilter {
+    MIP_FILTER_BOX,     // 2x2 average (fast, slightly soft)
+    MIP_FILTER_KAISER   // 8-tap Kaiser-windowed sinc (sharper, used for offline bakes)
+};
+
+struct MipOptions {
+    MipFilter filter = MIP_FILTER_BOX;
+    bool gammaCorrect = true;   // Filter color in linear space, alpha is always linear
+    bool wrapS = true;          // Kaiser taps wrap around (GL_REPEAT) instead of clamping
+    bool wrapT = true;
+    bool powerOfTwo = true;     // Resize level 0 to the nearest power of two first
+    int maxSize = 4096;         // Largest level 0 edge (GL_MAX_TEXTURE_SIZE)
+};
+
+// Mip Builder - replacement for gluBuild2DMipmaps
+// GLU resizes and filters every texture single-threaded in sRGB space on
+// every launch. This builds the chain from a linear float copy of the
+// image with SSE2 inner loops, splits each level's rows across the
+// WorkerPool, and hands back 8-bit levels for per-level glTexImage2D.
+class MipBuilder {
+public:
+    // Level 0 (resized if needed) down to 1x1, same channel count as the input
+    static void buildChain(const ImageData& image, const MipOptions& options, std::vector<ImageData>& levels);
+
+    // Just the level 0 resize, for textures without mipmaps
+    static void resize(const ImageData& image, int width, int height, bool gammaCorrect, ImageData& out);
+
+    // Size buildChain would give level 0
+    static void getBaseSize(int width, int height, const MipOptions& options, int& outWidth, int& outHeight);
+};
@@ -0,0 +1,215 @@
+#include "ModelInstancer.h"
+#include "glew.h"
+#include "Model_3DS.h"
+#include <cstddef>
+#include <cstdio>
+
+ModelInstancer::ModelInstancer() : enabled(true), checked(false), bufferObjects(false) {
+}
+
+ModelInstancer::~ModelInstancer() {
+    // The GL context is gone by the time static destructors run
+}
+
+ModelInstancer& ModelInstancer::getInstance() {
+    static ModelInstancer instance;
+    return instance;
+}
+
+void ModelInstancer::bake(const Model_3DS& model, BakedModel& baked) {
+    baked.vbo = 0;
+    baked.ibo = 0;
+
+    // Faces of each (material, textured) pair across all objects, merged
+    std::map<std::pair<int, bool>, std::vector<unsigned int> > faces;
+
+    for (int i = 0; i < model.numObjects; i++) {
+        const Model_3DS::Object& object = model.Objects[i];
+        if (object.Vertexes == NULL || object.numVerts <= 0) continue;
+
+        // Same placement Model_3DS::Draw applies per object
+        RenderMatrix placement;
+        placement.translate(object.pos.x, object.pos.y, object.pos.z);
+        placement.rotate(object.rot.z, 0.0f, 0.0f, 1.0f);
+        placement.rotate(object.rot.y, 0.0f, 1.0f, 0.0f);
+        placement.rotate(object.rot.x, 1.0f, 0.0f, 0.0f);
+        const float* m = placement.m;
+
+        unsigned int base = (unsigned int)baked.vertices.size();
+        for (int v = 0; v < object.numVerts; v++) {
+            const float* p = &object.Vertexes[v * 3];
+            Vertex vertex;
+            for (int row = 0; row < 3; row++) {
+                vertex.position[row] = m[row] * p[0] + m[4 + row] * p[1] + m[8 + row] * p[2] + m[12 + row];
+            }
+            if (object.Normals != NULL) {
+                const float* n = &object.Normals[v * 3];
+                for (int row = 0; row < 3; row++) {
+                    vertex.normal[row] = m[row] * n[0] + m[4 + row] * n[1] + m[8 + row] * n[2];
+                }
+            } else {
+                vertex.normal[0] = 0.0f;
+                vertex.normal[1] = 1.0f;
+                vertex.normal[2] = 0.0f;
+            }
+            if (object.textured && object.TexCoords != NULL && v < object.numTexCoords) {
+                vertex.texCoord[0] = object.TexCoords[v * 2];
+                vertex.texCoord[1] = object.TexCoords[v * 2 + 1];
+            } else {
+                vertex.texCoord[0] = 0.0f;
+                vertex.texCoord[1] = 0.0f;
+            }
+            baked.vertices.push_back(vertex);
+        }
+
+        for (int j = 0; j < object.numMatFaces; j++) {
+            const Model_3DS::MaterialFaces& matFaces = object.MatFaces[j];
+            std::vector<unsigned int>& list = faces[std::make_pair(matFaces.MatIndex, object.textured)];
+            for (int k = 0; k < matFaces.numSubFaces; k++) {
+                list.push_back(base + matFaces.subFaces[k]);
+            }
+        }
+    }
+
+    for (auto& entry : faces) {
+        if (entry.second.empty()) continue;
+        Range range;
+        range.material = entry.first.first;
+        range.textured = entry.first.second;
+        range.first = (int)baked.indices.size();
+        range.count = (int)entry.second.size();
+        baked.indices.insert(baked.indices.end(), entry.second.begin(), entry.second.end());
+        baked.ranges.push_back(range);
+    }
+
+    if (bufferObjects && !baked.ranges.empty()) {
+        glGenBuffers(1, &baked.vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, baked.vbo);
+        glBufferData(GL_ARRAY_BUFFER, baked.vertices.size() * sizeof(Vertex), &baked.vertices[0], GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        glGenBuffers(1, &baked.ibo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, baked.ibo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, baked.indices.size() * sizeof(unsigned int), &baked.indices[0],
+                     GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+        std::vector<Vertex>().swap(baked.vertices);
+        std::vector<unsigned int>().swap(baked.indices);
+    }
+}
+
+bool ModelInstancer::draw(Model_3DS& model, const DrawItem* items, int count) {
+    if (!enabled || model.shownormals) {
+        return false;
+    }
+    if (!model.visible || count <= 0) {
+        return true;
+    }
+    if (!checked) {
+        checked = true;
+        bufferObjects = (GLEW_VERSION_1_5 || GLEW_ARB_vertex_buffer_object) && glGenBuffers != NULL;
+        if (!bufferObjects) {
+            printf("ModelInstancer: no buffer objects, drawing from client arrays\n");
+        }
+    }
+
+    auto it = models.find(&model);
+    if (it == models.end()) {
+        it = models.insert(std::make_pair(&model, BakedModel())).first;
+        bake(model, it->second);
+    }
+    const BakedModel& baked = it->second;
+    if (baked.ranges.empty()) {
+        return false;
+    }
+
+    RenderMatrix placement = RenderQueue::getPlacement(model);
+
+    transforms.resize(count);
+    for (int i = 0; i < count; i++) {
+        transforms[i] = items[i].transform;
+        transforms[i].multiply(placement);
+    }
+
+    const char* base = NULL;
+    const unsigned int* indexBase = NULL;
+    if (baked.vbo != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, baked.vbo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, baked.ibo);
+    } else {
+        base = (const char*)&baked.vertices[0];
+        indexBase = &baked.indices[0];
+    }
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, position));
+    if (model.lit) {
+        glEnableClientState(GL_NORMAL_ARRAY);
+        glNormalPointer(GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, normal));
+    }
+    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, texCoord));
+
+    // Ranges are in material order; neighbours often share a texture
+    unsigned int boundTexture = 0;
+    bool bound = false;
+    for (const Range& range : baked.ranges) {
+        if (range.textured) {
+            glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        } else {
+            glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        }
+        // Looked up per draw: levels swap material textures after loading
+        if (range.material >= 0 && range.material < model.numMaterials) {
+            GLTexture& texture = model.Materials[range.material].tex;
+            if (!bound || texture.texture[0] != boundTexture) {
+                texture.Use();
+                boundTexture = texture.texture[0];
+                bound = true;
+            }
+        }
+        for (int i = 0; i < count; i++) {
+            glPushMatrix();
+            glMultMatrixf(transforms[i].m);
+            glDrawElements(GL_TRIANGLES, range.count, GL_UNSIGNED_INT, indexBase + range.first);
+            glPopMatrix();
+        }
+    }
+
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    if (baked.vbo != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+
+    return true;
+}
+
+void ModelInstancer::forget(const Model_3DS* model) {
+    auto it = models.find(model);
+    if (it == models.end()) {
+        return;
+    }
+    if (it->second.vbo != 0) {
+        glDeleteBuffers(1, &it->second.vbo);
+    }
+    if (it->second.ibo != 0) {
+        glDeleteBuffers(1, &it->second.ibo);
+    }
+    models.erase(it);
+}
+
+void ModelInstancer::release() {
+    for (auto& entry : models) {
+        if (entry.second.vbo != 0) {
+            glDeleteBuffers(1, &entry.second.vbo);
+        }
+        if (entry.second.ibo != 0) {
+            glDeleteBuffers(1, &entry.second.ibo);
+        }
+    }
+    models.clear();
+    checked = false;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "RenderQueue.h"
+#include <map>
+#include <vector>
+
+// Model Instancer - draws every placement of a model as one group
+// Model_3DS::Draw re-points the client arrays, rebinds each material's
+// texture and pushes a matrix per object for every single placement, so 40
+// buildings built from 10 models cost 40 full walks over the model. A model
+// is now baked once into a single vertex/index buffer (objects pre-placed,
+// faces merged per material), and a run of placements binds the buffer and
+// each texture once, then issues one glDrawElements per placement with its
+// transform. A real instanced draw (glDrawElementsInstanced with the
+// transforms in an attribute) needs a vertex shader, which this fixed-function
+// renderer doesn't have. Without buffer objects the baked arrays are drawn
+// from client memory; with the instancer disabled everything goes through
+// Model_3DS::Draw as before.
+class ModelInstancer {
+public:
+    // Singleton pattern (same as GameManager)
+    static ModelInstancer& getInstance();
+
+    ModelInstancer(const ModelInstancer&) = delete;
+    ModelInstancer& operator=(const ModelInstancer&) = delete;
+
+    void setEnabled(bool value) { enabled = value; }
+    bool isEnabled() const { return enabled; }
+
+    // Draw the model at each item's transform, on top of the current modelview.
+    // The caller sets the material. Returns false when the model can't be
+    // grouped (disabled, no geometry, normals shown); the caller then draws it.
+    bool draw(Model_3DS& model, const DrawItem* items, int count);
+
+    // Drop one model's bake (it is being unloaded or reloaded)
+    void forget(const Model_3DS* model);
+    // Free the buffers; models are baked again on next use
+    void release();
+
+    int getModelCount() const { return (int)models.size(); }
+
+private:
+    ModelInstancer();
+    ~ModelInstancer();
+
+    struct Vertex {
+        float position[3];
+        float normal[3];
+        float texCoord[2];
+    };
+
+    // Faces of one material, contiguous in the index buffer
+    struct Range {
+        int material;
+        bool textured;
+        int first;
+        int count;
+    };
+
+    struct BakedModel {
+        std::vector<Vertex> vertices;           // Kept when there are no buffer objects
+        std::vector<unsigned int> indices;
+        std::vector<Range> ranges;
+        unsigned int vbo;
+        unsigned int ibo;
+    };
+
+    std::map<const Model_3DS*, BakedModel> models;
+    std::vector<RenderMatrix> transforms;    // Scratch: item transform * model placement
+    bool enabled;
+    bool checked;
+    bool bufferObjects;
+
+    void bake(const Model_3DS& model, BakedModel& baked);
+};
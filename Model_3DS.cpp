@@ -79,6 +79,7 @@
 //#include "stdafx.h"
 #include <string>
 #include "Model_3DS.h"
+#include "GLState.h"
 
 #include <math.h>			// Header file for the math library
 #include <gl\gl.h>			// Header file for the OpenGL32 library
@@ -373,10 +374,10 @@ void Model_3DS::Draw()
 				for (int k = 0; k < Objects[i].numVerts * 3; k += 3)
 				{
 					// Disable texturing
-					glDisable(GL_TEXTURE_2D);
+					GLState::disable(GL_TEXTURE_2D);
 					// Disbale lighting if the model is lit
 					if (lit)
-						glDisable(GL_LIGHTING);
+						GLState::disable(GL_LIGHTING);
 					// Draw the normals blue
 					glColor3f(0.0f, 0.0f, 1.0f);
 
@@ -390,7 +391,7 @@ void Model_3DS::Draw()
 					glColor3f(1.0f, 1.0f, 1.0f);
 					// If the model is lit then renable lighting
 					if (lit)
-						glEnable(GL_LIGHTING);
+						GLState::enable(GL_LIGHTING);
 				}
 			}
 		}
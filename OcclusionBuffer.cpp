@@ -0,0 +1,276 @@
+#include "OcclusionBuffer.h"
+#include <math.h>
+#include <algorithm>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1) || defined(__SSE__)
+#include <xmmintrin.h>
+#define OCCLUSION_SSE 1
+#endif
+
+// Box faces as corner indices (see addBox); both windings get rasterized
+static const int BOX_FACES[6][4] = {
+    { 0, 2, 6, 4 }, { 1, 5, 7, 3 },     // -x, +x
+    { 0, 4, 5, 1 }, { 2, 3, 7, 6 },     // -y, +y
+    { 0, 1, 3, 2 }, { 4, 6, 7, 5 }      // -z, +z
+};
+
+// Boxes this close to the eye plane count as visible
+static const float MIN_W = 1e-5f;
+
+OcclusionBuffer::OcclusionBuffer(int width, int height)
+    : width((std::max(width, 4) + 3) & ~3), height(std::max(height, 1)), ready(false), occluderCount(0),
+      triangleCount(0) {
+    for (int i = 0; i < 16; i++) {
+        clip[i] = (i % 5 == 0) ? 1.0f : 0.0f;
+    }
+
+    // Level 0 is the depth buffer itself, then halve down to a single texel
+    int levelWidth = this->width;
+    int levelHeight = this->height;
+    while (true) {
+        Level level;
+        level.width = levelWidth;
+        level.height = levelHeight;
+        level.depth.assign(levelWidth * levelHeight, 1.0f);
+        levels.push_back(level);
+        if (levelWidth == 1 && levelHeight == 1) break;
+        levelWidth = (levelWidth + 1) / 2;
+        levelHeight = (levelHeight + 1) / 2;
+    }
+}
+
+void OcclusionBuffer::begin(const float* clipMatrix) {
+    for (int i = 0; i < 16; i++) {
+        clip[i] = clipMatrix[i];
+    }
+    std::fill(levels[0].depth.begin(), levels[0].depth.end(), 1.0f);
+    ready = false;
+    occluderCount = 0;
+    triangleCount = 0;
+}
+
+void OcclusionBuffer::transform(const float* point, float out[4]) const {
+    for (int row = 0; row < 4; row++) {
+        out[row] = clip[row] * point[0] + clip[4 + row] * point[1] + clip[8 + row] * point[2] + clip[12 + row];
+    }
+}
+
+void OcclusionBuffer::addBox(const float corners[24]) {
+    float projected[8][4];
+    for (int i = 0; i < 8; i++) {
+        transform(&corners[i * 3], projected[i]);
+    }
+    for (int f = 0; f < 6; f++) {
+        const int* face = BOX_FACES[f];
+        clipTriangle(projected[face[0]], projected[face[1]], projected[face[2]]);
+        clipTriangle(projected[face[0]], projected[face[2]], projected[face[3]]);
+    }
+    occluderCount++;
+}
+
+void OcclusionBuffer::clipTriangle(const float* a, const float* b, const float* c) {
+    // Sutherland-Hodgman against the near plane (z >= -w): up to four vertices
+    const float* input[3] = { a, b, c };
+    float output[4][4];
+    int count = 0;
+    for (int i = 0; i < 3; i++) {
+        const float* current = input[i];
+        const float* next = input[(i + 1) % 3];
+        float dCurrent = current[2] + current[3];
+        float dNext = next[2] + next[3];
+        if (dCurrent >= 0.0f) {
+            for (int k = 0; k < 4; k++) output[count][k] = current[k];
+            count++;
+        }
+        if ((dCurrent >= 0.0f) != (dNext >= 0.0f)) {
+            float t = dCurrent / (dCurrent - dNext);
+            for (int k = 0; k < 4; k++) output[count][k] = current[k] + (next[k] - current[k]) * t;
+            count++;
+        }
+    }
+    if (count < 3) {
+        return;
+    }
+
+    float screen[4][3];
+    for (int i = 0; i < count; i++) {
+        if (output[i][3] < MIN_W) {
+            return;
+        }
+        float invW = 1.0f / output[i][3];
+        screen[i][0] = (output[i][0] * invW * 0.5f + 0.5f) * width;
+        screen[i][1] = (output[i][1] * invW * 0.5f + 0.5f) * height;
+        screen[i][2] = output[i][2] * invW;
+    }
+    drawTriangle(screen[0], screen[1], screen[2]);
+    if (count == 4) {
+        drawTriangle(screen[0], screen[2], screen[3]);
+    }
+}
+
+void OcclusionBuffer::drawTriangle(const float* a, const float* b, const float* c) {
+    float area = (b[0] - a[0]) * (c[1] - a[1]) - (c[0] - a[0]) * (b[1] - a[1]);
+    if (fabsf(area) < 1e-8f) {
+        return;
+    }
+    if (area < 0.0f) {
+        std::swap(b, c);
+        area = -area;
+    }
+
+    int minX = std::max(0, (int)floorf(std::min(a[0], std::min(b[0], c[0]))));
+    int maxX = std::min(width - 1, (int)ceilf(std::max(a[0], std::max(b[0], c[0]))));
+    int minY = std::max(0, (int)floorf(std::min(a[1], std::min(b[1], c[1]))));
+    int maxY = std::min(height - 1, (int)ceilf(std::max(a[1], std::max(b[1], c[1]))));
+    if (minX > maxX || minY > maxY) {
+        return;
+    }
+    triangleCount++;
+
+    // Edge functions E = A*x + B*y + C, each >= 0 inside and equal to the
+    // opposite vertex's share of the area, so depth is a plane in x and y too.
+    // Triangles clipped at the near plane reach thousands of pixels off
+    // screen, so C and each row's B*y + C are formed in double, and every
+    // edge is widened by a thousandth of a pixel: pixel centers exactly on an
+    // edge shared by two triangles would otherwise be dropped by both.
+    const float* vertices[3] = { a, b, c };
+    float edgeA[3];
+    double edgeB[3], edgeC[3];
+    for (int i = 0; i < 3; i++) {
+        const float* p = vertices[(i + 1) % 3];
+        const float* q = vertices[(i + 2) % 3];
+        edgeA[i] = p[1] - q[1];
+        edgeB[i] = (double)q[0] - p[0];
+        edgeC[i] = -((double)edgeA[i] * p[0] + edgeB[i] * p[1]) + (fabs(edgeA[i]) + fabs(edgeB[i])) * 1e-3;
+    }
+    double invArea = 1.0 / area;
+    float depthA = (float)((edgeA[0] * (double)a[2] + edgeA[1] * (double)b[2] + edgeA[2] * (double)c[2]) * invArea);
+    double depthB = (edgeB[0] * a[2] + edgeB[1] * b[2] + edgeB[2] * c[2]) * invArea;
+    double depthC = (edgeC[0] * a[2] + edgeC[1] * b[2] + edgeC[2] * c[2]) * invArea;
+
+    std::vector<float>& depth = levels[0].depth;
+
+#ifdef OCCLUSION_SSE
+    // Four pixels per step from a 4-aligned column; the width is a multiple of four
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 a0 = _mm_set1_ps(edgeA[0]);
+    const __m128 a1 = _mm_set1_ps(edgeA[1]);
+    const __m128 a2 = _mm_set1_ps(edgeA[2]);
+    const __m128 aDepth = _mm_set1_ps(depthA);
+    int startX = minX & ~3;
+    for (int y = minY; y <= maxY; y++) {
+        double py = y + 0.5;
+        __m128 row0 = _mm_set1_ps((float)(edgeB[0] * py + edgeC[0]));
+        __m128 row1 = _mm_set1_ps((float)(edgeB[1] * py + edgeC[1]));
+        __m128 row2 = _mm_set1_ps((float)(edgeB[2] * py + edgeC[2]));
+        __m128 rowDepth = _mm_set1_ps((float)(depthB * py + depthC));
+        float* row = &depth[y * width];
+        for (int x = startX; x <= maxX; x += 4) {
+            __m128 px = _mm_add_ps(_mm_set1_ps((float)x), offsets);
+            __m128 e0 = _mm_add_ps(_mm_mul_ps(a0, px), row0);
+            __m128 e1 = _mm_add_ps(_mm_mul_ps(a1, px), row1);
+            __m128 e2 = _mm_add_ps(_mm_mul_ps(a2, px), row2);
+            __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)),
+                                       _mm_cmpge_ps(e2, zero));
+            if (_mm_movemask_ps(inside) == 0) continue;
+            __m128 z = _mm_add_ps(_mm_mul_ps(aDepth, px), rowDepth);
+            __m128 current = _mm_loadu_ps(row + x);
+            __m128 nearer = _mm_min_ps(current, z);
+            _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, current)));
+        }
+    }
+#else
+    for (int y = minY; y <= maxY; y++) {
+        double py = y + 0.5;
+        float row0 = (float)(edgeB[0] * py + edgeC[0]);
+        float row1 = (float)(edgeB[1] * py + edgeC[1]);
+        float row2 = (float)(edgeB[2] * py + edgeC[2]);
+        float rowDepth = (float)(depthB * py + depthC);
+        float* row = &depth[y * width];
+        for (int x = minX; x <= maxX; x++) {
+            float px = x + 0.5f;
+            if (edgeA[0] * px + row0 < 0.0f) continue;
+            if (edgeA[1] * px + row1 < 0.0f) continue;
+            if (edgeA[2] * px + row2 < 0.0f) continue;
+            float z = depthA * px + rowDepth;
+            if (z < row[x]) {
+                row[x] = z;
+            }
+        }
+    }
+#endif
+}
+
+void OcclusionBuffer::finish() {
+    // Each level keeps the farthest depth of the texels below it
+    for (size_t l = 1; l < levels.size(); l++) {
+        const Level& below = levels[l - 1];
+        Level& level = levels[l];
+        for (int y = 0; y < level.height; y++) {
+            int y0 = y * 2;
+            int y1 = std::min(y0 + 1, below.height - 1);
+            for (int x = 0; x < level.width; x++) {
+                int x0 = x * 2;
+                int x1 = std::min(x0 + 1, below.width - 1);
+                const float* top = &below.depth[y0 * below.width];
+                const float* bottom = &below.depth[y1 * below.width];
+                level.depth[y * level.width + x] =
+                    std::max(std::max(top[x0], top[x1]), std::max(bottom[x0], bottom[x1]));
+            }
+        }
+    }
+    ready = true;
+}
+
+bool OcclusionBuffer::testBox(float minX, float minY, float minZ, float maxX, float maxY, float maxZ) const {
+    if (!ready || occluderCount == 0) {
+        return true;
+    }
+
+    float screenMinX = 1e30f, screenMinY = 1e30f, screenMaxX = -1e30f, screenMaxY = -1e30f;
+    float nearest = 1e30f;
+    for (int i = 0; i < 8; i++) {
+        float corner[3] = { (i & 1) ? maxX : minX, (i & 2) ? maxY : minY, (i & 4) ? maxZ : minZ };
+        float projected[4];
+        transform(corner, projected);
+        // Reaches past the near plane: the eye may be inside it
+        if (projected[3] < MIN_W || projected[2] < -projected[3]) {
+            return true;
+        }
+        float invW = 1.0f / projected[3];
+        float sx = (projected[0] * invW * 0.5f + 0.5f) * width;
+        float sy = (projected[1] * invW * 0.5f + 0.5f) * height;
+        screenMinX = std::min(screenMinX, sx);
+        screenMaxX = std::max(screenMaxX, sx);
+        screenMinY = std::min(screenMinY, sy);
+        screenMaxY = std::max(screenMaxY, sy);
+        nearest = std::min(nearest, projected[2] * invW);
+    }
+    // Off screen is the frustum test's business
+    if (screenMaxX < 0.0f || screenMaxY < 0.0f || screenMinX >= width || screenMinY >= height) {
+        return true;
+    }
+
+    int x0 = std::max(0, (int)floorf(screenMinX));
+    int x1 = std::min(width - 1, (int)floorf(screenMaxX));
+    int y0 = std::max(0, (int)floorf(screenMinY));
+    int y1 = std::min(height - 1, (int)floorf(screenMaxY));
+
+    // Coarsest level where the box still covers only a few texels
+    int span = std::max(x1 - x0, y1 - y0) + 1;
+    size_t l = 0;
+    while (span > 4 && l + 1 < levels.size()) {
+        span = (span + 1) / 2;
+        l++;
+    }
+    const Level& level = levels[l];
+    for (int y = y0 >> l; y <= (y1 >> l); y++) {
+        for (int x = x0 >> l; x <= (x1 >> l); x++) {
+            if (nearest <= level.depth[y * level.width + x]) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
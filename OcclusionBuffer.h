@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+
+// Occlusion Buffer - low-resolution CPU depth buffer for occlusion culling
+// At street level in Level2 the landmark towers hide most of the city, but
+// the frustum test alone still sends everything behind them to GL. A few
+// large occluders (simplified building hulls) are rasterized here into a
+// small depth buffer, four pixels at a time with SSE where the compiler
+// targets it; a max-depth pyramid is then built over it. Queued items test
+// their bounding box against the pyramid level where the box covers a few
+// texels, and are dropped only when their nearest point lies behind every
+// texel they touch. Nothing here touches GL, so it runs headless too.
+class OcclusionBuffer {
+public:
+    // The width is rounded up to a multiple of four
+    explicit OcclusionBuffer(int width = 256, int height = 128);
+
+    // Clear to the far plane for this view (projection * modelview, column-major)
+    void begin(const float* clip);
+    // Rasterize a convex box from its eight world-space corners (x, y, z each);
+    // corner i has bit 0 set for +x, bit 1 for +y and bit 2 for +z
+    void addBox(const float corners[24]);
+    // Build the depth pyramid; call after the last occluder
+    void finish();
+    bool isReady() const { return ready; }
+
+    // False only when the world-space box is certainly hidden by the occluders
+    bool testBox(float minX, float minY, float minZ, float maxX, float maxY, float maxZ) const;
+    bool testSphere(float x, float y, float z, float radius) const {
+        return testBox(x - radius, y - radius, z - radius, x + radius, y + radius, z + radius);
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getOccluderCount() const { return occluderCount; }
+    int getTriangleCount() const { return triangleCount; }
+
+private:
+    struct Level {
+        int width;
+        int height;
+        std::vector<float> depth;   // Level 0: nearest depth; above: farthest of the 2x2 below
+    };
+
+    int width;
+    int height;
+    float clip[16];
+    std::vector<Level> levels;
+    bool ready;
+    int occluderCount;
+    int triangleCount;
+
+    // World point to clip space (x, y, z, w)
+    void transform(const float* point, float out[4]) const;
+    // Clip against the near plane, then rasterize the one or two triangles left
+    void clipTriangle(const float* a, const float* b, const float* c);
+    // Screen-space x, y and NDC depth per vertex
+    void drawTriangle(const float* a, const float* b, const float* c);
+};
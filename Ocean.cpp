@@ -0,0 +1,471 @@
+#include "Ocean.h"
+#include "glew.h"
+#include "WorkerPool.h"
+#include <math.h>
+#include <cstddef>
+#include <cstdio>
+#include <algorithm>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#include <emmintrin.h>
+#define OCEAN_SSE 1
+#endif
+
+static const float GRAVITY = 9.8f;
+// The grid reaches a little past the screen edges so displaced vertices don't open gaps there
+static const float OVERSCAN = 1.1f;
+
+// Column-major 4x4 inverse (cofactors); false if the matrix is singular
+static bool invertMatrix(const float* m, float* out) {
+    float inv[16];
+    inv[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] +
+             m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+    inv[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] -
+             m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+    inv[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] +
+             m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+    inv[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] -
+              m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+    inv[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] -
+             m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+    inv[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] +
+             m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+    inv[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] -
+             m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+    inv[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] +
+              m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+    inv[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] +
+             m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+    inv[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] -
+             m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+    inv[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] +
+              m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+    inv[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] -
+              m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+    inv[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] -
+             m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+    inv[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] +
+             m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+    inv[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] -
+              m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+    inv[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] +
+              m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+    float det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+    if (fabsf(det) < 1e-12f) {
+        return false;
+    }
+    for (int i = 0; i < 16; i++) {
+        out[i] = inv[i] / det;
+    }
+    return true;
+}
+
+// out = m * (x, y, z, w)
+static void transformPoint(const float* m, float x, float y, float z, float w, float* out) {
+    for (int row = 0; row < 4; row++) {
+        out[row] = m[row] * x + m[4 + row] * y + m[8 + row] * z + m[12 + row] * w;
+    }
+}
+
+#ifdef OCEAN_SSE
+// Sine and cosine of four angles: reduced to [-pi, pi], folded into
+// [-pi/2, pi/2] and evaluated as Taylor polynomials (error below 1e-5)
+static inline void sinCos4(__m128 x, __m128* sine, __m128* cosine) {
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 pi = _mm_set1_ps(3.14159265f);
+    const __m128 halfPi = _mm_set1_ps(1.57079633f);
+
+    __m128 turns = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(0.15915494f))));
+    x = _mm_sub_ps(x, _mm_mul_ps(turns, _mm_set1_ps(6.28318531f)));
+
+    __m128 sign = _mm_and_ps(x, signMask);
+    __m128 over = _mm_cmpgt_ps(_mm_andnot_ps(signMask, x), halfPi);
+    __m128 folded = _mm_sub_ps(_mm_or_ps(pi, sign), x);
+    x = _mm_or_ps(_mm_and_ps(over, folded), _mm_andnot_ps(over, x));
+
+    __m128 x2 = _mm_mul_ps(x, x);
+    __m128 s = _mm_add_ps(_mm_set1_ps(-1.0f / 5040.0f), _mm_mul_ps(x2, _mm_set1_ps(1.0f / 362880.0f)));
+    s = _mm_add_ps(_mm_set1_ps(1.0f / 120.0f), _mm_mul_ps(x2, s));
+    s = _mm_add_ps(_mm_set1_ps(-1.0f / 6.0f), _mm_mul_ps(x2, s));
+    s = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(x2, s));
+    *sine = _mm_mul_ps(x, s);
+
+    __m128 c = _mm_add_ps(_mm_set1_ps(1.0f / 40320.0f), _mm_mul_ps(x2, _mm_set1_ps(-1.0f / 3628800.0f)));
+    c = _mm_add_ps(_mm_set1_ps(-1.0f / 720.0f), _mm_mul_ps(x2, c));
+    c = _mm_add_ps(_mm_set1_ps(1.0f / 24.0f), _mm_mul_ps(x2, c));
+    c = _mm_add_ps(_mm_set1_ps(-0.5f), _mm_mul_ps(x2, c));
+    c = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(x2, c));
+    // Folded angles are on the far side, where the cosine changes sign
+    *cosine = _mm_xor_ps(c, _mm_and_ps(over, signMask));
+}
+#endif
+
+Ocean::Ocean(float level, int gridColumns, int gridRows)
+    : waterLevel(level), columns(gridColumns), rows(gridRows), time(0.0f), amplitude(0.0f), maxDistance(1950.0f),
+      vbo(0), ibo(0), checked(false) {
+    // Long swells along the wind, shorter chop spread around it; each
+    // wave is as high as a fixed fraction of its length
+    const float windAngle = 0.7f;
+    const float spread[WAVES] = { 0.0f, 0.45f, -0.35f, 0.9f, -0.8f, 0.25f, -1.15f, 1.3f };
+    float wavelength = 60.0f;
+    for (int i = 0; i < WAVES; i++) {
+        Wave& wave = waves[i];
+        float angle = windAngle + spread[i];
+        wave.dirX = cosf(angle);
+        wave.dirZ = sinf(angle);
+        wave.k = 6.28318531f / wavelength;
+        wave.amplitude = wavelength * 0.008f;
+        // Sum of Q * k * A stays below 1, so crests sharpen without looping over
+        wave.steepness = 0.7f / (wave.k * wave.amplitude * WAVES);
+        wave.omega = sqrtf(GRAVITY * wave.k);
+        wave.phase = i * 1.7f;
+        // Gone 40 wavelengths out, where the grid is too coarse to carry it
+        wave.fadeScale = 1.0f / (wavelength * 40.0f);
+        amplitude += wave.amplitude;
+        wavelength *= 0.72f;
+    }
+
+    // Two triangles per grid cell
+    for (int r = 0; r + 1 < rows; r++) {
+        for (int c = 0; c + 1 < columns; c++) {
+            unsigned short a = (unsigned short)(r * columns + c);
+            unsigned short b = (unsigned short)(a + 1);
+            unsigned short d = (unsigned short)(a + columns);
+            unsigned short e = (unsigned short)(d + 1);
+            indices.push_back(a);
+            indices.push_back(b);
+            indices.push_back(d);
+            indices.push_back(b);
+            indices.push_back(e);
+            indices.push_back(d);
+        }
+    }
+    vertices.resize(columns * rows);
+    columnTop.resize(columns);
+}
+
+Ocean::~Ocean() {
+    // Buffers are released explicitly (level cleanup) while the GL context is alive
+}
+
+void Ocean::update(float seconds) {
+    time = seconds;
+}
+
+void Ocean::evaluate(float x, float z, float* offset, float* normal) const {
+    offset[0] = offset[1] = offset[2] = 0.0f;
+    normal[0] = 0.0f;
+    normal[1] = 1.0f;
+    normal[2] = 0.0f;
+    for (int i = 0; i < WAVES; i++) {
+        const Wave& wave = waves[i];
+        float theta = wave.k * (wave.dirX * x + wave.dirZ * z) - wave.omega * time + wave.phase;
+        float s = sinf(theta);
+        float c = cosf(theta);
+        float qa = wave.steepness * wave.amplitude;
+        float ka = wave.k * wave.amplitude;
+        offset[0] += qa * wave.dirX * c;
+        offset[1] += wave.amplitude * s;
+        offset[2] += qa * wave.dirZ * c;
+        normal[0] -= wave.dirX * ka * c;
+        normal[1] -= wave.steepness * ka * s;
+        normal[2] -= wave.dirZ * ka * c;
+    }
+}
+
+float Ocean::getHeight(float x, float z) const {
+    // Crests pull water sideways, so first find the still-water point that
+    // ends up above (x, z); a few fixed-point steps are plenty
+    float offset[3];
+    float normal[3];
+    float px = x;
+    float pz = z;
+    for (int i = 0; i < 3; i++) {
+        evaluate(px, pz, offset, normal);
+        px = x - offset[0];
+        pz = z - offset[2];
+    }
+    evaluate(px, pz, offset, normal);
+    return waterLevel + offset[1];
+}
+
+Vector3f Ocean::getNormal(float x, float z) const {
+    float offset[3];
+    float normal[3];
+    float px = x;
+    float pz = z;
+    for (int i = 0; i < 3; i++) {
+        evaluate(px, pz, offset, normal);
+        px = x - offset[0];
+        pz = z - offset[2];
+    }
+    evaluate(px, pz, offset, normal);
+    return Vector3f(normal[0], normal[1], normal[2]).unit();
+}
+
+void Ocean::project(const float* inverse, const float* eye, float sx, float sy, float* x, float* z) const {
+    float nearPoint[4];
+    float farPoint[4];
+    transformPoint(inverse, sx, sy, -1.0f, 1.0f, nearPoint);
+    transformPoint(inverse, sx, sy, 1.0f, 1.0f, farPoint);
+    float dirX = farPoint[0] / farPoint[3] - nearPoint[0] / nearPoint[3];
+    float dirY = farPoint[1] / farPoint[3] - nearPoint[1] / nearPoint[3];
+    float dirZ = farPoint[2] / farPoint[3] - nearPoint[2] / nearPoint[3];
+
+    if (dirY < 0.0f && eye[1] > waterLevel) {
+        float t = (waterLevel - eye[1]) / dirY;
+        float hx = dirX * t;
+        float hz = dirZ * t;
+        if (hx * hx + hz * hz <= maxDistance * maxDistance) {
+            *x = eye[0] + hx;
+            *z = eye[2] + hz;
+            return;
+        }
+    }
+    // Misses the water, or hits it too far away: pin it to the edge of the range
+    float length = sqrtf(dirX * dirX + dirZ * dirZ);
+    if (length < 1e-6f) {
+        dirX = 0.0f;
+        dirZ = 1.0f;
+        length = 1.0f;
+    }
+    *x = eye[0] + dirX / length * maxDistance;
+    *z = eye[2] + dirZ / length * maxDistance;
+}
+
+void Ocean::evaluateBatch(const float* x, const float* z, const float* distance, int count,
+                          float* offsetX, float* offsetY, float* offsetZ,
+                          float* normalX, float* normalY, float* normalZ) const {
+    int n = 0;
+#ifdef OCEAN_SSE
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (; n + 4 <= count; n += 4) {
+        __m128 px = _mm_loadu_ps(x + n);
+        __m128 pz = _mm_loadu_ps(z + n);
+        __m128 dist = distance ? _mm_loadu_ps(distance + n) : zero;
+        __m128 ox = zero, oy = zero, oz = zero;
+        __m128 nx = zero, ny = one, nz = zero;
+        for (int i = 0; i < WAVES; i++) {
+            const Wave& wave = waves[i];
+            __m128 fade = _mm_sub_ps(one, _mm_mul_ps(dist, _mm_set1_ps(wave.fadeScale)));
+            fade = _mm_max_ps(zero, fade);
+            __m128 a = _mm_mul_ps(_mm_set1_ps(wave.amplitude), fade);
+            __m128 theta = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(wave.k * wave.dirX), px),
+                                      _mm_mul_ps(_mm_set1_ps(wave.k * wave.dirZ), pz));
+            theta = _mm_add_ps(theta, _mm_set1_ps(wave.phase - wave.omega * time));
+            __m128 s, co;
+            sinCos4(theta, &s, &co);
+
+            __m128 qaCos = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(wave.steepness), a), co);
+            __m128 kaCos = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(wave.k), a), co);
+            ox = _mm_add_ps(ox, _mm_mul_ps(_mm_set1_ps(wave.dirX), qaCos));
+            oz = _mm_add_ps(oz, _mm_mul_ps(_mm_set1_ps(wave.dirZ), qaCos));
+            oy = _mm_add_ps(oy, _mm_mul_ps(a, s));
+            nx = _mm_sub_ps(nx, _mm_mul_ps(_mm_set1_ps(wave.dirX), kaCos));
+            nz = _mm_sub_ps(nz, _mm_mul_ps(_mm_set1_ps(wave.dirZ), kaCos));
+            ny = _mm_sub_ps(ny, _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(wave.steepness * wave.k), a), s));
+        }
+        _mm_storeu_ps(offsetY + n, oy);
+        if (offsetX) {
+            _mm_storeu_ps(offsetX + n, ox);
+            _mm_storeu_ps(offsetZ + n, oz);
+            _mm_storeu_ps(normalX + n, nx);
+            _mm_storeu_ps(normalY + n, ny);
+            _mm_storeu_ps(normalZ + n, nz);
+        }
+    }
+#endif
+    for (; n < count; n++) {
+        float ox = 0.0f, oy = 0.0f, oz = 0.0f;
+        float nx = 0.0f, ny = 1.0f, nz = 0.0f;
+        for (int i = 0; i < WAVES; i++) {
+            const Wave& wave = waves[i];
+            float a = wave.amplitude;
+            if (distance) {
+                a *= std::max(0.0f, 1.0f - distance[n] * wave.fadeScale);
+            }
+            float theta = wave.k * (wave.dirX * x[n] + wave.dirZ * z[n]) - wave.omega * time + wave.phase;
+            float s = sinf(theta);
+            float co = cosf(theta);
+            ox += wave.steepness * a * wave.dirX * co;
+            oz += wave.steepness * a * wave.dirZ * co;
+            oy += a * s;
+            nx -= wave.dirX * wave.k * a * co;
+            nz -= wave.dirZ * wave.k * a * co;
+            ny -= wave.steepness * wave.k * a * s;
+        }
+        offsetY[n] = oy;
+        if (offsetX) {
+            offsetX[n] = ox;
+            offsetZ[n] = oz;
+            normalX[n] = nx;
+            normalY[n] = ny;
+            normalZ[n] = nz;
+        }
+    }
+}
+
+void Ocean::getHeights(const float* x, const float* z, float* heights, int count) const {
+    evaluateBatch(x, z, NULL, count, NULL, heights, NULL, NULL, NULL, NULL);
+    for (int n = 0; n < count; n++) {
+        heights[n] += waterLevel;
+    }
+}
+
+void Ocean::buildRows(const float* inverse, const float* eye, float texScale, float scrollU, float scrollV,
+                      int begin, int end) {
+    // Per row, structure of arrays: still-water point, distance, then the
+    // displacement and normal the waves add
+    std::vector<float> scratch(columns * 9);
+    float* baseX = &scratch[0];
+    float* baseZ = baseX + columns;
+    float* distance = baseZ + columns;
+    float* offsetX = distance + columns;
+    float* offsetY = offsetX + columns;
+    float* offsetZ = offsetY + columns;
+    float* normalX = offsetZ + columns;
+    float* normalY = normalX + columns;
+    float* normalZ = normalY + columns;
+
+    const float light[3] = { 0.3f, 0.9f, 0.3f };
+
+    for (int r = begin; r < end; r++) {
+        float t = (float)r / (rows - 1);
+        for (int c = 0; c < columns; c++) {
+            float sx = -OVERSCAN + 2.0f * OVERSCAN * c / (columns - 1);
+            float sy = -OVERSCAN + (columnTop[c] + OVERSCAN) * t;
+            project(inverse, eye, sx, sy, &baseX[c], &baseZ[c]);
+            float dx = baseX[c] - eye[0];
+            float dz = baseZ[c] - eye[2];
+            distance[c] = sqrtf(dx * dx + dz * dz);
+        }
+
+        evaluateBatch(baseX, baseZ, distance, columns, offsetX, offsetY, offsetZ, normalX, normalY, normalZ);
+
+        // Deep blue, lit by the slope (level water keeps the old color),
+        // whitening toward the highest crests
+        Vertex* out = &vertices[r * columns];
+        for (int c = 0; c < columns; c++) {
+            float nx = normalX[c], ny = normalY[c], nz = normalZ[c];
+            float facing = (nx * light[0] + ny * light[1] + nz * light[2]) / (sqrtf(nx * nx + ny * ny + nz * nz) * light[1]);
+            float shade = 0.75f + 0.25f * facing;
+            float foam = std::min(1.0f, std::max(0.0f, (offsetY[c] / amplitude - 0.45f) * 2.0f)) * 0.6f;
+            float red = 0.1f * shade * (1.0f - foam) + 0.75f * foam;
+            float green = 0.25f * shade * (1.0f - foam) + 0.82f * foam;
+            float blue = 0.55f * shade * (1.0f - foam) + 0.9f * foam;
+
+            Vertex& vertex = out[c];
+            vertex.position[0] = baseX[c] + offsetX[c];
+            vertex.position[1] = waterLevel + offsetY[c];
+            vertex.position[2] = baseZ[c] + offsetZ[c];
+            vertex.texCoord[0] = baseX[c] * texScale + scrollU;
+            vertex.texCoord[1] = baseZ[c] * texScale + scrollV;
+            vertex.color[0] = (unsigned char)(std::min(1.0f, red) * 255.0f);
+            vertex.color[1] = (unsigned char)(std::min(1.0f, green) * 255.0f);
+            vertex.color[2] = (unsigned char)(std::min(1.0f, blue) * 255.0f);
+            vertex.color[3] = 255;
+        }
+    }
+}
+
+void Ocean::draw(const float* clip, float texScale, float scrollU, float scrollV) {
+    float inverse[16];
+    if (!invertMatrix(clip, inverse)) {
+        return;
+    }
+    float eyeH[4];
+    transformPoint(inverse, 0.0f, 0.0f, 1.0f, 0.0f, eyeH);
+    if (fabsf(eyeH[3]) < 1e-12f) {
+        return;
+    }
+    float eye[3] = { eyeH[0] / eyeH[3], eyeH[1] / eyeH[3], eyeH[2] / eyeH[3] };
+
+    // Highest point of each screen column that still reaches the water
+    // within range; the column's rows are spread evenly below it
+    for (int c = 0; c < columns; c++) {
+        float sx = -OVERSCAN + 2.0f * OVERSCAN * c / (columns - 1);
+        auto reaches = [&](float sy) {
+            float x, z;
+            project(inverse, eye, sx, sy, &x, &z);
+            float dx = x - eye[0];
+            float dz = z - eye[2];
+            return dx * dx + dz * dz < maxDistance * maxDistance * 0.999f;
+        };
+        float low = -OVERSCAN;
+        float high = OVERSCAN;
+        if (reaches(high)) {
+            columnTop[c] = high;
+            continue;
+        }
+        if (!reaches(low)) {
+            columnTop[c] = low;
+            continue;
+        }
+        for (int i = 0; i < 16; i++) {
+            float middle = (low + high) * 0.5f;
+            if (reaches(middle)) low = middle; else high = middle;
+        }
+        columnTop[c] = high;
+    }
+
+    WorkerPool::getInstance().parallelFor(rows, 8, [&](int begin, int end) {
+        buildRows(inverse, eye, texScale, scrollU, scrollV, begin, end);
+    });
+
+    if (!checked) {
+        checked = true;
+        if ((GLEW_VERSION_1_5 || GLEW_ARB_vertex_buffer_object) && glGenBuffers != NULL) {
+            glGenBuffers(1, &vbo);
+            glGenBuffers(1, &ibo);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned short), &indices[0],
+                         GL_STATIC_DRAW);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        } else {
+            printf("Ocean: no buffer objects, drawing from client arrays\n");
+        }
+    }
+
+    const char* base = NULL;
+    const unsigned short* indexBase = NULL;
+    if (vbo != 0) {
+        // Rewritten every frame; a fresh store lets the driver skip waiting on the last one
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STREAM_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+    } else {
+        base = (const char*)&vertices[0];
+        indexBase = &indices[0];
+    }
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, position));
+    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, texCoord));
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), base + offsetof(Vertex, color));
+
+    glDrawElements(GL_TRIANGLES, (GLsizei)indices.size(), GL_UNSIGNED_SHORT, indexBase);
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    if (vbo != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+}
+
+void Ocean::release() {
+    if (vbo != 0) {
+        glDeleteBuffers(1, &vbo);
+        vbo = 0;
+    }
+    if (ibo != 0) {
+        glDeleteBuffers(1, &ibo);
+        ibo = 0;
+    }
+    checked = false;
+}
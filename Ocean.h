@@ -0,0 +1,94 @@
+#pragma once
+#include "Vector3f.h"
+#include <vector>
+
+// Ocean - Gerstner-wave sea surface on a camera-projected grid
+// Level1's sea was three flat 12,000-unit quads with scrolling texture
+// coordinates, so the carrier and boats bobbed on water that didn't move.
+// The surface is now a sum of Gerstner waves. Each frame a grid of
+// screen-space points is cast from the camera onto the still water plane,
+// so vertices are spread evenly over the screen instead of the world, and
+// every point is displaced by the waves. The waves are evaluated four
+// vertices at a time with SSE2 (plain loops otherwise), with rows split
+// across the WorkerPool. Waves shorter than the grid spacing far away are
+// faded out there to avoid shimmer. getHeight()/getNormal() evaluate the
+// same waves at any point, so floating objects ride the drawn surface.
+class Ocean {
+public:
+    // Still water at level; the projected grid is columns x rows vertices
+    Ocean(float level = 0.0f, int columns = 128, int rows = 128);
+    ~Ocean();
+
+    Ocean(const Ocean&) = delete;
+    Ocean& operator=(const Ocean&) = delete;
+
+    void setLevel(float level) { waterLevel = level; }
+    float getLevel() const { return waterLevel; }
+
+    // Move the waves to this time in seconds
+    void update(float time);
+
+    // Surface height and upward normal at (x, z), at full wave strength
+    float getHeight(float x, float z) const;
+    Vector3f getNormal(float x, float z) const;
+    // Heights at count points in one pass, taken where the waves would carry
+    // the point rather than above it (off by at most the swell's sideways
+    // sway); fine for foam and wakes laid on the water
+    void getHeights(const float* x, const float* z, float* heights, int count) const;
+
+    // Project the grid through the column-major projection * modelview and
+    // displace it; texture coordinates are world XZ * texScale plus the
+    // scroll offset. Then draw it with the current texture and blending.
+    void draw(const float* clip, float texScale, float scrollU, float scrollV);
+    void release();
+
+    // Highest the waves can lift the surface above the still level
+    float getAmplitude() const { return amplitude; }
+
+private:
+    static const int WAVES = 8;
+
+    struct Vertex {
+        float position[3];
+        float texCoord[2];
+        unsigned char color[4];
+    };
+
+    // One wave: direction, wave number, height, steepness, speed, phase
+    struct Wave {
+        float dirX, dirZ;
+        float k;
+        float amplitude;
+        float steepness;    // Q: how far crests pull together
+        float omega;        // Angular frequency from deep-water dispersion
+        float phase;
+        float fadeScale;    // 1 / distance where this wave has faded out
+    };
+
+    float waterLevel;
+    int columns;
+    int rows;
+    float time;
+    float amplitude;
+    float maxDistance;              // Grid points never land further than this from the eye
+    Wave waves[WAVES];
+    std::vector<Vertex> vertices;
+    std::vector<unsigned short> indices;
+    std::vector<float> columnTop;   // Highest NDC y of each column that still hits the water
+    unsigned int vbo;
+    unsigned int ibo;
+    bool checked;
+
+    // Gerstner offset of the undisplaced point (x, z): dx, dy, dz, and the normal
+    void evaluate(float x, float z, float* offset, float* normal) const;
+    // Offsets and normals of count undisplaced points, four at a time with
+    // SSE2; waves fade with distance when it is given. With offsetX NULL
+    // only the heights (offsetY) are written.
+    void evaluateBatch(const float* x, const float* z, const float* distance, int count,
+                       float* offsetX, float* offsetY, float* offsetZ,
+                       float* normalX, float* normalY, float* normalZ) const;
+    // Still-water point the grid point at NDC (sx, sy) lands on
+    void project(const float* inverse, const float* eye, float sx, float sy, float* x, float* z) const;
+    void buildRows(const float* inverse, const float* eye, float texScale, float scrollU, float scrollV,
+                   int begin, int end);
+};
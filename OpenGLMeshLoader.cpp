@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "TextureBuilder.h"
 #include "Model_3DS.h"
 #include "GLTexture.h"
@@ -8,6 +9,14 @@
 #include "OptionsMenu.h"
 #include "Level1.h"
 #include "Level2.h"
+#include "TextureManager.h"
+#include "TextureStreamer.h"
+#include "SkyDome.h"
+#include "ModelInstancer.h"
+#include "ProceduralTextures.h"
+#include "GLState.h"
+#include "TextRenderer.h"
+#include "RenderQueueCheck.h"
 #include <Vector3f.h>
 #include <glut.h>
 
@@ -29,20 +38,20 @@ GLdouble zFar = 1000;
 //=======================================================================
 void InitLightSource()
 {
-	glEnable(GL_LIGHTING);
-	glEnable(GL_LIGHT0);
+	GLState::enable(GL_LIGHTING);
+	GLState::enable(GL_LIGHT0);
 
 	GLfloat ambient[] = { 0.1f, 0.1f, 0.1f, 1.0f };
-	glLightfv(GL_LIGHT0, GL_AMBIENT, ambient);
+	GLState::lightfv(GL_LIGHT0, GL_AMBIENT, ambient);
 
 	GLfloat diffuse[] = { 0.5f, 0.5f, 0.5f, 1.0f };
-	glLightfv(GL_LIGHT0, GL_DIFFUSE, diffuse);
+	GLState::lightfv(GL_LIGHT0, GL_DIFFUSE, diffuse);
 
 	GLfloat specular[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-	glLightfv(GL_LIGHT0, GL_SPECULAR, specular);
+	GLState::lightfv(GL_LIGHT0, GL_SPECULAR, specular);
 
 	GLfloat light_position[] = { 0.0f, 10.0f, 0.0f, 1.0f };
-	glLightfv(GL_LIGHT0, GL_POSITION, light_position);
+	GLState::lightfv(GL_LIGHT0, GL_POSITION, light_position);
 }
 
 //=======================================================================
@@ -50,7 +59,7 @@ void InitLightSource()
 //=======================================================================
 void InitMaterial()
 {
-	glEnable(GL_COLOR_MATERIAL);
+	GLState::enable(GL_COLOR_MATERIAL);
 	glColorMaterial(GL_FRONT, GL_AMBIENT_AND_DIFFUSE);
 
 	GLfloat specular[] = { 1.0f, 1.0f, 1.0f, 1.0f };
@@ -67,6 +76,9 @@ void myInit(void)
 {
 	glClearColor(0.35, 0.45, 0.65, 1.0);  // Sky blue default
 
+	// Fresh context: nothing the state cache remembers is current
+	GLState::invalidate();
+
 	glMatrixMode(GL_PROJECTION);
 	glLoadIdentity();
 	gluPerspective(fovy, aspectRatio, zNear, zFar);
@@ -77,8 +89,8 @@ void myInit(void)
 	InitLightSource();
 	InitMaterial();
 
-	glEnable(GL_DEPTH_TEST);
-	glEnable(GL_NORMALIZE);
+	GLState::enable(GL_DEPTH_TEST);
+	GLState::enable(GL_NORMALIZE);
 }
 
 //=======================================================================
@@ -86,8 +98,19 @@ void myInit(void)
 //=======================================================================
 void myDisplay(void)
 {
+	GLState::resetCounts();
+
+	// First frame only: bake the HUD font atlas before anything is drawn
+	TextRenderer::getInstance().prepare();
+
+	// Finish a slice of queued texture uploads before drawing
+	TextureStreamer::getInstance().update();
+
 	// Delegate rendering to GameManager
 	GameManager::getInstance().render();
+
+	// Act on the mip requests the frame just made
+	TextureManager::getInstance().updateMipStreaming();
 	glFlush();
     glutSwapBuffers();
 }
@@ -123,6 +146,13 @@ void myKeyboardUp(unsigned char button, int x, int y) {
 void mySpecial(int key, int x, int y) {
     // Handle special keys (arrow keys) for plane selection
     Level* currentLevel = GameManager::getInstance().getCurrentLevel();
+    // F3: print last frame's culling, render state and GL state counts
+    if (key == GLUT_KEY_F3 && currentLevel) {
+        currentLevel->getRenderQueue().printCullStats(GameManager::getInstance().getCurrentLevelName().c_str());
+        currentLevel->getRenderStats().print(GameManager::getInstance().getCurrentLevelName().c_str());
+        GLState::printStats(GameManager::getInstance().getCurrentLevelName().c_str());
+        return;
+    }
     PlaneSelectionLevel* planeSelect = dynamic_cast<PlaneSelectionLevel*>(currentLevel);
     if (planeSelect) {
         planeSelect->handleSpecialKeys(key, true);
@@ -171,12 +201,47 @@ void myReshape(int w, int h)
 //=======================================================================
 int main(int argc, char** argv)
 {
+	// --check-render-queue: sort a small queue into a null backend, check the counts, then exit.
+	// Needs no window or GL context, so it runs before GLUT starts.
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--check-render-queue") == 0) {
+			return RenderQueueCheck::run() ? 0 : 1;
+		}
+	}
+
 	glutInit(&argc, argv);
 	glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGB | GLUT_DEPTH);
 	glutInitWindowSize(WIDTH, HEIGHT);
 	glutInitWindowPosition(100, 100);
 	glutCreateWindow(title);
 
+	// Load GL extension entry points (compressed textures, etc.)
+	GLenum glewStatus = glewInit();
+	if (glewStatus != GLEW_OK) {
+		printf("GLEW init failed: %s\n", (const char*)glewGetErrorString(glewStatus));
+	}
+
+	// --bake-textures: load every level once, write baked DDS files, then exit
+	// --texture-budget-mb N: VRAM budget for resident textures (0 = unlimited)
+	// --count-frame: record one frame of each level into a null backend, print the counts, then exit
+	// --analytic-sky: color the sky from the sun direction instead of the four skybox textures
+	// --no-instancing: draw every model placement through Model_3DS::Draw (for comparison)
+	// --no-occlusion: cull Level2's city against the view frustum only (for comparison)
+	bool bakeTextures = false;
+	bool countFrame = false;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--bake-textures") == 0) bakeTextures = true;
+		else if (strcmp(argv[i], "--count-frame") == 0) countFrame = true;
+		else if (strcmp(argv[i], "--analytic-sky") == 0) SkySystem::setAnalyticDefault(true);
+		else if (strcmp(argv[i], "--no-instancing") == 0) ModelInstancer::getInstance().setEnabled(false);
+		else if (strcmp(argv[i], "--no-occlusion") == 0) Level2::setOcclusionCulling(false);
+		else if (strcmp(argv[i], "--texture-budget-mb") == 0 && i + 1 < argc) {
+			TextureManager::getInstance().setBudget((size_t)atoi(argv[++i]) * 1024 * 1024);
+		}
+	}
+	TextureManager::getInstance().setBakeMode(bakeTextures);
+	TextureStreamer::getInstance().init();
+
 	glutDisplayFunc(myDisplay);
 	glutReshapeFunc(myReshape);
     
@@ -203,10 +268,36 @@ int main(int argc, char** argv)
     GameManager::getInstance().registerLevel("options", optionsMenu);
     
     // Initialize all levels
-    planeSelectLevel->init();
-    carrierLevel->init();
-    flightLevel->init();
-    optionsMenu->init();
+    GameManager::getInstance().initLevel("planeselect");
+    GameManager::getInstance().initLevel("level1");
+    GameManager::getInstance().initLevel("level2");
+    GameManager::getInstance().initLevel("options");
+    TextureManager::getInstance().printStats();
+    printf("ProceduralTextures: %d generated, %d from cache\n",
+           ProceduralTextures::getGeneratedCount(), ProceduralTextures::getCachedCount());
+    if (countFrame) {
+        Level* countedLevels[] = { carrierLevel, flightLevel };
+        const char* countedNames[] = { "level1", "level2" };
+        for (int i = 0; i < 2; i++) {
+            NullRenderBackend counter;
+            countedLevels[i]->recordScene();
+            countedLevels[i]->getRenderQueue().submit(counter);
+            printf("RenderQueue %s: %d draws in %d groups, %d triangles (%d meshes, %d materials)\n",
+                   countedNames[i], counter.getDrawCount(), counter.getGroupCount(), counter.getTriangleCount(),
+                   countedLevels[i]->getRenderQueue().getMeshCount(),
+                   countedLevels[i]->getRenderQueue().getMaterialCount());
+            counter.getStats().print(countedNames[i]);
+            countedLevels[i]->getRenderQueue().clear();
+        }
+    }
+    if (bakeTextures || countFrame) {
+        GameManager::getInstance().cleanup();
+        return 0;
+    }
+
+    // Loading is over: textures that arrive from now on (plane changes,
+    // evicted textures coming back) are uploaded over several frames
+    TextureManager::getInstance().setStreaming(true);
     
     // Start with plane selection screen
     GameManager::getInstance().switchToLevel("planeselect");
@@ -216,6 +307,10 @@ int main(int argc, char** argv)
     
     // Cleanup
     GameManager::getInstance().cleanup();
+    TextureStreamer::getInstance().cleanup();
+    SkyDome::getInstance().release();
+    ModelInstancer::getInstance().release();
+    TextRenderer::getInstance().release();
     
     return 0;
 }
\ No newline at end of file
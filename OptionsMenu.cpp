@@ -1,6 +1,8 @@
 #include "OptionsMenu.h"
 #include "GameManager.h"
 #include "PlaneSelectionLevel.h"
+#include "GLState.h"
+#include "TextRenderer.h"
 #include <glut.h>
 #include <stdio.h>
 #include <cmath>
@@ -19,8 +21,8 @@ void OptionsMenu::init() {
     printf("Initializing Options Menu...\n");
     // Match PlaneSelectionLevel clear color
     glClearColor(0.08f, 0.12f, 0.22f, 1.0f);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
     // Initialize selection indices
     selectedLevelIndex = 0;
@@ -34,6 +36,7 @@ void OptionsMenu::update(float deltaTime) {
 }
 
 void OptionsMenu::render() {
+    TextRenderer& textRenderer = TextRenderer::getInstance();
     if (!active) return;
     
     // Sync viewport
@@ -55,11 +58,11 @@ void OptionsMenu::render() {
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
     
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_LIGHTING);
-    glDisable(GL_TEXTURE_2D);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_TEXTURE_2D);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
     // Draw background gradient panels (Matching PlaneSelectionLevel)
     glBegin(GL_QUADS);
@@ -91,30 +94,28 @@ void OptionsMenu::render() {
     glVertex2f(0, 60);
     glEnd();
 
-    glColor4f(0.9f, 0.9f, 0.9f, 1.0f);
-    glRasterPos2f(screenWidth * 0.5f - 180, 25);
+    textRenderer.setColor(0.9f, 0.9f, 0.9f, 1.0f);
     const char* hint = "[LEFT/RIGHT] Navigate   |   [ENTER] Select   |   [ESC] Back";
-    for (const char* c = hint; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-    }
+    textRenderer.add(screenWidth * 0.5f - 180, 25, hint, GLUT_BITMAP_HELVETICA_12);
+
+    // Title and button labels were queued along the way
+    textRenderer.flush(TextRenderer::SCREEN_OPTIONS);
 }
 
 void OptionsMenu::drawTitle() {
+    TextRenderer& textRenderer = TextRenderer::getInstance();
     // Title with shadow
-    glColor4f(0.0f, 0.0f, 0.0f, 0.5f);
-    glRasterPos2f(screenWidth * 0.5f - 108, screenHeight - 68);
+    textRenderer.setColor(0.0f, 0.0f, 0.0f, 0.5f);
     const char* title = "OPTIONS MENU";
-    for (const char* c = title; *c; ++c) glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, *c);
+    textRenderer.add(screenWidth * 0.5f - 108, screenHeight - 68, title, GLUT_BITMAP_TIMES_ROMAN_24);
 
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glRasterPos2f(screenWidth * 0.5f - 110, screenHeight - 70);
-    for (const char* c = title; *c; ++c) glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, *c);
+    textRenderer.setColor(1.0f, 1.0f, 1.0f);
+    textRenderer.add(screenWidth * 0.5f - 110, screenHeight - 70, title, GLUT_BITMAP_TIMES_ROMAN_24);
     
     // Subtitle
-    glColor4f(0.7f, 0.8f, 0.9f, 0.9f);
-    glRasterPos2f(screenWidth * 0.5f - 60, screenHeight - 100);
+    textRenderer.setColor(0.7f, 0.8f, 0.9f, 0.9f);
     const char* subtitle = "Configure your flight";
-    for (const char* c = subtitle; *c; ++c) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
+    textRenderer.add(screenWidth * 0.5f - 60, screenHeight - 100, subtitle, GLUT_BITMAP_HELVETICA_12);
 }
 
 void OptionsMenu::drawLevelSelect() {
@@ -176,6 +177,7 @@ void OptionsMenu::drawPlaneSelect() {
 
 // Redesigned to look like 'Cards' from PlaneSelectionLevel
 void OptionsMenu::drawButton(const char* text, float x, float y, float w, float h, bool highlighted, bool pressed) {
+    TextRenderer& textRenderer = TextRenderer::getInstance();
     float scale = highlighted ? 1.05f : 1.0f;
     float pulse = highlighted ? (0.15f * sin(pulseTimer * 3.0f)) : 0.0f;
     
@@ -212,10 +214,10 @@ void OptionsMenu::drawButton(const char* text, float x, float y, float w, float
     // Border
     if (highlighted) {
         glColor4f(1.0f, 0.9f, 0.4f, 1.0f); // Gold highlight
-        glLineWidth(3.0f);
+        GLState::lineWidth(3.0f);
     } else {
         glColor4f(0.4f, 0.5f, 0.7f, 0.5f);
-        glLineWidth(1.0f);
+        GLState::lineWidth(1.0f);
     }
     
     glBegin(GL_LINE_LOOP);
@@ -224,10 +226,10 @@ void OptionsMenu::drawButton(const char* text, float x, float y, float w, float
     glVertex2f(dX + actualW, dY + actualH);
     glVertex2f(dX, dY + actualH);
     glEnd();
-    glLineWidth(1.0f);
+    GLState::lineWidth(1.0f);
     
     // Text
-    glColor3f(1.0f, 1.0f, 1.0f);
+    textRenderer.setColor(1.0f, 1.0f, 1.0f);
     
     // Simple centering logic
     // We'll just draw the text centered for now.
@@ -257,10 +259,7 @@ void OptionsMenu::drawButton(const char* text, float x, float y, float w, float
         void* font = GLUT_BITMAP_HELVETICA_18;
         float textX = dX + (actualW - strlen(line) * 9.0f) * 0.5f; 
         
-        glRasterPos2f(textX, currentY);
-        for (const char* c = line; *c; ++c) {
-             glutBitmapCharacter(font, *c);
-        }
+        textRenderer.add(textX, currentY, line, font);
         currentY -= 24.0f; // line spacing
         line = strtok(NULL, "\n");
     }
@@ -0,0 +1,572 @@
+#include "PNGDecoder.h"
+#include "WorkerPool.h"
+#include <stdio.h>
+#include <cstring>
+#include <cstdlib>
+#include <mutex>
+#include <emmintrin.h>
+
+//=======================================================================
+// Inflate (RFC 1950/1951)
+//=======================================================================
+
+// Codes up to this length resolve with one table lookup
+static const int FAST_BITS = 9;
+
+struct Huffman {
+    unsigned short fast[1 << FAST_BITS];    // (length << 9) | symbol, 0 = use the slow path
+    unsigned short firstCode[17];
+    unsigned short firstSymbol[17];
+    int maxCode[18];                        // One past the last code of each length, left-aligned to 16 bits
+    unsigned char size[288];
+    unsigned short value[288];
+};
+
+struct BitReader {
+    const unsigned char* p;
+    const unsigned char* end;
+    unsigned long long bits;
+    int count;
+    int padding;                // Zero bytes refilled past the end
+
+    // Refills read ahead, so padding alone is fine; consuming it isn't
+    bool overran() const { return padding * 8 > count; }
+
+    void refill() {
+        while (count <= 56) {
+            if (p < end) {
+                bits |= (unsigned long long)*p++ << count;
+            } else {
+                padding++;          // Past the end reads as zero bits
+            }
+            count += 8;
+        }
+    }
+
+    unsigned int get(int n) {
+        if (count < n) refill();
+        unsigned int value = (unsigned int)(bits & ((1ULL << n) - 1));
+        bits >>= n;
+        count -= n;
+        return value;
+    }
+};
+
+static int reverseBits(int code, int length) {
+    int result = 0;
+    for (int i = 0; i < length; i++) {
+        result = (result << 1) | (code & 1);
+        code >>= 1;
+    }
+    return result;
+}
+
+static bool buildHuffman(Huffman& h, const unsigned char* lengths, int count) {
+    int sizes[17] = { 0 };
+    int nextCode[16];
+    memset(h.fast, 0, sizeof(h.fast));
+    memset(h.size, 0, sizeof(h.size));
+
+    for (int i = 0; i < count; i++) sizes[lengths[i]]++;
+    sizes[0] = 0;
+
+    int code = 0;
+    int symbol = 0;
+    for (int i = 1; i < 16; i++) {
+        nextCode[i] = code;
+        h.firstCode[i] = (unsigned short)code;
+        h.firstSymbol[i] = (unsigned short)symbol;
+        code += sizes[i];
+        if (sizes[i] && code - 1 >= (1 << i)) {
+            return false;   // Over-subscribed
+        }
+        h.maxCode[i] = code << (16 - i);
+        code <<= 1;
+        symbol += sizes[i];
+    }
+    h.maxCode[16] = 0x10000;
+
+    for (int i = 0; i < count; i++) {
+        int length = lengths[i];
+        if (length == 0) continue;
+        int slot = nextCode[length] - h.firstCode[length] + h.firstSymbol[length];
+        h.size[slot] = (unsigned char)length;
+        h.value[slot] = (unsigned short)i;
+        if (length <= FAST_BITS) {
+            for (int j = reverseBits(nextCode[length], length); j < (1 << FAST_BITS); j += 1 << length) {
+                h.fast[j] = (unsigned short)((length << 9) | i);
+            }
+        }
+        nextCode[length]++;
+    }
+    return true;
+}
+
+static int decodeSymbol(BitReader& in, const Huffman& h) {
+    if (in.count < 16) in.refill();
+    int entry = h.fast[in.bits & ((1 << FAST_BITS) - 1)];
+    if (entry) {
+        int length = entry >> 9;
+        in.bits >>= length;
+        in.count -= length;
+        return entry & 511;
+    }
+
+    // Longer code: compare the bit-reversed next 16 bits against each length's range
+    int k = reverseBits((int)(in.bits & 0xFFFF), 16);
+    int length;
+    for (length = FAST_BITS + 1; length < 16; length++) {
+        if (k < h.maxCode[length]) break;
+    }
+    if (length >= 16) return -1;
+    int slot = (k >> (16 - length)) - h.firstCode[length] + h.firstSymbol[length];
+    if (slot >= 288 || h.size[slot] != length) return -1;
+    in.bits >>= length;
+    in.count -= length;
+    return h.value[slot];
+}
+
+static const unsigned short LENGTH_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const unsigned char LENGTH_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const unsigned short DIST_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const unsigned char DIST_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+static bool readDynamicTables(BitReader& in, Huffman& literals, Huffman& distances) {
+    static const unsigned char ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+    int literalCount = in.get(5) + 257;
+    int distanceCount = in.get(5) + 1;
+    int codeLengthCount = in.get(4) + 4;
+
+    unsigned char codeLengths[19] = { 0 };
+    for (int i = 0; i < codeLengthCount; i++) {
+        codeLengths[ORDER[i]] = (unsigned char)in.get(3);
+    }
+    Huffman codeLengthTable;
+    if (!buildHuffman(codeLengthTable, codeLengths, 19)) return false;
+
+    unsigned char lengths[286 + 32];
+    int total = literalCount + distanceCount;
+    int n = 0;
+    while (n < total) {
+        int symbol = decodeSymbol(in, codeLengthTable);
+        if (symbol < 0) return false;
+        if (symbol < 16) {
+            lengths[n++] = (unsigned char)symbol;
+            continue;
+        }
+        int repeat;
+        unsigned char fill = 0;
+        if (symbol == 16) {
+            if (n == 0) return false;
+            repeat = in.get(2) + 3;
+            fill = lengths[n - 1];
+        } else if (symbol == 17) {
+            repeat = in.get(3) + 3;
+        } else {
+            repeat = in.get(7) + 11;
+        }
+        if (n + repeat > total) return false;
+        memset(lengths + n, fill, repeat);
+        n += repeat;
+    }
+
+    return buildHuffman(literals, lengths, literalCount) &&
+           buildHuffman(distances, lengths + literalCount, distanceCount);
+}
+
+static bool inflateBlock(BitReader& in, const Huffman& literals, const Huffman& distances,
+                         unsigned char* out, size_t& pos, size_t outSize) {
+    for (;;) {
+        int symbol = decodeSymbol(in, literals);
+        if (symbol < 256) {
+            if (symbol < 0 || pos >= outSize) return false;
+            out[pos++] = (unsigned char)symbol;
+            continue;
+        }
+        if (symbol == 256) {
+            return true;
+        }
+
+        symbol -= 257;
+        if (symbol >= 29) return false;
+        int length = LENGTH_BASE[symbol] + (LENGTH_EXTRA[symbol] ? in.get(LENGTH_EXTRA[symbol]) : 0);
+
+        int distSymbol = decodeSymbol(in, distances);
+        if (distSymbol < 0 || distSymbol >= 30) return false;
+        size_t dist = DIST_BASE[distSymbol] + (DIST_EXTRA[distSymbol] ? in.get(DIST_EXTRA[distSymbol]) : 0);
+        if (dist > pos || pos + length > outSize) return false;
+
+        unsigned char* dest = out + pos;
+        const unsigned char* src = dest - dist;
+        if (dist == 1) {
+            memset(dest, *src, length);
+        } else if (dist >= (size_t)length) {
+            memcpy(dest, src, length);
+        } else {
+            for (int i = 0; i < length; i++) dest[i] = src[i];
+        }
+        pos += length;
+    }
+}
+
+bool PNGDecoder::inflate(const unsigned char* bytes, size_t size, size_t expectedSize, std::vector<unsigned char>& out) {
+    // zlib header: deflate method, no preset dictionary
+    if (size < 2 || (bytes[0] & 0x0F) != 8 || ((bytes[0] << 8) | bytes[1]) % 31 != 0 || (bytes[1] & 0x20)) {
+        return false;
+    }
+
+    BitReader in;
+    in.p = bytes + 2;
+    in.end = bytes + size;
+    in.bits = 0;
+    in.count = 0;
+    in.padding = 0;
+
+    out.resize(expectedSize);
+    unsigned char* dest = out.empty() ? NULL : &out[0];
+    size_t pos = 0;
+
+    // Built once; read-only afterwards, so concurrent decodes can share them
+    static Huffman fixedLiterals, fixedDistances;
+    static std::once_flag fixedOnce;
+    std::call_once(fixedOnce, []() {
+        unsigned char lengths[288];
+        memset(lengths, 8, 144);
+        memset(lengths + 144, 9, 112);
+        memset(lengths + 256, 7, 24);
+        memset(lengths + 280, 8, 8);
+        buildHuffman(fixedLiterals, lengths, 288);
+        memset(lengths, 5, 30);
+        buildHuffman(fixedDistances, lengths, 30);
+    });
+
+    bool last = false;
+    while (!last) {
+        last = in.get(1) != 0;
+        int type = in.get(2);
+
+        if (type == 0) {
+            // Stored: byte-align, then LEN / NLEN and raw bytes
+            in.get(in.count & 7);
+            unsigned int length = in.get(16);
+            unsigned int inverse = in.get(16);
+            if ((length ^ 0xFFFF) != inverse || pos + length > expectedSize) return false;
+            while (length > 0 && in.count >= 8) {
+                dest[pos++] = (unsigned char)in.get(8);
+                length--;
+            }
+            if (length > (size_t)(in.end - in.p)) return false;
+            memcpy(dest + pos, in.p, length);
+            in.p += length;
+            pos += length;
+        } else if (type == 1) {
+            if (!inflateBlock(in, fixedLiterals, fixedDistances, dest, pos, expectedSize)) return false;
+        } else if (type == 2) {
+            Huffman literals, distances;
+            if (!readDynamicTables(in, literals, distances)) return false;
+            if (!inflateBlock(in, literals, distances, dest, pos, expectedSize)) return false;
+        } else {
+            return false;
+        }
+    }
+    // A truncated stream decodes its missing tail as zeros
+    return pos == expectedSize && !in.overran();
+}
+
+//=======================================================================
+// Row filters
+//=======================================================================
+
+static inline __m128i load4(const unsigned char* p, int bpp) {
+    int value = 0;
+    memcpy(&value, p, bpp);
+    return _mm_cvtsi32_si128(value);
+}
+
+static inline void store4(unsigned char* p, __m128i v, int bpp) {
+    int value = _mm_cvtsi128_si32(v);
+    memcpy(p, &value, bpp);
+}
+
+void PNGDecoder::unfilterSub(unsigned char* row, size_t rowBytes, int bpp) {
+    if (bpp == 3 || bpp == 4) {
+        __m128i a = _mm_setzero_si128();
+        for (size_t i = 0; i < rowBytes; i += bpp) {
+            a = _mm_add_epi8(a, load4(row + i, bpp));
+            store4(row + i, a, bpp);
+        }
+        return;
+    }
+    for (size_t i = bpp; i < rowBytes; i++) {
+        row[i] = (unsigned char)(row[i] + row[i - bpp]);
+    }
+}
+
+void PNGDecoder::unfilterUp(unsigned char* row, const unsigned char* prev, size_t rowBytes) {
+    size_t i = 0;
+    for (; i + 16 <= rowBytes; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(row + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(prev + i));
+        _mm_storeu_si128((__m128i*)(row + i), _mm_add_epi8(x, b));
+    }
+    for (; i < rowBytes; i++) {
+        row[i] = (unsigned char)(row[i] + prev[i]);
+    }
+}
+
+void PNGDecoder::unfilterAverage(unsigned char* row, const unsigned char* prev, size_t rowBytes, int bpp) {
+    if (bpp == 3 || bpp == 4) {
+        const __m128i one = _mm_set1_epi8(1);
+        __m128i a = _mm_setzero_si128();
+        for (size_t i = 0; i < rowBytes; i += bpp) {
+            __m128i b = load4(prev + i, bpp);
+            // avg_epu8 rounds up; the filter wants (a + b) >> 1
+            __m128i average = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+            a = _mm_add_epi8(load4(row + i, bpp), average);
+            store4(row + i, a, bpp);
+        }
+        return;
+    }
+    for (size_t i = 0; i < rowBytes; i++) {
+        int a = i >= (size_t)bpp ? row[i - bpp] : 0;
+        row[i] = (unsigned char)(row[i] + ((a + prev[i]) >> 1));
+    }
+}
+
+void PNGDecoder::unfilterPaeth(unsigned char* row, const unsigned char* prev, size_t rowBytes, int bpp) {
+    if (bpp == 3 || bpp == 4) {
+        // One pixel per step in 16-bit lanes: left (a), up (b), up-left (c)
+        const __m128i zero = _mm_setzero_si128();
+        __m128i a = zero, c = zero;
+        for (size_t i = 0; i < rowBytes; i += bpp) {
+            __m128i b = _mm_unpacklo_epi8(load4(prev + i, bpp), zero);
+            __m128i x = load4(row + i, bpp);
+
+            __m128i pa = _mm_sub_epi16(b, c);       // p - a
+            __m128i pb = _mm_sub_epi16(a, c);       // p - b
+            __m128i pc = _mm_add_epi16(pa, pb);     // p - c
+            pa = _mm_max_epi16(pa, _mm_sub_epi16(zero, pa));
+            pb = _mm_max_epi16(pb, _mm_sub_epi16(zero, pb));
+            pc = _mm_max_epi16(pc, _mm_sub_epi16(zero, pc));
+            __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+
+            // Ties prefer a, then b, then c
+            __m128i useA = _mm_cmpeq_epi16(pa, smallest);
+            __m128i useB = _mm_andnot_si128(useA, _mm_cmpeq_epi16(pb, smallest));
+            __m128i useC = _mm_andnot_si128(_mm_or_si128(useA, useB), _mm_set1_epi16(-1));
+            __m128i nearest = _mm_or_si128(_mm_or_si128(_mm_and_si128(useA, a), _mm_and_si128(useB, b)),
+                                           _mm_and_si128(useC, c));
+
+            __m128i result = _mm_add_epi8(x, _mm_packus_epi16(nearest, zero));
+            store4(row + i, result, bpp);
+            a = _mm_unpacklo_epi8(result, zero);
+            c = b;
+        }
+        return;
+    }
+    for (size_t i = 0; i < rowBytes; i++) {
+        int a = i >= (size_t)bpp ? row[i - bpp] : 0;
+        int b = prev[i];
+        int c = i >= (size_t)bpp ? prev[i - bpp] : 0;
+        int pa = abs(b - c);
+        int pb = abs(a - c);
+        int pc = abs(a + b - 2 * c);
+        int predictor = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+        row[i] = (unsigned char)(row[i] + predictor);
+    }
+}
+
+bool PNGDecoder::unfilter(unsigned char* data, int height, size_t rowBytes, int bytesPerPixel, std::vector<unsigned char>& out) {
+    out.resize(rowBytes * height);
+    std::vector<unsigned char> zeroRow(rowBytes, 0);
+    const unsigned char* prev = &zeroRow[0];
+
+    for (int y = 0; y < height; y++) {
+        const unsigned char* src = data + (rowBytes + 1) * y;
+        unsigned char* row = &out[rowBytes * y];
+        memcpy(row, src + 1, rowBytes);
+
+        switch (src[0]) {
+            case 0: break;
+            case 1: unfilterSub(row, rowBytes, bytesPerPixel); break;
+            case 2: unfilterUp(row, prev, rowBytes); break;
+            case 3: unfilterAverage(row, prev, rowBytes, bytesPerPixel); break;
+            case 4: unfilterPaeth(row, prev, rowBytes, bytesPerPixel); break;
+            default: return false;
+        }
+        prev = row;
+    }
+    return true;
+}
+
+//=======================================================================
+// PNG
+//=======================================================================
+
+static unsigned int readBE32(const unsigned char* p) {
+    return ((unsigned int)p[0] << 24) | ((unsigned int)p[1] << 16) | ((unsigned int)p[2] << 8) | p[3];
+}
+
+bool PNGDecoder::isPNG(const unsigned char* bytes, size_t size) {
+    static const unsigned char SIGNATURE[8] = { 137, 'P', 'N', 'G', 13, 10, 26, 10 };
+    return size >= 8 && memcmp(bytes, SIGNATURE, 8) == 0;
+}
+
+bool PNGDecoder::decode(const unsigned char* bytes, size_t size, unsigned int flags, ImageData& out) {
+    if (!isPNG(bytes, size)) {
+        return false;
+    }
+
+    int width = 0, height = 0, bitDepth = 0, colorType = -1, interlace = 0;
+    unsigned char palette[256 * 4];
+    int paletteSize = 0;
+    bool paletteAlpha = false;
+    std::vector<unsigned char> compressed;
+
+    // Chunks: length, type, data, CRC (not verified; the inflate checks catch truncation)
+    size_t pos = 8;
+    while (pos + 12 <= size) {
+        unsigned int length = readBE32(bytes + pos);
+        const unsigned char* type = bytes + pos + 4;
+        const unsigned char* data = bytes + pos + 8;
+        if (length > size - pos - 12) {
+            return false;
+        }
+
+        if (memcmp(type, "IHDR", 4) == 0 && length >= 13) {
+            width = (int)readBE32(data);
+            height = (int)readBE32(data + 4);
+            bitDepth = data[8];
+            colorType = data[9];
+            interlace = data[12];
+        } else if (memcmp(type, "PLTE", 4) == 0) {
+            paletteSize = (int)(length / 3);
+            if (paletteSize > 256) return false;
+            for (int i = 0; i < paletteSize; i++) {
+                palette[i * 4 + 0] = data[i * 3 + 0];
+                palette[i * 4 + 1] = data[i * 3 + 1];
+                palette[i * 4 + 2] = data[i * 3 + 2];
+                palette[i * 4 + 3] = 255;
+            }
+        } else if (memcmp(type, "tRNS", 4) == 0 && colorType == 3) {
+            for (unsigned int i = 0; i < length && (int)i < paletteSize; i++) {
+                palette[i * 4 + 3] = data[i];
+            }
+            paletteAlpha = true;
+        } else if (memcmp(type, "IDAT", 4) == 0) {
+            compressed.insert(compressed.end(), data, data + length);
+        } else if (memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        pos += 12 + length;
+    }
+
+    if (width <= 0 || height <= 0 || width > 16384 || height > 16384 || compressed.empty()) {
+        return false;
+    }
+    if (interlace != 0) {
+        printf("PNGDecoder: Interlaced PNGs are not supported\n");
+        return false;
+    }
+
+    int samples;
+    switch (colorType) {
+        case 0: samples = 1; break;     // Gray
+        case 2: samples = 3; break;     // RGB
+        case 3: samples = 1; break;     // Palette
+        case 4: samples = 2; break;     // Gray + alpha
+        case 6: samples = 4; break;     // RGBA
+        default: return false;
+    }
+    bool validDepth = colorType == 3 ? (bitDepth == 1 || bitDepth == 2 || bitDepth == 4 || bitDepth == 8)
+                                     : (bitDepth == 8 || bitDepth == 16);
+    if (!validDepth || (colorType == 3 && paletteSize == 0)) {
+        return false;
+    }
+
+    size_t rowBytes = ((size_t)width * samples * bitDepth + 7) / 8;
+    int bytesPerPixel = (samples * bitDepth + 7) / 8;
+
+    std::vector<unsigned char> filtered;
+    if (!inflate(&compressed[0], compressed.size(), (rowBytes + 1) * height, filtered)) {
+        return false;
+    }
+    std::vector<unsigned char>().swap(compressed);
+
+    std::vector<unsigned char> raw;
+    if (!unfilter(&filtered[0], height, rowBytes, bytesPerPixel, raw)) {
+        return false;
+    }
+    std::vector<unsigned char>().swap(filtered);
+
+    bool brightnessAlpha = (flags & TEX_BRIGHTNESS_ALPHA) != 0;
+    bool flipVertical = (flags & TEX_FLIP_VERTICAL) != 0;
+    bool hasAlpha = colorType == 4 || colorType == 6 || (colorType == 3 && paletteAlpha);
+
+    out.width = width;
+    out.height = height;
+    out.channels = (hasAlpha || brightnessAlpha) ? 4 : 3;
+    out.pixels.resize((size_t)width * height * out.channels);
+
+    // Expand to 8-bit RGB(A); rows are independent from here on
+    int step = bitDepth == 16 ? 2 : 1;
+    WorkerPool::getInstance().parallelFor(height, 64, [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            const unsigned char* src = &raw[rowBytes * y];
+            int destY = flipVertical ? height - 1 - y : y;
+            unsigned char* dest = &out.pixels[(size_t)destY * width * out.channels];
+
+            for (int x = 0; x < width; x++) {
+                unsigned char r, g, b, a = 255;
+                if (colorType == 3) {
+                    int index;
+                    if (bitDepth == 8) {
+                        index = src[x];
+                    } else {
+                        int perByte = 8 / bitDepth;
+                        int shift = 8 - bitDepth * (x % perByte + 1);
+                        index = (src[x / perByte] >> shift) & ((1 << bitDepth) - 1);
+                    }
+                    const unsigned char* entry = &palette[(index < paletteSize ? index : 0) * 4];
+                    r = entry[0];
+                    g = entry[1];
+                    b = entry[2];
+                    a = entry[3];
+                } else {
+                    // High byte of 16-bit samples
+                    const unsigned char* pixel = src + (size_t)x * samples * step;
+                    if (samples <= 2) {
+                        r = g = b = pixel[0];
+                        if (samples == 2) a = pixel[step];
+                    } else {
+                        r = pixel[0];
+                        g = pixel[step];
+                        b = pixel[2 * step];
+                        if (samples == 4) a = pixel[3 * step];
+                    }
+                }
+
+                if (brightnessAlpha) {
+                    a = (unsigned char)((r + g + b) / 3);
+                }
+
+                dest[0] = r;
+                dest[1] = g;
+                dest[2] = b;
+                if (out.channels == 4) {
+                    dest[3] = a;
+                }
+                dest += out.channels;
+            }
+        }
+    });
+
+    return true;
+}
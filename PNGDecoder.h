@@ -0,0 +1,30 @@
+#pragma once
+#include "TextureManager.h"
+#include <vector>
+
+// PNG Decoder - 8/16-bit gray, RGB, palette and alpha PNGs
+// The tank model ships its textures as PNGs, which none of the loaders
+// could read. Non-interlaced images are supported (the common case for
+// exported textures). Inflate and the row filters are written for speed:
+// table-driven Huffman decoding and SSE2 unfiltering. A single image is
+// inherently serial, so throughput comes from decoding several images at
+// once (TextureManager::acquireBatch).
+class PNGDecoder {
+public:
+    static bool isPNG(const unsigned char* bytes, size_t size);
+
+    // Same conventions as TextureManager::decodeBMP: top row first unless
+    // TEX_FLIP_VERTICAL, RGB or RGBA out. PNG alpha is always kept.
+    static bool decode(const unsigned char* bytes, size_t size, unsigned int flags, ImageData& out);
+
+    // zlib stream -> exactly expectedSize bytes
+    static bool inflate(const unsigned char* bytes, size_t size, size_t expectedSize, std::vector<unsigned char>& out);
+
+private:
+    // Undo the per-row filters in place; rows are filter byte + rowBytes
+    static bool unfilter(unsigned char* data, int height, size_t rowBytes, int bytesPerPixel, std::vector<unsigned char>& out);
+    static void unfilterSub(unsigned char* row, size_t rowBytes, int bpp);
+    static void unfilterUp(unsigned char* row, const unsigned char* prev, size_t rowBytes);
+    static void unfilterAverage(unsigned char* row, const unsigned char* prev, size_t rowBytes, int bpp);
+    static void unfilterPaeth(unsigned char* row, const unsigned char* prev, size_t rowBytes, int bpp);
+};
@@ -1,5 +1,8 @@
 #include "ParticleEffects.h"
+#include "TextureManager.h"
+#include "ProceduralTextures.h"
 #include "glew.h"
+#include "GLState.h"
 #include <glut.h>
 #include <cstdlib>
 #include <cmath>
@@ -67,11 +70,11 @@ void WindSystem::update(float deltaTime, const Vector3f& cameraPos, const Vector
 void WindSystem::render(const Vector3f& forward, float speed) {
     if (speed < minSpeedThreshold) return;
     
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::disable(GL_LIGHTING);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
-    glLineWidth(1.0f);
+    GLState::lineWidth(1.0f);
     glBegin(GL_LINES);
     
     for (size_t i = 0; i < particles.size(); i++) {
@@ -91,8 +94,8 @@ void WindSystem::render(const Vector3f& forward, float speed) {
     }
     
     glEnd();
-    glDisable(GL_BLEND);
-    glEnable(GL_LIGHTING);
+    GLState::disable(GL_BLEND);
+    GLState::enable(GL_LIGHTING);
 }
 
 // ============ EXPLOSION SYSTEM IMPLEMENTATION ============
@@ -104,9 +107,7 @@ ExplosionSystem::ExplosionSystem()
 }
 
 ExplosionSystem::~ExplosionSystem() {
-    if (textureID != 0) {
-        glDeleteTextures(1, &textureID);
-    }
+    TextureManager::getInstance().release(textureID);
 }
 
 float ExplosionSystem::randomFloat(float min, float max) {
@@ -114,134 +115,39 @@ float ExplosionSystem::randomFloat(float min, float max) {
 }
 
 bool ExplosionSystem::loadExplosionTexture(const char* filename) {
-    FILE* file = NULL;
-    fopen_s(&file, filename, "rb");
-    if (!file) {
-        return false;
-    }
-    
-    // Read BMP header
-    unsigned char header[54];
-    if (fread(header, 1, 54, file) != 54 || header[0] != 'B' || header[1] != 'M') {
-        fclose(file);
-        return false;
-    }
-    
-    int dataOffset = *(int*)&header[10];
-    int width = *(int*)&header[18];
-    int height = *(int*)&header[22];
-    int bitsPerPixel = *(short*)&header[28];
-    
-    if (width <= 0 || height <= 0 || width > 4096 || height > 4096) {
-        fclose(file);
-        return false;
-    }
-    
-    bool topDown = height < 0;
-    if (topDown) height = -height;
-    
-    // We'll convert to RGBA for transparency support
-    unsigned char* rgbaData = new unsigned char[width * height * 4];
-    
-    if (bitsPerPixel == 24) {
-        fseek(file, dataOffset, SEEK_SET);
-        int rowSize = ((width * 3 + 3) / 4) * 4;
-        unsigned char* bmpData = new unsigned char[rowSize * height];
-        
-        if (fread(bmpData, 1, rowSize * height, file) != (size_t)(rowSize * height)) {
-            delete[] bmpData;
-            delete[] rgbaData;
-            fclose(file);
-            return false;
-        }
-        
-        // Convert BGR to RGBA, using brightness as alpha
-        for (int y = 0; y < height; y++) {
-            int srcY = topDown ? y : (height - 1 - y);
-            for (int x = 0; x < width; x++) {
-                int srcIdx = srcY * rowSize + x * 3;
-                int destIdx = (y * width + x) * 4;
-                
-                unsigned char b = bmpData[srcIdx + 0];
-                unsigned char g = bmpData[srcIdx + 1];
-                unsigned char r = bmpData[srcIdx + 2];
-                
-                rgbaData[destIdx + 0] = r;
-                rgbaData[destIdx + 1] = g;
-                rgbaData[destIdx + 2] = b;
-                
-                // Use brightness as alpha (for explosion effect)
-                float brightness = (r + g + b) / 3.0f;
-                rgbaData[destIdx + 3] = (unsigned char)brightness;
-            }
-        }
-        delete[] bmpData;
-    } else {
-        delete[] rgbaData;
-        fclose(file);
-        return false;
-    }
-    
-    fclose(file);
-    
-    // Create OpenGL texture
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgbaData);
-    
-    delete[] rgbaData;
-    return true;
+    // Same file and flags as ShootingSystem, so every explosion shares one texture
+    textureID = TextureManager::getInstance().acquire(filename, TEX_BRIGHTNESS_ALPHA | TEX_CLAMP | TEX_NO_MIPMAPS);
+    return textureID != 0;
 }
 
 void ExplosionSystem::init() {
     // Try to load explosion texture
-    if (!loadExplosionTexture("../textures/explosion.bmp")) {
-        if (!loadExplosionTexture("textures/explosion.bmp")) {
-            // Create procedural explosion texture
-            glGenTextures(1, &textureID);
-            glBindTexture(GL_TEXTURE_2D, textureID);
-            
-            const int texSize = 64;
-            unsigned char* texData = new unsigned char[texSize * texSize * 4];
-            
-            float centerX = texSize / 2.0f;
-            float centerY = texSize / 2.0f;
-            float maxDist = texSize / 2.0f;
-            
-            for (int y = 0; y < texSize; y++) {
-                for (int x = 0; x < texSize; x++) {
-                    float dx = x - centerX;
-                    float dy = y - centerY;
-                    float dist = sqrt(dx * dx + dy * dy);
-                    
-                    // Soft falloff from center
-                    float alpha = 1.0f - (dist / maxDist);
-                    if (alpha < 0.0f) alpha = 0.0f;
-                    alpha = alpha * alpha;  // Quadratic falloff
-                    
-                    int idx = (y * texSize + x) * 4;
-                    
-                    // Orange/yellow gradient for explosion
-                    float t = dist / maxDist;
-                    texData[idx + 0] = (unsigned char)(255);                    // R
-                    texData[idx + 1] = (unsigned char)(200 * (1.0f - t * 0.5f)); // G (fades to orange)
-                    texData[idx + 2] = (unsigned char)(50 * (1.0f - t));         // B (very little)
-                    texData[idx + 3] = (unsigned char)(alpha * 255);             // A
-                }
-            }
+    if (!loadExplosionTexture("textures/explosion.bmp")) {
+        // Procedural explosion texture (cached on disk)
+        const int texSize = 64;
+        const float centerX = texSize / 2.0f;
+        const float centerY = texSize / 2.0f;
+        const float maxDist = texSize / 2.0f;
+        
+        auto explosionPixel = [&](int x, int y, unsigned char* rgba) {
+            float dx = x - centerX;
+            float dy = y - centerY;
+            float dist = sqrt(dx * dx + dy * dy);
             
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texSize, texSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, texData);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+            // Soft falloff from center
+            float alpha = 1.0f - (dist / maxDist);
+            if (alpha < 0.0f) alpha = 0.0f;
+            alpha = alpha * alpha;  // Quadratic falloff
             
-            delete[] texData;
-        }
+            // Orange/yellow gradient for explosion
+            float t = dist / maxDist;
+            rgba[0] = (unsigned char)(255);                    // R
+            rgba[1] = (unsigned char)(200 * (1.0f - t * 0.5f)); // G (fades to orange)
+            rgba[2] = (unsigned char)(50 * (1.0f - t));         // B (very little)
+            rgba[3] = (unsigned char)(alpha * 255);             // A
+        };
+        
+        textureID = ProceduralTextures::acquire("explosion", 1, texSize, texSize, 0, explosionPixel);
     }
 }
 
@@ -381,16 +287,16 @@ void ExplosionSystem::update(float deltaTime) {
 void ExplosionSystem::render(const Vector3f& cameraPosition) {
     if (particles.empty()) return;
     
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    GLState::push(GL_CURRENT_BIT);
     
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);  // Additive blending for fire effect
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE);  // Additive blending for fire effect
     
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    GLState::enable(GL_TEXTURE_2D);
+    GLState::bindTexture(textureID);
     
-    glDisable(GL_LIGHTING);
-    glDepthMask(GL_FALSE);
+    GLState::disable(GL_LIGHTING);
+    GLState::depthMask(false);
     
     // Sort particles back to front
     std::vector<std::pair<float, size_t>> sortedIndices;
@@ -459,8 +365,8 @@ void ExplosionSystem::render(const Vector3f& cameraPosition) {
     
     glEnd();
     
-    glDepthMask(GL_TRUE);
-    glPopAttrib();
+    GLState::depthMask(true);
+    GLState::pop();
 }
 
 // ============ JET TRAIL SYSTEM IMPLEMENTATION ============
@@ -471,9 +377,7 @@ JetTrailSystem::JetTrailSystem()
 }
 
 JetTrailSystem::~JetTrailSystem() {
-    if (textureID != 0) {
-        glDeleteTextures(1, &textureID);
-    }
+    TextureManager::getInstance().release(textureID);
 }
 
 bool JetTrailSystem::loadTrailTexture(const char* filename) {
@@ -515,39 +419,26 @@ void JetTrailSystem::init(int maxParticles) {
         particles[i].active = false;
     }
     
-    // Generate procedural smoke/trail texture
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    
+    // Procedural smoke/trail texture (cached on disk)
     const int size = 64;
-    unsigned char* texData = new unsigned char[size * size * 4];
     
-    for (int y = 0; y < size; y++) {
-        for (int x = 0; x < size; x++) {
-            float dx = (x - size/2) / (float)(size/2);
-            float dy = (y - size/2) / (float)(size/2);
-            float d = sqrt(dx*dx + dy*dy);
-            
-            float alpha = 1.0f - d;
-            if (alpha < 0) alpha = 0;
-            alpha = pow(alpha, 2.0f); // Soft falloff
-            
-            int idx = (y * size + x) * 4;
-            // White smoke
-            texData[idx+0] = 200;
-            texData[idx+1] = 200;
-            texData[idx+2] = 220; // Slight blue tint
-            texData[idx+3] = (unsigned char)(alpha * 255);
-        }
-    }
-    
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, texData);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+    auto trailPixel = [&](int x, int y, unsigned char* rgba) {
+        float dx = (x - size/2) / (float)(size/2);
+        float dy = (y - size/2) / (float)(size/2);
+        float d = sqrt(dx*dx + dy*dy);
+        
+        float alpha = 1.0f - d;
+        if (alpha < 0) alpha = 0;
+        alpha = pow(alpha, 2.0f); // Soft falloff
+        
+        // White smoke
+        rgba[0] = 200;
+        rgba[1] = 200;
+        rgba[2] = 220; // Slight blue tint
+        rgba[3] = (unsigned char)(alpha * 255);
+    };
     
-    delete[] texData;
+    textureID = ProceduralTextures::acquire("jettrail", 1, size, size, 0, trailPixel);
 }
 
 void JetTrailSystem::diffEmit(const Vector3f& position, const Vector3f& velocity) {
@@ -586,12 +477,12 @@ void JetTrailSystem::update(float deltaTime) {
 }
 
 void JetTrailSystem::render() {
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_LIGHTING);
-    glDepthMask(GL_FALSE);
+    GLState::enable(GL_TEXTURE_2D);
+    GLState::bindTexture(textureID);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::disable(GL_LIGHTING);
+    GLState::depthMask(false);
     
     // Billboard setup
     float modelview[16];
@@ -620,8 +511,8 @@ void JetTrailSystem::render() {
     }
     glEnd();
     
-    glDepthMask(GL_TRUE);
-    glEnable(GL_LIGHTING);
+    GLState::depthMask(true);
+    GLState::enable(GL_LIGHTING);
 }
 
 void JetTrailSystem::reset() {
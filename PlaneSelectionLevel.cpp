@@ -1,5 +1,7 @@
 #include "PlaneSelectionLevel.h"
 #include "GameManager.h"
+#include "GLState.h"
+#include "TextRenderer.h"
 #include <glut.h>
 #include <stdio.h>
 #include <cmath>
@@ -22,8 +24,8 @@ PlaneSelectionLevel::~PlaneSelectionLevel() {
 void PlaneSelectionLevel::init() {
     printf("Initializing Plane Selection Level...\n");
     glClearColor(0.05f, 0.07f, 0.12f, 1.0f);
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_NORMALIZE);
+    GLState::enable(GL_DEPTH_TEST);
+    GLState::enable(GL_NORMALIZE);
     
     // Load plane 1 model (new model with geometry)
     model_plane1.Load("models/plane/mitsubishi_a6m2_zero_model_11.3ds");
@@ -62,6 +64,7 @@ void PlaneSelectionLevel::update(float deltaTime) {
 }
 
 void PlaneSelectionLevel::render() {
+    TextRenderer& textRenderer = TextRenderer::getInstance();
     // CRITICAL: Don't render if this level is not active
     if (!active) {
         return;
@@ -77,9 +80,9 @@ void PlaneSelectionLevel::render() {
     glViewport(0, 0, screenWidth, screenHeight);
 
     // Clear with gradient-like dark blue background
-    glDisable(GL_SCISSOR_TEST);
+    GLState::disable(GL_SCISSOR_TEST);
     glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-    glDepthMask(GL_TRUE);
+    GLState::depthMask(true);
     glClearColor(0.08f, 0.12f, 0.22f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -90,11 +93,11 @@ void PlaneSelectionLevel::render() {
     glMatrixMode(GL_MODELVIEW);
     glLoadIdentity();
 
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_LIGHTING);
-    glDisable(GL_TEXTURE_2D);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_TEXTURE_2D);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     // Draw background gradient panels
     glBegin(GL_QUADS);
@@ -169,10 +172,10 @@ void PlaneSelectionLevel::render() {
         // Card border
         if (selected) {
             glColor4f(1.0f, 0.9f, 0.4f, 1.0f);
-            glLineWidth(4.0f);
+            GLState::lineWidth(4.0f);
         } else {
             glColor4f(0.5f, 0.5f, 0.6f, 0.8f);
-            glLineWidth(2.0f);
+            GLState::lineWidth(2.0f);
         }
         glBegin(GL_LINE_LOOP);
         glVertex2f(x, y);
@@ -180,28 +183,23 @@ void PlaneSelectionLevel::render() {
         glVertex2f(x + actualWidth, y + actualHeight);
         glVertex2f(x, y + actualHeight);
         glEnd();
-        glLineWidth(1.0f);
+        GLState::lineWidth(1.0f);
 
         // Plane number indicator
-        glColor4f(1.0f, 1.0f, 1.0f, 0.9f);
+        textRenderer.setColor(1.0f, 1.0f, 1.0f, 0.9f);
         char numStr[16];
         sprintf_s(numStr, sizeof(numStr), "%d", i + 1);
-        glRasterPos2f(x + 15, y + actualHeight - 30);
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, numStr[0]);
+        textRenderer.add(x + 15, y + actualHeight - 30, numStr, GLUT_BITMAP_TIMES_ROMAN_24);
 
         // Plane name
-        glColor3f(1.0f, 1.0f, 1.0f);
+        textRenderer.setColor(1.0f, 1.0f, 1.0f);
         float nameX = x + actualWidth * 0.5f - strlen(planeNames[i]) * 4.5f;
-        glRasterPos2f(nameX, y + 55);
-        for (const char* c = planeNames[i]; *c; ++c) 
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
+        textRenderer.add(nameX, y + 55, planeNames[i], GLUT_BITMAP_HELVETICA_18);
 
         // Plane description
-        glColor4f(0.8f, 0.8f, 0.9f, 0.9f);
+        textRenderer.setColor(0.8f, 0.8f, 0.9f, 0.9f);
         float descX = x + actualWidth * 0.5f - strlen(planeDesc[i]) * 3.0f;
-        glRasterPos2f(descX, y + 30);
-        for (const char* c = planeDesc[i]; *c; ++c) 
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
+        textRenderer.add(descX, y + 30, planeDesc[i], GLUT_BITMAP_HELVETICA_12);
 
         // Selection indicator arrow
         if (selected) {
@@ -217,20 +215,17 @@ void PlaneSelectionLevel::render() {
     }
 
     // Title with shadow
-    glColor4f(0.0f, 0.0f, 0.0f, 0.5f);
-    glRasterPos2f(screenWidth * 0.5f - 118, screenHeight - 68);
+    textRenderer.setColor(0.0f, 0.0f, 0.0f, 0.5f);
     const char* title = "SELECT YOUR AIRCRAFT";
-    for (const char* c = title; *c; ++c) glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, *c);
+    textRenderer.add(screenWidth * 0.5f - 118, screenHeight - 68, title, GLUT_BITMAP_TIMES_ROMAN_24);
 
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glRasterPos2f(screenWidth * 0.5f - 120, screenHeight - 70);
-    for (const char* c = title; *c; ++c) glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, *c);
+    textRenderer.setColor(1.0f, 1.0f, 1.0f);
+    textRenderer.add(screenWidth * 0.5f - 120, screenHeight - 70, title, GLUT_BITMAP_TIMES_ROMAN_24);
 
     // Subtitle
-    glColor4f(0.7f, 0.8f, 0.9f, 0.9f);
-    glRasterPos2f(screenWidth * 0.5f - 100, screenHeight - 100);
+    textRenderer.setColor(0.7f, 0.8f, 0.9f, 0.9f);
     const char* subtitle = "Choose your fighter wisely";
-    for (const char* c = subtitle; *c; ++c) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
+    textRenderer.add(screenWidth * 0.5f - 100, screenHeight - 100, subtitle, GLUT_BITMAP_HELVETICA_12);
 
     // Instructions bar at bottom
     glColor4f(0.0f, 0.0f, 0.0f, 0.6f);
@@ -241,10 +236,9 @@ void PlaneSelectionLevel::render() {
     glVertex2f(0, 60);
     glEnd();
 
-    glColor4f(0.9f, 0.9f, 0.9f, 1.0f);
-    glRasterPos2f(screenWidth * 0.5f - 180, 25);
+    textRenderer.setColor(0.9f, 0.9f, 0.9f, 1.0f);
     const char* hint = "[LEFT/RIGHT or A/D] Navigate   |   [ENTER] Confirm Selection";
-    for (const char* c = hint; *c; ++c) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
+    textRenderer.add(screenWidth * 0.5f - 180, 25, hint, GLUT_BITMAP_HELVETICA_12);
 
     // Key indicators
     float keyY = 22;
@@ -258,9 +252,8 @@ void PlaneSelectionLevel::render() {
     glVertex2f(50 + keySize, keyY + keySize);
     glVertex2f(50, keyY + keySize);
     glEnd();
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glRasterPos2f(55, keyY + 5);
-    glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, '<');
+    textRenderer.setColor(1.0f, 1.0f, 1.0f);
+    textRenderer.add(55, keyY + 5, "<", GLUT_BITMAP_HELVETICA_12);
 
     // Right arrow key
     glColor4f(0.3f, 0.3f, 0.4f, 0.9f);
@@ -270,11 +263,10 @@ void PlaneSelectionLevel::render() {
     glVertex2f(80 + keySize, keyY + keySize);
     glVertex2f(80, keyY + keySize);
     glEnd();
-    glColor3f(1.0f, 1.0f, 1.0f);
-    glRasterPos2f(85, keyY + 5);
-    glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, '>');
+    textRenderer.add(85, keyY + 5, ">", GLUT_BITMAP_HELVETICA_12);
 
-    glDisable(GL_BLEND);
+    textRenderer.flush(TextRenderer::SCREEN_MENU);
+    GLState::disable(GL_BLEND);
 }
 
 void PlaneSelectionLevel::renderPlanePreview(int planeIndex, float xPos, float yPos, float zPos) {
@@ -297,7 +289,7 @@ void PlaneSelectionLevel::renderPlanePreview(int planeIndex, float xPos, float y
         glColor3f(pulse, pulse, 1.0f);
         
         // Draw selection ring
-        glDisable(GL_LIGHTING);
+        GLState::disable(GL_LIGHTING);
         glPushMatrix();
         glRotatef(-90, 1, 0, 0);
         glTranslatef(0, 0, -50.0f);
@@ -308,11 +300,11 @@ void PlaneSelectionLevel::renderPlanePreview(int planeIndex, float xPos, float y
         }
         glEnd();
         glPopMatrix();
-        glEnable(GL_LIGHTING);
+        GLState::enable(GL_LIGHTING);
     }
     
-    glEnable(GL_TEXTURE_2D);
-    glDisable(GL_LIGHTING);  // Unlit preview
+    GLState::enable(GL_TEXTURE_2D);
+    GLState::disable(GL_LIGHTING);  // Unlit preview
     glColor3f(1.0f, 1.0f, 1.0f);
     
     if (planeIndex == 0) {
@@ -337,12 +329,13 @@ void PlaneSelectionLevel::renderPlanePreview(int planeIndex, float xPos, float y
             glutWireCube(2.0);
         }
     }
-    glEnable(GL_LIGHTING);
+    GLState::enable(GL_LIGHTING);
     
     glPopMatrix();
 }
 
 void PlaneSelectionLevel::renderUI() {
+    TextRenderer& textRenderer = TextRenderer::getInstance();
     // Switch to 2D rendering for text
     glMatrixMode(GL_PROJECTION);
     glPushMatrix();
@@ -353,48 +346,34 @@ void PlaneSelectionLevel::renderUI() {
     glPushMatrix();
     glLoadIdentity();
     
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::disable(GL_LIGHTING);
     
-    glColor3f(1.0f, 1.0f, 1.0f);
+    textRenderer.setColor(1.0f, 1.0f, 1.0f);
     
     // Title
-    glRasterPos2f(screenWidth / 2 - 80, screenHeight - 50);
     const char* title = "SELECT YOUR AIRCRAFT";
-    for (const char* c = title; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
-    }
+    textRenderer.add(screenWidth / 2 - 80, screenHeight - 50, title, GLUT_BITMAP_HELVETICA_18);
     
     // Plane 1 label
-    glRasterPos2f(screenWidth / 5 - 40, 100);
     const char* plane1Label = "ZERO FIGHTER";
-    for (const char* c = plane1Label; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-    }
+    textRenderer.add(screenWidth / 5 - 40, 100, plane1Label, GLUT_BITMAP_HELVETICA_12);
     
     // Plane 2 label
-    glRasterPos2f(screenWidth / 2 - 40, 100);
     const char* plane2Label = "INTERCEPTOR";
-    for (const char* c = plane2Label; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-    }
+    textRenderer.add(screenWidth / 2 - 40, 100, plane2Label, GLUT_BITMAP_HELVETICA_12);
     
     // Plane 3 label
-    glRasterPos2f(4 * screenWidth / 5 - 40, 100);
     const char* plane3Label = "STEALTH JET";
-    for (const char* c = plane3Label; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-    }
+    textRenderer.add(4 * screenWidth / 5 - 40, 100, plane3Label, GLUT_BITMAP_HELVETICA_12);
     
     // Instructions
-    glColor3f(0.8f, 0.8f, 0.8f);
-    glRasterPos2f(screenWidth / 2 - 120, 50);
+    textRenderer.setColor(0.8f, 0.8f, 0.8f);
     const char* instructions = "LEFT/RIGHT: Select  |  ENTER: Confirm";
-    for (const char* c = instructions; *c != '\0'; c++) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, *c);
-    }
+    textRenderer.add(screenWidth / 2 - 120, 50, instructions, GLUT_BITMAP_HELVETICA_12);
+    textRenderer.flush(TextRenderer::SCREEN_MENU_PANEL);
     
-    glEnable(GL_DEPTH_TEST);
+    GLState::enable(GL_DEPTH_TEST);
     
     glPopMatrix();
     glMatrixMode(GL_PROJECTION);
@@ -404,11 +383,11 @@ void PlaneSelectionLevel::renderUI() {
 
 void PlaneSelectionLevel::cleanup() {
     if (tex_plane1 != 0) {
-        glDeleteTextures(1, &tex_plane1);
+        GLState::deleteTextures(1, &tex_plane1);
         tex_plane1 = 0;
     }
     if (tex_plane2 != 0) {
-        glDeleteTextures(1, &tex_plane2);
+        GLState::deleteTextures(1, &tex_plane2);
         tex_plane2 = 0;
     }
 }
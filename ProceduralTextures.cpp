@@ -0,0 +1,121 @@
+#include "ProceduralTextures.h"
+#include "WorkerPool.h"
+#include <stdio.h>
+#include <cstring>
+#include <direct.h>
+
+int ProceduralTextures::generatedCount = 0;
+int ProceduralTextures::cachedCount = 0;
+
+unsigned int ProceduralTextures::random(unsigned int seed, int x, int y, int channel) {
+    // Integer hash (lowbias32) of the combined inputs
+    unsigned int h = seed * 0x9E3779B1u ^ (unsigned int)x * 0x85EBCA6Bu ^
+                     (unsigned int)y * 0xC2B2AE35u ^ (unsigned int)channel * 0x27D4EB2Fu;
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    h *= 0x846CA68Bu;
+    h ^= h >> 16;
+    return h;
+}
+
+std::string ProceduralTextures::makeCacheName(const char* name, int version, int width, int height, unsigned int seed) {
+    char fileName[128];
+    sprintf_s(fileName, sizeof(fileName), "proc_%s_v%d_%dx%d_%08x.bmp", name, version, width, height, seed);
+    return fileName;
+}
+
+// 32-bit top-down BMP, readable by TextureManager::decodeBMP with TEX_ALPHA
+bool ProceduralTextures::saveBMP(const std::string& fileName, const ImageData& image) {
+    unsigned int pixelBytes = (unsigned int)image.width * image.height * 4;
+    unsigned char header[54];
+    memset(header, 0, sizeof(header));
+    header[0] = 'B';
+    header[1] = 'M';
+    *(unsigned int*)&header[2] = 54 + pixelBytes;   // File size
+    *(unsigned int*)&header[10] = 54;               // Pixel data offset
+    *(unsigned int*)&header[14] = 40;               // BITMAPINFOHEADER
+    *(int*)&header[18] = image.width;
+    *(int*)&header[22] = -image.height;             // Negative = top-down rows
+    *(unsigned short*)&header[26] = 1;              // Planes
+    *(unsigned short*)&header[28] = 32;             // Bits per pixel
+    *(unsigned int*)&header[34] = pixelBytes;
+
+    std::vector<unsigned char> bgra(pixelBytes);
+    for (size_t i = 0; i < (size_t)image.width * image.height; i++) {
+        bgra[i * 4 + 0] = image.pixels[i * 4 + 2];
+        bgra[i * 4 + 1] = image.pixels[i * 4 + 1];
+        bgra[i * 4 + 2] = image.pixels[i * 4 + 0];
+        bgra[i * 4 + 3] = image.pixels[i * 4 + 3];
+    }
+
+    // Same roots TextureManager searches; the first one with a textures folder wins
+    const char* prefixes[] = { "", "../", "../../" };
+    for (int i = 0; i < 3; i++) {
+        std::string folder = std::string(prefixes[i]) + "textures/baked";
+        _mkdir(folder.c_str());
+
+        std::string path = folder + "/" + fileName;
+        FILE* file = NULL;
+        fopen_s(&file, path.c_str(), "wb");
+        if (!file) {
+            continue;
+        }
+        bool ok = fwrite(header, 1, sizeof(header), file) == sizeof(header) &&
+                  fwrite(&bgra[0], 1, bgra.size(), file) == bgra.size();
+        fclose(file);
+        return ok;
+    }
+    return false;
+}
+
+bool ProceduralTextures::generate(const char* name, int version, int width, int height, unsigned int seed,
+                                  const PixelGenerator& generator, ImageData& out) {
+    std::string fileName = makeCacheName(name, version, width, height, seed);
+    std::string cachePath = "textures/baked/" + fileName;
+    TextureManager& textures = TextureManager::getInstance();
+
+    // Bake mode always regenerates so the cache can be refreshed in one run
+    if (!textures.isBakeMode() && textures.loadImage(cachePath.c_str(), TEX_ALPHA, out) &&
+        out.width == width && out.height == height && out.channels == 4) {
+        cachedCount++;
+        return true;
+    }
+
+    out.width = width;
+    out.height = height;
+    out.channels = 4;
+    out.pixels.assign((size_t)width * height * 4, 0);
+
+    WorkerPool::getInstance().parallelFor(height, 8, [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            unsigned char* row = &out.pixels[(size_t)y * width * 4];
+            for (int x = 0; x < width; x++) {
+                generator(x, y, row + x * 4);
+            }
+        }
+    });
+    generatedCount++;
+
+    if (!saveBMP(fileName, out)) {
+        printf("ProceduralTextures: Cannot cache %s\n", fileName.c_str());
+    }
+    return true;
+}
+
+unsigned int ProceduralTextures::acquire(const char* name, int version, int width, int height, unsigned int seed,
+                                         const PixelGenerator& generator, unsigned int flags) {
+    // A second system asking for the same texture shares the uploaded copy
+    std::string key = makeCacheName(name, version, width, height, seed);
+    TextureManager& textures = TextureManager::getInstance();
+    unsigned int texId = textures.acquireNamed(key.c_str(), flags);
+    if (texId != 0) {
+        return texId;
+    }
+
+    ImageData image;
+    if (!generate(name, version, width, height, seed, generator, image)) {
+        return 0;
+    }
+    return textures.acquireImage(key.c_str(), image, flags);
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "TextureManager.h"
+#include <functional>
+
+// Per-pixel generator: writes RGBA for pixel (x, y). It must only depend on
+// x, y and values derived from the seed (use ProceduralTextures::random),
+// since rows are generated in parallel and the result is cached to disk.
+typedef std::function<void(int x, int y, unsigned char* rgba)> PixelGenerator;
+
+// Procedural Textures - generated sprites with a disk cache
+// Flares, smoke, the explosion fallback, the jet trail and grass were
+// computed pixel by pixel at every init (and the grass used rand(), so it
+// changed every run). Generators now run on the WorkerPool with a fixed
+// seed, and the result is saved to textures/baked/ as a 32-bit BMP named
+// after the generator, its version, size and seed. Bump the version when a
+// generator changes so the stale image is regenerated.
+class ProceduralTextures {
+public:
+    // Load the cached image, or run the generator and cache the result
+    static bool generate(const char* name, int version, int width, int height, unsigned int seed,
+                         const PixelGenerator& generator, ImageData& out);
+
+    // Same, uploaded and shared through the TextureManager (release it there)
+    static unsigned int acquire(const char* name, int version, int width, int height, unsigned int seed,
+                                const PixelGenerator& generator, unsigned int flags = TEX_CLAMP | TEX_NO_MIPMAPS);
+
+    // Deterministic random bits for (seed, x, y, channel)
+    static unsigned int random(unsigned int seed, int x, int y, int channel = 0);
+
+    static int getGeneratedCount() { return generatedCount; }
+    static int getCachedCount() { return cachedCount; }
+
+private:
+    static std::string makeCacheName(const char* name, int version, int width, int height, unsigned int seed);
+    static bool saveBMP(const std::string& fileName, const ImageData& image);
+
+    static int generatedCount;
+    static int cachedCount;
+};
@@ -0,0 +1,644 @@
+#include "RenderQueue.h"
+#include "glew.h"
+#include "Model_3DS.h"
+#include "ModelInstancer.h"
+#include "OcclusionBuffer.h"
+#include "GLState.h"
+#include <math.h>
+#include <cstring>
+#include <algorithm>
+#include <cstdio>
+
+//=======================================================================
+// RenderMatrix
+//=======================================================================
+void RenderMatrix::setIdentity() {
+    memset(m, 0, sizeof(m));
+    m[0] = m[5] = m[10] = m[15] = 1.0f;
+}
+
+RenderMatrix& RenderMatrix::multiply(const RenderMatrix& other) {
+    float result[16];
+    for (int col = 0; col < 4; col++) {
+        for (int row = 0; row < 4; row++) {
+            result[col * 4 + row] = m[row] * other.m[col * 4] + m[4 + row] * other.m[col * 4 + 1] +
+                                    m[8 + row] * other.m[col * 4 + 2] + m[12 + row] * other.m[col * 4 + 3];
+        }
+    }
+    memcpy(m, result, sizeof(m));
+    return *this;
+}
+
+RenderMatrix& RenderMatrix::translate(float x, float y, float z) {
+    // Only the last column changes
+    for (int row = 0; row < 4; row++) {
+        m[12 + row] += m[row] * x + m[4 + row] * y + m[8 + row] * z;
+    }
+    return *this;
+}
+
+RenderMatrix& RenderMatrix::rotate(float degrees, float x, float y, float z) {
+    float length = sqrtf(x * x + y * y + z * z);
+    if (length <= 0.0f) {
+        return *this;
+    }
+    x /= length;
+    y /= length;
+    z /= length;
+
+    float radians = degrees * 3.14159265f / 180.0f;
+    float c = cosf(radians);
+    float s = sinf(radians);
+    float t = 1.0f - c;
+
+    // Same matrix glRotatef builds
+    RenderMatrix r;
+    r.m[0] = x * x * t + c;      r.m[4] = x * y * t - z * s;  r.m[8] = x * z * t + y * s;
+    r.m[1] = y * x * t + z * s;  r.m[5] = y * y * t + c;      r.m[9] = y * z * t - x * s;
+    r.m[2] = x * z * t - y * s;  r.m[6] = y * z * t + x * s;  r.m[10] = z * z * t + c;
+    return multiply(r);
+}
+
+RenderMatrix& RenderMatrix::scale(float x, float y, float z) {
+    for (int row = 0; row < 4; row++) {
+        m[row] *= x;
+        m[4 + row] *= y;
+        m[8 + row] *= z;
+    }
+    return *this;
+}
+
+//=======================================================================
+// State cache
+//=======================================================================
+static const float BLACK[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+static bool sameColor(const float* a, const float* b) {
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2] && a[3] == b[3];
+}
+
+static void copyColor(float* to, const float* from) {
+    for (int k = 0; k < 4; k++) {
+        to[k] = from[k];
+    }
+}
+
+void RenderStateCache::reset() {
+    textureKnown = textureEnabled = false;
+    boundKnown = false;
+    boundTexture = 0;
+    surfaceKnown = false;
+    emissionKnown = false;
+    colorKnown = false;
+}
+
+unsigned int RenderStateCache::apply(const RenderMaterial& material, RenderStats& stats) {
+    unsigned int changes = 0;
+
+    if (material.flags & RMAT_TEXTURE) {
+        if (!textureKnown || !textureEnabled) {
+            changes |= RSTATE_ENABLE_TEXTURE;
+            stats.textureToggles++;
+        }
+        if (!boundKnown || boundTexture != material.texId) {
+            changes |= RSTATE_BIND_TEXTURE;
+            stats.textureBinds++;
+        } else {
+            stats.redundant++;
+        }
+        textureKnown = textureEnabled = true;
+        boundKnown = true;
+        boundTexture = material.texId;
+    } else if (material.flags & RMAT_UNTEXTURED) {
+        if (!textureKnown || textureEnabled) {
+            changes |= RSTATE_DISABLE_TEXTURE;
+            stats.textureToggles++;
+        } else {
+            stats.redundant++;
+        }
+        textureKnown = true;
+        textureEnabled = false;
+    }
+
+    if (material.flags & RMAT_SURFACE) {
+        if (!surfaceKnown || !sameColor(ambient, material.ambient) || !sameColor(diffuse, material.diffuse) ||
+            !sameColor(specular, material.specular) || shininess != material.shininess) {
+            changes |= RSTATE_SURFACE;
+            stats.surfaceChanges++;
+            copyColor(ambient, material.ambient);
+            copyColor(diffuse, material.diffuse);
+            copyColor(specular, material.specular);
+            shininess = material.shininess;
+            surfaceKnown = true;
+        } else {
+            stats.redundant++;
+        }
+    }
+
+    // Materials without emission draw with none, so a glowing group's
+    // emission is only reset when something else follows it
+    const float* wanted = (material.flags & RMAT_EMISSION) ? material.emission : BLACK;
+    if (!emissionKnown || !sameColor(emission, wanted)) {
+        changes |= RSTATE_EMISSION;
+        stats.emissionChanges++;
+        copyColor(emission, wanted);
+        emissionKnown = true;
+    } else if (material.flags & RMAT_EMISSION) {
+        stats.redundant++;
+    }
+
+    if (material.flags & RMAT_COLOR) {
+        if (!colorKnown || !sameColor(color, material.color)) {
+            changes |= RSTATE_COLOR;
+            stats.colorChanges++;
+            copyColor(color, material.color);
+            colorKnown = true;
+        } else {
+            stats.redundant++;
+        }
+    }
+    return changes;
+}
+
+bool RenderStateCache::needsEmissionReset() const {
+    return !emissionKnown || !sameColor(emission, BLACK);
+}
+
+void RenderStateCache::emissionReset(RenderStats& stats) {
+    stats.emissionChanges++;
+    copyColor(emission, BLACK);
+    emissionKnown = true;
+}
+
+void RenderStats::print(const char* label) const {
+    printf("State %s: %d groups, %d draws, %d state changes (%d texture binds, %d texture toggles, "
+           "%d surface, %d emission, %d color), %d redundant skipped\n",
+           label, groups, draws, getStateChanges(), textureBinds, textureToggles, surfaceChanges, emissionChanges,
+           colorChanges, redundant);
+}
+
+//=======================================================================
+// Backends
+//=======================================================================
+void RenderBackend::beginFrame() {
+    state.reset();
+    stats = RenderStats();
+}
+
+void RenderBackend::drawGroup(const RenderMesh& mesh, const RenderMaterial& material, const DrawItem* items,
+                              int count) {
+    for (int i = 0; i < count; i++) {
+        draw(mesh, material, items[i].transform);
+    }
+}
+
+void GLRenderBackend::applyMaterial(const RenderMaterial& material) {
+    unsigned int changes = state.apply(material, stats);
+    if (changes & RSTATE_ENABLE_TEXTURE) {
+        GLState::enable(GL_TEXTURE_2D);
+    } else if (changes & RSTATE_DISABLE_TEXTURE) {
+        GLState::disable(GL_TEXTURE_2D);
+    }
+    if (changes & RSTATE_BIND_TEXTURE) {
+        GLState::bindTexture(material.texId);
+    }
+    if (changes & RSTATE_SURFACE) {
+        glMaterialfv(GL_FRONT, GL_AMBIENT, material.ambient);
+        glMaterialfv(GL_FRONT, GL_DIFFUSE, material.diffuse);
+        glMaterialfv(GL_FRONT, GL_SPECULAR, material.specular);
+        glMaterialf(GL_FRONT, GL_SHININESS, material.shininess);
+    }
+    if (changes & RSTATE_EMISSION) {
+        glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, (material.flags & RMAT_EMISSION) ? material.emission : BLACK);
+    }
+    if (changes & RSTATE_COLOR) {
+        glColor4fv(material.color);
+    }
+}
+
+void GLRenderBackend::drawMesh(const RenderMesh& mesh, const RenderMatrix& transform) {
+    glPushMatrix();
+    glMultMatrixf(transform.m);
+    if (mesh.model) {
+        mesh.model->Draw();
+        state.invalidateTexture();
+        if (mesh.model->shownormals) {
+            state.invalidateColor();
+        }
+    } else if (mesh.draw) {
+        mesh.draw();
+        state.reset();
+    }
+    glPopMatrix();
+    stats.draws++;
+}
+
+void GLRenderBackend::draw(const RenderMesh& mesh, const RenderMaterial& material, const RenderMatrix& transform) {
+    applyMaterial(material);
+    drawMesh(mesh, transform);
+}
+
+void GLRenderBackend::drawGroup(const RenderMesh& mesh, const RenderMaterial& material, const DrawItem* items,
+                                int count) {
+    stats.groups++;
+    applyMaterial(material);
+    if (mesh.model && ModelInstancer::getInstance().draw(*mesh.model, items, count)) {
+        state.invalidateTexture();
+        stats.draws += count;
+        return;
+    }
+    // Every item after the first finds the material already current
+    for (int i = 0; i < count; i++) {
+        if (i > 0) {
+            applyMaterial(material);
+        }
+        drawMesh(mesh, items[i].transform);
+    }
+}
+
+void GLRenderBackend::endFrame() {
+    if (state.needsEmissionReset()) {
+        state.emissionReset(stats);
+        glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, BLACK);
+    }
+}
+
+void NullRenderBackend::beginFrame() {
+    RenderBackend::beginFrame();
+    frames++;
+}
+
+void NullRenderBackend::reset() {
+    frames = 0;
+    groups = 0;
+    draws = 0;
+    triangles = 0;
+    records.clear();
+}
+
+void NullRenderBackend::drawGroup(const RenderMesh& mesh, const RenderMaterial& material, const DrawItem* items,
+                                  int count) {
+    groups++;
+    stats.groups++;
+    // As GLRenderBackend with the instancer: one material setup per group
+    state.apply(material, stats);
+    for (int i = 0; i < count; i++) {
+        countDraw(mesh, material, items[i].transform);
+    }
+}
+
+void NullRenderBackend::draw(const RenderMesh& mesh, const RenderMaterial& material, const RenderMatrix& transform) {
+    state.apply(material, stats);
+    countDraw(mesh, material, transform);
+}
+
+void NullRenderBackend::endFrame() {
+    if (state.needsEmissionReset()) {
+        state.emissionReset(stats);
+    }
+}
+
+void NullRenderBackend::countDraw(const RenderMesh& mesh, const RenderMaterial& material,
+                                  const RenderMatrix& transform) {
+    // Model draws leave the texture binding unknown, callbacks everything
+    if (mesh.model) {
+        state.invalidateTexture();
+    } else {
+        state.reset();
+    }
+    stats.draws++;
+    draws++;
+    triangles += mesh.triangles;
+    if (keep) {
+        Record record = { &mesh, &material, transform };
+        records.push_back(record);
+    }
+}
+
+//=======================================================================
+// RenderQueue
+//=======================================================================
+int RenderQueue::countTriangles(const Model_3DS& model) {
+    int indices = 0;
+    for (int i = 0; i < model.numObjects; i++) {
+        for (int j = 0; j < model.Objects[i].numMatFaces; j++) {
+            indices += model.Objects[i].MatFaces[j].numSubFaces;
+        }
+    }
+    return indices / 3;
+}
+
+bool RenderQueue::computeBox(const Model_3DS& model, float minimum[3], float maximum[3]) {
+    // Box around every vertex as Draw places its objects
+    for (int k = 0; k < 3; k++) {
+        minimum[k] = 1e30f;
+        maximum[k] = -1e30f;
+    }
+    for (int i = 0; i < model.numObjects; i++) {
+        const Model_3DS::Object& object = model.Objects[i];
+        if (object.Vertexes == NULL) continue;
+        RenderMatrix placement;
+        placement.translate(object.pos.x, object.pos.y, object.pos.z);
+        placement.rotate(object.rot.z, 0.0f, 0.0f, 1.0f);
+        placement.rotate(object.rot.y, 0.0f, 1.0f, 0.0f);
+        placement.rotate(object.rot.x, 1.0f, 0.0f, 0.0f);
+        const float* m = placement.m;
+        for (int v = 0; v < object.numVerts; v++) {
+            const float* p = &object.Vertexes[v * 3];
+            for (int row = 0; row < 3; row++) {
+                float value = m[row] * p[0] + m[4 + row] * p[1] + m[8 + row] * p[2] + m[12 + row];
+                minimum[row] = std::min(minimum[row], value);
+                maximum[row] = std::max(maximum[row], value);
+            }
+        }
+    }
+    return minimum[0] <= maximum[0];
+}
+
+RenderMatrix RenderQueue::getPlacement(const Model_3DS& model) {
+    RenderMatrix placement;
+    placement.translate(model.pos.x, model.pos.y, model.pos.z);
+    placement.rotate(model.rot.x, 1.0f, 0.0f, 0.0f);
+    placement.rotate(model.rot.y, 0.0f, 1.0f, 0.0f);
+    placement.rotate(model.rot.z, 0.0f, 0.0f, 1.0f);
+    placement.scale(model.scale);
+    return placement;
+}
+
+void RenderQueue::computeBounds(const Model_3DS& model, float bounds[4]) {
+    // Sphere around the model's box, then through Draw's placement
+    float minimum[3];
+    float maximum[3];
+    if (!computeBox(model, minimum, maximum)) {
+        bounds[0] = bounds[1] = bounds[2] = 0.0f;
+        bounds[3] = -1.0f;
+        return;
+    }
+
+    float local[4];
+    float radiusSq = 0.0f;
+    for (int k = 0; k < 3; k++) {
+        local[k] = (minimum[k] + maximum[k]) * 0.5f;
+        float half = (maximum[k] - minimum[k]) * 0.5f;
+        radiusSq += half * half;
+    }
+    local[3] = sqrtf(radiusSq);
+    transformBounds(getPlacement(model), local, bounds);
+}
+
+void RenderQueue::transformBounds(const RenderMatrix& transform, const float bounds[4], float out[4]) {
+    const float* m = transform.m;
+    for (int row = 0; row < 3; row++) {
+        out[row] = m[row] * bounds[0] + m[4 + row] * bounds[1] + m[8 + row] * bounds[2] + m[12 + row];
+    }
+    float scaleSq = 0.0f;
+    for (int col = 0; col < 3; col++) {
+        float lengthSq = m[col * 4] * m[col * 4] + m[col * 4 + 1] * m[col * 4 + 1] + m[col * 4 + 2] * m[col * 4 + 2];
+        scaleSq = std::max(scaleSq, lengthSq);
+    }
+    out[3] = bounds[3] < 0.0f ? bounds[3] : bounds[3] * sqrtf(scaleSq);
+}
+
+int RenderQueue::addMesh(const char* name, Model_3DS* model) {
+    RenderMesh mesh;
+    mesh.name = name;
+    mesh.model = model;
+    mesh.triangles = model ? countTriangles(*model) : 0;
+    if (model) {
+        computeBounds(*model, mesh.bounds);
+    }
+    meshes.push_back(mesh);
+    return (int)meshes.size() - 1;
+}
+
+int RenderQueue::addMesh(const char* name, const std::function<void()>& draw, int triangles) {
+    RenderMesh mesh;
+    mesh.name = name;
+    mesh.draw = draw;
+    mesh.triangles = triangles;
+    meshes.push_back(mesh);
+    return (int)meshes.size() - 1;
+}
+
+int RenderQueue::addMaterial(const RenderMaterial& material) {
+    materials.push_back(material);
+    return (int)materials.size() - 1;
+}
+
+void RenderQueue::record(int mesh, int material, const RenderMatrix& transform) {
+    if (mesh < 0 || mesh >= (int)meshes.size() || material < 0 || material >= (int)materials.size()) {
+        return;
+    }
+    DrawItem item;
+    item.sortKey = 0;
+    item.mesh = mesh;
+    item.material = material;
+    item.transform = transform;
+    items.push_back(item);
+}
+
+bool RenderQueue::isVisible(int mesh, const RenderMatrix& transform, float minRadius) {
+    if (mesh < 0 || mesh >= (int)meshes.size()) {
+        return true;
+    }
+    cullTotal.resize(meshes.size(), 0);
+    cullVisible.resize(meshes.size(), 0);
+    cullTotal[mesh]++;
+
+    float sphere[4];
+    transformBounds(transform, meshes[mesh].bounds, sphere);
+    bool visible = sphere[3] < 0.0f ||
+                   frustum.testSphere(sphere[0], sphere[1], sphere[2], std::max(sphere[3], minRadius));
+    if (visible) {
+        cullVisible[mesh]++;
+    }
+    return visible;
+}
+
+bool RenderQueue::wouldDraw(int mesh, const RenderMatrix& transform) const {
+    if (mesh < 0 || mesh >= (int)meshes.size()) {
+        return false;
+    }
+    float sphere[4];
+    transformBounds(transform, meshes[mesh].bounds, sphere);
+    if (sphere[3] < 0.0f) {
+        return true;
+    }
+    if (!frustum.testSphere(sphere[0], sphere[1], sphere[2], sphere[3])) {
+        return false;
+    }
+    return occlusion == nullptr || !occlusion->isReady() ||
+           occlusion->testSphere(sphere[0], sphere[1], sphere[2], sphere[3]);
+}
+
+void RenderQueue::cullItems() {
+    cullTotal.resize(meshes.size(), 0);
+    cullVisible.resize(meshes.size(), 0);
+    cullOccluded.resize(meshes.size(), 0);
+
+    // World-space spheres as separate arrays so the frustum tests four at once
+    size_t count = items.size();
+    sphereX.resize(count);
+    sphereY.resize(count);
+    sphereZ.resize(count);
+    sphereRadius.resize(count);
+    sphereVisible.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        float sphere[4];
+        transformBounds(items[i].transform, meshes[items[i].mesh].bounds, sphere);
+        sphereX[i] = sphere[0];
+        sphereY[i] = sphere[1];
+        sphereZ[i] = sphere[2];
+        // Unbounded meshes always pass
+        sphereRadius[i] = sphere[3] < 0.0f ? 1e30f : sphere[3];
+    }
+    if (count > 0 && frustum.isValid()) {
+        frustum.testSpheres(&sphereX[0], &sphereY[0], &sphereZ[0], &sphereRadius[0], (int)count, &sphereVisible[0]);
+    } else {
+        std::fill(sphereVisible.begin(), sphereVisible.end(), (unsigned char)1);
+    }
+
+    bool occlusionReady = occlusion != nullptr && occlusion->isReady();
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+        cullTotal[items[i].mesh]++;
+        if (!sphereVisible[i]) continue;
+        // Box around the sphere against the occluders; unbounded meshes skip it
+        if (occlusionReady && sphereRadius[i] < 1e30f &&
+            !occlusion->testSphere(sphereX[i], sphereY[i], sphereZ[i], sphereRadius[i])) {
+            cullOccluded[items[i].mesh]++;
+            continue;
+        }
+        cullVisible[items[i].mesh]++;
+        // View depth of the sphere's center: the w row of the clip matrix
+        const float* clip = frustum.getClipMatrix();
+        float depth = clip[3] * sphereX[i] + clip[7] * sphereY[i] + clip[11] * sphereZ[i] + clip[15];
+        items[kept] = items[i];
+        items[kept].sortKey = makeSortKey(items[kept], depth);
+        kept++;
+    }
+    items.resize(kept);
+}
+
+void RenderQueue::sortMaterials() {
+    // Textured materials grouped by texture, then untextured; registration order otherwise
+    std::vector<int> order(materials.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = (int)i;
+    }
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        bool texturedA = (materials[a].flags & RMAT_TEXTURE) != 0;
+        bool texturedB = (materials[b].flags & RMAT_TEXTURE) != 0;
+        if (texturedA != texturedB) return texturedA;
+        return texturedA && materials[a].texId < materials[b].texId;
+    });
+    materialOrder.resize(materials.size());
+    for (size_t rank = 0; rank < order.size(); rank++) {
+        materialOrder[order[rank]] = (int)rank;
+    }
+}
+
+unsigned long long RenderQueue::makeSortKey(const DrawItem& item, float depth) const {
+    // pass:8 | material rank:16 | mesh:16 | depth:24 (1/256 unit steps, nearest first)
+    unsigned long long pass = (unsigned long long)(materials[item.material].pass & 0xFF);
+    unsigned long long material = (unsigned long long)(materialOrder[item.material] & 0xFFFF);
+    unsigned long long mesh = (unsigned long long)(item.mesh & 0xFFFF);
+    float scaled = depth * 256.0f;
+    unsigned long long quantized = scaled <= 0.0f ? 0 : (scaled >= 16777215.0f ? 16777215 : (unsigned long long)scaled);
+    return (pass << 56) | (material << 40) | (mesh << 24) | quantized;
+}
+
+void RenderQueue::clear() {
+    items.clear();
+    lastVisible.swap(cullVisible);
+    lastOccluded.swap(cullOccluded);
+    lastTotal.swap(cullTotal);
+    cullVisible.assign(meshes.size(), 0);
+    cullOccluded.assign(meshes.size(), 0);
+    cullTotal.assign(meshes.size(), 0);
+}
+
+void RenderQueue::getCullStats(std::vector<CullStat>& stats) const {
+    stats.clear();
+    for (size_t i = 0; i < lastTotal.size() && i < meshes.size(); i++) {
+        if (lastTotal[i] == 0) continue;
+        // Meshes that share a name (the residential building variants) share a line
+        bool merged = false;
+        for (CullStat& stat : stats) {
+            if (strcmp(stat.name, meshes[i].name) == 0) {
+                stat.visible += lastVisible[i];
+                stat.occluded += i < lastOccluded.size() ? lastOccluded[i] : 0;
+                stat.total += lastTotal[i];
+                merged = true;
+                break;
+            }
+        }
+        if (!merged) {
+            CullStat stat = { meshes[i].name, lastVisible[i], i < lastOccluded.size() ? lastOccluded[i] : 0,
+                              lastTotal[i] };
+            stats.push_back(stat);
+        }
+    }
+}
+
+void RenderQueue::printCullStats(const char* label) const {
+    std::vector<CullStat> stats;
+    getCullStats(stats);
+    int visible = 0;
+    int occluded = 0;
+    int total = 0;
+    for (const CullStat& stat : stats) {
+        visible += stat.visible;
+        occluded += stat.occluded;
+        total += stat.total;
+    }
+    printf("Culling %s: %d of %d visible, %d occluded%s\n", label, visible, total, occluded,
+           frustum.isValid() ? "" : " (no frustum)");
+    for (const CullStat& stat : stats) {
+        if (stat.occluded > 0) {
+            printf("  %-22s %4d / %4d  (%d occluded)\n", stat.name, stat.visible, stat.total, stat.occluded);
+        } else {
+            printf("  %-22s %4d / %4d\n", stat.name, stat.visible, stat.total);
+        }
+    }
+}
+
+void RenderQueue::submit(RenderBackend& backend) {
+    // Materials can be edited between frames (getMaterial), so rank them here
+    sortMaterials();
+    cullItems();
+    std::stable_sort(items.begin(), items.end(), [](const DrawItem& a, const DrawItem& b) {
+        return a.sortKey < b.sortKey;
+    });
+
+    backend.beginFrame();
+    size_t start = 0;
+    while (start < items.size()) {
+        size_t end = start + 1;
+        while (end < items.size() && items[end].mesh == items[start].mesh &&
+               items[end].material == items[start].material) {
+            end++;
+        }
+        backend.drawGroup(meshes[items[start].mesh], materials[items[start].material], &items[start],
+                          (int)(end - start));
+        start = end;
+    }
+    backend.endFrame();
+}
+
+void RenderQueue::clearAll() {
+    for (const RenderMesh& mesh : meshes) {
+        if (mesh.model) {
+            ModelInstancer::getInstance().forget(mesh.model);
+        }
+    }
+    items.clear();
+    meshes.clear();
+    materials.clear();
+    cullVisible.clear();
+    cullOccluded.clear();
+    cullTotal.clear();
+    lastVisible.clear();
+    lastOccluded.clear();
+    lastTotal.clear();
+}
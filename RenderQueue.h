@@ -0,0 +1,293 @@
+#pragma once
+#include "Frustum.h"
+#include <vector>
+#include <functional>
+
+class Model_3DS;
+class OcclusionBuffer;
+
+// Column-major 4x4 matrix, laid out like glLoadMatrixf expects. The
+// translate/rotate/scale helpers compose the same way the glTranslatef /
+// glRotatef / glScalef calls they replace do.
+struct RenderMatrix {
+    float m[16];
+
+    RenderMatrix() { setIdentity(); }
+
+    void setIdentity();
+    RenderMatrix& translate(float x, float y, float z);
+    RenderMatrix& rotate(float degrees, float x, float y, float z);
+    RenderMatrix& scale(float x, float y, float z);
+    RenderMatrix& scale(float s) { return scale(s, s, s); }
+    RenderMatrix& multiply(const RenderMatrix& other);
+};
+
+// Material state bits; anything not listed is left as the backend found it
+enum RenderMaterialFlags {
+    RMAT_TEXTURE    = 1 << 0,   // Enable texturing and bind texId
+    RMAT_UNTEXTURED = 1 << 1,   // Disable texturing
+    RMAT_SURFACE    = 1 << 2,   // Front ambient/diffuse/specular/shininess
+    RMAT_EMISSION   = 1 << 3,   // Emission while drawing; black for materials without it
+    RMAT_COLOR      = 1 << 4    // glColor before drawing
+};
+
+// Draw passes, submitted in this order
+enum RenderPass {
+    RPASS_OPAQUE = 0,
+    RPASS_GLOW   = 1            // Emissive pickups, after the scene has filled the depth buffer
+};
+
+struct RenderMaterial {
+    unsigned int flags = 0;
+    unsigned int texId = 0;
+    float ambient[4] = { 0.2f, 0.2f, 0.2f, 1.0f };
+    float diffuse[4] = { 0.8f, 0.8f, 0.8f, 1.0f };
+    float specular[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    float emission[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+    float color[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    float shininess = 0.0f;
+    int pass = RPASS_OPAQUE;
+};
+
+// Either a loaded 3DS model or a callback that issues its own draw calls
+// (for immediate-mode geometry that hasn't been turned into a mesh yet)
+struct RenderMesh {
+    const char* name = "";
+    Model_3DS* model = nullptr;
+    std::function<void()> draw;
+    int triangles = 0;
+    // Bounding sphere in mesh space (x, y, z, radius); radius < 0 is never culled
+    float bounds[4] = { 0.0f, 0.0f, 0.0f, -1.0f };
+};
+
+// One recorded draw. Handles index the queue's mesh and material tables;
+// submit() fills in the sort key (see RenderQueue) and draws in ascending
+// order, ties in record order.
+struct DrawItem {
+    unsigned long long sortKey;
+    int mesh;
+    int material;
+    RenderMatrix transform;
+};
+
+// What one submit cost in state: changes a backend issued, and material
+// state it skipped because it was already current
+struct RenderStats {
+    int groups = 0;
+    int draws = 0;
+    int textureBinds = 0;
+    int textureToggles = 0;     // GL_TEXTURE_2D on/off
+    int surfaceChanges = 0;     // Ambient/diffuse/specular/shininess
+    int emissionChanges = 0;
+    int colorChanges = 0;
+    int redundant = 0;
+
+    int getStateChanges() const {
+        return textureBinds + textureToggles + surfaceChanges + emissionChanges + colorChanges;
+    }
+    void print(const char* label) const;
+};
+
+// Changes RenderStateCache::apply asks the backend to issue
+enum RenderStateChanges {
+    RSTATE_ENABLE_TEXTURE  = 1 << 0,
+    RSTATE_DISABLE_TEXTURE = 1 << 1,
+    RSTATE_BIND_TEXTURE    = 1 << 2,
+    RSTATE_SURFACE         = 1 << 3,
+    RSTATE_EMISSION        = 1 << 4,    // Set the material's emission, or black
+    RSTATE_COLOR           = 1 << 5
+};
+
+// Material state a backend last issued. The queue sorts items so that
+// neighbours share state; this makes sure what they share isn't sent again.
+// GL-free, so the null backend counts exactly what the GL one would issue.
+class RenderStateCache {
+public:
+    RenderStateCache() { reset(); }
+
+    // Nothing is known (frame start, or a callback mesh issued its own GL)
+    void reset();
+    // A 3DS model enabled and bound its own textures
+    void invalidateTexture() { textureKnown = false; boundKnown = false; }
+    void invalidateColor() { colorKnown = false; }
+
+    // RSTATE_* bits for what the material needs changed; the cache assumes
+    // they are issued, and counts them (or the skips) in stats
+    unsigned int apply(const RenderMaterial& material, RenderStats& stats);
+    // Emission must be back to black when the queue hands GL back
+    bool needsEmissionReset() const;
+    void emissionReset(RenderStats& stats);
+
+private:
+    bool textureKnown, textureEnabled;
+    bool boundKnown;
+    unsigned int boundTexture;
+    bool surfaceKnown;
+    float ambient[4], diffuse[4], specular[4], shininess;
+    bool emissionKnown;
+    float emission[4];
+    bool colorKnown;
+    float color[4];
+};
+
+// Receives the sorted draw items of one submit
+class RenderBackend {
+public:
+    virtual ~RenderBackend() {}
+    virtual void beginFrame();
+    virtual void draw(const RenderMesh& mesh, const RenderMaterial& material, const RenderMatrix& transform) = 0;
+    // A run of items sharing mesh and material; draws them one by one unless
+    // the backend can share the setup across the run
+    virtual void drawGroup(const RenderMesh& mesh, const RenderMaterial& material, const DrawItem* items, int count);
+    virtual void endFrame() {}
+
+    // Counts since the last beginFrame()
+    const RenderStats& getStats() const { return stats; }
+
+protected:
+    RenderStateCache state;
+    RenderStats stats;
+};
+
+// Issues the items to OpenGL on top of the current modelview (the camera).
+// Groups of a 3DS model go through the ModelInstancer.
+class GLRenderBackend : public RenderBackend {
+public:
+    void draw(const RenderMesh& mesh, const RenderMaterial& material, const RenderMatrix& transform) override;
+    void drawGroup(const RenderMesh& mesh, const RenderMaterial& material, const DrawItem* items, int count) override;
+    void endFrame() override;
+
+private:
+    void applyMaterial(const RenderMaterial& material);
+    void drawMesh(const RenderMesh& mesh, const RenderMatrix& transform);
+};
+
+// Never touches GL: counts what would have been drawn, and optionally keeps
+// the submitted items in order, so a frame can be built and checked headless
+class NullRenderBackend : public RenderBackend {
+public:
+    struct Record {
+        const RenderMesh* mesh;
+        const RenderMaterial* material;
+        RenderMatrix transform;
+    };
+
+    explicit NullRenderBackend(bool keepRecords = false) : keep(keepRecords) { reset(); }
+
+    void reset();
+    void beginFrame() override;
+    void draw(const RenderMesh& mesh, const RenderMaterial& material, const RenderMatrix& transform) override;
+    void drawGroup(const RenderMesh& mesh, const RenderMaterial& material, const DrawItem* items, int count) override;
+    void endFrame() override;
+
+    int getFrameCount() const { return frames; }
+    int getGroupCount() const { return groups; }
+    int getDrawCount() const { return draws; }
+    int getTriangleCount() const { return triangles; }
+    const std::vector<Record>& getRecords() const { return records; }
+
+private:
+    bool keep;
+    int frames;
+    int groups;
+    int draws;
+    int triangles;
+    std::vector<Record> records;
+
+    void countDraw(const RenderMesh& mesh, const RenderMaterial& material, const RenderMatrix& transform);
+};
+
+// Render Queue - command buffer between scene building and GL
+// Level render functions used to interleave game logic, state changes and
+// drawing, so nothing could be reordered or batched and none of it ran
+// without a GL context. Systems now record draw items (mesh, material,
+// transform) into the queue, which is GL-free, and a backend
+// submits them: GLRenderBackend for the game, NullRenderBackend to count a
+// frame headlessly. Meshes and materials are registered once at load time
+// and referenced by handle; items are cleared every frame.
+//
+// submit() orders the items by pass, then material (materials sharing a
+// texture next to each other), then mesh, then front to back, so each
+// material and mesh is set up once and near geometry fills the depth
+// buffer first. The backends skip material state that is already current.
+class RenderQueue {
+public:
+    RenderQueue() : occlusion(nullptr) {}
+    ~RenderQueue() { clearAll(); }
+
+    RenderQueue(const RenderQueue&) = delete;
+    RenderQueue& operator=(const RenderQueue&) = delete;
+
+    // Registration (load time); handles stay valid until clearAll()
+    int addMesh(const char* name, Model_3DS* model);
+    int addMesh(const char* name, const std::function<void()>& draw, int triangles = 0);
+    int addMaterial(const RenderMaterial& material);
+    // Per-frame tweaks (glow pulses, etc.) without re-registering
+    RenderMaterial& getMaterial(int handle) { return materials[handle]; }
+
+    void record(int mesh, int material, const RenderMatrix& transform);
+
+    // Cull against the frustum, sort and hand the items to the backend,
+    // consecutive items with the same mesh and material as one group; items
+    // are kept until clear()
+    void submit(RenderBackend& backend);
+    void clear();
+    // Drop items, meshes and materials (level cleanup), and the models' instancing data
+    void clearAll();
+
+    // View frustum for submit(): items whose bounds lie outside are dropped
+    // before sorting. An invalid frustum turns culling off.
+    void setFrustum(const Frustum& view) { frustum = view; }
+    // Occluders for submit(): items in the frustum whose box is hidden in the
+    // buffer are dropped too. Null (or a buffer not finished) turns it off.
+    void setOcclusion(const OcclusionBuffer* buffer) { occlusion = buffer; }
+    // Same test for geometry drawn outside the queue; counted in the cull stats.
+    // minRadius covers extra geometry drawn around the mesh.
+    bool isVisible(int mesh, const RenderMatrix& transform, float minRadius = 0.0f);
+    // Whether a recorded item survives submit()'s frustum and occlusion
+    // culling, without counting it (for work that only visible items need)
+    bool wouldDraw(int mesh, const RenderMatrix& transform) const;
+
+    // Visible/total items per mesh name over the last frame (submit to clear);
+    // occluded items were in the frustum but hidden by the occlusion buffer
+    struct CullStat {
+        const char* name;
+        int visible;
+        int occluded;
+        int total;
+    };
+    void getCullStats(std::vector<CullStat>& stats) const;
+    void printCullStats(const char* label) const;
+
+    int getItemCount() const { return (int)items.size(); }
+    int getMeshCount() const { return (int)meshes.size(); }
+    int getMaterialCount() const { return (int)materials.size(); }
+
+    static int countTriangles(const Model_3DS& model);
+    // Bounding sphere of the model as Model_3DS::Draw places it
+    static void computeBounds(const Model_3DS& model, float bounds[4]);
+    // Box around the model's objects before Draw's own placement; false if it has no vertices
+    static bool computeBox(const Model_3DS& model, float minimum[3], float maximum[3]);
+    // Draw's own placement of the whole model: translate, rotate x/y/z, scale
+    static RenderMatrix getPlacement(const Model_3DS& model);
+    // Sphere through a transform; the radius grows with the largest axis scale
+    static void transformBounds(const RenderMatrix& transform, const float bounds[4], float out[4]);
+
+private:
+    std::vector<RenderMesh> meshes;
+    std::vector<RenderMaterial> materials;
+    std::vector<DrawItem> items;
+
+    Frustum frustum;
+    const OcclusionBuffer* occlusion;
+    std::vector<int> cullVisible, cullOccluded, cullTotal;     // This frame, per mesh
+    std::vector<int> lastVisible, lastOccluded, lastTotal;     // Previous frame
+    std::vector<float> sphereX, sphereY, sphereZ, sphereRadius;
+    std::vector<unsigned char> sphereVisible;
+    std::vector<int> materialOrder;         // Material handle -> rank in draw order
+
+    void sortMaterials();
+    // Pass, material rank, mesh, view depth
+    unsigned long long makeSortKey(const DrawItem& item, float depth) const;
+    void cullItems();
+};
@@ -0,0 +1,12 @@
+#pragma once
+
+// Render Queue Check - headless self-test of submit()
+// Builds a small queue with interleaved items, submits it to a
+// NullRenderBackend and compares the draw order, group/draw/triangle counts
+// and state-change counts against values worked out by hand. Needs no GL
+// context, so main runs it for --check-render-queue before glutInit.
+class RenderQueueCheck {
+public:
+    // Prints each mismatch and a PASS/FAIL line; true when everything matched
+    static bool run();
+};
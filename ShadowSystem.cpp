@@ -1,4 +1,6 @@
 #include "ShadowSystem.h"
+#include "GLState.h"
+#include <cstddef>
 #include <cstdlib>
 
 ShadowSystem::ShadowSystem() 
@@ -15,7 +17,7 @@ ShadowSystem::ShadowSystem()
 
 ShadowSystem::~ShadowSystem() {
     if (shadowTexture != 0) {
-        glDeleteTextures(1, &shadowTexture);
+        GLState::deleteTextures(1, &shadowTexture);
     }
 }
 
@@ -24,27 +26,29 @@ void ShadowSystem::init() {
 }
 
 void ShadowSystem::generateShadowTexture() {
-    // Generate a soft circular gradient texture for blob shadows
+    // Generate soft circular gradients for blob shadows (left half) and
+    // base AO (right half, linear like the old vertex-colored ring)
     const int size = 64;
-    unsigned char* data = new unsigned char[size * size * 4];
+    const int width = size * 2;
+    unsigned char* data = new unsigned char[width * size * 4];
     
     float center = size / 2.0f;
     
     for (int y = 0; y < size; y++) {
-        for (int x = 0; x < size; x++) {
-            float dx = (x - center) / center;
+        for (int x = 0; x < width; x++) {
+            float dx = ((x % size) - center) / center;
             float dy = (y - center) / center;
             float dist = sqrt(dx*dx + dy*dy);
             
             // Soft falloff using smoothstep-like curve
             float alpha = 0.0f;
             if (dist < 1.0f) {
-                // Quadratic falloff for soft edges
                 float t = 1.0f - dist;
-                alpha = t * t;  // Soft circular gradient
+                // Quadratic falloff for soft blob edges, linear for AO
+                alpha = x < size ? t * t : t;
             }
             
-            int idx = (y * size + x) * 4;
+            int idx = (y * width + x) * 4;
             data[idx + 0] = 0;    // R
             data[idx + 1] = 0;    // G
             data[idx + 2] = 0;    // B
@@ -53,8 +57,8 @@ void ShadowSystem::generateShadowTexture() {
     }
     
     glGenTextures(1, &shadowTexture);
-    glBindTexture(GL_TEXTURE_2D, shadowTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+    GLState::bindTexture(shadowTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -104,36 +108,22 @@ void ShadowSystem::renderBlobShadow(const Vector3f& position, float radius,
         offsetZ = lightDirection.z * projectionFactor * 0.3f;
     }
     
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
-    
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, shadowTexture);
-    
-    glDepthMask(GL_FALSE);  // Don't write to depth buffer
-    
-    // Render shadow quad on ground (slightly above to prevent z-fighting)
+    // Shadow quad on ground (slightly above to prevent z-fighting)
     float groundY = 0.02f;
     float sx = position.x + offsetX;
     float sz = position.z + offsetZ;
     
-    glColor4f(0.0f, 0.0f, 0.0f, intensity);
-    
-    glBegin(GL_QUADS);
-    glTexCoord2f(0, 0); glVertex3f(sx - shadowRadius, groundY, sz - shadowRadius);
-    glTexCoord2f(1, 0); glVertex3f(sx + shadowRadius, groundY, sz - shadowRadius);
-    glTexCoord2f(1, 1); glVertex3f(sx + shadowRadius, groundY, sz + shadowRadius);
-    glTexCoord2f(0, 1); glVertex3f(sx - shadowRadius, groundY, sz + shadowRadius);
-    glEnd();
-    
-    glDepthMask(GL_TRUE);
-    glPopAttrib();
+    Vector3f corners[4];
+    corners[0] = Vector3f(sx - shadowRadius, groundY, sz - shadowRadius);
+    corners[1] = Vector3f(sx + shadowRadius, groundY, sz - shadowRadius);
+    corners[2] = Vector3f(sx + shadowRadius, groundY, sz + shadowRadius);
+    corners[3] = Vector3f(sx - shadowRadius, groundY, sz + shadowRadius);
+    addDecal(corners, 0.0f, intensity);
 }
 
 void ShadowSystem::renderOvalShadow(const Vector3f& position, const Vector3f& forward,
-                                     float length, float width, float height, float maxHeight) {
+                                     float length, float width, float height, float maxHeight,
+                                     float groundHeight) {
     // Don't render shadows for objects too high
     if (height > maxHeight) return;
     
@@ -168,22 +158,10 @@ void ShadowSystem::renderOvalShadow(const Vector3f& position, const Vector3f& fo
     // Calculate right vector
     Vector3f rightXZ = Vector3f(-fwdXZ.z, 0, fwdXZ.x);
     
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
-    
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, shadowTexture);
-    
-    glDepthMask(GL_FALSE);
-    
-    float groundY = 0.02f;
+    float groundY = groundHeight + 0.02f;
     float sx = position.x + offsetX;
     float sz = position.z + offsetZ;
     
-    glColor4f(0.0f, 0.0f, 0.0f, intensity);
-    
     // Calculate oval corners
     Vector3f corners[4];
     corners[0] = Vector3f(sx - fwdXZ.x * shadowLength - rightXZ.x * shadowWidth, groundY,
@@ -194,75 +172,96 @@ void ShadowSystem::renderOvalShadow(const Vector3f& position, const Vector3f& fo
                           sz + fwdXZ.z * shadowLength + rightXZ.z * shadowWidth);
     corners[3] = Vector3f(sx + fwdXZ.x * shadowLength - rightXZ.x * shadowWidth, groundY,
                           sz + fwdXZ.z * shadowLength - rightXZ.z * shadowWidth);
-    
-    glBegin(GL_QUADS);
-    glTexCoord2f(0, 0); glVertex3f(corners[0].x, corners[0].y, corners[0].z);
-    glTexCoord2f(1, 0); glVertex3f(corners[1].x, corners[1].y, corners[1].z);
-    glTexCoord2f(1, 1); glVertex3f(corners[2].x, corners[2].y, corners[2].z);
-    glTexCoord2f(0, 1); glVertex3f(corners[3].x, corners[3].y, corners[3].z);
-    glEnd();
-    
-    glDepthMask(GL_TRUE);
-    glPopAttrib();
+    addDecal(corners, 0.0f, intensity);
 }
 
 void ShadowSystem::renderBaseAO(const Vector3f& position, float radius, float intensity) {
     // Render ambient occlusion as a darker ring at the base of objects
     // This simulates the darkening that occurs where objects meet the ground
     
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    // Center is darker, outer edge transparent (the AO half of the texture)
+    float groundY = 0.01f;
     
-    glDisable(GL_LIGHTING);
-    glDisable(GL_TEXTURE_2D);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    Vector3f corners[4];
+    corners[0] = Vector3f(position.x - radius, groundY, position.z - radius);
+    corners[1] = Vector3f(position.x + radius, groundY, position.z - radius);
+    corners[2] = Vector3f(position.x + radius, groundY, position.z + radius);
+    corners[3] = Vector3f(position.x - radius, groundY, position.z + radius);
+    addDecal(corners, 0.5f, intensity);
+}
+
+void ShadowSystem::addDecal(const Vector3f corners[4], float u0, float alpha) {
+    if (alpha <= 0.0f) return;
+    if (alpha > 1.0f) alpha = 1.0f;
+    
+    static const float texCoords[4][2] = { { 0, 0 }, { 0.5f, 0 }, { 0.5f, 1 }, { 0, 1 } };
+    for (int i = 0; i < 4; i++) {
+        DecalVertex vertex;
+        vertex.position[0] = corners[i].x;
+        vertex.position[1] = corners[i].y;
+        vertex.position[2] = corners[i].z;
+        vertex.texCoord[0] = u0 + texCoords[i][0];
+        vertex.texCoord[1] = texCoords[i][1];
+        vertex.color[0] = 0;
+        vertex.color[1] = 0;
+        vertex.color[2] = 0;
+        vertex.color[3] = (unsigned char)(alpha * 255.0f + 0.5f);
+        decalVertices.push_back(vertex);
+    }
+}
+
+void ShadowSystem::flush() {
+    if (decalVertices.empty()) return;
     
-    glDepthMask(GL_FALSE);
+    GLState::push(GL_CURRENT_BIT);
     
-    float groundY = 0.01f;
-    int segments = 16;
-    
-    // Draw gradient ring
-    glBegin(GL_TRIANGLE_FAN);
-    
-    // Center is darker
-    glColor4f(0.0f, 0.0f, 0.0f, intensity);
-    glVertex3f(position.x, groundY, position.z);
-    
-    // Outer edge is transparent
-    glColor4f(0.0f, 0.0f, 0.0f, 0.0f);
-    for (int i = 0; i <= segments; i++) {
-        float angle = (float)i / segments * 2.0f * 3.14159f;
-        float x = position.x + cos(angle) * radius;
-        float z = position.z + sin(angle) * radius;
-        glVertex3f(x, groundY, z);
-    }
+    GLState::disable(GL_LIGHTING);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::enable(GL_TEXTURE_2D);
+    GLState::bindTexture(shadowTexture);
+    
+    GLState::depthMask(false);  // Don't write to depth buffer
+    
+    const char* base = (const char*)&decalVertices[0];
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(DecalVertex), base + offsetof(DecalVertex, position));
+    glTexCoordPointer(2, GL_FLOAT, sizeof(DecalVertex), base + offsetof(DecalVertex, texCoord));
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(DecalVertex), base + offsetof(DecalVertex, color));
+    
+    glDrawArrays(GL_QUADS, 0, (GLsizei)decalVertices.size());
+    
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
     
-    glEnd();
+    GLState::depthMask(true);
+    GLState::pop();
     
-    glDepthMask(GL_TRUE);
-    glPopAttrib();
+    decalVertices.clear();
 }
 
 void ShadowSystem::beginPlanarShadow(const Vector3f& lightDir, float groundY) {
     // Create a projection matrix that flattens geometry onto the ground plane
     // This is useful for rendering shadow volumes of 3D models
     
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    GLState::push(GL_CURRENT_BIT);
     glPushMatrix();
     
     // Disable lighting and textures for shadow pass
-    glDisable(GL_LIGHTING);
-    glDisable(GL_TEXTURE_2D);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_TEXTURE_2D);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
     // Enable stencil to prevent double-drawing shadows
-    glEnable(GL_STENCIL_TEST);
+    GLState::enable(GL_STENCIL_TEST);
     glStencilFunc(GL_EQUAL, 0, 0xFF);
     glStencilOp(GL_KEEP, GL_KEEP, GL_INCR);
     
-    glDepthMask(GL_FALSE);
+    GLState::depthMask(false);
     
     // Build shadow projection matrix
     // Projects onto Y = groundY plane
@@ -284,7 +283,10 @@ void ShadowSystem::beginPlanarShadow(const Vector3f& lightDir, float groundY) {
 }
 
 void ShadowSystem::endPlanarShadow() {
-    glDepthMask(GL_TRUE);
+    GLState::depthMask(true);
+    // GLState tracks the stencil enable (pop() restores it), not the func/op
+    glStencilFunc(GL_ALWAYS, 0, 0xFF);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
     glPopMatrix();
-    glPopAttrib();
+    GLState::pop();
 }
@@ -6,9 +6,17 @@
 #include "glew.h"
 #include <glut.h>
 #include <cmath>
+#include <vector>
 
 // Simple shadow system for fixed-function OpenGL pipeline
 // Uses projected blob shadows and fake ambient occlusion
+//
+// Blob, oval and AO decals used to be one immediate-mode draw each with its
+// own state setup and attribute push, per ring, toolkit, fuel container and
+// building. They are now queued as quads and drawn by flush() from one
+// vertex array with one state setup. Both falloffs live side by side in one
+// texture (blob on the left, AO on the right), and every decal is black
+// blended over the ground, so drawing order doesn't change the result.
 
 class ShadowSystem {
 public:
@@ -17,6 +25,11 @@ public:
     
     void init();
     
+    // The decal functions below only queue; flush() draws everything queued
+    // since the last flush. Call it once after the last decal of the frame.
+    void flush();
+    int getQueuedCount() const { return (int)decalVertices.size() / 4; }
+
     // Render a circular blob shadow under an object
     // position: world position of the object
     // radius: shadow radius
@@ -24,9 +37,11 @@ public:
     // maxHeight: maximum height for shadow visibility
     void renderBlobShadow(const Vector3f& position, float radius, float height, float maxHeight = 100.0f);
     
-    // Render an oval shadow for elongated objects (like the plane)
+    // Render an oval shadow for elongated objects (like the plane), on
+    // level ground at groundHeight
     void renderOvalShadow(const Vector3f& position, const Vector3f& forward, 
-                          float length, float width, float height, float maxHeight = 100.0f);
+                          float length, float width, float height, float maxHeight = 100.0f,
+                          float groundHeight = 0.0f);
     
     // Render ambient occlusion darkening at object base
     // Creates a gradient that darkens the ground near object bases
@@ -44,11 +59,21 @@ public:
     void setShadowDarkness(float darkness);
     
 private:
+    struct DecalVertex {
+        float position[3];
+        float texCoord[2];
+        unsigned char color[4];
+    };
+
     Vector3f lightDirection;
     float shadowDarkness;
     GLuint shadowTexture;
+    std::vector<DecalVertex> decalVertices;     // Quads, four vertices each
     
     void generateShadowTexture();
+    // Queue one black quad; corners counter-clockwise from (u0, 0), texture
+    // u from u0 to u0 + 0.5 (the blob or the AO half of the texture)
+    void addDecal(const Vector3f corners[4], float u0, float alpha);
 };
 
 #endif
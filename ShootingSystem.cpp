@@ -1,5 +1,7 @@
 #include "ShootingSystem.h"
+#include "TextureManager.h"
 #include "glew.h"
+#include "GLState.h"
 #include <glut.h>
 #include <cmath>
 #include <cstdlib>
@@ -13,50 +15,7 @@ ShootingSystem::ShootingSystem()
 }
 
 ShootingSystem::~ShootingSystem() {
-    if (explosionTexture != 0) {
-        glDeleteTextures(1, &explosionTexture);
-    }
-}
-
-std::string ShootingSystem::getFullPath(const char* filename) {
-    // Try to find the file in multiple locations
-    FILE* test = NULL;
-    
-    // Try relative path first (for running from VS)
-    std::string path1 = std::string("../") + filename;
-    fopen_s(&test, path1.c_str(), "rb");
-    if (test) {
-        fclose(test);
-        return path1;
-    }
-    
-    // Try direct path (for running from project folder)
-    fopen_s(&test, filename, "rb");
-    if (test) {
-        fclose(test);
-        return std::string(filename);
-    }
-    
-    // Try with absolute path using current directory
-    char cwd[512];
-    if (_getcwd(cwd, sizeof(cwd))) {
-        std::string absPath = std::string(cwd) + "\\" + filename;
-        fopen_s(&test, absPath.c_str(), "rb");
-        if (test) {
-            fclose(test);
-            return absPath;
-        }
-        
-        // Try parent directory
-        std::string parentPath = std::string(cwd) + "\\..\\" + filename;
-        fopen_s(&test, parentPath.c_str(), "rb");
-        if (test) {
-            fclose(test);
-            return parentPath;
-        }
-    }
-    
-    return std::string(filename);
+    TextureManager::getInstance().release(explosionTexture);
 }
 
 void ShootingSystem::init() {
@@ -83,88 +42,9 @@ void ShootingSystem::init() {
 }
 
 bool ShootingSystem::loadExplosionTexture(const char* filename) {
-    std::string fullPath = getFullPath(filename);
-    
-    FILE* file = NULL;
-    fopen_s(&file, fullPath.c_str(), "rb");
-    if (!file) {
-        // Try alternative paths
-        fopen_s(&file, "textures/explosion.bmp", "rb");
-        if (!file) {
-            fopen_s(&file, "../textures/explosion.bmp", "rb");
-            if (!file) {
-                return false;
-            }
-        }
-    }
-    
-    // Read BMP header
-    unsigned char header[54];
-    if (fread(header, 1, 54, file) != 54 || header[0] != 'B' || header[1] != 'M') {
-        fclose(file);
-        return false;
-    }
-    
-    int dataOffset = *(int*)&header[10];
-    int width = *(int*)&header[18];
-    int height = *(int*)&header[22];
-    int bitsPerPixel = *(short*)&header[28];
-    
-    if (width <= 0 || height <= 0) {
-        fclose(file);
-        return false;
-    }
-    
-    bool topDown = height < 0;
-    if (topDown) height = -height;
-    
-    fseek(file, dataOffset, SEEK_SET);
-    
-    int rowSize = ((width * 3 + 3) / 4) * 4;
-    unsigned char* bmpData = new unsigned char[rowSize * height];
-    
-    if (fread(bmpData, 1, rowSize * height, file) != (size_t)(rowSize * height)) {
-        delete[] bmpData;
-        fclose(file);
-        return false;
-    }
-    fclose(file);
-    
-    // Convert BGR to RGBA with alpha based on brightness (for transparency)
-    unsigned char* rgbaData = new unsigned char[width * height * 4];
-    
-    for (int y = 0; y < height; y++) {
-        int srcY = topDown ? y : (height - 1 - y);
-        for (int x = 0; x < width; x++) {
-            int srcIdx = srcY * rowSize + x * 3;
-            int destIdx = (y * width + x) * 4;
-            
-            unsigned char b = bmpData[srcIdx + 0];
-            unsigned char g = bmpData[srcIdx + 1];
-            unsigned char r = bmpData[srcIdx + 2];
-            
-            rgbaData[destIdx + 0] = r;
-            rgbaData[destIdx + 1] = g;
-            rgbaData[destIdx + 2] = b;
-            
-            // Use brightness as alpha - black = transparent
-            float brightness = (r + g + b) / 3.0f;
-            rgbaData[destIdx + 3] = (unsigned char)(brightness);
-        }
-    }
-    
-    delete[] bmpData;
-    
-    glGenTextures(1, &explosionTexture);
-    glBindTexture(GL_TEXTURE_2D, explosionTexture);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgbaData);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
-    
-    delete[] rgbaData;
-    return true;
+    // Shared with ExplosionSystem: brightness becomes alpha so black is transparent
+    explosionTexture = TextureManager::getInstance().acquire(filename, TEX_BRIGHTNESS_ALPHA | TEX_CLAMP | TEX_NO_MIPMAPS);
+    return explosionTexture != 0;
 }
 
 void ShootingSystem::fire(const Vector3f& position, const Vector3f& forward) {
@@ -314,12 +194,12 @@ void ShootingSystem::update(float deltaTime) {
 }
 
 void ShootingSystem::renderBullets() {
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    GLState::push(GL_CURRENT_BIT);
     
-    glDisable(GL_TEXTURE_2D);
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+    GLState::disable(GL_TEXTURE_2D);
+    GLState::disable(GL_LIGHTING);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE);
     
     for (size_t i = 0; i < bullets.size(); i++) {
         Bullet& bullet = bullets[i];
@@ -329,7 +209,7 @@ void ShootingSystem::renderBullets() {
         Vector3f tracerEnd = bullet.position - bullet.direction * 3.0f;  // 3 unit tracer
         
         // Draw tracer line
-        glLineWidth(3.0f);
+        GLState::lineWidth(3.0f);
         glBegin(GL_LINES);
         
         // Bright yellow/orange at front
@@ -343,27 +223,27 @@ void ShootingSystem::renderBullets() {
         glEnd();
         
         // Draw bullet glow
-        glPointSize(8.0f);
+        GLState::pointSize(8.0f);
         glBegin(GL_POINTS);
         glColor4f(1.0f, 1.0f, 0.5f, 0.8f);
         glVertex3f(bullet.position.x, bullet.position.y, bullet.position.z);
         glEnd();
     }
     
-    glPopAttrib();
+    GLState::pop();
 }
 
 void ShootingSystem::renderExplosions(const Vector3f& cameraPosition) {
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    GLState::push(GL_CURRENT_BIT);
     
-    glEnable(GL_TEXTURE_2D);
-    glDisable(GL_LIGHTING);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);  // Additive blending for fire
-    glDepthMask(GL_FALSE);
+    GLState::enable(GL_TEXTURE_2D);
+    GLState::disable(GL_LIGHTING);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE);  // Additive blending for fire
+    GLState::depthMask(false);
     
     if (explosionTexture != 0) {
-        glBindTexture(GL_TEXTURE_2D, explosionTexture);
+        GLState::bindTexture(explosionTexture);
     }
     
     for (size_t i = 0; i < explosions.size(); i++) {
@@ -410,8 +290,8 @@ void ShootingSystem::renderExplosions(const Vector3f& cameraPosition) {
         glPopMatrix();
     }
     
-    glDepthMask(GL_TRUE);
-    glPopAttrib();
+    GLState::depthMask(true);
+    GLState::pop();
 }
 
 void ShootingSystem::reset() {
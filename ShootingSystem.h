@@ -89,9 +89,6 @@ private:
     // Load explosion texture
     bool loadExplosionTexture(const char* filename);
     
-    // Get full path to file
-    std::string getFullPath(const char* filename);
-    
     // Check if bullet hit ground
     bool checkGroundCollision(Bullet& bullet);
 };
@@ -0,0 +1,209 @@
+#include "SkyDome.h"
+#include "glew.h"
+#include "GLState.h"
+#include <math.h>
+#include <cstddef>
+
+// Same tessellation the old gluSphere(800, 100, 100) call used
+static const int DOME_SLICES = 100;
+static const int DOME_STACKS = 100;
+
+SkyDome::SkyDome() : indexCount(0), vbo(0), ibo(0), built(false), multitexture(false) {
+}
+
+SkyDome::~SkyDome() {
+    // The GL context is gone by the time static destructors run
+}
+
+SkyDome& SkyDome::getInstance() {
+    static SkyDome instance;
+    return instance;
+}
+
+void SkyDome::build() {
+    built = true;
+    multitexture = (GLEW_VERSION_1_3 || (GLEW_ARB_multitexture && GLEW_ARB_texture_env_combine)) &&
+                   glActiveTexture != NULL && glClientActiveTexture != NULL;
+
+    // gluSphere's layout: rings from the +Z pole down, s around, t from 1 at the top
+    const float PI = 3.14159265f;
+    vertices.clear();
+    vertices.reserve((DOME_STACKS + 1) * (DOME_SLICES + 1));
+    for (int i = 0; i <= DOME_STACKS; i++) {
+        float rho = PI * i / DOME_STACKS;
+        for (int j = 0; j <= DOME_SLICES; j++) {
+            float theta = (j == DOME_SLICES) ? 0.0f : 2.0f * PI * j / DOME_SLICES;
+            Vertex v;
+            v.position[0] = -sinf(theta) * sinf(rho);
+            v.position[1] = cosf(theta) * sinf(rho);
+            v.position[2] = cosf(rho);
+            v.texCoord[0] = (float)j / DOME_SLICES;
+            v.texCoord[1] = 1.0f - (float)i / DOME_STACKS;
+            vertices.push_back(v);
+        }
+    }
+
+    indices.clear();
+    indices.reserve(DOME_STACKS * DOME_SLICES * 6);
+    for (int i = 0; i < DOME_STACKS; i++) {
+        for (int j = 0; j < DOME_SLICES; j++) {
+            unsigned short top = (unsigned short)(i * (DOME_SLICES + 1) + j);
+            unsigned short bottom = (unsigned short)(top + DOME_SLICES + 1);
+            indices.push_back(top);
+            indices.push_back(bottom);
+            indices.push_back((unsigned short)(top + 1));
+            indices.push_back((unsigned short)(top + 1));
+            indices.push_back(bottom);
+            indices.push_back((unsigned short)(bottom + 1));
+        }
+    }
+    indexCount = (int)indices.size();
+
+    if ((GLEW_VERSION_1_5 || GLEW_ARB_vertex_buffer_object) && glGenBuffers != NULL) {
+        glGenBuffers(1, &vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        glGenBuffers(1, &ibo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned short), &indices[0], GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+        std::vector<Vertex>().swap(vertices);
+        std::vector<unsigned short>().swap(indices);
+    }
+}
+
+void SkyDome::bindArrays(bool secondUnit) {
+    const char* base = NULL;
+    if (vbo != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    } else {
+        base = (const char*)&vertices[0];
+    }
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, position));
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, texCoord));
+    if (secondUnit) {
+        // Both skies share the dome's coordinates
+        glClientActiveTexture(GL_TEXTURE1);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, texCoord));
+        glClientActiveTexture(GL_TEXTURE0);
+    }
+}
+
+void SkyDome::unbindArrays(bool secondUnit) {
+    if (secondUnit) {
+        glClientActiveTexture(GL_TEXTURE1);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glClientActiveTexture(GL_TEXTURE0);
+    }
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    if (vbo != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+}
+
+void SkyDome::drawElements() {
+    if (ibo != 0) {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, NULL);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    } else {
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_SHORT, &indices[0]);
+    }
+}
+
+void SkyDome::draw(unsigned int texture) {
+    if (!built) {
+        build();
+    }
+    GLState::enable(GL_TEXTURE_2D);
+    GLState::bindTexture(texture);
+    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
+    bindArrays(false);
+    drawElements();
+    unbindArrays(false);
+}
+
+void SkyDome::drawBlend(unsigned int from, unsigned int to, float t) {
+    if (!built) {
+        build();
+    }
+    if (t <= 0.0f) {
+        draw(from);
+        return;
+    }
+    if (t >= 1.0f) {
+        draw(to);
+        return;
+    }
+
+    if (!multitexture) {
+        // Outgoing sky, then the incoming one alpha-blended over it
+        draw(from);
+        GLState::enable(GL_BLEND);
+        GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        GLState::bindTexture(to);
+        glColor4f(1.0f, 1.0f, 1.0f, t);
+        bindArrays(false);
+        drawElements();
+        unbindArrays(false);
+        GLState::disable(GL_BLEND);
+        return;
+    }
+
+    // Unit 0: outgoing sky as is
+    glActiveTexture(GL_TEXTURE0);
+    GLState::enable(GL_TEXTURE_2D);
+    GLState::bindTexture(from);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+
+    // Unit 1: incoming * t + previous * (1 - t), t in the constant color's alpha.
+    // GLState only shadows unit 0, so this unit is set up with the raw calls
+    glActiveTexture(GL_TEXTURE1);
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, to);
+    const float blend[4] = { 0.0f, 0.0f, 0.0f, t };
+    glTexEnvfv(GL_TEXTURE_ENV, GL_TEXTURE_ENV_COLOR, blend);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
+    glTexEnvi(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_INTERPOLATE);
+    glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE0_RGB, GL_TEXTURE);
+    glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND0_RGB, GL_SRC_COLOR);
+    glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE1_RGB, GL_PREVIOUS);
+    glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND1_RGB, GL_SRC_COLOR);
+    glTexEnvi(GL_TEXTURE_ENV, GL_SOURCE2_RGB, GL_CONSTANT);
+    glTexEnvi(GL_TEXTURE_ENV, GL_OPERAND2_RGB, GL_SRC_ALPHA);
+
+    bindArrays(true);
+    drawElements();
+    unbindArrays(true);
+
+    // Back to plain single texturing
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+    glDisable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+}
+
+void SkyDome::release() {
+    if (vbo != 0) {
+        glDeleteBuffers(1, &vbo);
+        vbo = 0;
+    }
+    if (ibo != 0) {
+        glDeleteBuffers(1, &ibo);
+        ibo = 0;
+    }
+    vertices.clear();
+    indices.clear();
+    indexCount = 0;
+    built = false;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <vector>
+
+// Sky Dome - the sky sphere mesh, tessellated once
+// renderSky used to build a GLU quadric and tessellate gluSphere(100, 100)
+// every frame, twice during a time-of-day transition (about 20k triangles
+// each). The dome is now generated once with the same layout and texture
+// coordinates as that gluSphere, kept in vertex/index buffers, and shared
+// by every SkySystem. A transition is drawn in a single pass: texture unit 0
+// holds the outgoing sky, unit 1 the incoming one, and the texture combiner
+// interpolates between them.
+class SkyDome {
+public:
+    // Singleton pattern (same as GameManager)
+    static SkyDome& getInstance();
+
+    SkyDome(const SkyDome&) = delete;
+    SkyDome& operator=(const SkyDome&) = delete;
+
+    // Unit sphere around the origin (scale it to the sky radius); the
+    // caller sets up depth, culling and lighting state
+    void draw(unsigned int texture);
+    // from * (1 - t) + to * t; two passes without multitexturing
+    void drawBlend(unsigned int from, unsigned int to, float t);
+
+    void release();
+
+    int getTriangleCount() const { return indexCount / 3; }
+    bool isUsingMultitexture() const { return multitexture; }
+
+private:
+    SkyDome();
+    ~SkyDome();
+
+    struct Vertex {
+        float position[3];
+        float texCoord[2];
+    };
+
+    std::vector<Vertex> vertices;           // Kept when there are no buffer objects
+    std::vector<unsigned short> indices;
+    int indexCount;
+    unsigned int vbo;
+    unsigned int ibo;
+    bool built;
+    bool multitexture;
+
+    void build();
+    void bindArrays(bool secondUnit);
+    void unbindArrays(bool secondUnit);
+    void drawElements();
+};
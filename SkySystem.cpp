@@ -1,10 +1,25 @@
 #include "SkySystem.h"
+#include "TextureManager.h"
+#include "ProceduralTextures.h"
+#include "SkyDome.h"
+#include "GLState.h"
 #include <cmath>
 #include <cstdlib>
 #include <cstdio>
 
+// Sky sphere radius, inside the 2000-unit far plane
+static const float SKY_RADIUS = 800.0f;
+
+// Analytic sun path: highest elevation (radians) and the part of the cycle it is up
+static const float SUN_MAX_ELEVATION = 1.1f;
+static const float SUN_RISE_LEAD = 20.0f;      // Sunrise, seconds before the cycle starts
+static const float SUN_DAY_LENGTH = 210.0f;    // Seconds from sunrise to sunset
+static const float SUN_NIGHT_DEPTH = 0.3f;     // Lowest elevation at midnight
+
+bool SkySystem::analyticDefault = false;
+
 SkySystem::SkySystem() 
-    : tex_sky_morning(0), tex_sky_noon(0), tex_sky_sunset(0), tex_sky_night(0),
+    : tex_sky_morning(0), tex_sky_noon(0), tex_sky_sunset(0), tex_sky_night(0), analytic(false),
       sunIntensity(1.0f), currentTime(TimeOfDay::MORNING), previousTime(TimeOfDay::MORNING),
       cycleTimer(0.0f), transitionProgress(0.0f), inTransition(false), cloudsInitialized(false) {
     
@@ -16,75 +31,60 @@ SkySystem::SkySystem()
     sunDirection.z /= len;
     
     for (int i = 0; i < 10; i++) {
-        tex_flare[i] = 0;
+        sprite_flare[i] = 0;
     }
     for (int i = 0; i < 3; i++) {
-        tex_cloud[i] = 0;
+        sprite_cloud[i] = 0;
     }
 }
 
 SkySystem::~SkySystem() {
-    if (tex_sky_morning != 0) glDeleteTextures(1, &tex_sky_morning);
-    if (tex_sky_noon != 0) glDeleteTextures(1, &tex_sky_noon);
-    if (tex_sky_sunset != 0) glDeleteTextures(1, &tex_sky_sunset);
-    if (tex_sky_night != 0) glDeleteTextures(1, &tex_sky_night);
-    
-    for (int i = 0; i < 10; i++) {
-        if (tex_flare[i] != 0) {
-            glDeleteTextures(1, &tex_flare[i]);
-        }
-    }
-    for (int i = 0; i < 3; i++) {
-        if (tex_cloud[i] != 0) {
-            glDeleteTextures(1, &tex_cloud[i]);
-        }
-    }
+    // Sky textures and the sprite atlas are shared through the TextureManager
+    TextureManager& textures = TextureManager::getInstance();
+    textures.release(tex_sky_morning);
+    textures.release(tex_sky_noon);
+    textures.release(tex_sky_sunset);
+    textures.release(tex_sky_night);
+    spriteAtlas.release();
 }
 
 void SkySystem::init() {
-    // Try multiple relative roots so textures load regardless of working directory
+    analytic = analyticDefault;
+    
+    // TextureManager tries multiple relative roots so textures load regardless of working directory
     auto tryLoad = [&](const char* relativePath, unsigned int& texId, bool flipVertical = false) -> bool {
-        const char* prefixes[] = { "", "../", "../../" };
-        char fullPath[260];
-        for (int i = 0; i < 3; ++i) {
-            sprintf_s(fullPath, sizeof(fullPath), "%s%s", prefixes[i], relativePath);
-            if (loadSkyTexture(fullPath, texId, flipVertical)) {
-                return true;
-            }
-        }
-        return false;
+        return loadSkyTexture(relativePath, texId, flipVertical);
     };
 
-    // Load all sky textures - try multiple paths
-    tryLoad("textures/sky.bmp", tex_sky_morning);
-    tryLoad("textures/noonsky.bmp", tex_sky_noon, true);
-    tryLoad("textures/sunsetsky.bmp", tex_sky_sunset, true);
-    tryLoad("textures/nightsky.bmp", tex_sky_night, true);
+    // The analytic sky needs none of the skybox textures
+    if (!analytic) {
+        // Load all sky textures - try multiple paths
+        tryLoad("textures/sky.bmp", tex_sky_morning);
+        tryLoad("textures/noonsky.bmp", tex_sky_noon, true);
+        tryLoad("textures/sunsetsky.bmp", tex_sky_sunset, true);
+        tryLoad("textures/nightsky.bmp", tex_sky_night, true);
 
-    // Solid-color fallbacks to avoid black sky if loading fails
-    auto ensureSky = [&](unsigned int& texId, unsigned char r, unsigned char g, unsigned char b) {
-        if (texId != 0) return;
-        glGenTextures(1, &texId);
-        glBindTexture(GL_TEXTURE_2D, texId);
-        unsigned char pixel[3] = { r, g, b };
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, pixel);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    };
+        // Solid-color fallbacks to avoid black sky if loading fails
+        auto ensureSky = [&](unsigned int& texId, unsigned char r, unsigned char g, unsigned char b) {
+            if (texId != 0) return;
+            texId = TextureManager::getInstance().acquireColor(r, g, b);
+        };
 
-    ensureSky(tex_sky_morning, 135, 180, 255);
-    ensureSky(tex_sky_noon,    170, 210, 255);
-    ensureSky(tex_sky_sunset,  200, 140, 120);
-    ensureSky(tex_sky_night,    10,  10,  25);
+        ensureSky(tex_sky_morning, 135, 180, 255);
+        ensureSky(tex_sky_noon,    170, 210, 255);
+        ensureSky(tex_sky_sunset,  200, 140, 120);
+        ensureSky(tex_sky_night,    10,  10,  25);
+    }
     
-    // Load cloud textures - with fallback to procedural generation
-    if (!tryLoad("textures/cloude1.bmp", tex_cloud[0])) {
+    // Cloud and flare sprites share one atlas so each is drawn in a single batch
+    sprite_cloud[0] = spriteAtlas.addFile("textures/cloude1.bmp");
+    if (sprite_cloud[0] < 0) {
         // Generate fallback cloud texture
-        glGenTextures(1, &tex_cloud[0]);
-        glBindTexture(GL_TEXTURE_2D, tex_cloud[0]);
-        unsigned char cloudTex[64 * 64 * 4];
+        ImageData cloudTex;
+        cloudTex.width = 64;
+        cloudTex.height = 64;
+        cloudTex.channels = 4;
+        cloudTex.pixels.resize(64 * 64 * 4);
         for (int y = 0; y < 64; y++) {
             for (int x = 0; x < 64; x++) {
                 float dx = (x - 32) / 32.0f;
@@ -93,22 +93,23 @@ void SkySystem::init() {
                 float alpha = (1.0f - dist) * 1.5f;
                 if (alpha < 0) alpha = 0; if (alpha > 1) alpha = 1;
                 int idx = (y * 64 + x) * 4;
-                cloudTex[idx] = cloudTex[idx+1] = cloudTex[idx+2] = 255;
-                cloudTex[idx+3] = (unsigned char)(alpha * 200);
+                cloudTex.pixels[idx] = cloudTex.pixels[idx+1] = cloudTex.pixels[idx+2] = 255;
+                cloudTex.pixels[idx+3] = (unsigned char)(alpha * 200);
             }
         }
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 64, 64, 0, GL_RGBA, GL_UNSIGNED_BYTE, cloudTex);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        sprite_cloud[0] = spriteAtlas.addImage(cloudTex);
     }
-    if (!tryLoad("textures/cloude2.bmp", tex_cloud[1])) {
-        tex_cloud[1] = tex_cloud[0];  // Use first texture as fallback
+    sprite_cloud[1] = spriteAtlas.addFile("textures/cloude2.bmp");
+    if (sprite_cloud[1] < 0) {
+        sprite_cloud[1] = sprite_cloud[0];  // Use first texture as fallback
     }
-    if (!tryLoad("textures/cloude3.bmp", tex_cloud[2])) {
-        tex_cloud[2] = tex_cloud[0];  // Use first texture as fallback
+    sprite_cloud[2] = spriteAtlas.addFile("textures/cloude3.bmp");
+    if (sprite_cloud[2] < 0) {
+        sprite_cloud[2] = sprite_cloud[0];  // Use first texture as fallback
     }
     
     generateFlareTextures();
+    spriteAtlas.build("sky_sprites");
     initClouds();
     
     // Start at morning
@@ -163,6 +164,26 @@ void SkySystem::update(float deltaTime) {
 }
 
 void SkySystem::updateSunPosition() {
+    if (analytic) {
+        // Continuous arc: up for SUN_DAY_LENGTH seconds, dipping below the horizon for the rest
+        const float PI = 3.14159265f;
+        float phase = fmod(cycleTimer + SUN_RISE_LEAD, fullCycleDuration) / SUN_DAY_LENGTH;
+        float elevation;
+        if (phase < 1.0f) {
+            elevation = SUN_MAX_ELEVATION * sin(PI * phase);
+        } else {
+            float nightLength = fullCycleDuration / SUN_DAY_LENGTH - 1.0f;
+            elevation = -SUN_NIGHT_DEPTH * sin(PI * (phase - 1.0f) / nightLength);
+        }
+        // Swings from one side to the other, staying in front of the +Z horizon
+        float swing = 0.5f * cos(PI * (phase < 1.0f ? phase : 1.0f));
+        sunDirection = Vector3f(cos(elevation) * swing, sin(elevation),
+                                cos(elevation) * sqrt(1.0f - swing * swing));
+        sunIntensity = sunDirection.y > 0.0f ? fmin(1.0f, 0.6f + sunDirection.y * 0.5f) : 0.0f;
+        analyticSky.update(sunDirection);
+        return;
+    }
+    
     float sunY, sunZ;
     
     switch (currentTime) {
@@ -227,6 +248,12 @@ DayLighting SkySystem::getCurrentLighting() const {
             break;
     }
     
+    if (analytic) {
+        // Follows the continuous sun instead of the phase's fixed height
+        lighting.sunHeight = sunDirection.y;
+        lighting.showLensFlare = sunDirection.y > 0.0f && currentTime != TimeOfDay::NIGHT;
+    }
+    
     return lighting;
 }
 
@@ -237,9 +264,9 @@ void SkySystem::applyLighting() {
     GLfloat diffuseLight[] = { lighting.diffuseR, lighting.diffuseG, lighting.diffuseB, 1.0f };
     GLfloat lightPosition[] = { sunDirection.x * 100.0f, sunDirection.y * 100.0f, sunDirection.z * 100.0f, 0.0f };
     
-    glLightfv(GL_LIGHT0, GL_AMBIENT, ambientLight);
-    glLightfv(GL_LIGHT0, GL_DIFFUSE, diffuseLight);
-    glLightfv(GL_LIGHT0, GL_POSITION, lightPosition);
+    GLState::lightfv(GL_LIGHT0, GL_AMBIENT, ambientLight);
+    GLState::lightfv(GL_LIGHT0, GL_DIFFUSE, diffuseLight);
+    GLState::lightfv(GL_LIGHT0, GL_POSITION, lightPosition);
 }
 
 void SkySystem::setTimeOfDay(TimeOfDay time) {
@@ -279,295 +306,169 @@ unsigned int SkySystem::getTextureForTime(TimeOfDay time) {
 }
 
 bool SkySystem::loadSkyTexture(const char* filename, unsigned int& texId, bool flipVertical) {
-    FILE* file = NULL;
-    fopen_s(&file, filename, "rb");
-    if (!file) {
-        return false;
-    }
-    
-    // Read BMP header
-    unsigned char header[138]; // Larger buffer for V4/V5 headers
-    size_t headerRead = fread(header, 1, 54, file);
-    if (headerRead < 54 || header[0] != 'B' || header[1] != 'M') {
-        fclose(file);
-        return false;
-    }
-    
-    // Extract dimensions from header
-    int width = *(int*)&header[18];
-    int height = *(int*)&header[22];
-    int bitsPerPixel = *(short*)&header[28];
-    int dataOffset = *(int*)&header[10];
-    int headerSize = *(int*)&header[14];
-    
-    if (width <= 0 || height <= 0) {
-        fclose(file);
-        return false;
-    }
-    
-    int absHeight = abs(height);
-    unsigned char* rgbData = new unsigned char[width * absHeight * 3];
-    
-    if (bitsPerPixel == 8) {
-        // 8-bit paletted BMP
-        fseek(file, 14 + headerSize, SEEK_SET);
-        unsigned char palette[1024];
-        if (fread(palette, 1, 1024, file) != 1024) {
-            delete[] rgbData;
-            fclose(file);
-            return false;
-        }
-        
-        fseek(file, dataOffset, SEEK_SET);
-        int rowSize = ((width + 3) / 4) * 4;
-        unsigned char* indexData = new unsigned char[rowSize * absHeight];
-        if (fread(indexData, 1, rowSize * absHeight, file) != (size_t)(rowSize * absHeight)) {
-            delete[] indexData;
-            delete[] rgbData;
-            fclose(file);
-            return false;
-        }
-        fclose(file);
-        
-        for (int y = 0; y < absHeight; y++) {
-            int srcY;
-            if (flipVertical) {
-                srcY = (height > 0) ? y : (absHeight - 1 - y);
-            } else {
-                srcY = (height > 0) ? (absHeight - 1 - y) : y;
-            }
-            
-            for (int x = 0; x < width; x++) {
-                unsigned char index = indexData[srcY * rowSize + x];
-                int destIdx = (y * width + x) * 3;
-                rgbData[destIdx + 0] = palette[index * 4 + 2];
-                rgbData[destIdx + 1] = palette[index * 4 + 1];
-                rgbData[destIdx + 2] = palette[index * 4 + 0];
-            }
-        }
-        delete[] indexData;
-    }
-    else {
-        // 24 or 32 bit BMP
-        fseek(file, dataOffset, SEEK_SET);
-        int bytesPerPixel = bitsPerPixel / 8;
-        int rowSize = ((width * bytesPerPixel + 3) / 4) * 4;
-        int imageSize = rowSize * absHeight;
-        
-        unsigned char* bmpData = new unsigned char[imageSize];
-        size_t bytesRead = fread(bmpData, 1, imageSize, file);
-        fclose(file);
-        
-        if (bytesRead == 0) {
-            delete[] bmpData;
-            delete[] rgbData;
-            return false;
-        }
-        
-        for (int y = 0; y < absHeight; y++) {
-            int srcY;
-            if (flipVertical) {
-                srcY = (height > 0) ? y : (absHeight - 1 - y);
-            } else {
-                srcY = (height > 0) ? (absHeight - 1 - y) : y;
-            }
-            
-            for (int x = 0; x < width; x++) {
-                int srcIdx = srcY * rowSize + x * bytesPerPixel;
-                int dstIdx = (y * width + x) * 3;
-                
-                if (bytesPerPixel >= 3) {
-                    rgbData[dstIdx + 0] = bmpData[srcIdx + 2];  // R
-                    rgbData[dstIdx + 1] = bmpData[srcIdx + 1];  // G
-                    rgbData[dstIdx + 2] = bmpData[srcIdx + 0];  // B
-                }
-            }
-        }
-        delete[] bmpData;
-    }
-    
-    glGenTextures(1, &texId);
-    glBindTexture(GL_TEXTURE_2D, texId);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, absHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, rgbData);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGB, width, absHeight, GL_RGB, GL_UNSIGNED_BYTE, rgbData);
-    
-    delete[] rgbData;
-    return true;
+    // Both levels own a SkySystem; the manager makes the second init() share the first one's textures
+    // Only one or two of the four skies are on screen at a time; the others drop to their mip tail
+    unsigned int flags = TEX_CLAMP_T | TEX_STREAM_MIPS;
+    if (flipVertical) flags |= TEX_FLIP_VERTICAL;
+    texId = TextureManager::getInstance().acquire(filename, flags);
+    return texId != 0;
 }
 
+// Bump when the flare math changes so cached images are regenerated
+static const int FLARE_GENERATOR_VERSION = 1;
+
 void SkySystem::generateFlareTextures() {
-    // Generate 10 high-quality AAA lens flare textures
+    // Generate 10 high-quality AAA lens flare textures (cached on disk, see ProceduralTextures)
     for (int i = 0; i < 10; i++) {
-        glGenTextures(1, &tex_flare[i]);
-        glBindTexture(GL_TEXTURE_2D, tex_flare[i]);
-        
         const int size = 256;
         const float halfSize = size / 2.0f;
-        unsigned char* data = new unsigned char[size * size * 4];
         
-        for (int y = 0; y < size; y++) {
-            for (int x = 0; x < size; x++) {
-                float dx = (x - halfSize) / halfSize;
-                float dy = (y - halfSize) / halfSize;
-                float dist = sqrt(dx*dx + dy*dy);
-                float angle = atan2(dy, dx);
-                
-                float alpha = 0.0f;
-                float r = 1.0f, g = 1.0f, b = 1.0f;
-                
-                switch(i) {
-                    case 0: // Sun corona
-                        alpha = pow(fmax(0.0f, 1.0f - dist), 2.5f);
-                        r = 1.0f; g = 0.9f; b = 0.7f;
-                        break;
-                    case 1: // Bright white core with rays
-                        {
-                            float core = pow(fmax(0.0f, 1.0f - dist * 2.0f), 6.0f);
-                            float rays = pow(fmax(0.0f, 1.0f - dist), 2.0f) * 
-                                         (0.5f + 0.5f * pow(fabs(sin(angle * 8.0f)), 8.0f));
-                            alpha = fmin(1.0f, core + rays * 0.3f);
-                        }
-                        break;
-                    case 2: // Blue/cyan ring
-                        {
-                            float ring = 1.0f - fabs(dist - 0.5f) * 5.0f;
-                            alpha = fmax(0.0f, ring) * 0.6f;
-                            r = 0.6f; g = 0.85f; b = 1.0f;
-                        }
-                        break;
-                    case 3: // Orange/gold circle
-                        alpha = pow(fmax(0.0f, 1.0f - dist * 1.2f), 3.0f) * 0.7f;
-                        r = 1.0f; g = 0.7f; b = 0.3f;
-                        break;
-                    case 4: // Green ghost
-                        alpha = pow(fmax(0.0f, 1.0f - dist * 1.5f), 2.0f) * 0.5f;
-                        r = 0.5f; g = 1.0f; b = 0.6f;
-                        break;
-                    case 5: // Purple/magenta
-                        alpha = pow(fmax(0.0f, 1.0f - dist * 2.0f), 4.0f) * 0.8f;
-                        r = 1.0f; g = 0.5f; b = 0.9f;
-                        break;
-                    case 6: // Rainbow ring
-                        {
-                            float ring = 1.0f - fabs(dist - 0.7f) * 8.0f;
-                            alpha = fmax(0.0f, ring) * 0.4f;
-                            r = 0.8f + 0.2f * sin(angle * 2.0f);
-                            g = 0.8f + 0.2f * sin(angle * 2.0f + 2.1f);
-                            b = 0.8f + 0.2f * sin(angle * 2.0f + 4.2f);
-                        }
-                        break;
-                    case 7: // Hexagonal bokeh
-                        {
-                            float hex = 0.0f;
-                            for (int k = 0; k < 6; k++) {
-                                float a = k * 3.14159f / 3.0f;
-                                hex = fmax(hex, fabs(dx * cos(a) + dy * sin(a)));
-                            }
-                            alpha = pow(fmax(0.0f, 1.0f - hex * 1.5f), 2.0f) * 0.5f;
-                            r = 1.0f; g = 0.95f; b = 0.85f;
-                        }
-                        break;
-                    case 8: // Anamorphic streak
-                        {
-                            float streak = exp(-dy * dy * 50.0f) * exp(-dx * dx * 0.5f);
-                            alpha = streak * 0.8f;
-                            r = 1.0f; g = 0.95f; b = 0.9f;
+        auto flarePixel = [&](int x, int y, unsigned char* rgba) {
+            float dx = (x - halfSize) / halfSize;
+            float dy = (y - halfSize) / halfSize;
+            float dist = sqrt(dx*dx + dy*dy);
+            float angle = atan2(dy, dx);
+            
+            float alpha = 0.0f;
+            float r = 1.0f, g = 1.0f, b = 1.0f;
+            
+            switch(i) {
+                case 0: // Sun corona
+                    alpha = pow(fmax(0.0f, 1.0f - dist), 2.5f);
+                    r = 1.0f; g = 0.9f; b = 0.7f;
+                    break;
+                case 1: // Bright white core with rays
+                    {
+                        float core = pow(fmax(0.0f, 1.0f - dist * 2.0f), 6.0f);
+                        float rays = pow(fmax(0.0f, 1.0f - dist), 2.0f) * 
+                                     (0.5f + 0.5f * pow(fabs(sin(angle * 8.0f)), 8.0f));
+                        alpha = fmin(1.0f, core + rays * 0.3f);
+                    }
+                    break;
+                case 2: // Blue/cyan ring
+                    {
+                        float ring = 1.0f - fabs(dist - 0.5f) * 5.0f;
+                        alpha = fmax(0.0f, ring) * 0.6f;
+                        r = 0.6f; g = 0.85f; b = 1.0f;
+                    }
+                    break;
+                case 3: // Orange/gold circle
+                    alpha = pow(fmax(0.0f, 1.0f - dist * 1.2f), 3.0f) * 0.7f;
+                    r = 1.0f; g = 0.7f; b = 0.3f;
+                    break;
+                case 4: // Green ghost
+                    alpha = pow(fmax(0.0f, 1.0f - dist * 1.5f), 2.0f) * 0.5f;
+                    r = 0.5f; g = 1.0f; b = 0.6f;
+                    break;
+                case 5: // Purple/magenta
+                    alpha = pow(fmax(0.0f, 1.0f - dist * 2.0f), 4.0f) * 0.8f;
+                    r = 1.0f; g = 0.5f; b = 0.9f;
+                    break;
+                case 6: // Rainbow ring
+                    {
+                        float ring = 1.0f - fabs(dist - 0.7f) * 8.0f;
+                        alpha = fmax(0.0f, ring) * 0.4f;
+                        r = 0.8f + 0.2f * sin(angle * 2.0f);
+                        g = 0.8f + 0.2f * sin(angle * 2.0f + 2.1f);
+                        b = 0.8f + 0.2f * sin(angle * 2.0f + 4.2f);
+                    }
+                    break;
+                case 7: // Hexagonal bokeh
+                    {
+                        float hex = 0.0f;
+                        for (int k = 0; k < 6; k++) {
+                            float a = k * 3.14159f / 3.0f;
+                            hex = fmax(hex, fabs(dx * cos(a) + dy * sin(a)));
                         }
-                        break;
-                    case 9: // Starburst
-                        {
-                            float star = 0.0f;
-                            for (int k = 0; k < 6; k++) {
-                                float a = k * 3.14159f / 3.0f;
-                                float rayDist = fabs(sin(angle - a));
-                                star += exp(-rayDist * 20.0f) * exp(-dist * 3.0f);
-                            }
-                            alpha = fmin(1.0f, star) * 0.6f;
-                            r = 1.0f; g = 0.98f; b = 0.9f;
+                        alpha = pow(fmax(0.0f, 1.0f - hex * 1.5f), 2.0f) * 0.5f;
+                        r = 1.0f; g = 0.95f; b = 0.85f;
+                    }
+                    break;
+                case 8: // Anamorphic streak
+                    {
+                        float streak = exp(-dy * dy * 50.0f) * exp(-dx * dx * 0.5f);
+                        alpha = streak * 0.8f;
+                        r = 1.0f; g = 0.95f; b = 0.9f;
+                    }
+                    break;
+                case 9: // Starburst
+                    {
+                        float star = 0.0f;
+                        for (int k = 0; k < 6; k++) {
+                            float a = k * 3.14159f / 3.0f;
+                            float rayDist = fabs(sin(angle - a));
+                            star += exp(-rayDist * 20.0f) * exp(-dist * 3.0f);
                         }
-                        break;
-                }
-                
-                if (alpha < 0) alpha = 0;
-                if (alpha > 1) alpha = 1;
-                if (r > 1) r = 1; if (g > 1) g = 1; if (b > 1) b = 1;
-                
-                int idx = (y * size + x) * 4;
-                data[idx + 0] = (unsigned char)(r * 255);
-                data[idx + 1] = (unsigned char)(g * 255);
-                data[idx + 2] = (unsigned char)(b * 255);
-                data[idx + 3] = (unsigned char)(alpha * 255);
+                        alpha = fmin(1.0f, star) * 0.6f;
+                        r = 1.0f; g = 0.98f; b = 0.9f;
+                    }
+                    break;
             }
-        }
-        
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+            
+            if (alpha < 0) alpha = 0;
+            if (alpha > 1) alpha = 1;
+            if (r > 1) r = 1; if (g > 1) g = 1; if (b > 1) b = 1;
+            
+            rgba[0] = (unsigned char)(r * 255);
+            rgba[1] = (unsigned char)(g * 255);
+            rgba[2] = (unsigned char)(b * 255);
+            rgba[3] = (unsigned char)(alpha * 255);
+        };
         
-        delete[] data;
+        char name[16];
+        sprintf_s(name, sizeof(name), "flare%d", i);
+        ImageData flare;
+        ProceduralTextures::generate(name, FLARE_GENERATOR_VERSION, size, size, 0, flarePixel, flare);
+        sprite_flare[i] = spriteAtlas.addImage(flare);
     }
 }
 
 void SkySystem::renderSky(const Vector3f& playerPosition) {
     glPushMatrix();
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    GLState::push(GL_CURRENT_BIT);
     
     // Center on player
     glTranslatef(playerPosition.x, playerPosition.y, playerPosition.z);
     
+    if (analytic) {
+        // Vertex-colored dome, already in world orientation
+        GLState::disable(GL_CULL_FACE);
+        GLState::depthMask(false);
+        GLState::disable(GL_LIGHTING);
+        glScalef(SKY_RADIUS, SKY_RADIUS, SKY_RADIUS);
+        analyticSky.draw();
+        GLState::pop();
+        glPopMatrix();
+        return;
+    }
+    
     // Rotate sky sphere so texture horizon aligns with world horizon
     glRotatef(-90.0f, 1.0f, 0.0f, 0.0f);
     
     // Setup for sky rendering
-    glEnable(GL_TEXTURE_2D);
-    glDisable(GL_CULL_FACE);  // Render inside of sphere regardless of global cull state
-    glDepthMask(GL_FALSE);
-    glDisable(GL_LIGHTING);
+    GLState::enable(GL_TEXTURE_2D);
+    GLState::disable(GL_CULL_FACE);  // Render inside of sphere regardless of global cull state
+    GLState::depthMask(false);
+    GLState::disable(GL_LIGHTING);
+    
+    // The dome wraps the texture once around its circumference
+    TextureManager& textures = TextureManager::getInstance();
+    textures.requestDetail(getTextureForTime(currentTime), 2.0f * 3.14159f * SKY_RADIUS, SKY_RADIUS);
+    if (inTransition) {
+        textures.requestDetail(getTextureForTime(previousTime), 2.0f * 3.14159f * SKY_RADIUS, SKY_RADIUS);
+    }
     
-    // If in transition, blend between two skies
+    // Unit dome, generated once and shared (see SkyDome)
+    glScalef(SKY_RADIUS, SKY_RADIUS, SKY_RADIUS);
     if (inTransition && transitionProgress < 1.0f) {
-        // First pass: previous sky (fading out)
-        glBindTexture(GL_TEXTURE_2D, getTextureForTime(previousTime));
-        float fadeOut = 1.0f - transitionProgress;
-        glColor4f(fadeOut, fadeOut, fadeOut, 1.0f);
-        
-        GLUquadricObj* qobj = gluNewQuadric();
-        gluQuadricTexture(qobj, true);
-        gluQuadricNormals(qobj, GL_SMOOTH);
-        gluSphere(qobj, 800, 100, 100);
-        gluDeleteQuadric(qobj);
-        
-        // Second pass: current sky (fading in) with blending
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        
-        glBindTexture(GL_TEXTURE_2D, getTextureForTime(currentTime));
-        glColor4f(1.0f, 1.0f, 1.0f, transitionProgress);
-        
-        qobj = gluNewQuadric();
-        gluQuadricTexture(qobj, true);
-        gluQuadricNormals(qobj, GL_SMOOTH);
-        gluSphere(qobj, 799, 100, 100);  // Slightly smaller to avoid z-fighting
-        gluDeleteQuadric(qobj);
+        // Previous sky fading out into the current one, in a single pass
+        SkyDome::getInstance().drawBlend(getTextureForTime(previousTime), getTextureForTime(currentTime),
+                                         transitionProgress);
     } else {
-        // Normal rendering - single sky
-        glBindTexture(GL_TEXTURE_2D, getTextureForTime(currentTime));
-        glColor3f(1.0f, 1.0f, 1.0f);
-        
-        GLUquadricObj* qobj = gluNewQuadric();
-        gluQuadricTexture(qobj, true);
-        gluQuadricNormals(qobj, GL_SMOOTH);
-        gluSphere(qobj, 800, 100, 100);
-        gluDeleteQuadric(qobj);
+        SkyDome::getInstance().draw(getTextureForTime(currentTime));
     }
     
-    glPopAttrib();
+    GLState::pop();
     glPopMatrix();
 }
 
@@ -634,7 +535,7 @@ void SkySystem::renderLensFlare(const Vector3f& playerPosition, const Vector3f&
         sunIntensity *= 0.7f;
     }
     
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    GLState::push(GL_CURRENT_BIT);
     
     glMatrixMode(GL_PROJECTION);
     glPushMatrix();
@@ -645,12 +546,12 @@ void SkySystem::renderLensFlare(const Vector3f& playerPosition, const Vector3f&
     glPushMatrix();
     glLoadIdentity();
     
-    glDisable(GL_LIGHTING);
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_FOG); // Fix for blocky lens flare
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-    glEnable(GL_TEXTURE_2D);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::disable(GL_FOG); // Fix for blocky lens flare
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE);
+    GLState::enable(GL_TEXTURE_2D);
     
     struct FlareElement {
         float position;
@@ -678,6 +579,10 @@ void SkySystem::renderLensFlare(const Vector3f& playerPosition, const Vector3f&
     
     int numFlares = sizeof(flares) / sizeof(flares[0]);
     
+    // Every flare element comes from the sprite atlas: one bind, one batch
+    GLState::bindTexture(spriteAtlas.getTexture());
+    glBegin(GL_QUADS);
+    
     for (int i = 0; i < numFlares; i++) {
         float t = flares[i].position;
         float fx = sunX + dx * t;
@@ -691,50 +596,29 @@ void SkySystem::renderLensFlare(const Vector3f& playerPosition, const Vector3f&
             continue;
         }
         
-        glBindTexture(GL_TEXTURE_2D, tex_flare[flares[i].textureIndex]);
         glColor4f(flares[i].r, flares[i].g, flares[i].b, alpha);
-        
-        glBegin(GL_QUADS);
-        glTexCoord2f(0, 0); glVertex2f(fx - size, fy - size);
-        glTexCoord2f(1, 0); glVertex2f(fx + size, fy - size);
-        glTexCoord2f(1, 1); glVertex2f(fx + size, fy + size);
-        glTexCoord2f(0, 1); glVertex2f(fx - size, fy + size);
-        glEnd();
+        drawFlareQuad(sprite_flare[flares[i].textureIndex], fx - size, fy - size, fx + size, fy + size);
     }
     
     // Anamorphic streak
-    glBindTexture(GL_TEXTURE_2D, tex_flare[8]);
     float streakIntensity = sunIntensity * 0.2f;
     float streakWidth = fScreenW * 0.3f * sunIntensity;
     float streakHeight = 8.0f * sunIntensity;
     
     glColor4f(1.0f, 0.95f, 0.85f, streakIntensity);
-    glBegin(GL_QUADS);
-    glTexCoord2f(0, 0); glVertex2f(sunX - streakWidth, sunY - streakHeight);
-    glTexCoord2f(1, 0); glVertex2f(sunX + streakWidth, sunY - streakHeight);
-    glTexCoord2f(1, 1); glVertex2f(sunX + streakWidth, sunY + streakHeight);
-    glTexCoord2f(0, 1); glVertex2f(sunX - streakWidth, sunY + streakHeight);
-    glEnd();
+    drawFlareQuad(sprite_flare[8], sunX - streakWidth, sunY - streakHeight, sunX + streakWidth, sunY + streakHeight);
     
     // Secondary streak
     glColor4f(0.85f, 0.9f, 1.0f, streakIntensity * 0.4f);
     float streak2Height = 4.0f * sunIntensity;
-    glBegin(GL_QUADS);
-    glTexCoord2f(0, 0); glVertex2f(sunX - streakWidth * 1.1f, sunY - streak2Height);
-    glTexCoord2f(1, 0); glVertex2f(sunX + streakWidth * 1.1f, sunY - streak2Height);
-    glTexCoord2f(1, 1); glVertex2f(sunX + streakWidth * 1.1f, sunY + streak2Height);
-    glTexCoord2f(0, 1); glVertex2f(sunX - streakWidth * 1.1f, sunY + streak2Height);
-    glEnd();
+    drawFlareQuad(sprite_flare[8], sunX - streakWidth * 1.1f, sunY - streak2Height,
+                  sunX + streakWidth * 1.1f, sunY + streak2Height);
     
     // Screen bloom
-    glBindTexture(GL_TEXTURE_2D, tex_flare[0]);
     glColor4f(1.0f, 0.97f, 0.9f, 0.08f * sunIntensity);
     float bloomSize = 450.0f * sunIntensity;
-    glBegin(GL_QUADS);
-    glTexCoord2f(0, 0); glVertex2f(sunX - bloomSize, sunY - bloomSize);
-    glTexCoord2f(1, 0); glVertex2f(sunX + bloomSize, sunY - bloomSize);
-    glTexCoord2f(1, 1); glVertex2f(sunX + bloomSize, sunY + bloomSize);
-    glTexCoord2f(0, 1); glVertex2f(sunX - bloomSize, sunY + bloomSize);
+    drawFlareQuad(sprite_flare[0], sunX - bloomSize, sunY - bloomSize, sunX + bloomSize, sunY + bloomSize);
+    
     glEnd();
     
     glMatrixMode(GL_PROJECTION);
@@ -742,7 +626,16 @@ void SkySystem::renderLensFlare(const Vector3f& playerPosition, const Vector3f&
     glMatrixMode(GL_MODELVIEW);
     glPopMatrix();
     
-    glPopAttrib();
+    GLState::pop();
+}
+
+// Screen-space quad for one flare sprite (inside glBegin(GL_QUADS))
+void SkySystem::drawFlareQuad(int sprite, float x0, float y0, float x1, float y1) {
+    const SpriteRect& r = spriteAtlas.getRect(sprite);
+    glTexCoord2f(r.u0, r.v0); glVertex2f(x0, y0);
+    glTexCoord2f(r.u1, r.v0); glVertex2f(x1, y0);
+    glTexCoord2f(r.u1, r.v1); glVertex2f(x1, y1);
+    glTexCoord2f(r.u0, r.v1); glVertex2f(x0, y1);
 }
 
 // Initialize cloud positions in the sky - STATIONARY world-space clouds
@@ -774,14 +667,14 @@ void SkySystem::initClouds() {
 void SkySystem::renderClouds(const Vector3f& playerPosition) {
     if (!cloudsInitialized) return;
     
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    GLState::push(GL_CURRENT_BIT);
     
-    glEnable(GL_TEXTURE_2D);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glDisable(GL_LIGHTING);
-    glDisable(GL_CULL_FACE);
-    glDepthMask(GL_FALSE);  // Don't write to depth buffer
+    GLState::enable(GL_TEXTURE_2D);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_CULL_FACE);
+    GLState::depthMask(false);  // Don't write to depth buffer
     
     // Adjust cloud color based on time of day
     float cloudR = 1.0f, cloudG = 1.0f, cloudB = 1.0f;
@@ -803,6 +696,10 @@ void SkySystem::renderClouds(const Vector3f& playerPosition) {
             break;
     }
     
+    // All cloud sprites live in the atlas, so every cloud goes into one batch
+    GLState::bindTexture(spriteAtlas.getTexture());
+    glBegin(GL_QUADS);
+    
     // Render each cloud as a FLAT HORIZONTAL quad (not billboard)
     for (int i = 0; i < MAX_CLOUDS; i++) {
         // Clouds are at FIXED world positions (stationary)
@@ -828,8 +725,7 @@ void SkySystem::renderClouds(const Vector3f& playerPosition) {
         
         if (alpha < 0.05f) continue;  // Skip nearly invisible clouds
         
-        // Bind appropriate cloud texture
-        glBindTexture(GL_TEXTURE_2D, tex_cloud[clouds[i].textureIndex]);
+        const SpriteRect& sprite = spriteAtlas.getRect(sprite_cloud[clouds[i].textureIndex]);
         glColor4f(cloudR, cloudG, cloudB, alpha);
         
         // Pre-calculate rotation for this cloud (fixed rotation, doesn't change)
@@ -846,18 +742,17 @@ void SkySystem::renderClouds(const Vector3f& playerPosition) {
             {-size,  size}
         };
         
-        glBegin(GL_QUADS);
         for (int c = 0; c < 4; c++) {
             // Apply Y-axis rotation to corner
             float rx = corners[c][0] * cosR - corners[c][1] * sinR;
             float rz = corners[c][0] * sinR + corners[c][1] * cosR;
             
-            glTexCoord2f(c == 0 || c == 3 ? 0.0f : 1.0f, c < 2 ? 0.0f : 1.0f);
+            glTexCoord2f(c == 0 || c == 3 ? sprite.u0 : sprite.u1, c < 2 ? sprite.v0 : sprite.v1);
             glVertex3f(cloudX + rx, cloudY, cloudZ + rz);
         }
-        glEnd();
     }
+    glEnd();
     
-    glDepthMask(GL_TRUE);
-    glPopAttrib();
+    GLState::depthMask(true);
+    GLState::pop();
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "glew.h"
 #include <glut.h>
 #include "Vector3f.h"
+#include "SpriteAtlas.h"
+#include "AnalyticSky.h"
 
 // Time of day phases for day/night cycle
 enum class TimeOfDay {
@@ -70,16 +72,27 @@ public:
     // Manually set time of day (for testing)
     void setTimeOfDay(TimeOfDay time);
     
+    // Analytic sky (see AnalyticSky) instead of the four skybox textures;
+    // sets the mode for SkySystems initialized afterwards
+    static void setAnalyticDefault(bool enabled) { analyticDefault = enabled; }
+    bool isAnalytic() const { return analytic; }
+    
 private:
     // Sky textures for each phase
     unsigned int tex_sky_morning;
     unsigned int tex_sky_noon;
     unsigned int tex_sky_sunset;
     unsigned int tex_sky_night;
-    unsigned int tex_flare[10];  // More flare textures for AAA quality
     
-    // Cloud textures and data
-    unsigned int tex_cloud[3];   // 3 cloud textures
+    // Analytic mode: no sky textures, the dome is colored from the sun direction
+    static bool analyticDefault;
+    bool analytic;
+    AnalyticSky analyticSky;
+    
+    // Cloud and lens flare sprites, packed into one atlas
+    SpriteAtlas spriteAtlas;
+    int sprite_flare[10];        // More flare textures for AAA quality
+    int sprite_cloud[3];         // 3 cloud textures
     static const int MAX_CLOUDS = 60;  // Number of clouds
     CloudBillboard clouds[60];   // Cloud instances
     bool cloudsInitialized;
@@ -105,8 +118,9 @@ private:
     // Load sky texture from BMP file (flipVertical: extra flip for textures that are upside down)
     bool loadSkyTexture(const char* filename, unsigned int& texId, bool flipVertical = false);
     
-    // Generate lens flare textures (AAA quality)
+    // Generate lens flare textures (AAA quality) into the sprite atlas
     void generateFlareTextures();
+    void drawFlareQuad(int sprite, float x0, float y0, float x1, float y1);
     
     // Render sun glow on skybox
     void renderSunGlow(const Vector3f& playerPosition);
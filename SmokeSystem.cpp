@@ -1,5 +1,7 @@
 #include "SmokeSystem.h"
+#include "ProceduralTextures.h"
 #include "glew.h"
+#include "GLState.h"
 #include <glut.h>
 #include <cstdlib>
 #include <cmath>
@@ -13,51 +15,34 @@ SmokeSystem::SmokeSystem()
 }
 
 SmokeSystem::~SmokeSystem() {
-    if (textureID != 0) {
-        glDeleteTextures(1, &textureID);
-    }
+    TextureManager::getInstance().release(textureID);
 }
 
 void SmokeSystem::init() {
-    // Create a simple procedural smoke texture if file loading fails
-    // This ensures smoke always works even without texture file
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    
-    // Create a 64x64 soft circle texture procedurally
+    // Procedural 64x64 soft circle, generated once and cached on disk.
+    // Every SmokeSystem shares the same uploaded texture.
     const int texSize = 64;
-    unsigned char* texData = new unsigned char[texSize * texSize * 4];
-    
-    float centerX = texSize / 2.0f;
-    float centerY = texSize / 2.0f;
-    float maxDist = texSize / 2.0f;
-    
-    for (int y = 0; y < texSize; y++) {
-        for (int x = 0; x < texSize; x++) {
-            float dx = x - centerX;
-            float dy = y - centerY;
-            float dist = sqrt(dx * dx + dy * dy);
-            
-            // Soft falloff from center
-            float alpha = 1.0f - (dist / maxDist);
-            if (alpha < 0.0f) alpha = 0.0f;
-            alpha = alpha * alpha;  // Quadratic falloff for softer edges
-            
-            int idx = (y * texSize + x) * 4;
-            texData[idx + 0] = 200;  // R - light gray
-            texData[idx + 1] = 200;  // G
-            texData[idx + 2] = 200;  // B
-            texData[idx + 3] = (unsigned char)(alpha * 255);  // A
-        }
-    }
+    const float centerX = texSize / 2.0f;
+    const float centerY = texSize / 2.0f;
+    const float maxDist = texSize / 2.0f;
     
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texSize, texSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, texData);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+    auto smokePixel = [&](int x, int y, unsigned char* rgba) {
+        float dx = x - centerX;
+        float dy = y - centerY;
+        float dist = sqrt(dx * dx + dy * dy);
+        
+        // Soft falloff from center
+        float alpha = 1.0f - (dist / maxDist);
+        if (alpha < 0.0f) alpha = 0.0f;
+        alpha = alpha * alpha;  // Quadratic falloff for softer edges
+        
+        rgba[0] = 200;  // R - light gray
+        rgba[1] = 200;  // G
+        rgba[2] = 200;  // B
+        rgba[3] = (unsigned char)(alpha * 255);  // A
+    };
     
-    delete[] texData;
+    textureID = ProceduralTextures::acquire("smoke", 1, texSize, texSize, 0, smokePixel);
 }
 
 float SmokeSystem::randomFloat(float min, float max) {
@@ -205,21 +190,21 @@ void SmokeSystem::render(const Vector3f& cameraPosition) {
     if (particles.empty()) return;
     
     // Save OpenGL state
-    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    GLState::push(GL_CURRENT_BIT);
     
     // Enable blending for transparency
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
     // Enable texture
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, textureID);
+    GLState::enable(GL_TEXTURE_2D);
+    GLState::bindTexture(textureID);
     
     // Disable lighting for particles (they should be self-illuminated)
-    glDisable(GL_LIGHTING);
+    GLState::disable(GL_LIGHTING);
     
     // Disable depth writing (but keep depth testing for proper ordering with scene)
-    glDepthMask(GL_FALSE);
+    GLState::depthMask(false);
     
     // Sort particles by distance to camera (back to front) for proper blending
     // Create index array for sorting
@@ -292,6 +277,6 @@ void SmokeSystem::render(const Vector3f& cameraPosition) {
     glEnd();
     
     // Restore OpenGL state
-    glDepthMask(GL_TRUE);
-    glPopAttrib();
+    GLState::depthMask(true);
+    GLState::pop();
 }
@@ -0,0 +1,127 @@
+#include "SpatialGrid.h"
+#include <math.h>
+#include <algorithm>
+
+SpatialGrid::SpatialGrid(float size) : cellSize(size), stamp(0) {
+}
+
+void SpatialGrid::clear() {
+    items.clear();
+    cells.clear();
+    stamps.clear();
+    stamp = 0;
+}
+
+int SpatialGrid::cellIndex(float value) const {
+    return (int)floorf(value / cellSize);
+}
+
+void SpatialGrid::nextStamp() const {
+    stamps.resize(items.size(), 0);
+    if (++stamp == 0) {
+        // Wrapped around: old stamps could match again
+        std::fill(stamps.begin(), stamps.end(), 0u);
+        stamp = 1;
+    }
+}
+
+void SpatialGrid::insert(int id, float minX, float minZ, float maxX, float maxZ, float minY, float maxY) {
+    Item item = { id, minX, minZ, maxX, maxZ, minY, maxY };
+    int index = (int)items.size();
+    items.push_back(item);
+
+    for (int cz = cellIndex(minZ); cz <= cellIndex(maxZ); cz++) {
+        for (int cx = cellIndex(minX); cx <= cellIndex(maxX); cx++) {
+            auto found = cells.find(cellKey(cx, cz));
+            if (found == cells.end()) {
+                Cell cell;
+                cell.minY = minY;
+                cell.maxY = maxY;
+                found = cells.insert(std::make_pair(cellKey(cx, cz), cell)).first;
+            }
+            Cell& cell = found->second;
+            cell.items.push_back(index);
+            cell.minY = std::min(cell.minY, minY);
+            cell.maxY = std::max(cell.maxY, maxY);
+        }
+    }
+}
+
+void SpatialGrid::queryBox(float minX, float minZ, float maxX, float maxZ, std::vector<int>& out) const {
+    out.clear();
+    if (items.empty()) {
+        return;
+    }
+    nextStamp();
+    for (int cz = cellIndex(minZ); cz <= cellIndex(maxZ); cz++) {
+        for (int cx = cellIndex(minX); cx <= cellIndex(maxX); cx++) {
+            auto found = cells.find(cellKey(cx, cz));
+            if (found == cells.end()) continue;
+            for (int index : found->second.items) {
+                if (stamps[index] == stamp) continue;
+                stamps[index] = stamp;
+                const Item& item = items[index];
+                if (item.maxX < minX || item.minX > maxX || item.maxZ < minZ || item.minZ > maxZ) continue;
+                out.push_back(item.id);
+            }
+        }
+    }
+}
+
+void SpatialGrid::queryRadius(float x, float z, float radius, std::vector<int>& out) const {
+    out.clear();
+    if (items.empty()) {
+        return;
+    }
+    nextStamp();
+    float radiusSq = radius * radius;
+    for (int cz = cellIndex(z - radius); cz <= cellIndex(z + radius); cz++) {
+        for (int cx = cellIndex(x - radius); cx <= cellIndex(x + radius); cx++) {
+            auto found = cells.find(cellKey(cx, cz));
+            if (found == cells.end()) continue;
+            for (int index : found->second.items) {
+                if (stamps[index] == stamp) continue;
+                stamps[index] = stamp;
+                // Distance from the center to the item's box
+                const Item& item = items[index];
+                float dx = std::max(0.0f, std::max(item.minX - x, x - item.maxX));
+                float dz = std::max(0.0f, std::max(item.minZ - z, z - item.maxZ));
+                if (dx * dx + dz * dz > radiusSq) continue;
+                out.push_back(item.id);
+            }
+        }
+    }
+}
+
+void SpatialGrid::queryFrustum(const Frustum& frustum, std::vector<int>& out) const {
+    out.clear();
+    if (items.empty()) {
+        return;
+    }
+    nextStamp();
+    for (const auto& entry : cells) {
+        const Cell& cell = entry.second;
+        int cx = (int)(unsigned int)(entry.first >> 32);
+        int cz = (int)(unsigned int)(entry.first & 0xffffffffu);
+
+        // Sphere around the cell's box, then the items' own boxes
+        float halfY = (cell.maxY - cell.minY) * 0.5f;
+        float half = cellSize * 0.5f;
+        if (!frustum.testSphere((cx + 0.5f) * cellSize, cell.minY + halfY, (cz + 0.5f) * cellSize,
+                                sqrtf(2.0f * half * half + halfY * halfY))) {
+            continue;
+        }
+        for (int index : cell.items) {
+            if (stamps[index] == stamp) continue;
+            stamps[index] = stamp;
+            const Item& item = items[index];
+            float hx = (item.maxX - item.minX) * 0.5f;
+            float hy = (item.maxY - item.minY) * 0.5f;
+            float hz = (item.maxZ - item.minZ) * 0.5f;
+            if (!frustum.testSphere(item.minX + hx, item.minY + hy, item.minZ + hz, sqrtf(hx * hx + hy * hy + hz * hz))) {
+                continue;
+            }
+            out.push_back(item.id);
+        }
+    }
+}
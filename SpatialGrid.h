@@ -0,0 +1,52 @@
+#pragma once
+#include "Frustum.h"
+#include <vector>
+#include <unordered_map>
+
+// Spatial Grid - uniform grid over the ground plane for static objects
+// Level2 kept buildings, trees and fuel containers in flat vectors that
+// collision, placement and rendering scanned end to end every time. Each
+// item is now indexed once by its bounding box in every cell it overlaps
+// (cells are hashed, so the world needs no fixed extent). Radius and box
+// queries visit only the cells they touch; frustum queries test each
+// occupied cell's box first and then the items in it. Queries return the
+// ids of candidates whose boxes overlap; callers keep their exact tests.
+class SpatialGrid {
+public:
+    explicit SpatialGrid(float cellSize = 100.0f);
+
+    void clear();
+    // Box on the ground (X/Z) plus its height range, for frustum queries
+    void insert(int id, float minX, float minZ, float maxX, float maxZ, float minY, float maxY);
+
+    void queryBox(float minX, float minZ, float maxX, float maxZ, std::vector<int>& out) const;
+    void queryRadius(float x, float z, float radius, std::vector<int>& out) const;
+    void queryFrustum(const Frustum& frustum, std::vector<int>& out) const;
+
+    int getItemCount() const { return (int)items.size(); }
+    int getCellCount() const { return (int)cells.size(); }
+
+private:
+    struct Item {
+        int id;
+        float minX, minZ, maxX, maxZ, minY, maxY;
+    };
+
+    struct Cell {
+        std::vector<int> items;     // Indices into items
+        float minY, maxY;           // Height range of its items
+    };
+
+    float cellSize;
+    std::vector<Item> items;
+    std::unordered_map<unsigned long long, Cell> cells;
+    // Items span several cells; a per-query stamp reports each one once
+    mutable std::vector<unsigned int> stamps;
+    mutable unsigned int stamp;
+
+    static unsigned long long cellKey(int x, int z) {
+        return ((unsigned long long)(unsigned int)x << 32) | (unsigned int)z;
+    }
+    int cellIndex(float value) const;
+    void nextStamp() const;
+};
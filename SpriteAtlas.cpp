@@ -0,0 +1,139 @@
+#include "SpriteAtlas.h"
+#include <stdio.h>
+#include <algorithm>
+
+// Largest atlas edge; bigger sets should be split into several atlases
+static const int MAX_ATLAS_SIZE = 4096;
+
+SpriteAtlas::SpriteAtlas() : texture(0), atlasWidth(0), atlasHeight(0) {
+}
+
+SpriteAtlas::~SpriteAtlas() {
+    release();
+}
+
+int SpriteAtlas::addImage(const ImageData& image) {
+    if (image.width <= 0 || image.height <= 0 || image.pixels.empty()) {
+        return -1;
+    }
+    pending.push_back(image);
+
+    SpriteRect rect = { 0.0f, 0.0f, 1.0f, 1.0f, image.width, image.height };
+    rects.push_back(rect);
+    return (int)rects.size() - 1;
+}
+
+int SpriteAtlas::addFile(const char* path, unsigned int flags) {
+    ImageData image;
+    if (!TextureManager::getInstance().loadImage(path, flags, image)) {
+        return -1;
+    }
+    return addImage(image);
+}
+
+bool SpriteAtlas::pack(int width, int height, int padding, std::vector<int>& posX, std::vector<int>& posY) const {
+    std::vector<int> order(pending.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = (int)i;
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return pending[a].height > pending[b].height;
+    });
+
+    posX.assign(pending.size(), 0);
+    posY.assign(pending.size(), 0);
+
+    int x = 0, y = 0, shelfHeight = 0;
+    for (size_t i = 0; i < order.size(); i++) {
+        int w = pending[order[i]].width + padding * 2;
+        int h = pending[order[i]].height + padding * 2;
+        if (w > width) {
+            return false;
+        }
+        if (x + w > width) {
+            // Start a new shelf
+            y += shelfHeight;
+            x = 0;
+            shelfHeight = 0;
+        }
+        if (y + h > height) {
+            return false;
+        }
+        posX[order[i]] = x + padding;
+        posY[order[i]] = y + padding;
+        x += w;
+        if (h > shelfHeight) shelfHeight = h;
+    }
+    return true;
+}
+
+bool SpriteAtlas::build(const char* name, int padding) {
+    if (pending.empty()) {
+        return false;
+    }
+
+    // Smallest power-of-two square that could hold the sprites, then grow until they fit
+    size_t area = 0;
+    for (size_t i = 0; i < pending.size(); i++) {
+        area += (size_t)(pending[i].width + padding * 2) * (pending[i].height + padding * 2);
+    }
+    int width = 64;
+    while ((size_t)width * width < area && width < MAX_ATLAS_SIZE) width *= 2;
+    int height = width;
+
+    std::vector<int> posX, posY;
+    while (!pack(width, height, padding, posX, posY)) {
+        if (width == MAX_ATLAS_SIZE && height == MAX_ATLAS_SIZE) {
+            printf("SpriteAtlas: %s doesn't fit in %dx%d\n", name, MAX_ATLAS_SIZE, MAX_ATLAS_SIZE);
+            return false;
+        }
+        if (height < width) height *= 2;
+        else width *= 2;
+    }
+
+    ImageData atlas;
+    atlas.width = width;
+    atlas.height = height;
+    atlas.channels = 4;
+    atlas.pixels.assign((size_t)width * height * 4, 0);
+
+    for (size_t i = 0; i < pending.size(); i++) {
+        const ImageData& image = pending[i];
+        int c = image.channels;
+
+        // Copy the sprite plus its border, clamping source coordinates so the border repeats the edge
+        for (int y = -padding; y < image.height + padding; y++) {
+            int sy = y < 0 ? 0 : (y >= image.height ? image.height - 1 : y);
+            unsigned char* dest = &atlas.pixels[((size_t)(posY[i] + y) * width + posX[i] - padding) * 4];
+            for (int x = -padding; x < image.width + padding; x++) {
+                int sx = x < 0 ? 0 : (x >= image.width ? image.width - 1 : x);
+                const unsigned char* src = &image.pixels[((size_t)sy * image.width + sx) * c];
+                dest[0] = src[0];
+                dest[1] = src[1];
+                dest[2] = src[2];
+                dest[3] = c == 4 ? src[3] : 255;
+                dest += 4;
+            }
+        }
+
+        SpriteRect& rect = rects[i];
+        rect.u0 = (float)posX[i] / width;
+        rect.v0 = (float)posY[i] / height;
+        rect.u1 = (float)(posX[i] + image.width) / width;
+        rect.v1 = (float)(posY[i] + image.height) / height;
+    }
+
+    release();
+    texture = TextureManager::getInstance().acquireImage(name, atlas, TEX_CLAMP);
+    atlasWidth = width;
+    atlasHeight = height;
+    pending.clear();
+
+    printf("SpriteAtlas: %s packed %d sprites into %dx%d\n", name, (int)rects.size(), width, height);
+    return texture != 0;
+}
+
+void SpriteAtlas::release() {
+    if (texture != 0) {
+        TextureManager::getInstance().release(texture);
+        texture = 0;
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "TextureManager.h"
+#include <vector>
+
+// Where a sprite ended up inside the atlas texture
+struct SpriteRect {
+    float u0, v0;   // First row / column (v0 is the image's top row)
+    float u1, v1;
+    int width;      // Source size in pixels
+    int height;
+};
+
+// Sprite Atlas - packs billboard sprites into one texture
+// Trees, clouds and lens flares used one texture each, so every sprite in
+// a category needed its own glBindTexture (and its own glBegin/glEnd).
+// Packing a category into one atlas lets the whole category be drawn in a
+// single batch. Each sprite gets a border of repeated edge pixels so
+// linear filtering and the first few mip levels don't bleed between them.
+// (Texture arrays would need shaders, which this renderer doesn't use.)
+class SpriteAtlas {
+public:
+    SpriteAtlas();
+    ~SpriteAtlas();
+
+    // Queue a sprite; returns its index (valid after build)
+    int addImage(const ImageData& image);
+    // Queue a BMP; returns -1 if it can't be loaded
+    int addFile(const char* path, unsigned int flags = TEX_DEFAULT);
+
+    // Pack and upload. The name is the atlas' TextureManager key, so two
+    // systems that build the same atlas share one texture.
+    bool build(const char* name, int padding = 8);
+    void release();
+
+    unsigned int getTexture() const { return texture; }
+    int getSpriteCount() const { return (int)rects.size(); }
+    int getWidth() const { return atlasWidth; }
+    int getHeight() const { return atlasHeight; }
+    const SpriteRect& getRect(int sprite) const { return rects[sprite]; }
+
+    // Map a 0..1 texture coordinate of a sprite into the atlas
+    void mapUV(int sprite, float u, float v, float& outU, float& outV) const {
+        const SpriteRect& r = rects[sprite];
+        outU = r.u0 + (r.u1 - r.u0) * u;
+        outV = r.v0 + (r.v1 - r.v0) * v;
+    }
+
+private:
+    std::vector<ImageData> pending;
+    std::vector<SpriteRect> rects;
+    unsigned int texture;
+    int atlasWidth;
+    int atlasHeight;
+
+    // Shelf packing, tallest sprites first. False if they don't fit.
+    bool pack(int width, int height, int padding, std::vector<int>& posX, std::vector<int>& posY) const;
+};
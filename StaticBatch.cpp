@@ -0,0 +1,319 @@
+#include "StaticBatch.h"
+#include "glew.h"
+#include "GLState.h"
+#include <math.h>
+#include <cstddef>
+#include <stdio.h>
+
+static const float PI = 3.14159265f;
+
+StaticBatch::StaticBatch()
+    : currentGroup(-1), primitive(TRIANGLES), vbo(0), vertexCount(0), built(false) {
+    current.position[0] = current.position[1] = current.position[2] = 0.0f;
+    current.normal[0] = current.normal[1] = 0.0f;
+    current.normal[2] = 1.0f;
+    current.texCoord[0] = current.texCoord[1] = 0.0f;
+    current.color[0] = current.color[1] = current.color[2] = current.color[3] = 255;
+    resetTransform();
+}
+
+StaticBatch::~StaticBatch() {
+    // The GL context may already be gone; release() is called from level cleanup
+}
+
+//=======================================================================
+// Recording
+//=======================================================================
+void StaticBatch::setMaterial(unsigned int texId, bool lit) {
+    if (built) {
+        release();
+    }
+    for (size_t i = 0; i < groups.size(); i++) {
+        if (groups[i].texId == texId && groups[i].lit == lit) {
+            currentGroup = (int)i;
+            return;
+        }
+    }
+    Group group;
+    group.texId = texId;
+    group.lit = lit;
+    group.first = 0;
+    group.count = 0;
+    groups.push_back(group);
+    currentGroup = (int)groups.size() - 1;
+}
+
+void StaticBatch::setTransform(const RenderMatrix& matrix) {
+    transform = matrix;
+
+    // Cofactor matrix of the upper 3x3: its columns are the cross products
+    // of the transform's columns, and it is the inverse transpose up to scale
+    const float* a0 = &transform.m[0];
+    const float* a1 = &transform.m[4];
+    const float* a2 = &transform.m[8];
+    const float* columns[3][2] = { { a1, a2 }, { a2, a0 }, { a0, a1 } };
+    for (int c = 0; c < 3; c++) {
+        const float* u = columns[c][0];
+        const float* v = columns[c][1];
+        normalMatrix[0 * 3 + c] = u[1] * v[2] - u[2] * v[1];
+        normalMatrix[1 * 3 + c] = u[2] * v[0] - u[0] * v[2];
+        normalMatrix[2 * 3 + c] = u[0] * v[1] - u[1] * v[0];
+    }
+    // Mirrored transforms would flip the normals inside out
+    float det = a0[0] * normalMatrix[0] + a0[1] * normalMatrix[3] + a0[2] * normalMatrix[6];
+    if (det < 0.0f) {
+        for (int i = 0; i < 9; i++) normalMatrix[i] = -normalMatrix[i];
+    }
+}
+
+void StaticBatch::color(float r, float g, float b, float a) {
+    current.color[0] = (unsigned char)(r * 255.0f + 0.5f);
+    current.color[1] = (unsigned char)(g * 255.0f + 0.5f);
+    current.color[2] = (unsigned char)(b * 255.0f + 0.5f);
+    current.color[3] = (unsigned char)(a * 255.0f + 0.5f);
+}
+
+void StaticBatch::normal(float x, float y, float z) {
+    float n[3];
+    for (int r = 0; r < 3; r++) {
+        n[r] = normalMatrix[r * 3 + 0] * x + normalMatrix[r * 3 + 1] * y + normalMatrix[r * 3 + 2] * z;
+    }
+    float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    if (length > 0.0f) {
+        current.normal[0] = n[0] / length;
+        current.normal[1] = n[1] / length;
+        current.normal[2] = n[2] / length;
+    }
+}
+
+void StaticBatch::texCoord(float s, float t) {
+    current.texCoord[0] = s;
+    current.texCoord[1] = t;
+}
+
+void StaticBatch::begin(Primitive type) {
+    if (currentGroup < 0) {
+        setMaterial(0, false);
+    }
+    primitive = type;
+    pending.clear();
+}
+
+void StaticBatch::vertex(float x, float y, float z) {
+    const float* m = transform.m;
+    current.position[0] = m[0] * x + m[4] * y + m[8] * z + m[12];
+    current.position[1] = m[1] * x + m[5] * y + m[9] * z + m[13];
+    current.position[2] = m[2] * x + m[6] * y + m[10] * z + m[14];
+    pending.push_back(current);
+}
+
+void StaticBatch::end() {
+    if (primitive == QUADS) {
+        for (size_t i = 0; i + 3 < pending.size(); i += 4) {
+            emit(pending[i]);
+            emit(pending[i + 1]);
+            emit(pending[i + 2]);
+            emit(pending[i]);
+            emit(pending[i + 2]);
+            emit(pending[i + 3]);
+        }
+    } else {
+        for (size_t i = 0; i + 2 < pending.size(); i += 3) {
+            emit(pending[i]);
+            emit(pending[i + 1]);
+            emit(pending[i + 2]);
+        }
+    }
+    pending.clear();
+}
+
+void StaticBatch::emit(const Vertex& v) {
+    groups[currentGroup].vertices.push_back(v);
+}
+
+//=======================================================================
+// Shapes
+//=======================================================================
+void StaticBatch::addCube(float size) {
+    float h = size * 0.5f;
+    // Outward normal, then four corners counter-clockwise seen from outside
+    const float faces[6][5][3] = {
+        { { 0, 0, 1 },  { -h, -h, h },  { h, -h, h },   { h, h, h },   { -h, h, h } },
+        { { 0, 0, -1 }, { h, -h, -h },  { -h, -h, -h }, { -h, h, -h }, { h, h, -h } },
+        { { 1, 0, 0 },  { h, -h, h },   { h, -h, -h },  { h, h, -h },  { h, h, h } },
+        { { -1, 0, 0 }, { -h, -h, -h }, { -h, -h, h },  { -h, h, h },  { -h, h, -h } },
+        { { 0, 1, 0 },  { -h, h, h },   { h, h, h },    { h, h, -h },  { -h, h, -h } },
+        { { 0, -1, 0 }, { -h, -h, -h }, { h, -h, -h },  { h, -h, h },  { -h, -h, h } }
+    };
+    begin(QUADS);
+    for (int f = 0; f < 6; f++) {
+        normal(faces[f][0][0], faces[f][0][1], faces[f][0][2]);
+        for (int c = 1; c <= 4; c++) {
+            vertex(faces[f][c][0], faces[f][c][1], faces[f][c][2]);
+        }
+    }
+    end();
+}
+
+void StaticBatch::addSphere(float radius, int slices, int stacks) {
+    begin(QUADS);
+    for (int i = 0; i < stacks; i++) {
+        // From the +Z pole down, like glutSolidSphere
+        float phi0 = PI * i / stacks;
+        float phi1 = PI * (i + 1) / stacks;
+        for (int j = 0; j < slices; j++) {
+            float theta0 = 2.0f * PI * j / slices;
+            float theta1 = 2.0f * PI * (j + 1) / slices;
+            const float corners[4][2] = { { phi0, theta0 }, { phi1, theta0 }, { phi1, theta1 }, { phi0, theta1 } };
+            for (int c = 0; c < 4; c++) {
+                float x = sinf(corners[c][0]) * cosf(corners[c][1]);
+                float y = sinf(corners[c][0]) * sinf(corners[c][1]);
+                float z = cosf(corners[c][0]);
+                normal(x, y, z);
+                vertex(x * radius, y * radius, z * radius);
+            }
+        }
+    }
+    end();
+}
+
+void StaticBatch::addCylinder(float baseRadius, float topRadius, float height, int slices) {
+    // Along +Z with the first slice at +Y, like gluCylinder with one stack
+    float slope = height > 0.0f ? (baseRadius - topRadius) / height : 0.0f;
+    begin(QUADS);
+    for (int i = 0; i < slices; i++) {
+        float a0 = 2.0f * PI * i / slices;
+        float a1 = 2.0f * PI * (i + 1) / slices;
+        float s0 = 1.0f - (float)i / slices;
+        float s1 = 1.0f - (float)(i + 1) / slices;
+
+        normal(sinf(a0), cosf(a0), slope);
+        texCoord(s0, 0.0f);
+        vertex(baseRadius * sinf(a0), baseRadius * cosf(a0), 0.0f);
+        texCoord(s0, 1.0f);
+        vertex(topRadius * sinf(a0), topRadius * cosf(a0), height);
+        normal(sinf(a1), cosf(a1), slope);
+        texCoord(s1, 1.0f);
+        vertex(topRadius * sinf(a1), topRadius * cosf(a1), height);
+        texCoord(s1, 0.0f);
+        vertex(baseRadius * sinf(a1), baseRadius * cosf(a1), 0.0f);
+    }
+    end();
+}
+
+void StaticBatch::addDisk(float innerRadius, float outerRadius, int slices) {
+    // Facing +Z; texture spans the outer radius like gluDisk
+    float texScale = outerRadius > 0.0f ? 0.5f / outerRadius : 0.0f;
+    normal(0.0f, 0.0f, 1.0f);
+    begin(TRIANGLES);
+    for (int i = 0; i < slices; i++) {
+        float a0 = 2.0f * PI * i / slices;
+        float a1 = 2.0f * PI * (i + 1) / slices;
+        float points[4][2] = {
+            { innerRadius * sinf(a0), innerRadius * cosf(a0) },
+            { innerRadius * sinf(a1), innerRadius * cosf(a1) },
+            { outerRadius * sinf(a1), outerRadius * cosf(a1) },
+            { outerRadius * sinf(a0), outerRadius * cosf(a0) }
+        };
+        const int order[6] = { 0, 1, 2, 0, 2, 3 };
+        for (int k = (innerRadius > 0.0f ? 0 : 3); k < 6; k++) {
+            const float* p = points[order[k]];
+            texCoord(p[0] * texScale + 0.5f, p[1] * texScale + 0.5f);
+            vertex(p[0], p[1], 0.0f);
+        }
+    }
+    end();
+}
+
+//=======================================================================
+// Upload and draw
+//=======================================================================
+void StaticBatch::build() {
+    packed.clear();
+    for (Group& group : groups) {
+        group.first = (int)packed.size();
+        group.count = (int)group.vertices.size();
+        packed.insert(packed.end(), group.vertices.begin(), group.vertices.end());
+        std::vector<Vertex>().swap(group.vertices);
+    }
+    vertexCount = (int)packed.size();
+    built = true;
+    currentGroup = -1;
+
+    if (packed.empty()) {
+        return;
+    }
+    if ((GLEW_VERSION_1_5 || GLEW_ARB_vertex_buffer_object) && glGenBuffers != NULL) {
+        glGenBuffers(1, &vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, packed.size() * sizeof(Vertex), &packed[0], GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        std::vector<Vertex>().swap(packed);
+    }
+}
+
+void StaticBatch::draw(bool applyColors) const {
+    if (!built || vertexCount == 0) {
+        return;
+    }
+
+    const char* base = NULL;
+    if (vbo != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    } else {
+        base = (const char*)&packed[0];
+    }
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glVertexPointer(3, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, position));
+    glNormalPointer(GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, normal));
+    glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, texCoord));
+    if (applyColors) {
+        glEnableClientState(GL_COLOR_ARRAY);
+        glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), base + offsetof(Vertex, color));
+    }
+
+    GLboolean wasLit = GLState::isEnabled(GL_LIGHTING);
+    GLboolean wasTextured = GLState::isEnabled(GL_TEXTURE_2D);
+    for (const Group& group : groups) {
+        if (group.count == 0) continue;
+        if (group.lit) GLState::enable(GL_LIGHTING);
+        else GLState::disable(GL_LIGHTING);
+        if (group.texId != 0) {
+            GLState::enable(GL_TEXTURE_2D);
+            GLState::bindTexture(group.texId);
+        } else {
+            GLState::disable(GL_TEXTURE_2D);
+        }
+        glDrawArrays(GL_TRIANGLES, group.first, group.count);
+    }
+    if (wasLit) GLState::enable(GL_LIGHTING);
+    else GLState::disable(GL_LIGHTING);
+    if (wasTextured) GLState::enable(GL_TEXTURE_2D);
+    else GLState::disable(GL_TEXTURE_2D);
+
+    if (applyColors) {
+        glDisableClientState(GL_COLOR_ARRAY);
+    }
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_NORMAL_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    if (vbo != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+}
+
+void StaticBatch::release() {
+    if (vbo != 0) {
+        glDeleteBuffers(1, &vbo);
+        vbo = 0;
+    }
+    groups.clear();
+    packed.clear();
+    pending.clear();
+    currentGroup = -1;
+    vertexCount = 0;
+    built = false;
+}
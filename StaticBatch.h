@@ -0,0 +1,91 @@
+#pragma once
+#include "RenderQueue.h"
+#include <vector>
+
+// Static Batch - geometry recorded once, drawn with a handful of calls
+// Level1's port (slabs, pylons, container stacks, lighthouse, light posts)
+// was rebuilt through glBegin/glEnd every frame although none of it moves.
+// The builder mirrors immediate mode (begin/vertex/end plus the glut/glu
+// shapes the port used), bakes the current transform into the vertices,
+// and groups everything by texture and lighting. build() uploads one vertex
+// buffer; draw() is one glDrawArrays per group. Animated parts (beams,
+// pulsing glows) stay out of the batch, or use draw(false) to take their
+// color from glColor.
+class StaticBatch {
+public:
+    enum Primitive {
+        TRIANGLES,
+        QUADS
+    };
+
+    StaticBatch();
+    ~StaticBatch();
+
+    StaticBatch(const StaticBatch&) = delete;
+    StaticBatch& operator=(const StaticBatch&) = delete;
+
+    // Recording state, applied to the vertices that follow
+    void setMaterial(unsigned int texId, bool lit);     // texId 0 = untextured
+    void setTransform(const RenderMatrix& transform);
+    void resetTransform() { setTransform(RenderMatrix()); }
+    void color(float r, float g, float b, float a = 1.0f);
+    void normal(float x, float y, float z);
+    void texCoord(float s, float t);
+
+    void begin(Primitive primitive);
+    void vertex(float x, float y, float z);
+    void end();
+
+    // Same shapes and parameters as glutSolidCube/glutSolidSphere and
+    // gluCylinder/gluDisk (texture coordinates like a textured quadric)
+    void addCube(float size);
+    void addSphere(float radius, int slices, int stacks);
+    void addCylinder(float baseRadius, float topRadius, float height, int slices);
+    void addDisk(float innerRadius, float outerRadius, int slices);
+
+    // Upload the recorded geometry (needs a GL context); recording again
+    // afterwards starts a new batch
+    void build();
+    // Draw every group. GL_LIGHTING and GL_TEXTURE_2D are restored
+    // afterwards; without applyColors the current glColor is used instead.
+    void draw(bool applyColors = true) const;
+    // Drop the geometry and its buffer
+    void release();
+
+    bool isBuilt() const { return built; }
+    int getGroupCount() const { return (int)groups.size(); }
+    int getVertexCount() const { return vertexCount; }
+
+private:
+    struct Vertex {
+        float position[3];
+        float normal[3];
+        float texCoord[2];
+        unsigned char color[4];
+    };
+
+    struct Group {
+        unsigned int texId;
+        bool lit;
+        std::vector<Vertex> vertices;   // Until build()
+        int first;
+        int count;
+    };
+
+    std::vector<Group> groups;
+    int currentGroup;
+    Vertex current;
+    RenderMatrix transform;
+    float normalMatrix[9];              // Inverse transpose of the upper 3x3
+    Primitive primitive;
+    std::vector<Vertex> pending;        // Vertices of the open begin/end
+
+    std::vector<Vertex> packed;         // Client-side copy when there are no VBOs
+    unsigned int vbo;
+    int vertexCount;
+    bool built;
+
+    void emit(const Vertex& v);
+    void triangle(float ax, float ay, float az, float bx, float by, float bz,
+                  float cx, float cy, float cz);
+};
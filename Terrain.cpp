@@ -0,0 +1,411 @@
+#include "Terrain.h"
+#include "glew.h"
+#include <math.h>
+#include <cstddef>
+#include <cstdio>
+#include <algorithm>
+
+static const float HILL_HEIGHT = 320.0f;
+static const float HILL_WAVELENGTH = 900.0f;
+static const int OCTAVES = 5;
+
+static int wrap(int value, int size) {
+    int r = value % size;
+    return r < 0 ? r + size : r;
+}
+
+// 0..1 at each integer lattice point
+static float lattice(int x, int z) {
+    unsigned int h = (unsigned int)x * 374761393u + (unsigned int)z * 668265263u;
+    h = (h ^ (h >> 13)) * 1274126177u;
+    h ^= h >> 16;
+    return (h & 0xFFFF) / 65535.0f;
+}
+
+static float valueNoise(float x, float z) {
+    float fx = floorf(x);
+    float fz = floorf(z);
+    int ix = (int)fx;
+    int iz = (int)fz;
+    float tx = x - fx;
+    float tz = z - fz;
+    tx = tx * tx * (3.0f - 2.0f * tx);
+    tz = tz * tz * (3.0f - 2.0f * tz);
+    float a = lattice(ix, iz) + (lattice(ix + 1, iz) - lattice(ix, iz)) * tx;
+    float b = lattice(ix, iz + 1) + (lattice(ix + 1, iz + 1) - lattice(ix, iz + 1)) * tx;
+    return a + (b - a) * tz;
+}
+
+Terrain::Terrain(float gridSpacing, int radiusChunks, float textureRepeat)
+    : spacing(gridSpacing), radius(radiusChunks), ringSize(2 * radiusChunks + 1), texScale(1.0f / textureRepeat),
+      vbo(0), ibo(0), allocated(false), triangleCount(0) {
+    for (int dz = -radius; dz <= radius; dz++) {
+        for (int dx = -radius; dx <= radius; dx++) {
+            if (dx * dx + dz * dz <= radius * radius) {
+                Offset offset = { dx, dz };
+                offsets.push_back(offset);
+            }
+        }
+    }
+    std::sort(offsets.begin(), offsets.end(), [](const Offset& a, const Offset& b) {
+        return a.dx * a.dx + a.dz * a.dz < b.dx * b.dx + b.dz * b.dz;
+    });
+    buildIndices();
+}
+
+Terrain::~Terrain() {
+    // Buffers are released explicitly (level cleanup) while the GL context is alive
+}
+
+void Terrain::addFlatZone(float x, float z, float zoneRadius, float ramp) {
+    FlatZone zone = { x, z, zoneRadius, ramp };
+    flatZones.push_back(zone);
+}
+
+float Terrain::sample(float x, float z) const {
+    // Fractal value noise; only the upper part of its range becomes hills,
+    // so there are stretches of open lowland between them
+    float n = 0.0f;
+    float amplitude = 0.5f;
+    float total = 0.0f;
+    float frequency = 1.0f / HILL_WAVELENGTH;
+    for (int i = 0; i < OCTAVES; i++) {
+        n += valueNoise(x * frequency + i * 17.3f, z * frequency - i * 9.1f) * amplitude;
+        total += amplitude;
+        amplitude *= 0.5f;
+        frequency *= 2.0f;
+    }
+    float t = std::max(0.0f, n / total - 0.3f) / 0.7f;
+    float height = HILL_HEIGHT * t * sqrtf(t);
+
+    for (const FlatZone& zone : flatZones) {
+        float dx = x - zone.x;
+        float dz = z - zone.z;
+        float m = (sqrtf(dx * dx + dz * dz) - zone.radius) / zone.ramp;
+        if (m <= 0.0f) return 0.0f;
+        if (m < 1.0f) height *= m * m * (3.0f - 2.0f * m);
+    }
+    return height;
+}
+
+float Terrain::gridHeight(int gridX, int gridZ) const {
+    return sample(gridX * spacing, gridZ * spacing);
+}
+
+float Terrain::getHeight(float x, float z) const {
+    float fx = x / spacing;
+    float fz = z / spacing;
+    int gx = (int)floorf(fx);
+    int gz = (int)floorf(fz);
+    float tx = fx - gx;
+    float tz = fz - gz;
+
+    // Each cell is split along the diagonal from (1, 0) to (0, 1)
+    if (tx + tz <= 1.0f) {
+        float h00 = gridHeight(gx, gz);
+        return h00 + (gridHeight(gx + 1, gz) - h00) * tx + (gridHeight(gx, gz + 1) - h00) * tz;
+    }
+    float h11 = gridHeight(gx + 1, gz + 1);
+    return h11 + (gridHeight(gx, gz + 1) - h11) * (1.0f - tx) + (gridHeight(gx + 1, gz) - h11) * (1.0f - tz);
+}
+
+Vector3f Terrain::getNormal(float x, float z) const {
+    float fx = x / spacing;
+    float fz = z / spacing;
+    int gx = (int)floorf(fx);
+    int gz = (int)floorf(fz);
+
+    float slopeX, slopeZ;
+    if ((fx - gx) + (fz - gz) <= 1.0f) {
+        float h00 = gridHeight(gx, gz);
+        slopeX = gridHeight(gx + 1, gz) - h00;
+        slopeZ = gridHeight(gx, gz + 1) - h00;
+    } else {
+        float h11 = gridHeight(gx + 1, gz + 1);
+        slopeX = h11 - gridHeight(gx, gz + 1);
+        slopeZ = h11 - gridHeight(gx + 1, gz);
+    }
+    return Vector3f(-slopeX, spacing, -slopeZ).unit();
+}
+
+void Terrain::buildIndices() {
+    indices.clear();
+    for (int level = 0; level < LEVELS; level++) {
+        int step = 1 << level;
+        for (int mask = 0; mask < 16; mask++) {
+            ranges[level][mask].first = (int)indices.size();
+
+            // Vertex index, with in-between vertices on an edge next to a
+            // coarser chunk moved back onto the coarse edge's previous vertex
+            auto index = [&](int i, int j) {
+                if ((mask & EDGE_NEAR_Z) && j == 0 && (i / step) % 2 == 1) i -= step;
+                if ((mask & EDGE_FAR_Z) && j == CHUNK_CELLS && (i / step) % 2 == 1) i -= step;
+                if ((mask & EDGE_NEAR_X) && i == 0 && (j / step) % 2 == 1) j -= step;
+                if ((mask & EDGE_FAR_X) && i == CHUNK_CELLS && (j / step) % 2 == 1) j -= step;
+                return (unsigned short)(j * CHUNK_VERTS + i);
+            };
+            auto triangle = [&](unsigned short a, unsigned short b, unsigned short c) {
+                if (a == b || b == c || a == c) return;     // Folded away at a seam
+                indices.push_back(a);
+                indices.push_back(b);
+                indices.push_back(c);
+            };
+
+            for (int j = 0; j < CHUNK_CELLS; j += step) {
+                for (int i = 0; i < CHUNK_CELLS; i += step) {
+                    unsigned short a = index(i, j);
+                    unsigned short b = index(i + step, j);
+                    unsigned short c = index(i, j + step);
+                    unsigned short d = index(i + step, j + step);
+                    triangle(a, b, c);
+                    triangle(b, d, c);
+                }
+            }
+            ranges[level][mask].count = (int)indices.size() - ranges[level][mask].first;
+        }
+    }
+}
+
+void Terrain::allocate() {
+    if (allocated) {
+        return;
+    }
+    Slot empty = { 0, 0, 0.0f, 0.0f, false };
+    slots.assign(ringSize * ringSize, empty);
+    size_t totalVertices = slots.size() * CHUNK_VERTS * CHUNK_VERTS;
+
+    if ((GLEW_VERSION_1_5 || GLEW_ARB_vertex_buffer_object) && glGenBuffers != NULL) {
+        glGenBuffers(1, &vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, totalVertices * sizeof(Vertex), NULL, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        glGenBuffers(1, &ibo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned short), &indices[0], GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    } else {
+        printf("Terrain: no buffer objects, drawing from client arrays\n");
+        clientVertices.resize(totalVertices);
+    }
+    allocated = true;
+
+    printf("Terrain: %d chunk slots of %.0f units, %.0f units out\n", (int)slots.size(), getChunkSize(),
+           getRange());
+}
+
+Terrain::Slot& Terrain::slotFor(int chunkX, int chunkZ) {
+    return slots[wrap(chunkZ, ringSize) * ringSize + wrap(chunkX, ringSize)];
+}
+
+void Terrain::generate(int chunkX, int chunkZ, Slot& slot) {
+    // Heights with a one-vertex border, for the normals at the edges
+    const int border = CHUNK_VERTS + 2;
+    float heights[border * border];
+    int baseX = chunkX * CHUNK_CELLS;
+    int baseZ = chunkZ * CHUNK_CELLS;
+    for (int j = 0; j < border; j++) {
+        for (int i = 0; i < border; i++) {
+            heights[j * border + i] = gridHeight(baseX + i - 1, baseZ + j - 1);
+        }
+    }
+
+    // Lighting is off for the ground, so slopes are shaded here; level
+    // ground keeps the texture's own color
+    const float light[3] = { 0.42f, 0.84f, 0.34f };
+    slot.minY = slot.maxY = heights[border + 1];
+    scratch.resize(CHUNK_VERTS * CHUNK_VERTS);
+    for (int j = 0; j < CHUNK_VERTS; j++) {
+        for (int i = 0; i < CHUNK_VERTS; i++) {
+            const float* h = &heights[(j + 1) * border + (i + 1)];
+            float x = (baseX + i) * spacing;
+            float z = (baseZ + j) * spacing;
+            float y = h[0];
+            slot.minY = std::min(slot.minY, y);
+            slot.maxY = std::max(slot.maxY, y);
+
+            float nx = h[-1] - h[1];
+            float nz = h[-border] - h[border];
+            float ny = 2.0f * spacing;
+            float shade = (nx * light[0] + ny * light[1] + nz * light[2]) / (sqrtf(nx * nx + ny * ny + nz * nz) * light[1]);
+            shade = std::max(0.45f, std::min(1.0f, shade));
+            unsigned char c = (unsigned char)(shade * 255.0f);
+
+            Vertex& vertex = scratch[j * CHUNK_VERTS + i];
+            vertex.position[0] = x;
+            vertex.position[1] = y;
+            vertex.position[2] = z;
+            vertex.texCoord[0] = x * texScale;
+            vertex.texCoord[1] = z * texScale;
+            vertex.color[0] = vertex.color[1] = vertex.color[2] = c;
+            vertex.color[3] = 255;
+        }
+    }
+
+    size_t first = (&slot - &slots[0]) * CHUNK_VERTS * CHUNK_VERTS;
+    if (vbo != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(Vertex), scratch.size() * sizeof(Vertex), &scratch[0]);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    } else {
+        std::copy(scratch.begin(), scratch.end(), clientVertices.begin() + first);
+    }
+
+    slot.chunkX = chunkX;
+    slot.chunkZ = chunkZ;
+    slot.resident = true;
+}
+
+void Terrain::update(float x, float z, int maxNewChunks) {
+    allocate();
+    float chunkSize = getChunkSize();
+    int camChunkX = (int)floorf(x / chunkSize);
+    int camChunkZ = (int)floorf(z / chunkSize);
+
+    // Without the chunk underneath (first frame, respawn) everything in
+    // range is generated at once rather than leaving holes for a while
+    const Slot& own = slotFor(camChunkX, camChunkZ);
+    bool jumped = !own.resident || own.chunkX != camChunkX || own.chunkZ != camChunkZ;
+    int budget = jumped ? (int)offsets.size() : maxNewChunks;
+    for (const Offset& offset : offsets) {
+        if (budget <= 0) break;
+        int chunkX = camChunkX + offset.dx;
+        int chunkZ = camChunkZ + offset.dz;
+        Slot& slot = slotFor(chunkX, chunkZ);
+        if (slot.resident && slot.chunkX == chunkX && slot.chunkZ == chunkZ) {
+            continue;
+        }
+        // The chunk that held the slot has left the range
+        generate(chunkX, chunkZ, slot);
+        budget--;
+    }
+}
+
+int Terrain::draw(const Frustum& frustum, const Vector3f& eye, bool shaded) {
+    triangleCount = 0;
+    if (!allocated) {
+        return 0;
+    }
+    float chunkSize = getChunkSize();
+    float half = chunkSize * 0.5f;
+    int camChunkX = (int)floorf(eye.x / chunkSize);
+    int camChunkZ = (int)floorf(eye.z / chunkSize);
+
+    // Level per ring position (relative to the camera's chunk, not the
+    // slot), -1 where no chunk is resident: one level per doubling of the
+    // distance past the first chunk size
+    levels.assign(ringSize * ringSize, -1);
+    for (const Offset& offset : offsets) {
+        int chunkX = camChunkX + offset.dx;
+        int chunkZ = camChunkZ + offset.dz;
+        const Slot& slot = slotFor(chunkX, chunkZ);
+        if (!slot.resident || slot.chunkX != chunkX || slot.chunkZ != chunkZ) continue;
+
+        float dx = (chunkX * chunkSize + half) - eye.x;
+        float dy = (slot.minY + slot.maxY) * 0.5f - eye.y;
+        float dz = (chunkZ * chunkSize + half) - eye.z;
+        float distance = sqrtf(dx * dx + dy * dy + dz * dz);
+        int level = 0;
+        for (float limit = chunkSize; distance >= limit && level < LEVELS - 1; limit *= 2.0f) {
+            level++;
+        }
+        levels[(offset.dz + radius) * ringSize + (offset.dx + radius)] = level;
+    }
+
+    // Seams are only stitched one level apart: pull any chunk more than
+    // one level coarser than a neighbour down until none is
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int j = 0; j < ringSize; j++) {
+            for (int i = 0; i < ringSize; i++) {
+                int& level = levels[j * ringSize + i];
+                if (level < 0) continue;
+                const int neighbours[4][2] = { { i - 1, j }, { i + 1, j }, { i, j - 1 }, { i, j + 1 } };
+                for (int n = 0; n < 4; n++) {
+                    int ni = neighbours[n][0];
+                    int nj = neighbours[n][1];
+                    if (ni < 0 || nj < 0 || ni >= ringSize || nj >= ringSize) continue;
+                    int other = levels[nj * ringSize + ni];
+                    if (other >= 0 && level > other + 1) {
+                        level = other + 1;
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+
+    if (vbo != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+    }
+    const unsigned short* indexBase = vbo != 0 ? NULL : &indices[0];
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    if (shaded) {
+        glEnableClientState(GL_COLOR_ARRAY);
+    }
+
+    int drawn = 0;
+    for (const Offset& offset : offsets) {
+        int i = offset.dx + radius;
+        int j = offset.dz + radius;
+        int level = levels[j * ringSize + i];
+        if (level < 0) continue;
+
+        int chunkX = camChunkX + offset.dx;
+        int chunkZ = camChunkZ + offset.dz;
+        const Slot& slot = slotFor(chunkX, chunkZ);
+        float centerY = (slot.minY + slot.maxY) * 0.5f;
+        float sphere = half * 1.4143f + (slot.maxY - slot.minY) * 0.5f;
+        if (!frustum.testSphere(chunkX * chunkSize + half, centerY, chunkZ * chunkSize + half, sphere)) continue;
+
+        auto coarser = [&](int ni, int nj) {
+            if (ni < 0 || nj < 0 || ni >= ringSize || nj >= ringSize) return false;
+            return levels[nj * ringSize + ni] == level + 1;
+        };
+        int mask = 0;
+        if (coarser(i, j - 1)) mask |= EDGE_NEAR_Z;
+        if (coarser(i + 1, j)) mask |= EDGE_FAR_X;
+        if (coarser(i, j + 1)) mask |= EDGE_FAR_Z;
+        if (coarser(i - 1, j)) mask |= EDGE_NEAR_X;
+        const IndexRange& range = ranges[level][mask];
+
+        size_t first = (&slot - &slots[0]) * CHUNK_VERTS * CHUNK_VERTS;
+        const char* base = vbo != 0 ? NULL : (const char*)&clientVertices[0];
+        base += first * sizeof(Vertex);
+        glVertexPointer(3, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, position));
+        glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, texCoord));
+        if (shaded) {
+            glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), base + offsetof(Vertex, color));
+        }
+        glDrawElements(GL_TRIANGLES, range.count, GL_UNSIGNED_SHORT, indexBase + range.first);
+        triangleCount += range.count / 3;
+        drawn++;
+    }
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    if (vbo != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+    return drawn;
+}
+
+void Terrain::release() {
+    if (vbo != 0) {
+        glDeleteBuffers(1, &vbo);
+        vbo = 0;
+    }
+    if (ibo != 0) {
+        glDeleteBuffers(1, &ibo);
+        ibo = 0;
+    }
+    slots.clear();
+    clientVertices.clear();
+    scratch.clear();
+    allocated = false;
+}
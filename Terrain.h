@@ -0,0 +1,116 @@
+#pragma once
+#include "Frustum.h"
+#include "Vector3f.h"
+#include <vector>
+
+// Terrain - procedural heightmap drawn as streamed, geomipmapped chunks
+// Level2's ground was one 4000x4000 quad glued under the player: flat,
+// endless and with nothing to hit. The ground is now a height function
+// (value-noise hills, held at zero inside flat zones where the level has
+// buildings) sampled on a grid and cut into square chunks of 32x32 cells.
+// Chunks stream in a ring around the player like GrassField's cells: each
+// owns a slot of one vertex buffer with its full-resolution grid, and
+// coarser levels only skip vertices through shared index lists, one per
+// level and per set of coarser neighbours. Neighbouring chunks are kept
+// within one level of each other, and a chunk next to a coarser one folds
+// its in-between edge vertices onto the coarse edge, so seams have no
+// cracks. getHeight() interpolates the grid the same way the finest level
+// triangulates it, so ground checks match what is drawn up close.
+class Terrain {
+public:
+    // Grid vertices spacing units apart, chunks streamed out to
+    // radiusChunks chunks from the player's; the ground texture repeats
+    // every textureRepeat units
+    Terrain(float spacing = 8.0f, int radiusChunks = 8, float textureRepeat = 50.0f);
+    ~Terrain();
+
+    Terrain(const Terrain&) = delete;
+    Terrain& operator=(const Terrain&) = delete;
+
+    // Keep the ground at zero within radius of (x, z), rising to full
+    // height over the next ramp units; applies to chunks generated after
+    void addFlatZone(float x, float z, float radius, float ramp);
+
+    // Ground height and upward normal at (x, z), as the finest level draws it
+    float getHeight(float x, float z) const;
+    Vector3f getNormal(float x, float z) const;
+
+    // Generate missing chunks around (x, z), at most maxNewChunks of them
+    // unless the chunk under (x, z) is missing too (needs a GL context)
+    void update(float x, float z, int maxNewChunks = 2);
+    // Draw the resident chunks that touch the frustum, each at the level its
+    // distance from eye calls for. The caller binds the texture; shaded
+    // modulates it by the baked slope shading. Returns the chunks drawn.
+    int draw(const Frustum& frustum, const Vector3f& eye, bool shaded = true);
+    // Drop the buffers and every chunk (flat zones are kept)
+    void release();
+
+    float getChunkSize() const { return spacing * CHUNK_CELLS; }
+    float getRange() const { return radius * getChunkSize(); }
+    int getTriangleCount() const { return triangleCount; }
+
+private:
+    static const int CHUNK_CELLS = 32;
+    static const int CHUNK_VERTS = CHUNK_CELLS + 1;
+    static const int LEVELS = 5;                    // Steps of 1, 2, 4, 8 and 16 cells
+
+    // Neighbour bits of an index list; set where that neighbour is one level coarser
+    enum {
+        EDGE_NEAR_Z = 1,
+        EDGE_FAR_X = 2,
+        EDGE_FAR_Z = 4,
+        EDGE_NEAR_X = 8
+    };
+
+    struct Vertex {
+        float position[3];
+        float texCoord[2];
+        unsigned char color[4];
+    };
+
+    struct Slot {
+        int chunkX, chunkZ;
+        float minY, maxY;
+        bool resident;
+    };
+
+    struct FlatZone {
+        float x, z;
+        float radius;
+        float ramp;
+    };
+
+    struct Offset {
+        int dx, dz;
+    };
+
+    struct IndexRange {
+        int first;
+        int count;
+    };
+
+    float spacing;
+    int radius;
+    int ringSize;                   // N = 2 * radius + 1
+    float texScale;
+    std::vector<Slot> slots;
+    std::vector<Offset> offsets;    // Chunks in range around the player's, nearest first
+    std::vector<FlatZone> flatZones;
+    std::vector<Vertex> clientVertices;     // Whole ring when there are no VBOs
+    std::vector<Vertex> scratch;            // One chunk, before upload
+    std::vector<unsigned short> indices;    // Every level and edge combination, back to back
+    IndexRange ranges[LEVELS][16];
+    std::vector<int> levels;        // Per ring position, while drawing
+    unsigned int vbo;
+    unsigned int ibo;
+    bool allocated;
+    int triangleCount;
+
+    // Height of the underlying function; vertices sample it at grid points
+    float sample(float x, float z) const;
+    float gridHeight(int gridX, int gridZ) const;
+    void allocate();
+    void buildIndices();
+    Slot& slotFor(int chunkX, int chunkZ);
+    void generate(int chunkX, int chunkZ, Slot& slot);
+};
@@ -0,0 +1,310 @@
+#include "TextRenderer.h"
+#include "glew.h"
+#include "GLState.h"
+#include <glut.h>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+
+// Empty pixels around each glyph so overhanging strokes aren't cut off
+static const int PADDING = 2;
+static const int ATLAS_WIDTH = 512;
+static const int FIRST_CHAR = 32;
+static const int LAST_CHAR = 126;
+
+TextRenderer::TextRenderer()
+    : queueCount(0), texture(0), atlasWidth(0), atlasHeight(0), tried(false), layoutCount(0) {
+    color[0] = color[1] = color[2] = color[3] = 255;
+
+    // The bitmap fonts the HUDs and menus use, with room for their descenders
+    struct { void* handle; int height; int descent; } used[] = {
+        { GLUT_BITMAP_HELVETICA_12, 16, 4 },
+        { GLUT_BITMAP_HELVETICA_18, 24, 6 },
+        { GLUT_BITMAP_TIMES_ROMAN_24, 32, 8 },
+    };
+    for (int i = 0; i < 3; i++) {
+        Font font;
+        memset(&font, 0, sizeof(font));
+        font.handle = used[i].handle;
+        font.height = used[i].height + 2 * PADDING;
+        font.descent = used[i].descent + PADDING;
+        fonts.push_back(font);
+    }
+}
+
+TextRenderer::~TextRenderer() {
+    // The GL context is gone by the time static destructors run
+}
+
+TextRenderer& TextRenderer::getInstance() {
+    static TextRenderer instance;
+    return instance;
+}
+
+void TextRenderer::prepare() {
+    if (tried) return;
+    tried = true;
+    if (bake()) {
+        // Anything laid out before has no quads
+        for (int i = 0; i < SCREEN_COUNT; i++) {
+            screens[i].clear();
+        }
+    }
+}
+
+void TextRenderer::release() {
+    if (texture != 0) {
+        GLState::deleteTextures(1, &texture);
+        texture = 0;
+    }
+    for (int i = 0; i < SCREEN_COUNT; i++) {
+        screens[i].clear();
+    }
+    queueCount = 0;
+    tried = false;
+}
+
+const TextRenderer::Font* TextRenderer::findFont(void* handle) const {
+    for (const Font& font : fonts) {
+        if (font.handle == handle) return &font;
+    }
+    return NULL;
+}
+
+bool TextRenderer::bake() {
+    // Rows of glyph cells, each font starting on a new row
+    int x = 0;
+    int y = 0;
+    int rowHeight = 0;
+    for (Font& font : fonts) {
+        if (x > 0) {
+            y += rowHeight;
+            x = 0;
+        }
+        rowHeight = font.height;
+        for (int c = FIRST_CHAR; c <= LAST_CHAR; c++) {
+            Glyph& glyph = font.glyphs[c - FIRST_CHAR];
+            glyph.advance = (short)glutBitmapWidth(font.handle, c);
+            glyph.width = (short)(glyph.advance + 2 * PADDING);
+            if (x + glyph.width > ATLAS_WIDTH) {
+                x = 0;
+                y += font.height;
+            }
+            glyph.x = (short)x;
+            glyph.y = (short)y;
+            x += glyph.width;
+        }
+    }
+    int usedHeight = y + fonts.back().height;
+
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    if (viewport[2] < ATLAS_WIDTH || viewport[3] < usedHeight) {
+        printf("TextRenderer: window smaller than the %dx%d atlas, drawing text as bitmaps\n",
+               ATLAS_WIDTH, usedHeight);
+        return false;
+    }
+
+    GLState::push(GL_CURRENT_BIT);
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    gluOrtho2D(0, viewport[2], 0, viewport[3]);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::disable(GL_TEXTURE_2D);
+    GLState::disable(GL_BLEND);
+    GLState::disable(GL_FOG);
+    GLState::disable(GL_ALPHA_TEST);
+
+    // Black background, white glyphs: the red channel becomes the alpha
+    glColor3f(0.0f, 0.0f, 0.0f);
+    glBegin(GL_QUADS);
+    glVertex2i(0, 0);
+    glVertex2i(ATLAS_WIDTH, 0);
+    glVertex2i(ATLAS_WIDTH, usedHeight);
+    glVertex2i(0, usedHeight);
+    glEnd();
+
+    glColor3f(1.0f, 1.0f, 1.0f);
+    for (const Font& font : fonts) {
+        for (int c = FIRST_CHAR; c <= LAST_CHAR; c++) {
+            const Glyph& glyph = font.glyphs[c - FIRST_CHAR];
+            glRasterPos2i(glyph.x + PADDING, glyph.y + font.descent);
+            glutBitmapCharacter(font.handle, c);
+        }
+    }
+
+    atlasWidth = ATLAS_WIDTH;
+    atlasHeight = 1;
+    while (atlasHeight < usedHeight) atlasHeight *= 2;
+    std::vector<unsigned char> pixels(atlasWidth * atlasHeight, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadBuffer(GL_BACK);
+    glReadPixels(viewport[0], viewport[1], atlasWidth, usedHeight, GL_RED, GL_UNSIGNED_BYTE, &pixels[0]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+    glPopMatrix();
+    GLState::pop();
+
+    glGenTextures(1, &texture);
+    GLState::bindTexture(texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, atlasWidth, atlasHeight, 0, GL_ALPHA, GL_UNSIGNED_BYTE, &pixels[0]);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    // Quads land on whole pixels, so texels map 1:1
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    printf("TextRenderer: %d fonts baked into a %dx%d atlas\n", (int)fonts.size(), atlasWidth, atlasHeight);
+    return true;
+}
+
+void TextRenderer::setColor(float r, float g, float b, float a) {
+    const float values[4] = { r, g, b, a };
+    for (int i = 0; i < 4; i++) {
+        float v = values[i] < 0.0f ? 0.0f : (values[i] > 1.0f ? 1.0f : values[i]);
+        color[i] = (unsigned char)(v * 255.0f + 0.5f);
+    }
+}
+
+void TextRenderer::add(float x, float y, const char* text, void* font) {
+    // Whole pixels, as glRasterPos would have rounded them
+    x = (float)(int)(x + 0.5f);
+    y = (float)(int)(y + 0.5f);
+
+    if (queueCount == (int)queue.size()) {
+        queue.push_back(Label());
+    }
+    Label& label = queue[queueCount++];
+    label.font = font;
+    label.x = x;
+    label.y = y;
+    memcpy(label.color, color, 4);
+    label.text = text;
+}
+
+void TextRenderer::layout(Label& label) {
+    layoutCount++;
+    label.vertices.clear();
+    const Font* font = findFont(label.font);
+    if (font == NULL || texture == 0) {
+        return;
+    }
+
+    float invWidth = 1.0f / atlasWidth;
+    float invHeight = 1.0f / atlasHeight;
+    float pen = label.x;
+    for (const char* c = label.text.c_str(); *c != '\0'; c++) {
+        int index = (unsigned char)*c - FIRST_CHAR;
+        if (index < 0 || index > LAST_CHAR - FIRST_CHAR) {
+            continue;
+        }
+        const Glyph& glyph = font->glyphs[index];
+        if (*c != ' ') {
+            float x0 = pen - PADDING;
+            float y0 = label.y - font->descent;
+            float x1 = x0 + glyph.width;
+            float y1 = y0 + font->height;
+            float u0 = glyph.x * invWidth;
+            float v0 = glyph.y * invHeight;
+            float u1 = (glyph.x + glyph.width) * invWidth;
+            float v1 = (glyph.y + font->height) * invHeight;
+
+            const float corners[4][4] = {
+                { x0, y0, u0, v0 }, { x1, y0, u1, v0 }, { x1, y1, u1, v1 }, { x0, y1, u0, v1 }
+            };
+            for (int i = 0; i < 4; i++) {
+                Vertex vertex;
+                vertex.position[0] = corners[i][0];
+                vertex.position[1] = corners[i][1];
+                vertex.texCoord[0] = corners[i][2];
+                vertex.texCoord[1] = corners[i][3];
+                memcpy(vertex.color, label.color, 4);
+                label.vertices.push_back(vertex);
+            }
+        }
+        pen += glyph.advance;
+    }
+}
+
+void TextRenderer::drawBitmaps(const std::vector<Label>& labels, int count) const {
+    for (int i = 0; i < count; i++) {
+        const Label& label = labels[i];
+        if (texture != 0 && findFont(label.font) != NULL) continue;
+        glColor4ubv(label.color);
+        glRasterPos2f(label.x, label.y);
+        for (const char* c = label.text.c_str(); *c != '\0'; c++) {
+            glutBitmapCharacter(label.font, *c);
+        }
+    }
+}
+
+void TextRenderer::flush(Screen screen) {
+    if (queueCount == 0) return;
+
+    // Match the queue against this screen's labels from last frame, slot by slot
+    std::vector<Label>& labels = screens[screen];
+    while ((int)labels.size() < queueCount) {
+        labels.push_back(Label());
+        labels.back().font = NULL;
+    }
+
+    vertices.clear();
+    for (int i = 0; i < queueCount; i++) {
+        const Label& queued = queue[i];
+        Label& label = labels[i];
+        if (label.font != queued.font || label.x != queued.x || label.y != queued.y ||
+            memcmp(label.color, queued.color, 4) != 0 || label.text != queued.text) {
+            label.font = queued.font;
+            label.x = queued.x;
+            label.y = queued.y;
+            memcpy(label.color, queued.color, 4);
+            label.text = queued.text;
+            layout(label);
+        }
+        vertices.insert(vertices.end(), label.vertices.begin(), label.vertices.end());
+    }
+
+    GLState::push(GL_CURRENT_BIT);
+    GLState::disable(GL_LIGHTING);
+    GLState::disable(GL_DEPTH_TEST);
+    GLState::disable(GL_FOG);
+    GLState::enable(GL_BLEND);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    if (!vertices.empty()) {
+        GLState::enable(GL_TEXTURE_2D);
+        GLState::bindTexture(texture);
+        glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+
+        const char* base = (const char*)&vertices[0];
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+        glVertexPointer(2, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, position));
+        glTexCoordPointer(2, GL_FLOAT, sizeof(Vertex), base + offsetof(Vertex, texCoord));
+        glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(Vertex), base + offsetof(Vertex, color));
+
+        glDrawArrays(GL_QUADS, 0, (GLsizei)vertices.size());
+
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+    }
+
+    GLState::disable(GL_TEXTURE_2D);
+    drawBitmaps(labels, queueCount);
+    GLState::pop();
+
+    queueCount = 0;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Text Renderer - HUD and menu text drawn from a baked glyph atlas
+// Every HUD string went out character by character through glRasterPos and
+// glutBitmapCharacter, one of the slowest paths in legacy GL, dozens of
+// times per frame. On the first frame the GLUT bitmap fonts the game uses
+// are drawn once into the back buffer and read back into an alpha texture.
+// add() queues a string and flush() draws everything queued as one vertex
+// array. Each flush site names its screen, which keeps the laid-out quads
+// of its strings from last frame; a string is only laid out again when its
+// font, text, position or color changed at that place in the screen. Until
+// the atlas exists (or when the window is too small to bake it, or for a
+// font that isn't in it) the queued strings are drawn as bitmaps instead.
+class TextRenderer {
+public:
+    // Flush sites; screens drawn in the same frame keep separate caches
+    enum Screen {
+        SCREEN_GAUGES,          // HUDRenderer's flight instruments
+        SCREEN_HUD,             // A level's own HUD
+        SCREEN_GAME_OVER,
+        SCREEN_LEVEL_COMPLETE,
+        SCREEN_MENU,
+        SCREEN_MENU_PANEL,
+        SCREEN_OPTIONS,
+        SCREEN_COUNT
+    };
+
+    // Singleton pattern (same as GameManager)
+    static TextRenderer& getInstance();
+
+    TextRenderer(const TextRenderer&) = delete;
+    TextRenderer& operator=(const TextRenderer&) = delete;
+
+    // Bake the atlas unless that was already tried. Needs a GL context and
+    // draws over the back buffer, so call it before the frame is drawn.
+    void prepare();
+    void release();
+
+    // Color of the strings added after this call
+    void setColor(float r, float g, float b, float a = 1.0f);
+    // Queue text whose baseline starts at (x, y) in window pixels (the 2D
+    // projection the HUDs set up); font is a GLUT bitmap font
+    void add(float x, float y, const char* text, void* font);
+    // Draw the queue on top of the current 2D projection and empty it,
+    // reusing what this screen laid out last frame
+    void flush(Screen screen);
+
+    bool isBaked() const { return texture != 0; }
+    // Strings laid out again since the start, for checking the cache works
+    int getLayoutCount() const { return layoutCount; }
+
+private:
+    TextRenderer();
+    ~TextRenderer();
+
+    struct Vertex {
+        float position[2];
+        float texCoord[2];
+        unsigned char color[4];
+    };
+
+    // A character's cell in the atlas; the pen sits PADDING pixels in from
+    // the left and descent pixels up from the bottom
+    struct Glyph {
+        short x;
+        short y;
+        short width;
+        short advance;
+    };
+
+    struct Font {
+        void* handle;
+        int height;
+        int descent;
+        Glyph glyphs[95];       // ' ' to '~'
+    };
+
+    struct Label {
+        void* font;
+        float x;
+        float y;
+        unsigned char color[4];
+        std::string text;
+        std::vector<Vertex> vertices;
+    };
+
+    std::vector<Font> fonts;
+    std::vector<Label> queue;       // Slots reused across frames; the first queueCount are queued
+    int queueCount;
+    std::vector<Label> screens[SCREEN_COUNT];   // Laid-out labels of each screen, by queue position
+    std::vector<Vertex> vertices;   // Scratch: all queued labels back to back
+    unsigned char color[4];
+    unsigned int texture;
+    int atlasWidth;
+    int atlasHeight;
+    bool tried;
+    int layoutCount;
+
+    const Font* findFont(void* handle) const;
+    bool bake();
+    void layout(Label& label);
+    void drawBitmaps(const std::vector<Label>& labels, int count) const;
+};
@@ -0,0 +1,421 @@
+#include "TextureBaker.h"
+#include "MipBuilder.h"
+#include "WorkerPool.h"
+#include <stdio.h>
+#include <cstring>
+#include <direct.h>
+
+// DDS header constants (only what DXT1/DXT5 files need)
+static const unsigned int DDS_MAGIC = 0x20534444;           // "DDS "
+static const unsigned int DDSD_CAPS = 0x1;
+static const unsigned int DDSD_HEIGHT = 0x2;
+static const unsigned int DDSD_WIDTH = 0x4;
+static const unsigned int DDSD_PIXELFORMAT = 0x1000;
+static const unsigned int DDSD_MIPMAPCOUNT = 0x20000;
+static const unsigned int DDSD_LINEARSIZE = 0x80000;
+static const unsigned int DDPF_FOURCC = 0x4;
+static const unsigned int DDSCAPS_COMPLEX = 0x8;
+static const unsigned int DDSCAPS_TEXTURE = 0x1000;
+static const unsigned int DDSCAPS_MIPMAP = 0x400000;
+static const unsigned int FOURCC_DXT1 = 0x31545844;         // "DXT1"
+static const unsigned int FOURCC_DXT5 = 0x35545844;         // "DXT5"
+static const int DDS_HEADER_DWORDS = 31;                    // 124 bytes
+
+// Largest baked level; what every S3TC-capable driver accepts
+static const int MAX_BAKED_SIZE = 4096;
+
+std::string TextureBaker::getBakedPath(const std::string& sourcePath, unsigned long long contentHash, unsigned int flags) {
+    size_t slash = sourcePath.find_last_of("/\\");
+    std::string folder = (slash == std::string::npos) ? std::string() : sourcePath.substr(0, slash + 1);
+
+    // Only flags that change the decoded pixels matter; sampler state is set at upload
+    char name[64];
+    sprintf_s(name, sizeof(name), "baked/%016llx_%02x.dds", contentHash, flags & TEX_DECODE_FLAGS);
+    return folder + name;
+}
+
+size_t TextureBaker::getLevelSize(int width, int height, bool hasAlpha) {
+    size_t blocksX = (size_t)((width + 3) / 4);
+    size_t blocksY = (size_t)((height + 3) / 4);
+    return blocksX * blocksY * (hasAlpha ? 16 : 8);
+}
+
+//=======================================================================
+// BC1 / BC3 blocks
+//=======================================================================
+
+static unsigned short packColor565(const unsigned char* rgb) {
+    return (unsigned short)(((rgb[0] >> 3) << 11) | ((rgb[1] >> 2) << 5) | (rgb[2] >> 3));
+}
+
+static void unpackColor565(unsigned short color, unsigned char* rgb) {
+    unsigned char r = (color >> 11) & 0x1F;
+    unsigned char g = (color >> 5) & 0x3F;
+    unsigned char b = color & 0x1F;
+    rgb[0] = (r << 3) | (r >> 2);
+    rgb[1] = (g << 2) | (g >> 4);
+    rgb[2] = (b << 3) | (b >> 2);
+}
+
+// Bounding box endpoints, inset by 1/16 of the range to cut the error at the extremes
+void TextureBaker::encodeColorBlock(const unsigned char block[64], unsigned char* out) {
+    unsigned char minColor[3] = { 255, 255, 255 };
+    unsigned char maxColor[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; i++) {
+        for (int ch = 0; ch < 3; ch++) {
+            unsigned char v = block[i * 4 + ch];
+            if (v < minColor[ch]) minColor[ch] = v;
+            if (v > maxColor[ch]) maxColor[ch] = v;
+        }
+    }
+    for (int ch = 0; ch < 3; ch++) {
+        int inset = (maxColor[ch] - minColor[ch]) >> 4;
+        minColor[ch] = (unsigned char)(minColor[ch] + inset);
+        maxColor[ch] = (unsigned char)(maxColor[ch] - inset);
+    }
+
+    unsigned short c0 = packColor565(maxColor);
+    unsigned short c1 = packColor565(minColor);
+    if (c0 < c1) {
+        unsigned short t = c0; c0 = c1; c1 = t;
+    }
+
+    out[0] = (unsigned char)(c0 & 0xFF);
+    out[1] = (unsigned char)(c0 >> 8);
+    out[2] = (unsigned char)(c1 & 0xFF);
+    out[3] = (unsigned char)(c1 >> 8);
+
+    unsigned int indices = 0;
+    if (c0 != c1) {
+        // Four color mode (c0 > c1): c0, c1, 2/3 c0 + 1/3 c1, 1/3 c0 + 2/3 c1
+        unsigned char palette[4][3];
+        unpackColor565(c0, palette[0]);
+        unpackColor565(c1, palette[1]);
+        for (int ch = 0; ch < 3; ch++) {
+            palette[2][ch] = (unsigned char)((2 * palette[0][ch] + palette[1][ch]) / 3);
+            palette[3][ch] = (unsigned char)((palette[0][ch] + 2 * palette[1][ch]) / 3);
+        }
+
+        for (int i = 0; i < 16; i++) {
+            const unsigned char* p = &block[i * 4];
+            int best = 0;
+            int bestDist = 0x7FFFFFFF;
+            for (int j = 0; j < 4; j++) {
+                int dr = p[0] - palette[j][0];
+                int dg = p[1] - palette[j][1];
+                int db = p[2] - palette[j][2];
+                int dist = dr * dr + dg * dg + db * db;
+                if (dist < bestDist) {
+                    bestDist = dist;
+                    best = j;
+                }
+            }
+            indices |= (unsigned int)best << (i * 2);
+        }
+    }
+    // c0 == c1: every index 0 is the exact color
+
+    out[4] = (unsigned char)(indices & 0xFF);
+    out[5] = (unsigned char)((indices >> 8) & 0xFF);
+    out[6] = (unsigned char)((indices >> 16) & 0xFF);
+    out[7] = (unsigned char)(indices >> 24);
+}
+
+void TextureBaker::encodeAlphaBlock(const unsigned char block[64], unsigned char* out) {
+    unsigned char minAlpha = 255;
+    unsigned char maxAlpha = 0;
+    for (int i = 0; i < 16; i++) {
+        unsigned char a = block[i * 4 + 3];
+        if (a < minAlpha) minAlpha = a;
+        if (a > maxAlpha) maxAlpha = a;
+    }
+
+    out[0] = maxAlpha;
+    out[1] = minAlpha;
+
+    unsigned long long indices = 0;
+    if (maxAlpha != minAlpha) {
+        // Eight alpha mode (a0 > a1)
+        int palette[8];
+        palette[0] = maxAlpha;
+        palette[1] = minAlpha;
+        for (int j = 1; j < 7; j++) {
+            palette[j + 1] = ((7 - j) * maxAlpha + j * minAlpha) / 7;
+        }
+
+        for (int i = 0; i < 16; i++) {
+            int a = block[i * 4 + 3];
+            int best = 0;
+            int bestDist = 256;
+            for (int j = 0; j < 8; j++) {
+                int dist = a > palette[j] ? a - palette[j] : palette[j] - a;
+                if (dist < bestDist) {
+                    bestDist = dist;
+                    best = j;
+                }
+            }
+            indices |= (unsigned long long)best << (i * 3);
+        }
+    }
+
+    for (int i = 0; i < 6; i++) {
+        out[2 + i] = (unsigned char)((indices >> (i * 8)) & 0xFF);
+    }
+}
+
+void TextureBaker::decodeColorBlock(const unsigned char* in, bool forceFourColor, unsigned char block[64]) {
+    unsigned short c0 = (unsigned short)(in[0] | (in[1] << 8));
+    unsigned short c1 = (unsigned short)(in[2] | (in[3] << 8));
+    unsigned int indices = in[4] | (in[5] << 8) | (in[6] << 16) | ((unsigned int)in[7] << 24);
+
+    unsigned char palette[4][4];
+    unpackColor565(c0, palette[0]);
+    unpackColor565(c1, palette[1]);
+    palette[0][3] = palette[1][3] = 255;
+    palette[2][3] = palette[3][3] = 255;
+
+    if (c0 > c1 || forceFourColor) {
+        for (int ch = 0; ch < 3; ch++) {
+            palette[2][ch] = (unsigned char)((2 * palette[0][ch] + palette[1][ch]) / 3);
+            palette[3][ch] = (unsigned char)((palette[0][ch] + 2 * palette[1][ch]) / 3);
+        }
+    } else {
+        // Three color mode: midpoint and transparent black
+        for (int ch = 0; ch < 3; ch++) {
+            palette[2][ch] = (unsigned char)((palette[0][ch] + palette[1][ch]) / 2);
+            palette[3][ch] = 0;
+        }
+        palette[3][3] = 0;
+    }
+
+    for (int i = 0; i < 16; i++) {
+        int index = (indices >> (i * 2)) & 3;
+        memcpy(&block[i * 4], palette[index], 4);
+    }
+}
+
+void TextureBaker::decodeAlphaBlock(const unsigned char* in, unsigned char block[64]) {
+    int palette[8];
+    palette[0] = in[0];
+    palette[1] = in[1];
+    if (palette[0] > palette[1]) {
+        for (int j = 1; j < 7; j++) {
+            palette[j + 1] = ((7 - j) * palette[0] + j * palette[1]) / 7;
+        }
+    } else {
+        for (int j = 1; j < 5; j++) {
+            palette[j + 1] = ((5 - j) * palette[0] + j * palette[1]) / 5;
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    unsigned long long indices = 0;
+    for (int i = 0; i < 6; i++) {
+        indices |= (unsigned long long)in[2 + i] << (i * 8);
+    }
+    for (int i = 0; i < 16; i++) {
+        block[i * 4 + 3] = (unsigned char)palette[(indices >> (i * 3)) & 7];
+    }
+}
+
+//=======================================================================
+// Baking
+//=======================================================================
+
+void TextureBaker::bake(const ImageData& image, unsigned int flags, BakedTexture& out) {
+    // Bakes are offline, so they get the sharper Kaiser filter
+    MipOptions options;
+    options.filter = MIP_FILTER_KAISER;
+    options.wrapS = (flags & TEX_CLAMP) == 0;
+    options.wrapT = (flags & (TEX_CLAMP | TEX_CLAMP_T)) == 0;
+    options.powerOfTwo = true;
+    options.maxSize = MAX_BAKED_SIZE;
+
+    std::vector<ImageData> chain;
+    MipBuilder::buildChain(image, options, chain);
+
+    out.hasAlpha = false;
+    out.levels.clear();
+    if (chain.empty()) {
+        return;
+    }
+    if (chain[0].channels == 4) {
+        const std::vector<unsigned char>& pixels = chain[0].pixels;
+        for (size_t i = 3; i < pixels.size(); i += 4) {
+            if (pixels[i] != 255) {
+                out.hasAlpha = true;
+                break;
+            }
+        }
+    }
+
+    out.levels.resize(chain.size());
+    for (size_t i = 0; i < chain.size(); i++) {
+        encodeLevel(chain[i], out.hasAlpha, out.levels[i]);
+    }
+}
+
+// Rows of blocks are independent, so they are compressed on the WorkerPool
+void TextureBaker::encodeLevel(const ImageData& level, bool hasAlpha, BakedLevel& out) {
+    out.width = level.width;
+    out.height = level.height;
+    out.data.resize(getLevelSize(level.width, level.height, hasAlpha));
+
+    int c = level.channels;
+    int blocksX = (level.width + 3) / 4;
+    int blocksY = (level.height + 3) / 4;
+    size_t blockBytes = hasAlpha ? 16 : 8;
+
+    WorkerPool::getInstance().parallelFor(blocksY, 4, [&](int begin, int end) {
+        unsigned char block[64];
+        for (int blockY = begin; blockY < end; blockY++) {
+            unsigned char* dest = &out.data[(size_t)blockY * blocksX * blockBytes];
+            for (int blockX = 0; blockX < blocksX; blockX++) {
+                // Gather the 4x4 block as RGBA, repeating edge pixels for 1x1 and 2x2 levels
+                for (int py = 0; py < 4; py++) {
+                    int y = blockY * 4 + py < level.height ? blockY * 4 + py : level.height - 1;
+                    for (int px = 0; px < 4; px++) {
+                        int x = blockX * 4 + px < level.width ? blockX * 4 + px : level.width - 1;
+                        const unsigned char* src = &level.pixels[((size_t)y * level.width + x) * c];
+                        unsigned char* texel = &block[(py * 4 + px) * 4];
+                        texel[0] = src[0];
+                        texel[1] = src[1];
+                        texel[2] = src[2];
+                        texel[3] = c == 4 ? src[3] : 255;
+                    }
+                }
+
+                if (hasAlpha) {
+                    encodeAlphaBlock(block, dest);
+                    dest += 8;
+                }
+                encodeColorBlock(block, dest);
+                dest += 8;
+            }
+        }
+    });
+}
+
+void TextureBaker::decompressLevel(const BakedLevel& level, bool hasAlpha, std::vector<unsigned char>& rgba) {
+    rgba.assign((size_t)level.width * level.height * 4, 255);
+    const unsigned char* src = &level.data[0];
+    unsigned char block[64];
+
+    for (int by = 0; by < level.height; by += 4) {
+        for (int bx = 0; bx < level.width; bx += 4) {
+            if (hasAlpha) {
+                decodeColorBlock(src + 8, true, block);
+                decodeAlphaBlock(src, block);
+                src += 16;
+            } else {
+                decodeColorBlock(src, false, block);
+                src += 8;
+            }
+
+            for (int py = 0; py < 4 && by + py < level.height; py++) {
+                for (int px = 0; px < 4 && bx + px < level.width; px++) {
+                    memcpy(&rgba[((size_t)(by + py) * level.width + bx + px) * 4], &block[(py * 4 + px) * 4], 4);
+                }
+            }
+        }
+    }
+}
+
+//=======================================================================
+// DDS container
+//=======================================================================
+
+bool TextureBaker::save(const char* path, const BakedTexture& texture) {
+    if (texture.levels.empty()) {
+        return false;
+    }
+
+    // Make sure the "baked" folder exists (fails harmlessly if it already does)
+    std::string folder(path);
+    size_t slash = folder.find_last_of("/\\");
+    if (slash != std::string::npos) {
+        folder.resize(slash);
+        _mkdir(folder.c_str());
+    }
+
+    FILE* file = NULL;
+    fopen_s(&file, path, "wb");
+    if (!file) {
+        printf("TextureBaker: Cannot write %s\n", path);
+        return false;
+    }
+
+    const BakedLevel& top = texture.levels[0];
+    unsigned int header[DDS_HEADER_DWORDS];
+    memset(header, 0, sizeof(header));
+    header[0] = 124;
+    header[1] = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+    header[2] = top.height;
+    header[3] = top.width;
+    header[4] = (unsigned int)top.data.size();
+    header[6] = (unsigned int)texture.levels.size();
+    header[18] = 32;                                            // Pixel format size
+    header[19] = DDPF_FOURCC;
+    header[20] = texture.hasAlpha ? FOURCC_DXT5 : FOURCC_DXT1;
+    header[26] = DDSCAPS_TEXTURE | DDSCAPS_MIPMAP | DDSCAPS_COMPLEX;
+
+    bool ok = fwrite(&DDS_MAGIC, 4, 1, file) == 1 &&
+              fwrite(header, sizeof(header), 1, file) == 1;
+    for (size_t i = 0; ok && i < texture.levels.size(); i++) {
+        const std::vector<unsigned char>& data = texture.levels[i].data;
+        ok = fwrite(&data[0], 1, data.size(), file) == data.size();
+    }
+    fclose(file);
+    return ok;
+}
+
+bool TextureBaker::load(const char* path, BakedTexture& out) {
+    std::vector<unsigned char> bytes;
+    if (!TextureManager::readFile(path, bytes)) {
+        return false;
+    }
+    if (bytes.size() < 4 + DDS_HEADER_DWORDS * 4) {
+        return false;
+    }
+
+    unsigned int magic;
+    unsigned int header[DDS_HEADER_DWORDS];
+    memcpy(&magic, &bytes[0], 4);
+    memcpy(header, &bytes[4], sizeof(header));
+    if (magic != DDS_MAGIC || header[0] != 124 || !(header[19] & DDPF_FOURCC)) {
+        return false;
+    }
+    if (header[20] != FOURCC_DXT1 && header[20] != FOURCC_DXT5) {
+        printf("TextureBaker: %s is not DXT1/DXT5\n", path);
+        return false;
+    }
+
+    int width = (int)header[3];
+    int height = (int)header[2];
+    int levelCount = (header[1] & DDSD_MIPMAPCOUNT) && header[6] > 0 ? (int)header[6] : 1;
+    if (width <= 0 || height <= 0 || levelCount > 16) {
+        return false;
+    }
+
+    out.hasAlpha = header[20] == FOURCC_DXT5;
+    out.levels.clear();
+
+    size_t offset = 4 + sizeof(header);
+    for (int i = 0; i < levelCount; i++) {
+        BakedLevel level;
+        level.width = width;
+        level.height = height;
+        size_t size = getLevelSize(width, height, out.hasAlpha);
+        if (offset + size > bytes.size()) {
+            return false;
+        }
+        level.data.assign(bytes.begin() + offset, bytes.begin() + offset + size);
+        out.levels.push_back(level);
+        offset += size;
+
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    return true;
+}
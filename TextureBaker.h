@@ -0,0 +1,53 @@
+#pragma once
+#include "TextureManager.h"
+#include <string>
+#include <vector>
+
+// One level of a baked texture
+struct BakedLevel {
+    int width;
+    int height;
+    std::vector<unsigned char> data;    // BC1/BC3 blocks
+};
+
+// A baked texture as stored on disk: a BC1 (opaque) or BC3 (alpha)
+// compressed, pre-filtered mip chain in a standard DDS container
+struct BakedTexture {
+    bool hasAlpha = false;              // BC3 when true, BC1 otherwise
+    std::vector<BakedLevel> levels;     // Level 0 first, down to 1x1
+};
+
+// Texture Baker - offline compression of source images
+// gluBuild2DMipmaps rescales, filters and uploads uncompressed RGB every launch.
+// Running the game with --bake-textures writes every texture it loads to
+// "<source folder>/baked/<content hash>_<flags>.dds". Later launches upload
+// those levels directly with glCompressedTexImage2D (4:1 to 8:1 smaller in
+// VRAM), or decompress them on the CPU when S3TC isn't supported.
+// Baked files are named by content hash, so an edited source image simply
+// stops matching its old bake.
+class TextureBaker {
+public:
+    // Where the bake for a source image lives
+    static std::string getBakedPath(const std::string& sourcePath, unsigned long long contentHash, unsigned int flags);
+
+    // Resize to a power of two, build the mip chain and compress it.
+    // Flags pick clamp or wrap at the edges for the mip filter.
+    static void bake(const ImageData& image, unsigned int flags, BakedTexture& out);
+
+    // DDS container I/O (DXT1 / DXT5 only)
+    static bool save(const char* path, const BakedTexture& texture);
+    static bool load(const char* path, BakedTexture& out);
+
+    // Decompress a level to tightly packed RGBA (no S3TC support)
+    static void decompressLevel(const BakedLevel& level, bool hasAlpha, std::vector<unsigned char>& rgba);
+
+    static size_t getLevelSize(int width, int height, bool hasAlpha);
+
+private:
+    static void encodeLevel(const ImageData& level, bool hasAlpha, BakedLevel& out);
+
+    static void encodeColorBlock(const unsigned char block[64], unsigned char* out);
+    static void encodeAlphaBlock(const unsigned char block[64], unsigned char* out);
+    static void decodeColorBlock(const unsigned char* in, bool forceFourColor, unsigned char block[64]);
+    static void decodeAlphaBlock(const unsigned char* in, unsigned char block[64]);
+};
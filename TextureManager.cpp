@@ -0,0 +1,1081 @@
+#include "TextureManager.h"
+#include "TextureBaker.h"
+#include "MipBuilder.h"
+#include "TextureStreamer.h"
+#include "PNGDecoder.h"
+#include "WorkerPool.h"
+#include "glew.h"
+#include "GLState.h"
+#include <glut.h>
+#include <stdio.h>
+#include <cstring>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+// Default VRAM budget. Integrated GPUs share system memory, and textures
+// are the first thing to run out there.
+static const size_t DEFAULT_BUDGET = 256 * 1024 * 1024;
+// Smaller textures aren't worth a frame of placeholder
+static const size_t STREAM_MIN_BYTES = 64 * 1024;
+// TEX_STREAM_MIPS textures keep levels up to this size resident at all times
+static const int MIP_TAIL_SIZE = 64;
+// Frames a streamed texture must want less detail before its top mips are dropped
+static const int MIP_DROP_FRAMES = 120;
+
+TextureManager::TextureManager()
+    : bakeMode(false), decodeCount(0), bakedLoads(0), bakesWritten(0), pathHits(0), contentHits(0),
+      scopeTick(0), budget(DEFAULT_BUDGET), evictions(0), reloads(0), streaming(false),
+      viewportHeight(720), fovY(45.0f), mipLoads(0), mipDrops(0) {
+}
+
+TextureManager::~TextureManager() {
+    // The GL context is gone by the time static destructors run,
+    // so only the bookkeeping is dropped here
+    entries.clear();
+    pathIndex.clear();
+    contentIndex.clear();
+}
+
+TextureManager& TextureManager::getInstance() {
+    static TextureManager instance;
+    return instance;
+}
+
+std::string TextureManager::makePathKey(const char* path, unsigned int flags) {
+    char suffix[16];
+    sprintf_s(suffix, sizeof(suffix), "|%u", flags);
+    return std::string(path) + suffix;
+}
+
+bool TextureManager::readFile(const char* path, std::vector<unsigned char>& out) {
+    FILE* file = NULL;
+    fopen_s(&file, path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size <= 0) {
+        fclose(file);
+        return false;
+    }
+
+    out.resize((size_t)size);
+    size_t bytesRead = fread(&out[0], 1, (size_t)size, file);
+    fclose(file);
+    out.resize(bytesRead);
+    return bytesRead > 0;
+}
+
+bool TextureManager::resolvePath(const char* path, std::string& resolved, std::vector<unsigned char>& bytes) {
+    const char* prefixes[] = { "", "../", "../../" };
+    char fullPath[260];
+    for (int i = 0; i < 3; ++i) {
+        sprintf_s(fullPath, sizeof(fullPath), "%s%s", prefixes[i], path);
+        if (readFile(fullPath, bytes)) {
+            resolved = fullPath;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 64-bit FNV-1a over the whole file
+unsigned long long TextureManager::hashBytes(const unsigned char* bytes, size_t size) {
+    unsigned long long hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Handles 8-bit paletted, 16-bit 565, 24-bit and 32-bit BMPs (including V4/V5 headers).
+// Rows come out top row first unless TEX_FLIP_VERTICAL is set.
+bool TextureManager::decodeBMP(const unsigned char* bytes, size_t size, unsigned int flags, ImageData& out) {
+    if (size < 54 || bytes[0] != 'B' || bytes[1] != 'M') {
+        return false;
+    }
+
+    int dataOffset = *(const int*)&bytes[10];
+    int headerSize = *(const int*)&bytes[14];  // DIB header size
+    int width = *(const int*)&bytes[18];
+    int height = *(const int*)&bytes[22];
+    int bitsPerPixel = *(const short*)&bytes[28];
+
+    if (width <= 0 || height == 0 || width > 16384) {
+        return false;
+    }
+
+    // Negative height means a top-down bitmap
+    bool topDown = height < 0;
+    if (topDown) height = -height;
+
+    int rowSize = ((width * bitsPerPixel + 31) / 32) * 4;
+    if (bitsPerPixel != 8 && bitsPerPixel != 16 && bitsPerPixel != 24 && bitsPerPixel != 32) {
+        return false;
+    }
+    if (dataOffset <= 0 || (size_t)dataOffset >= size) {
+        return false;
+    }
+
+    // Some exporters write short files; missing rows read as black like the old loaders did
+    std::vector<unsigned char> pixelData((size_t)rowSize * height, 0);
+    size_t available = size - (size_t)dataOffset;
+    if (available > pixelData.size()) available = pixelData.size();
+    memcpy(&pixelData[0], bytes + dataOffset, available);
+
+    const unsigned char* palette = NULL;
+    if (bitsPerPixel == 8) {
+        // Palette sits right after the DIB header (14 = BMP file header size)
+        size_t paletteOffset = 14 + (size_t)headerSize;
+        if (paletteOffset + 1024 > size) {
+            return false;
+        }
+        palette = bytes + paletteOffset;
+    }
+
+    bool keepAlpha = (flags & TEX_ALPHA) != 0;
+    bool brightnessAlpha = (flags & TEX_BRIGHTNESS_ALPHA) != 0;
+    bool flipVertical = (flags & TEX_FLIP_VERTICAL) != 0;
+
+    out.width = width;
+    out.height = height;
+    out.channels = (bitsPerPixel == 32 || brightnessAlpha) ? 4 : 3;
+    out.pixels.assign((size_t)width * height * out.channels, 0);
+
+    for (int y = 0; y < height; y++) {
+        int srcY;
+        if (flipVertical) {
+            srcY = topDown ? (height - 1 - y) : y;
+        } else {
+            srcY = topDown ? y : (height - 1 - y);
+        }
+        const unsigned char* row = &pixelData[(size_t)srcY * rowSize];
+        unsigned char* dest = &out.pixels[(size_t)y * width * out.channels];
+
+        for (int x = 0; x < width; x++) {
+            unsigned char r, g, b, a = 255;
+            if (bitsPerPixel == 8) {
+                unsigned char index = row[x];
+                r = palette[index * 4 + 2];  // Palette is BGRA
+                g = palette[index * 4 + 1];
+                b = palette[index * 4 + 0];
+            } else if (bitsPerPixel == 16) {
+                unsigned short pix = row[x * 2] | (row[x * 2 + 1] << 8);
+                r = (unsigned char)((pix >> 11) & 0x1F);
+                g = (unsigned char)((pix >> 5) & 0x3F);
+                b = (unsigned char)(pix & 0x1F);
+                // Expand 565 to 8 bits per channel
+                r = (r << 3) | (r >> 2);
+                g = (g << 2) | (g >> 4);
+                b = (b << 3) | (b >> 2);
+            } else if (bitsPerPixel == 24) {
+                b = row[x * 3 + 0];
+                g = row[x * 3 + 1];
+                r = row[x * 3 + 2];
+            } else {
+                b = row[x * 4 + 0];
+                g = row[x * 4 + 1];
+                r = row[x * 4 + 2];
+                // Many 32-bit BMPs are XRGB with a zero alpha byte, so alpha is opt-in
+                a = keepAlpha ? row[x * 4 + 3] : 255;
+            }
+
+            if (brightnessAlpha) {
+                a = (unsigned char)((r + g + b) / 3);
+            }
+
+            dest[0] = r;
+            dest[1] = g;
+            dest[2] = b;
+            if (out.channels == 4) {
+                dest[3] = a;
+            }
+            dest += out.channels;
+        }
+    }
+
+    return true;
+}
+
+bool TextureManager::decodeTGA(const unsigned char* bytes, size_t size, unsigned int flags, ImageData& out) {
+    // No color map, uncompressed true color (type 2)
+    if (size < 18 || bytes[1] != 0 || bytes[2] != 2) {
+        return false;
+    }
+
+    int idLength = bytes[0];
+    int width = bytes[12] | (bytes[13] << 8);
+    int height = bytes[14] | (bytes[15] << 8);
+    int bitsPerPixel = bytes[16];
+    // Bit 5 of the descriptor: rows stored top-down instead of bottom-up
+    bool topDown = (bytes[17] & 0x20) != 0;
+
+    if (width <= 0 || height <= 0 || (bitsPerPixel != 24 && bitsPerPixel != 32)) {
+        return false;
+    }
+    int bytesPerPixel = bitsPerPixel / 8;
+    size_t dataOffset = 18 + (size_t)idLength;
+    if (dataOffset + (size_t)width * height * bytesPerPixel > size) {
+        return false;
+    }
+
+    bool brightnessAlpha = (flags & TEX_BRIGHTNESS_ALPHA) != 0;
+    bool flipVertical = (flags & TEX_FLIP_VERTICAL) != 0;
+
+    out.width = width;
+    out.height = height;
+    out.channels = (bitsPerPixel == 32 || brightnessAlpha) ? 4 : 3;
+    out.pixels.assign((size_t)width * height * out.channels, 0);
+
+    for (int y = 0; y < height; y++) {
+        int srcY;
+        if (flipVertical) {
+            srcY = topDown ? (height - 1 - y) : y;
+        } else {
+            srcY = topDown ? y : (height - 1 - y);
+        }
+        const unsigned char* row = bytes + dataOffset + (size_t)srcY * width * bytesPerPixel;
+        unsigned char* dest = &out.pixels[(size_t)y * width * out.channels];
+
+        for (int x = 0; x < width; x++) {
+            const unsigned char* pixel = row + x * bytesPerPixel;   // BGR(A)
+            unsigned char a = bytesPerPixel == 4 ? pixel[3] : 255;
+            if (brightnessAlpha) {
+                a = (unsigned char)((pixel[0] + pixel[1] + pixel[2]) / 3);
+            }
+            dest[0] = pixel[2];
+            dest[1] = pixel[1];
+            dest[2] = pixel[0];
+            if (out.channels == 4) {
+                dest[3] = a;
+            }
+            dest += out.channels;
+        }
+    }
+
+    return true;
+}
+
+void TextureManager::applySamplerState(unsigned int flags) {
+    GLint minFilter = GL_LINEAR_MIPMAP_LINEAR;
+    if (flags & TEX_NO_MIPMAPS) minFilter = GL_LINEAR;
+    else if (flags & TEX_NEAREST_MIPMAP) minFilter = GL_LINEAR_MIPMAP_NEAREST;
+
+    GLint wrapS = (flags & TEX_CLAMP) ? GL_CLAMP : GL_REPEAT;
+    GLint wrapT = (flags & TEX_CLAMP) ? GL_CLAMP : ((flags & TEX_CLAMP_T) ? GL_CLAMP_TO_EDGE : GL_REPEAT);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapS);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapT);
+}
+
+// Levels to upload: the image itself, a resized copy, or a mip chain
+void TextureManager::buildLevels(const ImageData& image, unsigned int flags, int maxTextureSize,
+                                 std::vector<UploadLevel>& levels) {
+    GLenum format = image.channels == 4 ? GL_RGBA : GL_RGB;
+
+    MipOptions options;
+    options.wrapS = (flags & TEX_CLAMP) == 0;
+    options.wrapT = (flags & (TEX_CLAMP | TEX_CLAMP_T)) == 0;
+    options.powerOfTwo = !GLEW_ARB_texture_non_power_of_two;
+    if (maxTextureSize > 0) options.maxSize = maxTextureSize;
+
+    std::vector<ImageData> built;
+    if (flags & TEX_NO_MIPMAPS) {
+        int width, height;
+        MipBuilder::getBaseSize(image.width, image.height, options, width, height);
+        built.resize(1);
+        if (width == image.width && height == image.height) {
+            built[0] = image;
+        } else {
+            MipBuilder::resize(image, width, height, options.gammaCorrect, built[0]);
+        }
+    } else {
+        MipBuilder::buildChain(image, options, built);
+    }
+
+    levels.resize(built.size());
+    for (size_t i = 0; i < built.size(); i++) {
+        levels[i].level = (int)i;
+        levels[i].width = built[i].width;
+        levels[i].height = built[i].height;
+        levels[i].internalFormat = format;
+        levels[i].format = format;
+        levels[i].data.swap(built[i].pixels);
+    }
+}
+
+int TextureManager::getMaxTextureSize() {
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    return maxSize;
+}
+
+// A baked mip chain as-is. Without S3TC the levels are decompressed on the
+// CPU, which still skips the resize and filtering.
+void TextureManager::bakedLevels(const BakedTexture& baked, unsigned int flags, std::vector<UploadLevel>& levels) {
+    size_t levelCount = (flags & TEX_NO_MIPMAPS) ? 1 : baked.levels.size();
+    bool compressed = GLEW_EXT_texture_compression_s3tc && glCompressedTexImage2D != NULL;
+    GLenum compressedFormat = baked.hasAlpha ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+
+    levels.resize(levelCount);
+    for (size_t i = 0; i < levelCount; i++) {
+        const BakedLevel& level = baked.levels[i];
+        UploadLevel& upload = levels[i];
+        upload.level = (int)i;
+        upload.width = level.width;
+        upload.height = level.height;
+        if (compressed) {
+            upload.internalFormat = compressedFormat;
+            upload.format = 0;
+            upload.data = level.data;
+        } else {
+            // Decompressed to RGBA; the GL stores RGB for DXT1 sources
+            upload.internalFormat = baked.hasAlpha ? GL_RGBA : GL_RGB;
+            upload.format = GL_RGBA;
+            TextureBaker::decompressLevel(level, baked.hasAlpha, upload.data);
+        }
+    }
+}
+
+size_t TextureManager::getLevelBytes(const UploadLevel& level) {
+    // Decompressed DXT1 is uploaded as RGBA but stored as RGB
+    if (level.format == GL_RGBA && level.internalFormat == GL_RGB) {
+        return (size_t)level.width * level.height * 3;
+    }
+    return level.data.size();
+}
+
+unsigned int TextureManager::submit(unsigned int texId, unsigned int flags, std::vector<UploadLevel>& levels,
+                                    size_t& gpuBytes, bool partial) {
+    gpuBytes = 0;
+    if (levels.empty()) {
+        return 0;
+    }
+
+    if (texId == 0) {
+        glGenTextures(1, &texId);
+    }
+    GLState::bindTexture(texId);
+    if (!partial) {
+        applySamplerState(flags);
+    }
+
+    for (size_t i = 0; i < levels.size(); i++) {
+        gpuBytes += getLevelBytes(levels[i]);
+    }
+
+    if (streaming && gpuBytes >= STREAM_MIN_BYTES) {
+        TextureStreamer::getInstance().queue(texId, levels, !partial);
+        return texId;
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (size_t i = 0; i < levels.size(); i++) {
+        const UploadLevel& upload = levels[i];
+        if (upload.format == 0) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, upload.level, upload.internalFormat, upload.width, upload.height, 0,
+                                   (GLsizei)upload.data.size(), &upload.data[0]);
+        } else {
+            glTexImage2D(GL_TEXTURE_2D, upload.level, upload.internalFormat, upload.width, upload.height, 0,
+                         upload.format, GL_UNSIGNED_BYTE, &upload.data[0]);
+        }
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, levels.front().level);
+    if (!partial) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels.back().level);
+    }
+
+    return texId;
+}
+
+unsigned int TextureManager::upload(const ImageData& image, unsigned int flags, size_t& gpuBytes, unsigned int texId) {
+    std::vector<UploadLevel> levels;
+    buildLevels(image, flags, getMaxTextureSize(), levels);
+    return submit(texId, flags, levels, gpuBytes, false);
+}
+
+void TextureManager::addEntry(unsigned int texId, unsigned long long contentHash, unsigned int flags,
+                              int width, int height, int channels, size_t gpuBytes, const std::string& path,
+                              Source source) {
+    Entry entry;
+    entry.texId = texId;
+    entry.refCount = 1;
+    entry.contentHash = contentHash;
+    entry.flags = flags;
+    entry.width = width;
+    entry.height = height;
+    entry.channels = channels;
+    entry.gpuBytes = gpuBytes;
+    entry.path = path;
+    entry.source = source;
+    entry.resident = true;
+    entry.lastUse = scopeTick;
+    entry.topMip = 0;
+    entry.tailMip = 0;
+    entry.wantedMip = INT_MAX;
+    entry.idleFrames = 0;
+    addOwner(entry);
+    entries[texId] = entry;
+    enforceBudget();
+}
+
+bool TextureManager::loadLevels(const std::string& resolved, const std::vector<unsigned char>& bytes,
+                                unsigned long long contentHash, unsigned int flags, std::vector<UploadLevel>& levels,
+                                int& width, int& height, int& channels) {
+    std::string bakedPath = TextureBaker::getBakedPath(resolved, contentHash, flags);
+
+    // Baked, pre-filtered and compressed copy on disk
+    BakedTexture baked;
+    if (!bakeMode && TextureBaker::load(bakedPath.c_str(), baked) && !baked.levels.empty()) {
+        bakedLevels(baked, flags, levels);
+        width = baked.levels[0].width;
+        height = baked.levels[0].height;
+        channels = baked.hasAlpha ? 4 : 3;
+        bakedLoads++;
+        return true;
+    }
+
+    // Decode the source image, unless acquireBatch already did
+    ImageData image;
+    auto predecodedIt = predecoded.find(makePathKey(resolved.c_str(), flags));
+    if (predecodedIt != predecoded.end()) {
+        image.width = predecodedIt->second.width;
+        image.height = predecodedIt->second.height;
+        image.channels = predecodedIt->second.channels;
+        image.pixels.swap(predecodedIt->second.pixels);
+        predecoded.erase(predecodedIt);
+    } else {
+        if (!decodeImage(&bytes[0], bytes.size(), flags, image)) {
+            return false;
+        }
+        decodeCount++;
+    }
+
+    buildLevels(image, flags, getMaxTextureSize(), levels);
+    width = image.width;
+    height = image.height;
+    channels = image.channels;
+
+    if (bakeMode) {
+        TextureBaker::bake(image, flags, baked);
+        if (TextureBaker::save(bakedPath.c_str(), baked)) {
+            printf("TextureManager: Baked %s -> %s\n", resolved.c_str(), bakedPath.c_str());
+            bakesWritten++;
+        }
+    }
+    return true;
+}
+
+unsigned int TextureManager::loadFile(Entry& entry, const std::vector<unsigned char>& bytes, unsigned int texId) {
+    std::vector<UploadLevel> levels;
+    if (!loadLevels(entry.path, bytes, entry.contentHash, entry.flags, levels,
+                    entry.width, entry.height, entry.channels)) {
+        return 0;
+    }
+
+    entry.levelBytes.resize(levels.size());
+    for (size_t i = 0; i < levels.size(); i++) {
+        entry.levelBytes[i] = getLevelBytes(levels[i]);
+    }
+
+    // Streamed textures start with just the mip tail; updateMipStreaming adds the rest
+    entry.topMip = 0;
+    if (entry.flags & TEX_STREAM_MIPS) {
+        while (entry.topMip + 1 < (int)levels.size() &&
+               std::max(levels[entry.topMip].width, levels[entry.topMip].height) > MIP_TAIL_SIZE) {
+            entry.topMip++;
+        }
+        levels.erase(levels.begin(), levels.begin() + entry.topMip);
+    }
+    entry.tailMip = entry.topMip;
+    entry.wantedMip = INT_MAX;
+    entry.idleFrames = 0;
+
+    return submit(texId, entry.flags, levels, entry.gpuBytes, false);
+}
+
+unsigned int TextureManager::acquire(const char* path, unsigned int flags) {
+    if (path == NULL || path[0] == '\0') {
+        return 0;
+    }
+
+    // 1) Same request seen before: no file I/O at all
+    std::string requestKey = makePathKey(path, flags);
+    auto pathIt = pathIndex.find(requestKey);
+    if (pathIt != pathIndex.end()) {
+        useEntry(entries[pathIt->second]);
+        pathHits++;
+        return pathIt->second;
+    }
+
+    std::string resolved;
+    std::vector<unsigned char> bytes;
+    if (!resolvePath(path, resolved, bytes)) {
+        return 0;
+    }
+
+    // 2) Different spelling of a path that is already loaded ("../textures/x" vs "textures/x")
+    std::string resolvedKey = makePathKey(resolved.c_str(), flags);
+    pathIt = pathIndex.find(resolvedKey);
+    if (pathIt != pathIndex.end()) {
+        pathIndex[requestKey] = pathIt->second;
+        useEntry(entries[pathIt->second]);
+        pathHits++;
+        return pathIt->second;
+    }
+
+    // 3) Same image content under another name (model folders ship copies of the same BMPs)
+    unsigned long long contentHash = hashBytes(&bytes[0], bytes.size());
+    auto contentIt = contentIndex.find(std::make_pair(contentHash, flags));
+    if (contentIt != contentIndex.end()) {
+        pathIndex[requestKey] = contentIt->second;
+        pathIndex[resolvedKey] = contentIt->second;
+        useEntry(entries[contentIt->second]);
+        contentHits++;
+        return contentIt->second;
+    }
+
+    // 4) Baked copy or decode
+    Entry loaded;
+    loaded.path = resolved;
+    loaded.contentHash = contentHash;
+    loaded.flags = flags;
+    unsigned int texId = loadFile(loaded, bytes, 0);
+    if (texId == 0) {
+        return 0;
+    }
+
+    addEntry(texId, contentHash, flags, loaded.width, loaded.height, loaded.channels, loaded.gpuBytes,
+             resolved, SOURCE_FILE);
+    Entry& entry = entries[texId];
+    entry.levelBytes.swap(loaded.levelBytes);
+    entry.topMip = loaded.topMip;
+    entry.tailMip = loaded.tailMip;
+    pathIndex[requestKey] = texId;
+    pathIndex[resolvedKey] = texId;
+    contentIndex[std::make_pair(contentHash, flags)] = texId;
+    return texId;
+}
+
+unsigned int TextureManager::acquireColor(unsigned char r, unsigned char g, unsigned char b, unsigned char a) {
+    char key[32];
+    sprintf_s(key, sizeof(key), "#%02x%02x%02x%02x", r, g, b, a);
+
+    auto it = pathIndex.find(key);
+    if (it != pathIndex.end()) {
+        useEntry(entries[it->second]);
+        pathHits++;
+        return it->second;
+    }
+
+    ImageData image;
+    image.width = 1;
+    image.height = 1;
+    image.channels = 4;
+    image.pixels.resize(4);
+    image.pixels[0] = r;
+    image.pixels[1] = g;
+    image.pixels[2] = b;
+    image.pixels[3] = a;
+
+    size_t gpuBytes = 0;
+    unsigned int texId = upload(image, TEX_NO_MIPMAPS, gpuBytes);
+    addEntry(texId, 0, TEX_NO_MIPMAPS, 1, 1, 4, gpuBytes, std::string(), SOURCE_COLOR);
+
+    pathIndex[key] = texId;
+    return texId;
+}
+
+unsigned int TextureManager::acquireImage(const char* name, const ImageData& image, unsigned int flags) {
+    if (name == NULL || image.pixels.empty()) {
+        return 0;
+    }
+
+    unsigned int existing = acquireNamed(name, flags);
+    if (existing != 0) {
+        return existing;
+    }
+
+    size_t gpuBytes = 0;
+    unsigned int texId = upload(image, flags, gpuBytes);
+    if (texId == 0) {
+        return 0;
+    }
+    addEntry(texId, 0, flags, image.width, image.height, image.channels, gpuBytes, name, SOURCE_MEMORY);
+    pathIndex[makePathKey((std::string("@") + name).c_str(), flags)] = texId;
+    return texId;
+}
+
+unsigned int TextureManager::acquireNamed(const char* name, unsigned int flags) {
+    if (name == NULL) {
+        return 0;
+    }
+    auto it = pathIndex.find(makePathKey((std::string("@") + name).c_str(), flags));
+    if (it == pathIndex.end()) {
+        return 0;
+    }
+    useEntry(entries[it->second]);
+    pathHits++;
+    return it->second;
+}
+
+bool TextureManager::loadImage(const char* path, unsigned int flags, ImageData& out) {
+    std::string resolved;
+    std::vector<unsigned char> bytes;
+    if (path == NULL || !resolvePath(path, resolved, bytes)) {
+        return false;
+    }
+    if (!decodeImage(&bytes[0], bytes.size(), flags, out)) {
+        return false;
+    }
+    decodeCount++;
+    return true;
+}
+
+bool TextureManager::decodeImage(const unsigned char* bytes, size_t size, unsigned int flags, ImageData& out) {
+    if (PNGDecoder::isPNG(bytes, size)) {
+        return PNGDecoder::decode(bytes, size, flags, out);
+    }
+    // TGA has no signature; anything that isn't a BMP gets its header check
+    if (size >= 2 && (bytes[0] != 'B' || bytes[1] != 'M')) {
+        return decodeTGA(bytes, size, flags, out);
+    }
+    return decodeBMP(bytes, size, flags, out);
+}
+
+int TextureManager::acquireBatch(const char* const* paths, int count, unsigned int flags, unsigned int* texIds) {
+    // Read the files that will actually need decoding: not loaded yet, and no bake to use instead
+    std::vector<std::vector<unsigned char>> files(count);
+    std::vector<std::string> resolved(count);
+    std::vector<int> work;
+    for (int i = 0; i < count; i++) {
+        if (paths[i] == NULL || pathIndex.find(makePathKey(paths[i], flags)) != pathIndex.end()) continue;
+        if (!resolvePath(paths[i], resolved[i], files[i])) continue;
+
+        unsigned long long contentHash = hashBytes(&files[i][0], files[i].size());
+        if (contentIndex.find(std::make_pair(contentHash, flags)) != contentIndex.end()) continue;
+        if (!bakeMode) {
+            FILE* baked = NULL;
+            fopen_s(&baked, TextureBaker::getBakedPath(resolved[i], contentHash, flags).c_str(), "rb");
+            if (baked) {
+                fclose(baked);
+                continue;
+            }
+        }
+        work.push_back(i);
+    }
+
+    // One image per task: inflate and unfilter are serial within an image
+    std::vector<ImageData> images(count);
+    std::vector<char> decoded(count, 0);
+    WorkerPool::getInstance().parallelFor((int)work.size(), 1, [&](int begin, int end) {
+        for (int k = begin; k < end; k++) {
+            int i = work[k];
+            decoded[i] = decodeImage(&files[i][0], files[i].size(), flags, images[i]) ? 1 : 0;
+            std::vector<unsigned char>().swap(files[i]);
+        }
+    });
+    for (size_t k = 0; k < work.size(); k++) {
+        int i = work[k];
+        if (decoded[i]) {
+            predecoded[makePathKey(resolved[i].c_str(), flags)] = std::move(images[i]);
+            decodeCount++;
+        }
+    }
+
+    // Upload in order (GL calls stay on this thread)
+    int loaded = 0;
+    for (int i = 0; i < count; i++) {
+        texIds[i] = paths[i] != NULL ? acquire(paths[i], flags) : 0;
+        if (texIds[i] != 0) loaded++;
+    }
+    predecoded.clear();
+    return loaded;
+}
+
+void TextureManager::addRef(unsigned int texId) {
+    auto it = entries.find(texId);
+    if (it != entries.end()) {
+        it->second.refCount++;
+    }
+}
+
+void TextureManager::release(unsigned int texId) {
+    auto it = entries.find(texId);
+    if (it == entries.end()) {
+        return;
+    }
+    if (--it->second.refCount > 0) {
+        return;
+    }
+
+    TextureStreamer::getInstance().cancel(texId);
+    GLuint id = texId;
+    GLState::deleteTextures(1, &id);
+    removeEntry(texId);
+}
+
+bool TextureManager::isManaged(unsigned int texId) const {
+    return entries.find(texId) != entries.end();
+}
+
+bool TextureManager::isReady(unsigned int texId) const {
+    auto it = entries.find(texId);
+    if (it == entries.end()) return false;
+    return it->second.resident && !TextureStreamer::getInstance().isPending(texId);
+}
+
+bool TextureManager::getSize(unsigned int texId, int& width, int& height) const {
+    auto it = entries.find(texId);
+    if (it == entries.end()) return false;
+    width = it->second.width;
+    height = it->second.height;
+    return true;
+}
+
+void TextureManager::removeEntry(unsigned int texId) {
+    for (auto it = pathIndex.begin(); it != pathIndex.end(); ) {
+        if (it->second == texId) it = pathIndex.erase(it);
+        else ++it;
+    }
+    for (auto it = contentIndex.begin(); it != contentIndex.end(); ) {
+        if (it->second == texId) it = contentIndex.erase(it);
+        else ++it;
+    }
+    entries.erase(texId);
+}
+
+size_t TextureManager::getResidentBytes() const {
+    size_t total = 0;
+    for (const auto& pair : entries) {
+        if (pair.second.resident) total += pair.second.gpuBytes;
+    }
+    return total;
+}
+
+size_t TextureManager::getTextureBytes() const {
+    size_t total = 0;
+    for (const auto& pair : entries) {
+        total += pair.second.gpuBytes;
+    }
+    return total;
+}
+
+void TextureManager::printStats() const {
+    printf("TextureManager: %d textures, %.1f MB, %d decodes, %d baked loads, %d path hits, %d content hits\n",
+           getTextureCount(), getTextureBytes() / (1024.0f * 1024.0f),
+           decodeCount, bakedLoads, pathHits, contentHits);
+    printf("TextureManager: %.1f MB resident of %.1f MB budget, %d evictions, %d reloads\n",
+           getResidentBytes() / (1024.0f * 1024.0f), budget / (1024.0f * 1024.0f), evictions, reloads);
+    printf("TextureManager: %d mip loads, %d mip drops\n", mipLoads, mipDrops);
+    if (bakeMode) {
+        printf("TextureManager: %d baked textures written\n", bakesWritten);
+    }
+}
+
+//=======================================================================
+// Residency
+//=======================================================================
+void TextureManager::addOwner(Entry& entry) {
+    if (scope.empty()) {
+        return;
+    }
+    if (std::find(entry.owners.begin(), entry.owners.end(), scope) == entry.owners.end()) {
+        entry.owners.push_back(scope);
+    }
+}
+
+void TextureManager::useEntry(Entry& entry) {
+    entry.refCount++;
+    entry.lastUse = scopeTick;
+    addOwner(entry);
+    if (!entry.resident) {
+        reload(entry);
+        enforceBudget();
+    }
+}
+
+void TextureManager::setScope(const std::string& name) {
+    scope = name;
+    scopeTick++;
+
+    for (auto& pair : entries) {
+        Entry& entry = pair.second;
+        if (std::find(entry.owners.begin(), entry.owners.end(), scope) == entry.owners.end()) {
+            continue;
+        }
+        entry.lastUse = scopeTick;
+        if (!entry.resident) {
+            reload(entry);
+        }
+    }
+    enforceBudget();
+}
+
+void TextureManager::setBudget(size_t bytes) {
+    budget = bytes;
+    enforceBudget();
+}
+
+void TextureManager::enforceBudget() {
+    if (budget == 0 || bakeMode) {
+        return;
+    }
+    size_t resident = getResidentBytes();
+    if (resident <= budget) {
+        return;
+    }
+
+    // Textures used only by other scopes, least recently used first
+    std::vector<Entry*> candidates;
+    for (auto& pair : entries) {
+        Entry& entry = pair.second;
+        if (!entry.resident || entry.source == SOURCE_COLOR || entry.owners.empty()) continue;
+        if (std::find(entry.owners.begin(), entry.owners.end(), scope) != entry.owners.end()) continue;
+        candidates.push_back(&entry);
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Entry* a, const Entry* b) {
+        return a->lastUse < b->lastUse;
+    });
+
+    for (size_t i = 0; i < candidates.size() && resident > budget; i++) {
+        resident -= candidates[i]->gpuBytes;
+        evict(*candidates[i]);
+    }
+    if (resident > budget) {
+        printf("TextureManager: Scope '%s' needs %.1f MB, over the %.1f MB budget\n",
+               scope.c_str(), resident / (1024.0f * 1024.0f), budget / (1024.0f * 1024.0f));
+    }
+}
+
+void TextureManager::evict(Entry& entry) {
+    // Level 0 has to be complete before it can be read back or measured
+    TextureStreamer::getInstance().flush(entry.texId);
+    GLState::bindTexture(entry.texId);
+
+    GLint width = 0, height = 0;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+
+    // Images built in memory have no file to come back from
+    if (entry.source == SOURCE_MEMORY) {
+        GLenum format = entry.channels == 4 ? GL_RGBA : GL_RGB;
+        entry.cpuCopy.width = width;
+        entry.cpuCopy.height = height;
+        entry.cpuCopy.channels = entry.channels;
+        entry.cpuCopy.pixels.resize((size_t)width * height * entry.channels);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glGetTexImage(GL_TEXTURE_2D, 0, format, GL_UNSIGNED_BYTE, &entry.cpuCopy.pixels[0]);
+    }
+
+    // Free every mip level but keep the id valid: a 1x1 gray level 0 and
+    // a non-mipmapped filter so the texture stays complete
+    int levelCount = 1;
+    for (int size = std::max((int)width, (int)height); size > 1; size /= 2) levelCount++;
+    levelCount = std::max(levelCount, (int)entry.levelBytes.size());
+    for (int level = levelCount - 1; level >= 1; level--) {
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGB, 0, 0, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+    }
+    const unsigned char gray[4] = { 128, 128, 128, 255 };
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, gray);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+
+    entry.resident = false;
+    evictions++;
+}
+
+bool TextureManager::reload(Entry& entry) {
+    unsigned int texId = 0;
+
+    if (entry.source == SOURCE_MEMORY) {
+        if (entry.cpuCopy.pixels.empty()) {
+            return false;
+        }
+        texId = upload(entry.cpuCopy, entry.flags, entry.gpuBytes, entry.texId);
+        entry.cpuCopy = ImageData();
+    } else if (entry.source == SOURCE_FILE) {
+        std::vector<unsigned char> bytes;
+        if (!readFile(entry.path.c_str(), bytes)) {
+            printf("TextureManager: Cannot reload %s\n", entry.path.c_str());
+            return false;
+        }
+        texId = loadFile(entry, bytes, entry.texId);
+    }
+    if (texId == 0) {
+        return false;
+    }
+
+    entry.resident = true;
+    reloads++;
+    return true;
+}
+
+//=======================================================================
+// Mip streaming
+//=======================================================================
+void TextureManager::setViewport(int heightPixels, float fovYDegrees) {
+    viewportHeight = heightPixels > 0 ? heightPixels : 1;
+    fovY = fovYDegrees;
+}
+
+void TextureManager::requestDetail(unsigned int texId, float worldSize, float distance) {
+    auto it = entries.find(texId);
+    if (it == entries.end() || (it->second.flags & TEX_STREAM_MIPS) == 0) {
+        return;
+    }
+    Entry& entry = it->second;
+
+    // Screen pixels covered by one repeat of the texture, and the texels that land on each pixel
+    if (distance < 0.01f) distance = 0.01f;
+    float pixelsPerUnit = viewportHeight / (2.0f * distance * tanf(fovY * 0.5f * 3.14159f / 180.0f));
+    float pixels = worldSize * pixelsPerUnit;
+    float texelsPerPixel = std::max(entry.width, entry.height) / std::max(pixels, 0.001f);
+
+    int mip = 0;
+    while (texelsPerPixel >= 2.0f) {
+        texelsPerPixel *= 0.5f;
+        mip++;
+    }
+    entry.wantedMip = std::min(entry.wantedMip, mip);
+}
+
+void TextureManager::updateMipStreaming() {
+    TextureStreamer& streamer = TextureStreamer::getInstance();
+
+    if (mipLoad && mipLoad->done) {
+        finishMips();
+    }
+
+    // One file load at a time, for the texture that is furthest from what it needs
+    Entry* load = NULL;
+    int loadMip = 0;
+    int loadGap = 0;
+
+    for (auto& pair : entries) {
+        Entry& entry = pair.second;
+        if ((entry.flags & TEX_STREAM_MIPS) == 0 || !entry.resident || entry.levelBytes.size() < 2) {
+            continue;
+        }
+        int wanted = std::min(entry.wantedMip, entry.tailMip);
+        entry.wantedMip = INT_MAX;
+        if (streamer.isPending(entry.texId)) {
+            continue;
+        }
+
+        if (wanted < entry.topMip) {
+            entry.idleFrames = 0;
+            if (entry.topMip - wanted > loadGap) {
+                load = &entry;
+                loadMip = wanted;
+                loadGap = entry.topMip - wanted;
+            }
+        } else if (wanted > entry.topMip) {
+            // Not seen up close for a while (or not seen at all): drop the top levels
+            if (++entry.idleFrames >= MIP_DROP_FRAMES) {
+                dropMips(entry, wanted);
+                entry.idleFrames = 0;
+            }
+        } else {
+            entry.idleFrames = 0;
+        }
+    }
+
+    if (load != NULL && !mipLoad) {
+        loadMips(*load, loadMip);
+    }
+}
+
+void TextureManager::loadMips(Entry& entry, int mip) {
+    std::shared_ptr<MipLoad> load(new MipLoad());
+    load->texId = entry.texId;
+    load->contentHash = entry.contentHash;
+    load->mip = mip;
+    load->topMip = entry.topMip;
+    load->loaded = false;
+    load->baked = false;
+    load->done = false;
+    mipLoad = load;
+
+    // Copies only: the task may still run after the entry is gone
+    std::string path = entry.path;
+    unsigned int flags = entry.flags;
+    bool useBake = !bakeMode;
+    int maxTextureSize = getMaxTextureSize();
+    WorkerPool::getInstance().runAsync([load, path, flags, useBake, maxTextureSize]() {
+        readMips(*load, path, flags, useBake, maxTextureSize);
+        load->done = true;
+    });
+}
+
+void TextureManager::readMips(MipLoad& load, const std::string& path, unsigned int flags, bool useBake,
+                              int maxTextureSize) {
+    std::vector<UploadLevel> levels;
+    BakedTexture baked;
+    if (useBake && TextureBaker::load(TextureBaker::getBakedPath(path, load.contentHash, flags).c_str(), baked) &&
+        !baked.levels.empty()) {
+        bakedLevels(baked, flags, levels);
+        load.baked = true;
+    } else {
+        std::vector<unsigned char> bytes;
+        ImageData image;
+        if (!readFile(path.c_str(), bytes) || !decodeImage(&bytes[0], bytes.size(), flags, image)) {
+            return;
+        }
+        buildLevels(image, flags, maxTextureSize, levels);
+    }
+    if ((int)levels.size() < load.topMip) {
+        return;
+    }
+
+    // Only the missing levels; the coarser ones are already resident
+    levels.erase(levels.begin() + load.topMip, levels.end());
+    levels.erase(levels.begin(), levels.begin() + load.mip);
+    load.levels.swap(levels);
+    load.loaded = true;
+}
+
+void TextureManager::finishMips() {
+    std::shared_ptr<MipLoad> load;
+    load.swap(mipLoad);
+    if (!load->loaded) {
+        return;
+    }
+    if (load->baked) bakedLoads++; else decodeCount++;
+
+    auto it = entries.find(load->texId);
+    if (it == entries.end()) {
+        return;
+    }
+    Entry& entry = it->second;
+    if (entry.contentHash != load->contentHash || !entry.resident || entry.topMip != load->topMip) {
+        return;
+    }
+
+    size_t gpuBytes = 0;
+    submit(entry.texId, entry.flags, load->levels, gpuBytes, true);
+    entry.gpuBytes += gpuBytes;
+    entry.topMip = load->mip;
+    mipLoads++;
+    enforceBudget();
+}
+
+void TextureManager::dropMips(Entry& entry, int mip) {
+    GLState::bindTexture(entry.texId);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, mip);
+    for (int level = entry.topMip; level < mip; level++) {
+        glTexImage2D(GL_TEXTURE_2D, level, GL_RGB, 0, 0, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+        entry.gpuBytes -= entry.levelBytes[level];
+    }
+    entry.topMip = mip;
+    mipDrops++;
+}
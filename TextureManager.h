@@ -0,0 +1,263 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+#include <utility>
+#include <memory>
+#include <atomic>
+
+// Flags that change how an image is decoded or uploaded.
+// They are part of the cache key: the same file loaded with different
+// flags produces a different GL texture.
+enum TextureFlags {
+    TEX_DEFAULT          = 0,
+    TEX_ALPHA            = 1 << 0,  // Keep the alpha channel of 32-bit BMPs (trees, sprites)
+    TEX_FLIP_VERTICAL    = 1 << 1,  // Keep the BMP's bottom-up row order (sky domes, 3DS materials)
+    TEX_BRIGHTNESS_ALPHA = 1 << 2,  // Derive alpha from brightness, black = transparent (explosions)
+    TEX_CLAMP            = 1 << 3,  // GL_CLAMP on S and T instead of GL_REPEAT
+    TEX_CLAMP_T          = 1 << 4,  // GL_CLAMP_TO_EDGE on T only (sky domes)
+    TEX_NO_MIPMAPS       = 1 << 5,  // Plain GL_LINEAR, no mip chain
+    TEX_NEAREST_MIPMAP   = 1 << 6,  // GL_LINEAR_MIPMAP_NEAREST (GLTexture's filter)
+    TEX_STREAM_MIPS      = 1 << 7,  // Keep only the mips the view needs (big ground, sky and facade images)
+
+    // Flags that change the decoded pixels (the rest only change sampler state)
+    TEX_DECODE_FLAGS     = TEX_ALPHA | TEX_FLIP_VERTICAL | TEX_BRIGHTNESS_ALPHA
+};
+
+// Decoded pixels, tightly packed RGB or RGBA
+struct ImageData {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    std::vector<unsigned char> pixels;
+};
+
+struct BakedTexture;
+struct UploadLevel;
+
+// Texture Manager - one GL texture per unique image
+// Every level, system and 3DS material used to decode and upload its own
+// copy of the same BMPs. Textures are now keyed by resolved path (cheap
+// repeat lookups) and by a hash of the file contents (copies of the same
+// image under different names), and shared with reference counts.
+// Images that have a baked DDS (see TextureBaker) skip decoding and
+// mip generation entirely.
+//
+// Residency: every texture remembers which level scopes use it. When the
+// estimated VRAM use goes over the budget, textures that only belong to
+// inactive levels are evicted, least recently used first. An evicted
+// texture keeps its GL id (as a 1x1 placeholder) so the ids held by
+// levels stay valid, and it is reloaded when its level becomes active
+// again or someone acquires it.
+class TextureManager {
+public:
+    // Singleton pattern (same as GameManager)
+    static TextureManager& getInstance();
+
+    TextureManager(const TextureManager&) = delete;
+    TextureManager& operator=(const TextureManager&) = delete;
+
+    // Load a texture file, or share the already loaded copy.
+    // Tries "", "../" and "../../" prefixes so paths work from the project
+    // folder and from Debug/. Returns 0 if the file can't be loaded.
+    unsigned int acquire(const char* path, unsigned int flags = TEX_DEFAULT);
+
+    // Acquire several files at once. Images that need decoding are decoded
+    // in parallel on the WorkerPool first (worth it for big PNGs); returns
+    // how many loaded, with 0 in texIds for the ones that failed.
+    int acquireBatch(const char* const* paths, int count, unsigned int flags, unsigned int* texIds);
+
+    // Shared 1x1 solid color texture (load fallbacks)
+    unsigned int acquireColor(unsigned char r, unsigned char g, unsigned char b, unsigned char a = 255);
+
+    // Upload an image built in memory (atlases, generated textures) under a
+    // unique name. Later calls with the same name and flags share it.
+    unsigned int acquireImage(const char* name, const ImageData& image, unsigned int flags = TEX_DEFAULT);
+    // Share an image uploaded earlier with acquireImage; 0 if there is none
+    unsigned int acquireNamed(const char* name, unsigned int flags = TEX_DEFAULT);
+
+    // Decode a texture file without uploading it (same path search as acquire)
+    bool loadImage(const char* path, unsigned int flags, ImageData& out);
+
+    // Reference counting. Releasing the last reference deletes the GL texture.
+    // Ids that were not created by the manager are ignored.
+    void addRef(unsigned int texId);
+    void release(unsigned int texId);
+    bool isManaged(unsigned int texId) const;
+    // Resident with every level uploaded (not a placeholder)
+    bool isReady(unsigned int texId) const;
+    bool getSize(unsigned int texId, int& width, int& height) const;
+
+    // Scope (level name) that new and re-acquired textures belong to.
+    // Switching scope reloads the scope's evicted textures and then
+    // enforces the budget. Textures acquired with no scope are never evicted.
+    void setScope(const std::string& scope);
+    const std::string& getScope() const { return scope; }
+
+    // Streaming: uploads go through the TextureStreamer and finish over the
+    // next frames; textures show a placeholder (mip tail) until then.
+    // Off during startup loading, where blocking is fine.
+    void setStreaming(bool enabled) { streaming = enabled; }
+    bool isStreaming() const { return streaming; }
+
+    // Mip streaming for TEX_STREAM_MIPS textures. They load with just their
+    // mip tail; each frame the renderer reports how they are seen, and
+    // updateMipStreaming loads the finer levels that are needed (one file
+    // at a time, read and built on the WorkerPool, then handed to the
+    // TextureStreamer) and drops the ones that haven't been needed for a while.
+    // worldSize: world units covered by one repeat of the texture
+    // distance: from the camera to the nearest visible point
+    void requestDetail(unsigned int texId, float worldSize, float distance);
+    void setViewport(int heightPixels, float fovYDegrees);
+    void updateMipStreaming();
+
+    // VRAM budget in bytes (--texture-budget-mb), 0 = unlimited
+    void setBudget(size_t bytes);
+    size_t getBudget() const { return budget; }
+
+    // Bake mode (--bake-textures): every decoded image is also written to
+    // its baked DDS file, and existing bakes are ignored so they get refreshed
+    void setBakeMode(bool enabled) { bakeMode = enabled; }
+    bool isBakeMode() const { return bakeMode; }
+
+    // Stats
+    int getTextureCount() const { return (int)entries.size(); }
+    size_t getTextureBytes() const;     // All textures as if resident
+    size_t getResidentBytes() const;    // Textures currently in VRAM
+    int getEvictionCount() const { return evictions; }
+    int getReloadCount() const { return reloads; }
+    int getMipLoadCount() const { return mipLoads; }
+    int getMipDropCount() const { return mipDrops; }
+    int getDecodeCount() const { return decodeCount; }
+    int getBakedLoadCount() const { return bakedLoads; }
+    int getBakesWritten() const { return bakesWritten; }
+    int getPathHits() const { return pathHits; }
+    int getContentHits() const { return contentHits; }
+    void printStats() const;
+
+    // Helpers shared with the other image loaders
+    static bool readFile(const char* path, std::vector<unsigned char>& out);
+    static unsigned long long hashBytes(const unsigned char* bytes, size_t size);
+    static bool decodeBMP(const unsigned char* bytes, size_t size, unsigned int flags, ImageData& out);
+    // Uncompressed 24/32-bit TGA; 32-bit keeps its alpha, as GLTexture's loader did
+    static bool decodeTGA(const unsigned char* bytes, size_t size, unsigned int flags, ImageData& out);
+    // BMP, PNG or uncompressed TGA, by header
+    static bool decodeImage(const unsigned char* bytes, size_t size, unsigned int flags, ImageData& out);
+
+private:
+    TextureManager();
+    ~TextureManager();
+
+    // Where an evicted texture is reloaded from
+    enum Source {
+        SOURCE_FILE,    // Re-read the file (baked DDS or decode)
+        SOURCE_MEMORY,  // Read back before eviction, kept in cpuCopy
+        SOURCE_COLOR    // 1x1 colors are never evicted
+    };
+
+    struct Entry {
+        unsigned int texId;
+        int refCount;
+        unsigned long long contentHash;
+        unsigned int flags;
+        int width;
+        int height;
+        int channels;
+        size_t gpuBytes;    // Estimated VRAM use, all mip levels
+        std::string path;   // Resolved path ("" for solid colors)
+
+        Source source;
+        bool resident;
+        unsigned int lastUse;               // Scope tick of the last use
+        std::vector<std::string> owners;    // Scopes using it, empty = pinned
+        ImageData cpuCopy;                  // SOURCE_MEMORY pixels while evicted
+
+        // Mip streaming (TEX_STREAM_MIPS from files)
+        std::vector<size_t> levelBytes;     // Full chain, level 0 first
+        int topMip;                         // Finest resident level
+        int tailMip;                        // Coarse levels that always stay resident
+        int wantedMip;                      // Finest level requested this frame
+        int idleFrames;                     // Frames topMip has been finer than needed
+    };
+
+    // Texture id -> entry
+    std::map<unsigned int, Entry> entries;
+    // "requested path|flags" -> texture id
+    std::map<std::string, unsigned int> pathIndex;
+    // (content hash, flags) -> texture id
+    std::map<std::pair<unsigned long long, unsigned int>, unsigned int> contentIndex;
+    // "resolved path|flags" -> image decoded ahead by acquireBatch
+    std::map<std::string, ImageData> predecoded;
+
+    bool bakeMode;
+    int decodeCount;
+    int bakedLoads;
+    int bakesWritten;
+    int pathHits;
+    int contentHits;
+
+    std::string scope;
+    unsigned int scopeTick;
+    size_t budget;
+    int evictions;
+    int reloads;
+    bool streaming;
+    int viewportHeight;
+    float fovY;
+    int mipLoads;
+    int mipDrops;
+
+    // Finer levels of one texture being read and built on the WorkerPool.
+    // The task only fills levels and sets done; the result is dropped if
+    // the texture changed (evicted, released, other mips) in the meantime.
+    struct MipLoad {
+        unsigned int texId;
+        unsigned long long contentHash;
+        int mip;                            // Finest level wanted
+        int topMip;                         // The entry's finest level when the load started
+        std::vector<UploadLevel> levels;    // [mip, topMip) once done
+        bool loaded;
+        bool baked;                         // Came from the baked DDS rather than a decode
+        std::atomic<bool> done;
+    };
+    std::shared_ptr<MipLoad> mipLoad;
+
+    static std::string makePathKey(const char* path, unsigned int flags);
+    static bool resolvePath(const char* path, std::string& resolved, std::vector<unsigned char>& bytes);
+
+    static void applySamplerState(unsigned int flags);
+    // maxTextureSize from getMaxTextureSize(), so the build can run off the GL thread
+    static void buildLevels(const ImageData& image, unsigned int flags, int maxTextureSize,
+                            std::vector<UploadLevel>& levels);
+    static int getMaxTextureSize();
+    static void bakedLevels(const BakedTexture& baked, unsigned int flags, std::vector<UploadLevel>& levels);
+    static size_t getLevelBytes(const UploadLevel& level);
+    // Upload into texId, or into a new texture when texId is 0. A partial
+    // upload adds finer levels to a texture that has its coarser ones.
+    unsigned int submit(unsigned int texId, unsigned int flags, std::vector<UploadLevel>& levels,
+                        size_t& gpuBytes, bool partial);
+    unsigned int upload(const ImageData& image, unsigned int flags, size_t& gpuBytes, unsigned int texId = 0);
+    // Baked copy if there is one, else decode (and bake in bake mode)
+    bool loadLevels(const std::string& resolved, const std::vector<unsigned char>& bytes,
+                    unsigned long long contentHash, unsigned int flags, std::vector<UploadLevel>& levels,
+                    int& width, int& height, int& channels);
+    // Load entry.path into texId (0 = new texture); fills the entry's size and mip fields
+    unsigned int loadFile(Entry& entry, const std::vector<unsigned char>& bytes, unsigned int texId);
+    void addEntry(unsigned int texId, unsigned long long contentHash, unsigned int flags,
+                  int width, int height, int channels, size_t gpuBytes, const std::string& path, Source source);
+    void removeEntry(unsigned int texId);
+
+    // Count a new reference from the current scope, reloading if evicted
+    void useEntry(Entry& entry);
+    void addOwner(Entry& entry);
+    void evict(Entry& entry);
+    bool reload(Entry& entry);
+    void enforceBudget();
+    // Start loading levels [mip, entry.topMip) in the background
+    void loadMips(Entry& entry, int mip);
+    // Runs on a worker: baked DDS if there is one, else read, decode and build
+    static void readMips(MipLoad& load, const std::string& path, unsigned int flags, bool useBake,
+                         int maxTextureSize);
+    void finishMips();
+    void dropMips(Entry& entry, int mip);
+};
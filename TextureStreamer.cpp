@@ -0,0 +1,249 @@
+#include "TextureStreamer.h"
+#include "glew.h"
+#include "GLState.h"
+#include <glut.h>
+#include <stdio.h>
+#include <cstring>
+#include <algorithm>
+
+// Three buffers: one being filled, one in flight, one the driver may still be reading
+static const int PBO_RING_SIZE = 3;
+// About 2 ms of transfer on integrated GPUs
+static const size_t DEFAULT_FRAME_BUDGET = 2 * 1024 * 1024;
+
+TextureStreamer::TextureStreamer()
+    : nextPbo(0), frameBudget(DEFAULT_FRAME_BUDGET), uploadedBytes(0), completedCount(0) {
+}
+
+TextureStreamer::~TextureStreamer() {
+    // The GL context is gone by the time static destructors run
+    jobs.clear();
+    pbos.clear();
+}
+
+TextureStreamer& TextureStreamer::getInstance() {
+    static TextureStreamer instance;
+    return instance;
+}
+
+void TextureStreamer::init() {
+    if (!pbos.empty()) {
+        return;
+    }
+    if ((GLEW_VERSION_2_1 || GLEW_ARB_pixel_buffer_object) && glGenBuffers != NULL) {
+        pbos.resize(PBO_RING_SIZE);
+        glGenBuffers(PBO_RING_SIZE, &pbos[0]);
+    }
+    printf("TextureStreamer: %s uploads, %u KB per frame\n",
+           pbos.empty() ? "Direct" : "PBO", (unsigned int)(frameBudget / 1024));
+}
+
+void TextureStreamer::cleanup() {
+    flushAll();
+    if (!pbos.empty()) {
+        glDeleteBuffers((GLsizei)pbos.size(), &pbos[0]);
+        pbos.clear();
+    }
+}
+
+void TextureStreamer::queue(unsigned int texId, std::vector<UploadLevel>& levels, bool placeholder) {
+    if (levels.empty()) {
+        return;
+    }
+    cancel(texId);
+
+    Job job;
+    job.texId = texId;
+    job.row = 0;
+    job.rowBytes = 0;
+    job.placeholderLevel = -1;
+    job.levels.swap(levels);
+    std::sort(job.levels.begin(), job.levels.end(), [](const UploadLevel& a, const UploadLevel& b) {
+        return a.level < b.level;
+    });
+
+    if (!placeholder) {
+        jobs.push_back(std::move(job));
+        return;
+    }
+
+    GLState::bindTexture(texId);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, job.levels.back().level);
+
+    if (job.levels.size() > 1) {
+        // The mip tail is tiny, so it goes up now and stands in for the rest
+        uploadNext(job, (size_t)-1);
+    } else {
+        const unsigned char gray[4] = { 128, 128, 128, 255 };
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, job.levels[0].level, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, gray);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, job.levels[0].level);
+        job.placeholderLevel = job.levels[0].level;
+    }
+    jobs.push_back(std::move(job));
+}
+
+void TextureStreamer::uploadRows(unsigned int texId, const UploadLevel& level, int firstRow, int rowCount,
+                                 size_t offset, size_t size) {
+    const unsigned char* pixels = &level.data[offset];
+    bool usePbo = false;
+
+    if (!pbos.empty()) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos[nextPbo]);
+        nextPbo = (nextPbo + 1) % (int)pbos.size();
+        // Orphan the old storage so mapping doesn't wait for its transfer
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW);
+        void* dest = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+        if (dest != NULL) {
+            memcpy(dest, pixels, size);
+            usePbo = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+        }
+        if (usePbo) {
+            pixels = NULL;  // Offset 0 into the bound buffer
+        } else {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        }
+    }
+
+    GLState::bindTexture(texId);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    bool whole = firstRow == 0 && rowCount == level.height;
+    if (level.format == 0) {
+        if (whole) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, level.level, level.internalFormat, level.width, level.height, 0,
+                                   (GLsizei)size, pixels);
+        } else {
+            glCompressedTexSubImage2D(GL_TEXTURE_2D, level.level, 0, firstRow, level.width, rowCount,
+                                      level.internalFormat, (GLsizei)size, pixels);
+        }
+    } else {
+        if (whole) {
+            glTexImage2D(GL_TEXTURE_2D, level.level, level.internalFormat, level.width, level.height, 0,
+                         level.format, GL_UNSIGNED_BYTE, pixels);
+        } else {
+            glTexSubImage2D(GL_TEXTURE_2D, level.level, 0, firstRow, level.width, rowCount,
+                            level.format, GL_UNSIGNED_BYTE, pixels);
+        }
+    }
+
+    if (usePbo) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    uploadedBytes += size;
+}
+
+size_t TextureStreamer::uploadNext(Job& job, size_t budget, bool atLeastOne) {
+    const UploadLevel& level = job.levels.back();
+    size_t total = level.data.size();
+    size_t sent;
+
+    if (job.row == 0 && (total <= budget || level.level == job.placeholderLevel)) {
+        if (total > budget && !atLeastOne) return 0;
+        uploadRows(job.texId, level, 0, level.height, 0, total);
+        sent = total;
+    } else {
+        // Compressed levels go in whole rows of 4x4 blocks
+        int unitRows = level.format == 0 ? 4 : 1;
+        int units = (level.height + unitRows - 1) / unitRows;
+        size_t unitBytes = std::max<size_t>(1, total / units);
+        size_t fit = budget / unitBytes;
+        if (fit == 0) {
+            if (!atLeastOne) return 0;
+            fit = 1;
+        }
+        if (job.row == 0) {
+            // Storage only; the bands fill it in. A compressed internal
+            // format with no data just allocates the blocks.
+            GLState::bindTexture(job.texId);
+            glTexImage2D(GL_TEXTURE_2D, level.level, level.internalFormat, level.width, level.height, 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+        }
+        int rows = (int)std::min<size_t>(fit * unitRows, (size_t)(level.height - job.row));
+        size_t size = job.row + rows >= level.height ? total - job.rowBytes : (rows / unitRows) * unitBytes;
+        uploadRows(job.texId, level, job.row, rows, job.rowBytes, size);
+        job.row += rows;
+        job.rowBytes += size;
+        sent = size;
+        if (job.row < level.height) {
+            return sent;
+        }
+    }
+
+    // Level complete: draw from it from now on
+    GLState::bindTexture(job.texId);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level.level);
+    job.levels.pop_back();
+    job.row = 0;
+    job.rowBytes = 0;
+    if (job.levels.empty()) {
+        completedCount++;
+    }
+    return sent;
+}
+
+void TextureStreamer::update() {
+    size_t spent = 0;
+    while (!jobs.empty() && spent < frameBudget) {
+        size_t sent = uploadNext(jobs.front(), frameBudget - spent, spent == 0);
+        if (sent == 0) break;
+        spent += sent;
+        if (jobs.front().levels.empty()) {
+            jobs.pop_front();
+        }
+    }
+    if (spent > 0) {
+        GLState::bindTexture(0);
+    }
+}
+
+void TextureStreamer::flush(unsigned int texId) {
+    for (auto it = jobs.begin(); it != jobs.end(); ++it) {
+        if (it->texId == texId) {
+            while (!it->levels.empty()) {
+                uploadNext(*it, (size_t)-1);
+            }
+            jobs.erase(it);
+            return;
+        }
+    }
+}
+
+void TextureStreamer::flushAll() {
+    while (!jobs.empty()) {
+        while (!jobs.front().levels.empty()) {
+            uploadNext(jobs.front(), (size_t)-1);
+        }
+        jobs.pop_front();
+    }
+}
+
+void TextureStreamer::cancel(unsigned int texId) {
+    for (auto it = jobs.begin(); it != jobs.end(); ++it) {
+        if (it->texId == texId) {
+            jobs.erase(it);
+            return;
+        }
+    }
+}
+
+bool TextureStreamer::isPending(unsigned int texId) const {
+    for (const Job& job : jobs) {
+        if (job.texId == texId) return true;
+    }
+    return false;
+}
+
+size_t TextureStreamer::getQueuedBytes() const {
+    size_t total = 0;
+    for (const Job& job : jobs) {
+        for (const UploadLevel& level : job.levels) total += level.data.size();
+        total -= job.rowBytes;
+    }
+    return total;
+}
+
+void TextureStreamer::printStats() const {
+    printf("TextureStreamer: %d textures streamed, %.1f MB uploaded, %d pending (%.1f MB)\n",
+           completedCount, uploadedBytes / (1024.0f * 1024.0f), getPendingCount(),
+           getQueuedBytes() / (1024.0f * 1024.0f));
+}
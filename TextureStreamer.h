@@ -0,0 +1,97 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <cstddef>
+
+// One mip level waiting to be uploaded. Formats are GL enums; a format of 0
+// means data is already compressed in internalFormat (DXT from a bake).
+struct UploadLevel {
+    int level = 0;
+    int width = 0;
+    int height = 0;
+    unsigned int internalFormat = 0;
+    unsigned int format = 0;
+    std::vector<unsigned char> data;
+};
+
+// Texture Streamer - spreads texture uploads over frames
+// Uploading a whole mip chain with glTexImage2D stalls the frame it happens
+// in, which showed up as a hitch on every level switch (plane reload,
+// evicted textures coming back). Queued textures start out as a placeholder
+// (their smallest mip, or a 1x1 gray) and get their levels smallest first,
+// a few per frame under a byte budget. A level bigger than what is left of
+// the budget is allocated empty and filled in bands of rows over as many
+// frames as it takes. GL_TEXTURE_BASE_LEVEL always points at the largest
+// level completed so far, so the texture can be drawn at any point. A level
+// that the gray placeholder stands in for goes up whole instead, as the
+// first upload of a frame. With pixel buffer objects the copy goes through
+// a ring of PBOs and the driver transfers it without blocking the frame.
+class TextureStreamer {
+public:
+    // Singleton pattern (same as GameManager)
+    static TextureStreamer& getInstance();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // Create the PBO ring (needs a GL context and glewInit)
+    void init();
+    void cleanup();
+
+    // Take the levels of a bound-and-configured texture (any order) and
+    // upload its placeholder right away. Without a placeholder the levels
+    // are added to a texture that already has its coarser ones.
+    void queue(unsigned int texId, std::vector<UploadLevel>& levels, bool placeholder = true);
+
+    // Upload queued levels up to the per-frame budget; call once per frame
+    void update();
+    // Finish one texture, or everything, right now
+    void flush(unsigned int texId);
+    void flushAll();
+    // Drop a texture's remaining levels (released or evicted)
+    void cancel(unsigned int texId);
+
+    bool isPending(unsigned int texId) const;
+    int getPendingCount() const { return (int)jobs.size(); }
+
+    // Bytes uploaded per update(); at least one row goes up every frame
+    void setFrameBudget(size_t bytes) { frameBudget = bytes; }
+    size_t getFrameBudget() const { return frameBudget; }
+
+    // Stats
+    bool isUsingPBO() const { return !pbos.empty(); }
+    size_t getQueuedBytes() const;
+    size_t getUploadedBytes() const { return uploadedBytes; }
+    int getCompletedCount() const { return completedCount; }
+    void printStats() const;
+
+private:
+    TextureStreamer();
+    ~TextureStreamer();
+
+    struct Job {
+        unsigned int texId;
+        std::vector<UploadLevel> levels;    // Largest first, uploaded from the back
+        int row;                            // Rows of the back level already uploaded
+        size_t rowBytes;                    // Their size in bytes
+        int placeholderLevel;               // Level holding the 1x1 gray, or -1
+    };
+
+    std::deque<Job> jobs;
+    std::vector<unsigned int> pbos;
+    int nextPbo;
+    size_t frameBudget;
+    size_t uploadedBytes;
+    int completedCount;
+
+    // Upload rows [firstRow, firstRow + rowCount) of a level; a whole level
+    // is (re)specified, a band goes into storage allocated before
+    void uploadRows(unsigned int texId, const UploadLevel& level, int firstRow, int rowCount, size_t offset,
+                    size_t size);
+    // Upload as much of the job's next level as fits in budget; returns the
+    // bytes sent. A band is at least one row (four for compressed levels),
+    // and with atLeastOne that row goes up even when it doesn't fit. The
+    // placeholder's level is never banded: allocating it empty would
+    // replace the gray with undefined texels until the last band.
+    size_t uploadNext(Job& job, size_t budget, bool atLeastOne = true);
+};
@@ -0,0 +1,126 @@
+#include "WorkerPool.h"
+
+// Set on pool threads so nested parallelFor calls run inline instead of deadlocking
+static thread_local bool isPoolThread = false;
+// Set while the submitting thread works on its own job; it still holds
+// submitMutex, so a nested parallelFor from the body must run inline too
+static thread_local bool isInsideJob = false;
+
+WorkerPool::WorkerPool()
+    : job(nullptr), jobCount(0), jobGrain(1), jobSerial(0), busyWorkers(0), nextItem(0), quitting(false) {
+    unsigned int cores = std::thread::hardware_concurrency();
+    int workerCount = cores > 1 ? (int)cores - 1 : 0;
+    if (workerCount > 7) workerCount = 7;
+
+    for (int i = 0; i < workerCount; i++) {
+        threads.push_back(std::thread(&WorkerPool::workerLoop, this));
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quitting = true;
+    }
+    wake.notify_all();
+    for (size_t i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+}
+
+WorkerPool& WorkerPool::getInstance() {
+    static WorkerPool instance;
+    return instance;
+}
+
+void WorkerPool::runChunks(const std::function<void(int, int)>* body, int count, int grain) {
+    while (true) {
+        int begin = nextItem.fetch_add(grain);
+        if (begin >= count) {
+            break;
+        }
+        int end = begin + grain < count ? begin + grain : count;
+        (*body)(begin, end);
+    }
+}
+
+void WorkerPool::workerLoop() {
+    isPoolThread = true;
+    unsigned int seenSerial = 0;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [&] { return quitting || (job != nullptr && jobSerial != seenSerial) || !tasks.empty(); });
+        if (quitting) {
+            return;
+        }
+
+        if (job == nullptr || jobSerial == seenSerial) {
+            std::function<void()> task = std::move(tasks.front());
+            tasks.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+            continue;
+        }
+
+        // Copy the job while holding the lock; the submitter waits for busyWorkers to drop to 0
+        seenSerial = jobSerial;
+        const std::function<void(int, int)>* body = job;
+        int count = jobCount;
+        int grain = jobGrain;
+        busyWorkers++;
+
+        lock.unlock();
+        runChunks(body, count, grain);
+        lock.lock();
+
+        if (--busyWorkers == 0) {
+            finished.notify_all();
+        }
+    }
+}
+
+void WorkerPool::parallelFor(int count, int grain, const std::function<void(int, int)>& body) {
+    if (count <= 0) {
+        return;
+    }
+    if (grain < 1) grain = 1;
+
+    if (threads.empty() || count <= grain || isPoolThread || isInsideJob) {
+        body(0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submitLock(submitMutex);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &body;
+        jobCount = count;
+        jobGrain = grain;
+        jobSerial++;
+        nextItem = 0;
+    }
+    wake.notify_all();
+
+    isInsideJob = true;
+    runChunks(&body, count, grain);
+    isInsideJob = false;
+
+    // Workers that never picked the job up see job == nullptr and keep sleeping
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&] { return busyWorkers == 0; });
+    job = nullptr;
+}
+
+void WorkerPool::runAsync(const std::function<void()>& task) {
+    if (threads.empty()) {
+        task();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(task);
+    }
+    wake.notify_one();
+}
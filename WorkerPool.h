@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <deque>
+
+// Worker Pool - fixed set of background threads for data-parallel loops
+// Used for CPU-heavy loading work (mip generation, decoding) and the
+// per-frame ocean grid, which split cleanly into independent ranges. The
+// calling thread takes part in the work, and parallelFor only returns once
+// every range is done. runAsync hands a single task to the workers and
+// returns at once, for loads the main thread shouldn't wait on.
+class WorkerPool {
+public:
+    // Singleton pattern (same as GameManager)
+    static WorkerPool& getInstance();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Call body(begin, end) over [0, count) in chunks of at most grain items.
+    // Small loops, and loops started from inside a worker or another
+    // parallelFor body, run inline.
+    void parallelFor(int count, int grain, const std::function<void(int, int)>& body);
+
+    // Run task on a worker in the background, in submission order as
+    // workers free up (parallelFor jobs go first). Inline when there are
+    // no workers. The task must not touch GL or unsynchronized state.
+    void runAsync(const std::function<void()>& task);
+
+    // Worker threads plus the calling thread
+    int getThreadCount() const { return (int)threads.size() + 1; }
+
+private:
+    WorkerPool();
+    ~WorkerPool();
+
+    void workerLoop();
+    void runChunks(const std::function<void(int, int)>* job, int count, int grain);
+
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable wake;       // New job, new task or shutdown
+    std::condition_variable finished;   // Last worker left the job
+    std::mutex submitMutex;             // One parallelFor at a time
+
+    // Current job (guarded by mutex, except the chunk counter)
+    const std::function<void(int, int)>* job;
+    int jobCount;
+    int jobGrain;
+    unsigned int jobSerial;
+    int busyWorkers;
+    std::atomic<int> nextItem;
+    std::deque<std::function<void()>> tasks;    // runAsync tasks not started yet (guarded by mutex)
+    bool quitting;
+};